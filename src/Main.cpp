@@ -1031,19 +1031,47 @@ int main (int argc, char* argv[])
         return exitCode;
     }
 
-    // Main loop at ~60Hz (vsync-paced).
-    // GLFW pollEvents handles vsync pacing; tick() drives meter
-    // updates and message queue processing each frame.
+    // Main loop. Input, posted messages and plugin fds/timers all wake the
+    // event wait, so it only needs a timeout while frames keep coming: a
+    // ~60Hz frame timer while something painted last frame or the app says
+    // state is changing on its own (playback, scans, imports, waveforms
+    // loading). Otherwise it sleeps, with a slow idle tick to pick up
+    // polled state such as meters.
+    constexpr double frameIntervalSeconds = 1.0 / 60.0;
+    constexpr double idleTickSeconds = 0.25;
+
+#if defined(__linux__)
+    dc::LinuxRunLoop::instance().startWatching ([] { dc::platform::GlfwWindow::postEmptyEvent(); });
+    appController->getMessageQueue().setWakeCallback ([] { dc::LinuxRunLoop::instance().wake(); });
+#endif
+
+    auto lastFrameStart = std::chrono::steady_clock::now();
+
     while (! shouldQuit && ! glfwWindow->shouldClose())
     {
-        glfwWindow->pollEvents();
+        double timeout = idleTickSeconds;
+
+        if (! renderer->wasLastFrameSkipped() || appController->needsFrameTimer())
+        {
+            double sinceFrame = std::chrono::duration<double> (
+                std::chrono::steady_clock::now() - lastFrameStart).count();
+            timeout = frameIntervalSeconds - sinceFrame;
+        }
+
+        glfwWindow->waitEvents (timeout);
 #if defined(__linux__)
         dc::LinuxRunLoop::instance().poll();
 #endif
+        lastFrameStart = std::chrono::steady_clock::now();
         appController->tick();
         renderer->renderFrame (*appController);
     }
 
+#if defined(__linux__)
+    appController->getMessageQueue().setWakeCallback (nullptr);
+    dc::LinuxRunLoop::instance().stopWatching();
+#endif
+
     // Tear down in reverse order
     appController.reset();
     eventDispatch.reset();
@@ -1,7 +1,13 @@
 #include "AudioFileReader.h"
 #include <algorithm>
+#include <cctype>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 namespace dc {
 
 std::unique_ptr<AudioFileReader> AudioFileReader::open (const std::filesystem::path& path)
@@ -10,10 +16,61 @@ std::unique_ptr<AudioFileReader> AudioFileReader::open (const std::filesystem::p
     reader->path_ = path;
     reader->info_ = {};
 
-    reader->file_ = sf_open (path.string().c_str(), SFM_READ, &reader->info_);
+    // Open the descriptor ourselves so read-ahead hints can be issued on it.
+    // The reader keeps ownership and closes it after sf_close().
+    reader->fd_ = ::open (path.string().c_str(), O_RDONLY | O_CLOEXEC);
+    if (reader->fd_ < 0)
+        return nullptr;
+
+    reader->file_ = sf_open_fd (reader->fd_, SFM_READ, &reader->info_, SF_FALSE);
     if (reader->file_ == nullptr)
         return nullptr;
 
+    // libsndfile reads the header straight from the descriptor and leaves
+    // it at the audio data
+    reader->dataOffset_ = std::max<int64_t> (::lseek (reader->fd_, 0, SEEK_CUR), 0);
+
+    return reader;
+}
+
+std::shared_ptr<AudioFileReader> AudioFileReader::openShared (const std::filesystem::path& path)
+{
+    struct SharedHandle
+    {
+        std::filesystem::file_time_type modificationTime;
+        std::weak_ptr<AudioFileReader> reader;
+    };
+
+    static std::mutex tableMutex;
+    static std::unordered_map<std::string, SharedHandle> table;
+
+    std::error_code ec;
+    auto key = std::filesystem::weakly_canonical (path, ec).string();
+    if (ec)
+        key = path.lexically_normal().string();
+
+    auto modified = std::filesystem::last_write_time (path, ec);
+    if (ec)
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock (tableMutex);
+
+    auto it = table.find (key);
+    if (it != table.end())
+    {
+        if (auto existing = it->second.reader.lock(); existing && it->second.modificationTime == modified)
+            return existing;
+    }
+
+    std::shared_ptr<AudioFileReader> reader = open (path);
+    if (reader == nullptr)
+        return nullptr;
+
+    // Drop entries whose readers have all been released
+    for (auto e = table.begin(); e != table.end();)
+        e = e->second.reader.expired() ? table.erase (e) : std::next (e);
+
+    table[key] = { modified, reader };
     return reader;
 }
 
@@ -24,6 +81,12 @@ AudioFileReader::~AudioFileReader()
         sf_close (file_);
         file_ = nullptr;
     }
+
+    if (fd_ >= 0)
+    {
+        ::close (fd_);
+        fd_ = -1;
+    }
 }
 
 int AudioFileReader::getNumChannels() const
@@ -46,8 +109,23 @@ int64_t AudioFileReader::read (float* buffer, int64_t startFrame, int64_t numFra
     if (file_ == nullptr)
         return 0;
 
-    sf_seek (file_, startFrame, SEEK_SET);
-    return sf_readf_float (file_, buffer, numFrames);
+    std::lock_guard<std::mutex> lock (readMutex_);
+    return readLocked (buffer, startFrame, numFrames);
+}
+
+int64_t AudioFileReader::readLocked (float* buffer, int64_t startFrame, int64_t numFrames)
+{
+    // Seeking a compressed stream restarts the decoder, so sequential
+    // reads continue from where the last one stopped
+    if (startFrame != position_ && sf_seek (file_, startFrame, SEEK_SET) < 0)
+    {
+        position_ = -1;
+        return 0;
+    }
+
+    auto got = sf_readf_float (file_, buffer, numFrames);
+    position_ = got >= 0 ? startFrame + got : -1;
+    return got;
 }
 
 int64_t AudioFileReader::read (AudioBlock& block, int64_t startFrame, int64_t numFrames)
@@ -60,8 +138,11 @@ int64_t AudioFileReader::read (AudioBlock& block, int64_t startFrame, int64_t nu
 
     // Read interleaved into temporary buffer
     std::vector<float> interleaved (static_cast<size_t> (framesToRead * channels));
-    sf_seek (file_, startFrame, SEEK_SET);
-    int64_t framesRead = sf_readf_float (file_, interleaved.data(), framesToRead);
+    int64_t framesRead;
+    {
+        std::lock_guard<std::mutex> lock (readMutex_);
+        framesRead = readLocked (interleaved.data(), startFrame, framesToRead);
+    }
 
     // De-interleave into block channels
     int blockChannels = std::min (channels, block.getNumChannels());
@@ -93,6 +174,19 @@ std::string AudioFileReader::getFormatName() const
     }
 }
 
+bool AudioFileReader::isCompressed() const
+{
+    int majorFormat = info_.format & SF_FORMAT_TYPEMASK;
+    if (majorFormat == SF_FORMAT_FLAC || majorFormat == SF_FORMAT_OGG)
+        return true;
+
+    // MP3's major format only exists in newer libsndfile releases
+    auto ext = path_.extension().string();
+    std::transform (ext.begin(), ext.end(), ext.begin(),
+                    [] (unsigned char c) { return static_cast<char> (std::tolower (c)); });
+    return ext == ".mp3";
+}
+
 int AudioFileReader::getBitDepth() const
 {
     int subFormat = info_.format & SF_FORMAT_SUBMASK;
@@ -110,4 +204,40 @@ int AudioFileReader::getBitDepth() const
     }
 }
 
+void AudioFileReader::adviseSequential()
+{
+#if defined (POSIX_FADV_SEQUENTIAL)
+    if (fd_ >= 0)
+        posix_fadvise (fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+void AudioFileReader::adviseWillNeed (int64_t startFrame, int64_t numFrames)
+{
+    if (fd_ < 0 || numFrames <= 0)
+        return;
+
+    int bytesPerSample = std::max (1, getBitDepth() / 8);
+    auto bytesPerFrame = static_cast<off_t> (bytesPerSample * info_.channels);
+    auto begin = static_cast<off_t> (dataOffset_) + static_cast<off_t> (std::max<int64_t> (startFrame, 0)) * bytesPerFrame;
+    auto end = begin + static_cast<off_t> (numFrames) * bytesPerFrame;
+
+    // Whole pages, so frames straddling a page boundary are covered too
+    static const off_t pageSize = std::max<off_t> (::sysconf (_SC_PAGESIZE), 1);
+    auto offset = begin / pageSize * pageSize;
+    auto length = (end + pageSize - 1) / pageSize * pageSize - offset;
+
+#if defined (POSIX_FADV_WILLNEED)
+    posix_fadvise (fd_, offset, length, POSIX_FADV_WILLNEED);
+#elif defined (F_RDADVISE)
+    radvisory ra;
+    ra.ra_offset = offset;
+    ra.ra_count = static_cast<int> (std::min<off_t> (length, 0x7fffffff));
+    fcntl (fd_, F_RDADVISE, &ra);
+#else
+    (void) offset;
+    (void) length;
+#endif
+}
+
 } // namespace dc
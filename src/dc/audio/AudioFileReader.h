@@ -4,18 +4,28 @@
 #include <cstdint>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <sndfile.h>
 
 namespace dc {
 
 /// Reads audio files via libsndfile. RAII — destructor closes the file.
+///
+/// Reads are serialised internally, so one reader may be shared by
+/// several threads (see openShared()).
 class AudioFileReader
 {
 public:
     /// Open a file for reading. Returns nullptr on failure.
     static std::unique_ptr<AudioFileReader> open (const std::filesystem::path& path);
 
+    /// Open a file through a process-wide table of shared handles: callers
+    /// opening the same (unmodified) file get the same reader, so many
+    /// streamers playing one file hold a single descriptor. The handle
+    /// closes when the last holder releases it. Returns nullptr on failure.
+    static std::shared_ptr<AudioFileReader> openShared (const std::filesystem::path& path);
+
     ~AudioFileReader();
 
     int getNumChannels() const;
@@ -34,13 +44,31 @@ public:
     std::string getFormatName() const;
     int getBitDepth() const;
 
+    /// True for formats whose decoding costs CPU (FLAC, Ogg, MP3), as opposed
+    /// to PCM that is read more or less straight from disk.
+    bool isCompressed() const;
+
+    /// Hint to the OS that the file will be read front to back
+    /// (posix_fadvise SEQUENTIAL). No-op where unsupported.
+    void adviseSequential();
+
+    /// Hint that the given frame range will be read soon so the kernel can
+    /// start read-ahead. The byte range is approximate for compressed files.
+    void adviseWillNeed (int64_t startFrame, int64_t numFrames);
+
 private:
     AudioFileReader() = default;
 
     AudioFileReader (const AudioFileReader&) = delete;
     AudioFileReader& operator= (const AudioFileReader&) = delete;
 
+    int64_t readLocked (float* buffer, int64_t startFrame, int64_t numFrames);   // requires readMutex_
+
+    std::mutex readMutex_;     // sf_seek + sf_readf must not interleave
+    int64_t position_ = -1;    // codec position after the last read; -1 = unknown
     SNDFILE* file_ = nullptr;
+    int fd_ = -1;
+    int64_t dataOffset_ = 0;   // file offset of the first frame, as left by sf_open_fd
     SF_INFO info_{};
     std::filesystem::path path_;
 };
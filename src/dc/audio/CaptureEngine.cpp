@@ -0,0 +1,532 @@
+#include "CaptureEngine.h"
+#include "PeakStore.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace dc {
+
+namespace {
+
+constexpr size_t pageSize = 4096;
+
+// RIFF + fmt (16) + JUNK padding + data header = one page, so the sample
+// data starts page aligned
+constexpr size_t dataOffset = pageSize;
+constexpr size_t riffSizeOffset = 4;
+constexpr size_t dataSizeOffset = dataOffset - 4;
+
+size_t nextPowerOf2 (size_t v)
+{
+    v--;
+    v |= v >> 1;
+    v |= v >> 2;
+    v |= v >> 4;
+    v |= v >> 8;
+    v |= v >> 16;
+    v |= v >> 32;
+    v++;
+    return v;
+}
+
+int bytesPerSample (CaptureEngine::SampleFormat f)
+{
+    switch (f)
+    {
+        case CaptureEngine::SampleFormat::int16:   return 2;
+        case CaptureEngine::SampleFormat::int24:   return 3;
+        case CaptureEngine::SampleFormat::float32: return 4;
+    }
+    return 4;
+}
+
+void putLE16 (uint8_t* p, uint32_t v)
+{
+    p[0] = static_cast<uint8_t> (v);
+    p[1] = static_cast<uint8_t> (v >> 8);
+}
+
+void putLE32 (uint8_t* p, uint32_t v)
+{
+    p[0] = static_cast<uint8_t> (v);
+    p[1] = static_cast<uint8_t> (v >> 8);
+    p[2] = static_cast<uint8_t> (v >> 16);
+    p[3] = static_cast<uint8_t> (v >> 24);
+}
+
+uint32_t clampSize (uint64_t v)
+{
+    return static_cast<uint32_t> (std::min<uint64_t> (v, 0xffffffffu));
+}
+
+/// Convert interleaved floats to the file's little-endian sample format
+void encode (const float* src, size_t numSamples, CaptureEngine::SampleFormat format, uint8_t* dst)
+{
+    switch (format)
+    {
+        case CaptureEngine::SampleFormat::int16:
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                auto v = static_cast<int32_t> (std::lrint (std::clamp (src[i], -1.0f, 1.0f) * 32767.0f));
+                putLE16 (dst + i * 2, static_cast<uint32_t> (v));
+            }
+            break;
+
+        case CaptureEngine::SampleFormat::int24:
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                auto v = static_cast<int32_t> (std::lrint (std::clamp (src[i], -1.0f, 1.0f) * 8388607.0f));
+                uint8_t* p = dst + i * 3;
+                p[0] = static_cast<uint8_t> (v);
+                p[1] = static_cast<uint8_t> (v >> 8);
+                p[2] = static_cast<uint8_t> (v >> 16);
+            }
+            break;
+
+        case CaptureEngine::SampleFormat::float32:
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                uint32_t bits;
+                std::memcpy (&bits, src + i, 4);
+                putLE32 (dst + i * 4, bits);
+            }
+            break;
+    }
+}
+
+struct AlignedFree
+{
+    void operator() (uint8_t* p) const { std::free (p); }
+};
+
+} // anonymous namespace
+
+struct CaptureEngine::Input
+{
+    InputSpec spec;
+    int fd = -1;
+    int bytesPerFrame = 0;
+
+    // Interleaved ring; single producer (audio thread), single consumer
+    // (writer thread)
+    std::vector<float> ring;
+    size_t capacity = 0;      // frames, power of 2
+    size_t mask = 0;
+    std::atomic<size_t> readPos { 0 };
+    std::atomic<size_t> writePos { 0 };
+
+    // Frames per regular write: a multiple of both the page size (in
+    // bytes) and the frame size, so every write lands page aligned
+    size_t chunkFrames = 0;
+    std::unique_ptr<uint8_t, AlignedFree> staging;
+    std::vector<float> gather;
+
+    uint64_t dataBytes = 0;           // written so far
+    uint64_t preallocatedEnd = 0;     // file offset reserved up to
+    std::atomic<int64_t> framesOnDisk { 0 };
+
+    std::atomic<size_t> minFreeFrames { 0 };
+    std::atomic<int64_t> droppedFrames { 0 };
+
+    // Peaks of what has reached the file, built by the writer thread
+    std::shared_ptr<LivePeaks> peaks;
+};
+
+CaptureEngine::CaptureEngine (double ringSeconds)
+    : ringSeconds_ (ringSeconds > 0.0 ? ringSeconds : defaultRingSeconds)
+{
+}
+
+CaptureEngine::~CaptureEngine()
+{
+    stop();
+}
+
+bool CaptureEngine::start (const std::vector<InputSpec>& specs, double sampleRate)
+{
+    stop();
+
+    if (specs.empty() || sampleRate <= 0.0)
+        return false;
+
+    // The audio thread may still be in write() on the last take's inputs
+    waitForWriters();
+
+    sampleRate_ = sampleRate;
+    inputs_.clear();
+
+    for (auto& spec : specs)
+    {
+        auto in = std::make_unique<Input>();
+        in->spec = spec;
+        in->spec.numChannels = std::max (spec.numChannels, 1);
+        in->bytesPerFrame = bytesPerSample (spec.format) * in->spec.numChannels;
+
+        in->capacity = nextPowerOf2 (static_cast<size_t> (std::ceil (ringSeconds_ * sampleRate)));
+        in->mask = in->capacity - 1;
+        in->ring.assign (in->capacity * static_cast<size_t> (in->spec.numChannels), 0.0f);
+        in->minFreeFrames.store (in->capacity, std::memory_order_relaxed);
+
+        // Chunks of about a quarter of the ring, capped, in whole
+        // alignment units
+        auto unitBytes = std::lcm (pageSize, static_cast<size_t> (in->bytesPerFrame));
+        auto unitFrames = unitBytes / static_cast<size_t> (in->bytesPerFrame);
+        auto targetBytes = std::min (maxWriteBytes, in->capacity / 4 * static_cast<size_t> (in->bytesPerFrame));
+        in->chunkFrames = std::max<size_t> (1, targetBytes / unitBytes) * unitFrames;
+
+        // A ring too small for even one aligned unit gives up alignment
+        // rather than only ever draining at stop()
+        if (in->chunkFrames > in->capacity / 2)
+            in->chunkFrames = std::max<size_t> (1, in->capacity / 4);
+
+        // Leave room for the tail flush, which may be a partial chunk
+        size_t stagingBytes = (in->chunkFrames * static_cast<size_t> (in->bytesPerFrame) + pageSize - 1)
+                              / pageSize * pageSize;
+        in->staging.reset (static_cast<uint8_t*> (std::aligned_alloc (pageSize, stagingBytes)));
+        in->gather.resize (in->chunkFrames * static_cast<size_t> (in->spec.numChannels));
+        in->peaks = std::make_shared<LivePeaks> (in->spec.numChannels, sampleRate);
+
+        std::error_code ec;
+        std::filesystem::create_directories (spec.file.parent_path(), ec);
+
+        in->fd = ::open (spec.file.string().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (in->fd < 0 || in->staging == nullptr)
+        {
+            if (in->fd >= 0)
+                ::close (in->fd);
+            for (auto& created : inputs_)
+            {
+                ::close (created->fd);
+                std::filesystem::remove (created->spec.file, ec);
+            }
+            inputs_.clear();
+            return false;
+        }
+
+        updateHeader (*in);
+        preallocate (*in, static_cast<int64_t> (dataOffset));
+
+        inputs_.push_back (std::move (in));
+    }
+
+    bytesWritten_.store (0, std::memory_order_relaxed);
+    writes_.store (0, std::memory_order_relaxed);
+    writeSeconds_.store (0.0, std::memory_order_relaxed);
+    maxWriteSeconds_.store (0.0, std::memory_order_relaxed);
+
+    recording_.store (true, std::memory_order_release);
+    writerThread_ = std::thread (&CaptureEngine::writerThreadFunc, this);
+    return true;
+}
+
+void CaptureEngine::write (int input, const AudioBlock& block, int numSamples)
+{
+    // Announce this call before checking the flag, so stop() and start()
+    // either see it in flight or it sees recording cleared
+    writersInside_.fetch_add (1);
+    struct Leave
+    {
+        std::atomic<int>& count;
+        ~Leave() { count.fetch_sub (1, std::memory_order_release); }
+    } leave { writersInside_ };
+
+    if (! recording_.load()
+        || input < 0 || input >= static_cast<int> (inputs_.size()))
+        return;
+
+    auto& in = *inputs_[static_cast<size_t> (input)];
+    int numChannels = in.spec.numChannels;
+
+    size_t rp = in.readPos.load (std::memory_order_acquire);
+    size_t wp = in.writePos.load (std::memory_order_relaxed);
+    size_t space = in.capacity - (wp - rp);
+
+    int frames = std::min (numSamples, static_cast<int> (space));
+    if (frames < numSamples)
+        in.droppedFrames.fetch_add (numSamples - frames, std::memory_order_relaxed);
+
+    // Single producer: a plain load/store keeps the minimum
+    size_t freeAfter = space - static_cast<size_t> (std::max (frames, 0));
+    if (freeAfter < in.minFreeFrames.load (std::memory_order_relaxed))
+        in.minFreeFrames.store (freeAfter, std::memory_order_relaxed);
+
+    if (frames <= 0)
+        return;
+
+    int blockChannels = block.getNumChannels();
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const float* src = block.getChannel (ch < blockChannels ? ch : 0);
+        for (int f = 0; f < frames; ++f)
+            in.ring[((wp + static_cast<size_t> (f)) & in.mask) * static_cast<size_t> (numChannels)
+                    + static_cast<size_t> (ch)] = src[f];
+    }
+
+    in.writePos.store (wp + static_cast<size_t> (frames), std::memory_order_release);
+}
+
+void CaptureEngine::stop()
+{
+    if (! recording_.exchange (false))
+        return;
+
+    waitForWriters();
+
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+    }
+    cv_.notify_one();
+
+    if (writerThread_.joinable())
+        writerThread_.join();
+
+    // Drain what the audio thread queued before it saw the stop
+    for (auto& in : inputs_)
+    {
+        while (writeChunk (*in, true))
+        {
+        }
+        finish (*in);
+    }
+}
+
+void CaptureEngine::waitForWriters() const
+{
+    // A write() is a short copy into a ring, so this spins for microseconds
+    while (writersInside_.load (std::memory_order_acquire) != 0)
+        std::this_thread::yield();
+}
+
+int64_t CaptureEngine::getRecordedFrames (int input) const
+{
+    if (input < 0 || input >= static_cast<int> (inputs_.size()))
+        return 0;
+    return inputs_[static_cast<size_t> (input)]->framesOnDisk.load (std::memory_order_relaxed);
+}
+
+std::shared_ptr<LivePeaks> CaptureEngine::getPeaks (int input) const
+{
+    if (input < 0 || input >= static_cast<int> (inputs_.size()))
+        return nullptr;
+    return inputs_[static_cast<size_t> (input)]->peaks;
+}
+
+CaptureEngine::Metrics CaptureEngine::getMetrics() const
+{
+    Metrics m;
+    m.bytesWritten = bytesWritten_.load (std::memory_order_relaxed);
+    m.writes = writes_.load (std::memory_order_relaxed);
+    m.maxWriteMilliseconds = maxWriteSeconds_.load (std::memory_order_relaxed) * 1000.0;
+
+    double seconds = writeSeconds_.load (std::memory_order_relaxed);
+    if (seconds > 0.0)
+        m.diskBytesPerSecond = static_cast<double> (m.bytesWritten) / seconds;
+
+    m.minHeadroomSeconds = ringSeconds_;
+    for (auto& in : inputs_)
+    {
+        m.requiredBytesPerSecond += sampleRate_ * in->bytesPerFrame;
+        m.droppedFrames += in->droppedFrames.load (std::memory_order_relaxed);
+
+        auto minFree = static_cast<double> (in->minFreeFrames.load (std::memory_order_relaxed));
+        m.minHeadroom = std::min (m.minHeadroom, minFree / static_cast<double> (in->capacity));
+        m.minHeadroomSeconds = std::min (m.minHeadroomSeconds, minFree / sampleRate_);
+    }
+
+    return m;
+}
+
+void CaptureEngine::writerThreadFunc()
+{
+    using clock = std::chrono::steady_clock;
+    auto lastHeaderUpdate = clock::now();
+
+    while (recording_.load (std::memory_order_acquire))
+    {
+        // Fullest ring first until none has a whole chunk waiting
+        bool wrote = true;
+        while (wrote && recording_.load (std::memory_order_relaxed))
+        {
+            // Compare each ring's fill as a share of its own capacity
+            Input* fullest = nullptr;
+            double mostFull = 0.0;
+            for (auto& in : inputs_)
+            {
+                size_t queued = in->writePos.load (std::memory_order_acquire)
+                              - in->readPos.load (std::memory_order_relaxed);
+                double fill = static_cast<double> (queued) / static_cast<double> (in->capacity);
+                if (queued >= in->chunkFrames && fill > mostFull)
+                {
+                    fullest = in.get();
+                    mostFull = fill;
+                }
+            }
+
+            wrote = fullest != nullptr && writeChunk (*fullest, false);
+        }
+
+        if (clock::now() - lastHeaderUpdate >= std::chrono::duration<double> (headerUpdateSeconds))
+        {
+            for (auto& in : inputs_)
+                updateHeader (*in);
+            lastHeaderUpdate = clock::now();
+        }
+
+        // Polled rather than signalled so the audio thread never touches
+        // the condition variable
+        std::unique_lock<std::mutex> lock (mutex_);
+        cv_.wait_for (lock, std::chrono::milliseconds (5),
+                      [this] { return ! recording_.load (std::memory_order_relaxed); });
+    }
+}
+
+bool CaptureEngine::writeChunk (Input& in, bool flush)
+{
+    size_t rp = in.readPos.load (std::memory_order_relaxed);
+    size_t wp = in.writePos.load (std::memory_order_acquire);
+    size_t queued = wp - rp;
+
+    size_t frames = flush ? std::min (queued, in.chunkFrames) : in.chunkFrames;
+    if (frames == 0 || frames > queued)
+        return false;
+
+    auto numChannels = static_cast<size_t> (in.spec.numChannels);
+
+    // Gather the (possibly wrapped) ring span, then encode into the
+    // aligned staging buffer
+    size_t first = std::min (frames, in.capacity - (rp & in.mask));
+    std::memcpy (in.gather.data(), in.ring.data() + (rp & in.mask) * numChannels,
+                 sizeof (float) * first * numChannels);
+    std::memcpy (in.gather.data() + first * numChannels, in.ring.data(),
+                 sizeof (float) * (frames - first) * numChannels);
+
+    in.readPos.store (rp + frames, std::memory_order_release);
+
+    size_t bytes = frames * static_cast<size_t> (in.bytesPerFrame);
+    encode (in.gather.data(), frames * numChannels, in.spec.format, in.staging.get());
+
+    auto offset = static_cast<int64_t> (dataOffset + in.dataBytes);
+    preallocate (in, offset + static_cast<int64_t> (bytes));
+
+    auto t0 = std::chrono::steady_clock::now();
+    size_t done = 0;
+    while (done < bytes)
+    {
+        auto n = pwrite (in.fd, in.staging.get() + done, bytes - done, static_cast<off_t> (offset) + static_cast<off_t> (done));
+        if (n <= 0)
+            break;
+        done += static_cast<size_t> (n);
+    }
+    double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - t0).count();
+
+    // A failed write loses the chunk; account it as dropped
+    if (done < bytes)
+        in.droppedFrames.fetch_add (static_cast<int64_t> (frames), std::memory_order_relaxed);
+    else
+    {
+        in.dataBytes += bytes;
+        in.framesOnDisk.fetch_add (static_cast<int64_t> (frames), std::memory_order_relaxed);
+        in.peaks->add (in.gather.data(), static_cast<int64_t> (frames));
+    }
+
+    bytesWritten_.fetch_add (static_cast<int64_t> (done), std::memory_order_relaxed);
+    writes_.fetch_add (1, std::memory_order_relaxed);
+    writeSeconds_.store (writeSeconds_.load (std::memory_order_relaxed) + seconds, std::memory_order_relaxed);
+    if (seconds > maxWriteSeconds_.load (std::memory_order_relaxed))
+        maxWriteSeconds_.store (seconds, std::memory_order_relaxed);
+
+    return true;
+}
+
+void CaptureEngine::preallocate (Input& in, int64_t upToByte)
+{
+    if (static_cast<uint64_t> (upToByte) <= in.preallocatedEnd)
+        return;
+
+    // Reserve in large steps so the filesystem can lay the file out
+    // contiguously and writes never wait on block allocation
+    auto step = static_cast<uint64_t> (preallocateSeconds * sampleRate_) * static_cast<uint64_t> (in.bytesPerFrame);
+    step = (step + pageSize - 1) / pageSize * pageSize;
+    uint64_t newEnd = std::max<uint64_t> (in.preallocatedEnd, dataOffset) + step;
+    while (newEnd < static_cast<uint64_t> (upToByte))
+        newEnd += step;
+
+#if defined (__linux__)
+    fallocate (in.fd, FALLOC_FL_KEEP_SIZE, static_cast<off_t> (in.preallocatedEnd),
+               static_cast<off_t> (newEnd - in.preallocatedEnd));
+#endif
+
+    in.preallocatedEnd = newEnd;
+}
+
+void CaptureEngine::updateHeader (Input& in)
+{
+    uint8_t h[dataOffset] = {};
+    int numChannels = in.spec.numChannels;
+    int bytesPerSamp = bytesPerSample (in.spec.format);
+    auto rate = static_cast<uint32_t> (std::lround (sampleRate_));
+
+    // Odd-sized data is padded to an even length by finish()
+    uint64_t paddedData = in.dataBytes + (in.dataBytes & 1);
+
+    std::memcpy (h, "RIFF", 4);
+    putLE32 (h + riffSizeOffset, clampSize (dataOffset - 8 + paddedData));
+    std::memcpy (h + 8, "WAVE", 4);
+
+    std::memcpy (h + 12, "fmt ", 4);
+    putLE32 (h + 16, 16);
+    putLE16 (h + 20, in.spec.format == SampleFormat::float32 ? 3 : 1);
+    putLE16 (h + 22, static_cast<uint32_t> (numChannels));
+    putLE32 (h + 24, rate);
+    putLE32 (h + 28, rate * static_cast<uint32_t> (in.bytesPerFrame));
+    putLE16 (h + 32, static_cast<uint32_t> (in.bytesPerFrame));
+    putLE16 (h + 34, static_cast<uint32_t> (bytesPerSamp * 8));
+
+    // JUNK chunk pads the header out to the page boundary
+    std::memcpy (h + 36, "JUNK", 4);
+    putLE32 (h + 40, static_cast<uint32_t> (dataOffset - 8 - 44));
+
+    std::memcpy (h + dataOffset - 8, "data", 4);
+    putLE32 (h + dataSizeOffset, clampSize (in.dataBytes));
+
+    if (pwrite (in.fd, h, sizeof (h), 0) != static_cast<ssize_t> (sizeof (h)))
+        return;
+}
+
+void CaptureEngine::finish (Input& in)
+{
+    if (in.fd < 0)
+        return;
+
+    uint64_t end = dataOffset + in.dataBytes;
+    if (in.dataBytes & 1)
+    {
+        uint8_t pad = 0;
+        if (pwrite (in.fd, &pad, 1, static_cast<off_t> (end)) == 1)
+            ++end;
+    }
+
+    updateHeader (in);
+
+    // Give back the preallocated space past the end
+    if (ftruncate (in.fd, static_cast<off_t> (end)) != 0)
+    {
+        // The file is complete either way; only the reservation leaks
+    }
+
+    ::close (in.fd);
+    in.fd = -1;
+
+    // The take's peak file comes from what was captured, not a rescan
+    in.peaks->finish();
+    PeakStore::getInstance().save (in.spec.file, *in.peaks);
+}
+
+} // namespace dc
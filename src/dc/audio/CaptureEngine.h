@@ -0,0 +1,134 @@
+#pragma once
+
+#include "AudioBlock.h"
+#include "LivePeaks.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dc {
+
+/// Multi-track recorder: many inputs, one writer thread.
+///
+/// Each input has its own lock-free ring that the audio thread fills via
+/// write(). A single writer thread drains whichever ring is fullest in
+/// large chunks and writes them with pwrite() straight into a WAV file it
+/// lays out itself: the sample data starts on a 4 KiB boundary and every
+/// chunk is a multiple of 4 KiB, so writes stay page aligned. Files are
+/// preallocated ahead of the write position and their headers are fixed up
+/// periodically, so a crash loses at most the last few seconds.
+///
+/// Samples are dropped (and counted) rather than blocking the audio thread
+/// when a ring is full; getMetrics() reports how close that came.
+class CaptureEngine
+{
+public:
+    enum class SampleFormat { int16, int24, float32 };
+
+    struct InputSpec
+    {
+        std::filesystem::path file;
+        int numChannels = 1;
+        SampleFormat format = SampleFormat::int24;
+    };
+
+    /// @param ringSeconds  Audio each input can buffer before dropping.
+    explicit CaptureEngine (double ringSeconds = defaultRingSeconds);
+    ~CaptureEngine();
+
+    CaptureEngine (const CaptureEngine&) = delete;
+    CaptureEngine& operator= (const CaptureEngine&) = delete;
+
+    static constexpr double defaultRingSeconds = 4.0;
+
+    /// Largest single write per input.
+    static constexpr size_t maxWriteBytes = 1u << 20;
+
+    /// How often the RIFF and data sizes on disk are brought up to date.
+    static constexpr double headerUpdateSeconds = 2.0;
+
+    /// How far ahead of the write position disk space is reserved.
+    static constexpr double preallocateSeconds = 30.0;
+
+    /// Create the files and start the writer thread. Existing files are
+    /// replaced. Returns false (and creates nothing) on failure.
+    bool start (const std::vector<InputSpec>& inputs, double sampleRate);
+
+    /// Queue numSamples frames for an input. Audio-thread safe: never
+    /// blocks or allocates. Missing block channels repeat channel 0.
+    void write (int input, const AudioBlock& block, int numSamples);
+
+    /// Flush everything queued, finalise the headers and close the files.
+    void stop();
+
+    bool isRecording() const { return recording_.load (std::memory_order_relaxed); }
+    int getNumInputs() const { return static_cast<int> (inputs_.size()); }
+    double getSampleRate() const { return sampleRate_; }
+
+    /// Frames of an input that have reached the file.
+    int64_t getRecordedFrames (int input) const;
+
+    /// Waveform peaks of an input's take, growing as it reaches the file.
+    /// Completed at stop(), which also stores them as the file's peak file.
+    std::shared_ptr<LivePeaks> getPeaks (int input) const;
+
+    struct Metrics
+    {
+        int64_t bytesWritten = 0;
+        int64_t writes = 0;
+        double diskBytesPerSecond = 0.0;        // measured while writing
+        double requiredBytesPerSecond = 0.0;    // what the inputs produce
+        double maxWriteMilliseconds = 0.0;      // slowest single write
+        double minHeadroomSeconds = 0.0;        // least free ring space seen, any input
+        double minHeadroom = 1.0;               // same as a fraction of the ring
+        int64_t droppedFrames = 0;
+
+        /// Share of measured disk bandwidth the session needs (< 1 keeps up).
+        double getDiskLoad() const
+        {
+            return diskBytesPerSecond > 0.0 ? requiredBytesPerSecond / diskBytesPerSecond : 0.0;
+        }
+    };
+
+    Metrics getMetrics() const;
+
+private:
+    struct Input;
+
+    void writerThreadFunc();
+
+    /// Wait for write() calls that saw recording_ set to leave. Once
+    /// recording_ is clear, inputs_ may then be drained or replaced.
+    void waitForWriters() const;
+
+    /// Write one chunk of in's ring (or everything left when flushing).
+    /// Returns false if nothing was written.
+    bool writeChunk (Input& in, bool flush);
+
+    void preallocate (Input& in, int64_t upToByte);
+    void updateHeader (Input& in);
+    void finish (Input& in);
+
+    double ringSeconds_;
+    double sampleRate_ = 0.0;
+    std::vector<std::unique_ptr<Input>> inputs_;
+
+    std::thread writerThread_;
+    std::atomic<bool> recording_ { false };
+    std::atomic<int> writersInside_ { 0 };     // write() calls in flight
+    std::mutex mutex_;
+    std::condition_variable cv_;
+
+    // Writer-thread statistics, read by getMetrics()
+    std::atomic<int64_t> bytesWritten_ { 0 };
+    std::atomic<int64_t> writes_ { 0 };
+    std::atomic<double> writeSeconds_ { 0.0 };
+    std::atomic<double> maxWriteSeconds_ { 0.0 };
+};
+
+} // namespace dc
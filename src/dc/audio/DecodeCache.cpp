@@ -0,0 +1,328 @@
+#include "DecodeCache.h"
+#include <algorithm>
+#include <cstring>
+
+namespace dc {
+
+DecodeCache::DecodeCache (size_t memoryBudgetBytes, int numThreads)
+    : memoryBudget_ (memoryBudgetBytes)
+{
+    if (numThreads <= 0)
+        numThreads = std::clamp (static_cast<int> (std::thread::hardware_concurrency()) / 2, 1, 4);
+
+    for (int i = 0; i < numThreads; ++i)
+        threads_.emplace_back ([this] { workerLoop(); });
+}
+
+DecodeCache::~DecodeCache()
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        stopping_ = true;
+    }
+    workCv_.notify_all();
+
+    for (auto& t : threads_)
+        if (t.joinable())
+            t.join();
+}
+
+DecodeCache& DecodeCache::getInstance()
+{
+    static DecodeCache instance;
+    return instance;
+}
+
+int64_t DecodeCache::read (const std::shared_ptr<AudioFileReader>& reader, float* buffer,
+                           int64_t startFrame, int64_t numFrames)
+{
+    if (reader == nullptr || numFrames <= 0 || startFrame < 0)
+        return 0;
+
+    auto channels = static_cast<int64_t> (reader->getNumChannels());
+    int64_t done = 0;
+
+    while (done < numFrames)
+    {
+        int64_t position = startFrame + done;
+        int64_t block = position / blockFrames;
+
+        auto data = acquire (reader, block);
+        if (data == nullptr)
+            break;
+
+        int64_t offset = position - block * blockFrames;
+        int64_t available = static_cast<int64_t> (data->size()) / channels - offset;
+        if (available <= 0)
+            break;
+
+        int64_t n = std::min (available, numFrames - done);
+        std::memcpy (buffer + done * channels, data->data() + offset * channels,
+                     sizeof (float) * static_cast<size_t> (n * channels));
+        done += n;
+    }
+
+    // Keep the next blocks decoding while the caller plays this one
+    int64_t lastBlock = (startFrame + std::max<int64_t> (done, 1) - 1) / blockFrames;
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        queueBlocks (reader, lastBlock + 1, lastBlock + readAheadBlocks_);
+    }
+    workCv_.notify_all();
+
+    return done;
+}
+
+void DecodeCache::prefetch (const std::shared_ptr<AudioFileReader>& reader, int64_t startFrame, int64_t numFrames)
+{
+    if (reader == nullptr || numFrames <= 0 || startFrame < 0)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        queueBlocks (reader, startFrame / blockFrames, (startFrame + numFrames - 1) / blockFrames);
+    }
+    workCv_.notify_all();
+}
+
+DecodeCache::Data DecodeCache::acquire (const std::shared_ptr<AudioFileReader>& reader, int64_t block)
+{
+    std::unique_lock<std::mutex> lock (mutex_);
+    bool waited = false;
+
+    for (;;)
+    {
+        auto& blocks = sourceFor (reader).blocks;
+        auto it = blocks.find (block);
+
+        if (it != blocks.end() && it->second.state == Block::ready)
+        {
+            ++(waited ? stats_.waits : stats_.hits);
+            lru_.splice (lru_.begin(), lru_, it->second.lruPosition);
+            return it->second.data;
+        }
+
+        if (it != blocks.end() && it->second.state == Block::decoding)
+        {
+            waited = true;
+            readyCv_.wait (lock);
+            continue;
+        }
+
+        // Not there, or only queued: it is needed now, so decode it here
+        blocks[block].state = Block::decoding;
+        ++stats_.misses;
+
+        lock.unlock();
+        auto data = decode (*reader, block);
+        lock.lock();
+
+        finish (reader, block, data);
+        return data;
+    }
+}
+
+DecodeCache::Data DecodeCache::decode (AudioFileReader& reader, int64_t block)
+{
+    int64_t start = block * blockFrames;
+    int64_t frames = std::min (blockFrames, reader.getLengthInSamples() - start);
+    if (frames <= 0)
+        return nullptr;
+
+    auto channels = static_cast<size_t> (reader.getNumChannels());
+    std::vector<float> samples (static_cast<size_t> (frames) * channels);
+
+    auto got = reader.read (samples.data(), start, frames);
+    if (got <= 0)
+        return nullptr;
+
+    samples.resize (static_cast<size_t> (got) * channels);
+    return std::make_shared<const std::vector<float>> (std::move (samples));
+}
+
+void DecodeCache::workerLoop()
+{
+    for (;;)
+    {
+        std::shared_ptr<AudioFileReader> reader;
+        int64_t block = 0;
+        {
+            std::unique_lock<std::mutex> lock (mutex_);
+            workCv_.wait (lock, [this] { return stopping_ || ! jobs_.empty(); });
+
+            if (stopping_)
+                return;
+
+            auto job = jobs_.front();
+            jobs_.pop_front();
+
+            // Skip files closed, blocks claimed by a reader, or cleared since
+            reader = job.reader.lock();
+            if (reader == nullptr)
+                continue;
+
+            auto source = sources_.find (reader.get());
+            if (source == sources_.end() || source->second.reader.lock() != reader)
+                continue;
+
+            auto it = source->second.blocks.find (job.block);
+            if (it == source->second.blocks.end() || it->second.state != Block::queued)
+                continue;
+
+            it->second.state = Block::decoding;
+            block = job.block;
+        }
+
+        auto data = decode (*reader, block);
+
+        std::lock_guard<std::mutex> lock (mutex_);
+        if (data != nullptr)
+            ++stats_.decodedAhead;
+        finish (reader, block, std::move (data));
+    }
+}
+
+DecodeCache::Source& DecodeCache::sourceFor (const std::shared_ptr<AudioFileReader>& reader)
+{
+    auto it = sources_.find (reader.get());
+    if (it != sources_.end())
+    {
+        if (it->second.reader.lock() == reader)
+            return it->second;
+
+        // A reader freed and another allocated at the same address
+        eraseSource (it);
+    }
+
+    // Drop blocks of files nobody has open any more
+    for (auto s = sources_.begin(); s != sources_.end();)
+    {
+        auto next = std::next (s);
+        if (s->second.reader.expired())
+            eraseSource (s);
+        s = next;
+    }
+
+    auto& source = sources_[reader.get()];
+    source.reader = reader;
+    return source;
+}
+
+void DecodeCache::queueBlocks (const std::shared_ptr<AudioFileReader>& reader, int64_t first, int64_t last)
+{
+    int64_t length = reader->getLengthInSamples();
+    auto& blocks = sourceFor (reader).blocks;
+
+    for (int64_t b = first; b <= last && b * blockFrames < length; ++b)
+    {
+        if (blocks.count (b) != 0)
+            continue;
+
+        blocks[b].state = Block::queued;
+        jobs_.push_back ({ reader, b });
+    }
+}
+
+void DecodeCache::finish (const std::shared_ptr<AudioFileReader>& reader, int64_t block, Data data)
+{
+    readyCv_.notify_all();
+
+    auto source = sources_.find (reader.get());
+    if (source == sources_.end() || source->second.reader.lock() != reader)
+        return;
+
+    auto& blocks = source->second.blocks;
+    auto it = blocks.find (block);
+    if (it == blocks.end() || it->second.state != Block::decoding)
+        return;     // cleared meanwhile
+
+    if (data == nullptr)
+    {
+        blocks.erase (it);
+        return;
+    }
+
+    it->second.state = Block::ready;
+    it->second.data = std::move (data);
+    lru_.emplace_front (reader.get(), block);
+    it->second.lruPosition = lru_.begin();
+    stats_.residentBytes += it->second.data->size() * sizeof (float);
+
+    evictToBudget();
+}
+
+void DecodeCache::eraseSource (std::unordered_map<const AudioFileReader*, Source>::iterator it)
+{
+    for (auto& [index, block] : it->second.blocks)
+    {
+        if (block.state == Block::ready)
+        {
+            stats_.residentBytes -= block.data->size() * sizeof (float);
+            lru_.erase (block.lruPosition);
+        }
+    }
+
+    sources_.erase (it);
+}
+
+void DecodeCache::evictToBudget()
+{
+    while (stats_.residentBytes > memoryBudget_ && ! lru_.empty())
+    {
+        auto [readerPtr, index] = lru_.back();
+        lru_.pop_back();
+
+        auto& blocks = sources_[readerPtr].blocks;
+        auto it = blocks.find (index);
+        stats_.residentBytes -= it->second.data->size() * sizeof (float);
+        blocks.erase (it);
+        ++stats_.evictions;
+    }
+}
+
+void DecodeCache::setReadAheadBlocks (int blocks)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    readAheadBlocks_ = std::max (blocks, 0);
+}
+
+int DecodeCache::getReadAheadBlocks() const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return readAheadBlocks_;
+}
+
+void DecodeCache::setMemoryBudget (size_t bytes)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    memoryBudget_ = bytes;
+    evictToBudget();
+}
+
+size_t DecodeCache::getMemoryBudget() const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return memoryBudget_;
+}
+
+void DecodeCache::clear()
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+
+    while (! sources_.empty())
+        eraseSource (sources_.begin());
+    jobs_.clear();
+
+    readyCv_.notify_all();
+}
+
+DecodeCache::Stats DecodeCache::getStats() const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+
+    auto stats = stats_;
+    stats.numBlocks = static_cast<int> (lru_.size());
+    return stats;
+}
+
+} // namespace dc
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "AudioFileReader.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace dc {
+
+/// Process-wide cache of decoded blocks of compressed audio.
+///
+/// FLAC and Ogg decoding is CPU-bound: a streamer refilling its ring from
+/// such a file would decode on the I/O thread, one ring chunk at a time.
+/// Through this cache a file is decoded in large fixed blocks
+/// (blockFrames), and the blocks after the one being read are decoded
+/// ahead on worker threads of their own, so streamers mostly copy audio
+/// that is already decoded. A seek lands in whatever block covers it;
+/// the codec is only repositioned at block boundaries.
+///
+/// Blocks are keyed by reader, so streamers sharing a handle through
+/// AudioFileReader::openShared() share the decoded audio too. Blocks
+/// beyond the memory budget are evicted least recently used first.
+///
+/// read() may block on decoding and must not be called on the audio thread.
+class DecodeCache
+{
+public:
+    /// @param numThreads  Decode-ahead workers (0 = half the cores, at most 4).
+    explicit DecodeCache (size_t memoryBudgetBytes = defaultMemoryBudgetBytes, int numThreads = 0);
+    ~DecodeCache();
+
+    DecodeCache (const DecodeCache&) = delete;
+    DecodeCache& operator= (const DecodeCache&) = delete;
+
+    /// Process-wide cache used by DiskStreamer.
+    static DecodeCache& getInstance();
+
+    static constexpr int64_t blockFrames = 65536;
+    static constexpr int defaultReadAheadBlocks = 2;
+    static constexpr size_t defaultMemoryBudgetBytes = 128u * 1024u * 1024u;
+
+    /// Read numFrames interleaved frames starting at startFrame. Blocks not
+    /// decoded yet are decoded on the calling thread, or waited for if a
+    /// worker is already on them; the blocks after the range are queued
+    /// for decoding ahead. Returns the number of frames read.
+    int64_t read (const std::shared_ptr<AudioFileReader>& reader, float* buffer,
+                  int64_t startFrame, int64_t numFrames);
+
+    /// Queue the blocks covering [startFrame, startFrame + numFrames) for
+    /// decoding on the worker threads, e.g. ahead of a known seek target.
+    void prefetch (const std::shared_ptr<AudioFileReader>& reader, int64_t startFrame, int64_t numFrames);
+
+    /// Blocks decoded ahead of each read.
+    void setReadAheadBlocks (int blocks);
+    int getReadAheadBlocks() const;
+
+    /// Total bytes the cache keeps resident. Lowering it evicts at once.
+    void setMemoryBudget (size_t bytes);
+    size_t getMemoryBudget() const;
+
+    /// Drop every decoded block.
+    void clear();
+
+    int getNumThreads() const { return static_cast<int> (threads_.size()); }
+
+    struct Stats
+    {
+        int64_t hits = 0;               // block already decoded
+        int64_t misses = 0;             // decoded by the reading thread
+        int64_t waits = 0;              // waited for a worker to finish it
+        int64_t decodedAhead = 0;       // decoded by the workers
+        int64_t evictions = 0;
+        size_t residentBytes = 0;
+        int numBlocks = 0;
+
+        double getHitRate() const
+        {
+            auto total = hits + misses + waits;
+            return total > 0 ? static_cast<double> (hits) / static_cast<double> (total) : 0.0;
+        }
+    };
+
+    Stats getStats() const;
+
+private:
+    using Data = std::shared_ptr<const std::vector<float>>;
+
+    struct Block
+    {
+        enum State { queued, decoding, ready };
+
+        State state = queued;
+        Data data;
+        std::list<std::pair<const AudioFileReader*, int64_t>>::iterator lruPosition;
+    };
+
+    struct Source
+    {
+        std::weak_ptr<AudioFileReader> reader;
+        std::unordered_map<int64_t, Block> blocks;
+    };
+
+    struct Job
+    {
+        std::weak_ptr<AudioFileReader> reader;
+        int64_t block = 0;
+    };
+
+    /// The decoded block, decoding it here if needed; nullptr past the end
+    /// of the file or on a decode error.
+    Data acquire (const std::shared_ptr<AudioFileReader>& reader, int64_t block);
+
+    static Data decode (AudioFileReader& reader, int64_t block);
+
+    void workerLoop();
+
+    // Require mutex_ held
+    Source& sourceFor (const std::shared_ptr<AudioFileReader>& reader);
+    void queueBlocks (const std::shared_ptr<AudioFileReader>& reader, int64_t first, int64_t last);
+    void finish (const std::shared_ptr<AudioFileReader>& reader, int64_t block, Data data);
+    void eraseSource (std::unordered_map<const AudioFileReader*, Source>::iterator it);
+    void evictToBudget();
+
+    mutable std::mutex mutex_;
+    std::condition_variable workCv_;
+    std::condition_variable readyCv_;
+
+    std::unordered_map<const AudioFileReader*, Source> sources_;
+    std::list<std::pair<const AudioFileReader*, int64_t>> lru_;  // ready blocks, most recent first
+    std::deque<Job> jobs_;
+
+    size_t memoryBudget_;
+    int readAheadBlocks_ = defaultReadAheadBlocks;
+    Stats stats_;
+
+    std::vector<std::thread> threads_;
+    bool stopping_ = false;
+};
+
+} // namespace dc
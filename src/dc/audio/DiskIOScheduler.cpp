@@ -0,0 +1,183 @@
+#include "DiskIOScheduler.h"
+#include "DiskStreamer.h"
+#include <algorithm>
+#include <chrono>
+
+namespace dc {
+
+namespace {
+
+// Weight of the newest read in the throughput estimate
+constexpr double kThroughputSmoothing = 0.1;
+
+// Idle poll interval; wake() normally arrives well before this
+constexpr auto kIdlePoll = std::chrono::milliseconds (20);
+
+} // anonymous namespace
+
+DiskIOScheduler::DiskIOScheduler (int numThreads)
+{
+    numThreads = std::max (1, numThreads);
+    threads_.reserve (static_cast<size_t> (numThreads));
+
+    for (int i = 0; i < numThreads; ++i)
+        threads_.emplace_back (&DiskIOScheduler::threadFunc, this);
+}
+
+DiskIOScheduler::~DiskIOScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        running_ = false;
+    }
+    workCv_.notify_all();
+
+    for (auto& t : threads_)
+        if (t.joinable())
+            t.join();
+}
+
+DiskIOScheduler& DiskIOScheduler::getInstance()
+{
+    static DiskIOScheduler instance;
+    return instance;
+}
+
+void DiskIOScheduler::addStreamer (DiskStreamer* streamer)
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        if (std::find (streamers_.begin(), streamers_.end(), streamer) == streamers_.end())
+            streamers_.push_back (streamer);
+
+        utilisation_.store (computeUtilisation(), std::memory_order_relaxed);
+    }
+    workCv_.notify_one();
+}
+
+void DiskIOScheduler::removeStreamer (DiskStreamer* streamer)
+{
+    std::unique_lock<std::mutex> lock (mutex_);
+    idleCv_.wait (lock, [streamer] { return ! streamer->inService_; });
+
+    streamers_.erase (std::remove (streamers_.begin(), streamers_.end(), streamer),
+                      streamers_.end());
+
+    utilisation_.store (computeUtilisation(), std::memory_order_relaxed);
+}
+
+void DiskIOScheduler::wake()
+{
+    workCv_.notify_one();
+}
+
+int DiskIOScheduler::getRecommendedBufferFrames (double sampleRate) const
+{
+    // Queueing delay grows like 1 / (1 - utilisation): as the disk gets
+    // busier each streamer has to wait longer for its turn, so it needs
+    // more audio buffered to ride it out.
+    double rho = std::min (utilisation_.load (std::memory_order_relaxed), 0.95);
+    double seconds = std::clamp (baseBufferSeconds / (1.0 - rho), minBufferSeconds, maxBufferSeconds);
+
+    if (sampleRate <= 0.0)
+        sampleRate = 48000.0;
+
+    return static_cast<int> (seconds * sampleRate);
+}
+
+DiskIOScheduler::Stats DiskIOScheduler::getStats() const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+
+    Stats s;
+    s.numStreamers = static_cast<int> (streamers_.size());
+    s.readsIssued = readsIssued_;
+    s.samplesRead = samplesRead_;
+    s.samplesPerSecond = secondsPerSample_ > 0.0 ? 1.0 / secondsPerSample_ : 0.0;
+    s.utilisation = utilisation_.load (std::memory_order_relaxed);
+    return s;
+}
+
+DiskStreamer* DiskIOScheduler::pickMostUrgent()
+{
+    DiskStreamer* best = nullptr;
+    double bestBuffered = 0.0;
+
+    for (auto* s : streamers_)
+    {
+        if (s->inService_ || ! s->needsService())
+            continue;
+
+        double buffered = s->getSecondsBuffered();
+        if (best == nullptr || buffered < bestBuffered)
+        {
+            best = s;
+            bestBuffered = buffered;
+        }
+    }
+
+    return best;
+}
+
+double DiskIOScheduler::computeUtilisation() const
+{
+    if (secondsPerSample_ <= 0.0)
+        return 0.0;
+
+    double demand = 0.0;
+    for (auto* s : streamers_)
+        demand += s->getDemandSamplesPerSecond();
+
+    return demand * secondsPerSample_ / static_cast<double> (threads_.size());
+}
+
+void DiskIOScheduler::recordRead (int64_t samples, double seconds)
+{
+    ++readsIssued_;
+    samplesRead_ += samples;
+
+    double perSample = seconds / static_cast<double> (samples);
+    secondsPerSample_ = secondsPerSample_ <= 0.0
+        ? perSample
+        : secondsPerSample_ + kThroughputSmoothing * (perSample - secondsPerSample_);
+
+    utilisation_.store (computeUtilisation(), std::memory_order_relaxed);
+}
+
+void DiskIOScheduler::threadFunc()
+{
+    std::vector<float> scratch;
+    std::unique_lock<std::mutex> lock (mutex_);
+
+    while (running_)
+    {
+        auto* streamer = pickMostUrgent();
+        if (streamer == nullptr)
+        {
+            workCv_.wait_for (lock, kIdlePoll);
+            continue;
+        }
+
+        streamer->inService_ = true;
+        lock.unlock();
+
+        auto startTime = std::chrono::steady_clock::now();
+        int64_t samples = streamer->service (scratch);
+        double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - startTime).count();
+
+        lock.lock();
+        streamer->inService_ = false;
+
+        if (samples > 0)
+            recordRead (samples, seconds);
+
+        idleCv_.notify_all();
+
+        // A streamer that wanted service but produced nothing (read error)
+        // must not spin this thread
+        if (samples <= 0)
+            workCv_.wait_for (lock, std::chrono::milliseconds (1));
+    }
+}
+
+} // namespace dc
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dc {
+
+class DiskStreamer;
+
+/// Shared disk I/O service for DiskStreamer playback.
+///
+/// A small fixed pool of I/O threads services every started streamer.
+/// Each time a thread is free it picks the streamer with the least audio
+/// buffered (earliest underrun deadline) and refills it with one large
+/// sequential read. Read timings feed a throughput estimate that is used
+/// to size the rings of newly opened streamers: the busier the disk, the
+/// more audio each streamer buffers.
+class DiskIOScheduler
+{
+public:
+    /// @param numThreads  Number of I/O threads (clamped to at least 1).
+    explicit DiskIOScheduler (int numThreads = defaultNumThreads);
+    ~DiskIOScheduler();
+
+    DiskIOScheduler (const DiskIOScheduler&) = delete;
+    DiskIOScheduler& operator= (const DiskIOScheduler&) = delete;
+
+    /// Process-wide scheduler used by DiskStreamers that are not given one.
+    static DiskIOScheduler& getInstance();
+
+    static constexpr int defaultNumThreads = 2;
+
+    /// Register a streamer for servicing. Called by DiskStreamer::start().
+    void addStreamer (DiskStreamer* streamer);
+
+    /// Unregister a streamer. Blocks until no I/O thread is reading it,
+    /// so the streamer may be closed or destroyed once this returns.
+    void removeStreamer (DiskStreamer* streamer);
+
+    /// Wake an I/O thread (a streamer drained below its low-water mark or
+    /// requested a seek).
+    void wake();
+
+    int getNumThreads() const { return static_cast<int> (threads_.size()); }
+
+    /// Ring size, in frames, for a new streamer at the given sample rate,
+    /// derived from current disk utilisation. Rounded by the caller.
+    int getRecommendedBufferFrames (double sampleRate) const;
+
+    struct Stats
+    {
+        int numStreamers = 0;
+        int64_t readsIssued = 0;
+        int64_t samplesRead = 0;          // frames x channels
+        double samplesPerSecond = 0.0;    // measured disk throughput (0 until measured)
+        double utilisation = 0.0;         // demand / throughput, 0..1+
+    };
+
+    Stats getStats() const;
+
+    static constexpr double minBufferSeconds = 0.5;
+    static constexpr double baseBufferSeconds = 1.0;
+    static constexpr double maxBufferSeconds = 8.0;
+
+private:
+    void threadFunc();
+
+    /// Pick the most urgent streamer that needs a read and is not being
+    /// serviced. Requires mutex_ held.
+    DiskStreamer* pickMostUrgent();
+
+    void recordRead (int64_t samples, double seconds);
+    double computeUtilisation() const;   // requires mutex_ held
+
+    mutable std::mutex mutex_;
+    std::condition_variable workCv_;
+    std::condition_variable idleCv_;
+    std::vector<DiskStreamer*> streamers_;
+    std::vector<std::thread> threads_;
+    bool running_ = true;
+
+    // Throughput estimate (EMA of seconds per decoded sample)
+    double secondsPerSample_ = 0.0;
+    int64_t readsIssued_ = 0;
+    int64_t samplesRead_ = 0;
+    std::atomic<double> utilisation_ { 0.0 };
+};
+
+} // namespace dc
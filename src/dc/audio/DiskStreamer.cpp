@@ -1,5 +1,8 @@
 #include "DiskStreamer.h"
+#include "DecodeCache.h"
+#include "DiskIOScheduler.h"
 #include <algorithm>
+#include <cmath>
 #include <cstring>
 
 namespace dc {
@@ -17,8 +20,10 @@ size_t DiskStreamer::nextPowerOf2 (size_t v)
     return v;
 }
 
-DiskStreamer::DiskStreamer (int bufferSizeInFrames)
-    : requestedBufferSize_ (bufferSizeInFrames)
+DiskStreamer::DiskStreamer (int bufferSizeInFrames, DiskIOScheduler* scheduler)
+    : scheduler_ (scheduler != nullptr ? *scheduler : DiskIOScheduler::getInstance()),
+      requestedDecodeCache_ (&DecodeCache::getInstance()),
+      requestedBufferSize_ (bufferSizeInFrames)
 {
 }
 
@@ -28,19 +33,53 @@ DiskStreamer::~DiskStreamer()
     close();
 }
 
+void DiskStreamer::setOutputSampleRate (double sampleRate, Resampler::Quality quality)
+{
+    outputSampleRate_ = sampleRate;
+    resamplerQuality_ = quality;
+}
+
+void DiskStreamer::setDecodeCache (DecodeCache* cache, bool forAllFormats)
+{
+    requestedDecodeCache_ = cache;
+    decodeAllFormats_ = forAllFormats;
+}
+
 bool DiskStreamer::open (const std::filesystem::path& path)
 {
     stop();
     close();
 
-    reader_ = AudioFileReader::open (path);
+    // Streamers of the same file share one handle
+    reader_ = AudioFileReader::openShared (path);
     if (reader_ == nullptr)
         return false;
 
+    reader_->adviseSequential();
+
+    if (reader_->isCompressed() || decodeAllFormats_)
+        decodeCache_ = requestedDecodeCache_;
+
+    if (outputSampleRate_ > 0.0 && std::abs (outputSampleRate_ - reader_->getSampleRate()) > 1e-6)
+    {
+        resampler_ = std::make_unique<Resampler> (reader_->getNumChannels(), reader_->getSampleRate(),
+                                                  outputSampleRate_, resamplerQuality_);
+        outputLength_ = resampler_->getOutputLength (reader_->getLengthInSamples());
+    }
+
+    int bufferFrames = requestedBufferSize_ > 0
+        ? requestedBufferSize_
+        : scheduler_.getRecommendedBufferFrames (getSampleRate());
+
     numChannels_ = reader_->getNumChannels();
-    ringCapacity_ = nextPowerOf2 (static_cast<size_t> (requestedBufferSize_));
+    ringCapacity_ = nextPowerOf2 (static_cast<size_t> (std::max (bufferFrames, 64)));
     ringMask_ = ringCapacity_ - 1;
 
+    // Refill in large sequential chunks: wait until at least 1/8 of the
+    // ring is free, then read up to half of it in one go.
+    minReadFrames_ = std::max<size_t> (ringCapacity_ / 8, 1);
+    maxReadFrames_ = std::max<size_t> (ringCapacity_ / 2, 1);
+
     ringBuffers_.resize (static_cast<size_t> (numChannels_));
     for (auto& buf : ringBuffers_)
         buf.resize (ringCapacity_, 0.0f);
@@ -48,7 +87,35 @@ bool DiskStreamer::open (const std::filesystem::path& path)
     readPos_.store (0, std::memory_order_relaxed);
     writePos_.store (0, std::memory_order_relaxed);
     diskPosition_.store (0, std::memory_order_relaxed);
-    seekTarget_.store (-1, std::memory_order_relaxed);
+    seekTarget_.store (0, std::memory_order_relaxed);
+    seekRequested_.store (0, std::memory_order_relaxed);
+    seekServed_.store (0, std::memory_order_relaxed);
+    seekStartPos_.store (0, std::memory_order_relaxed);
+    seekConsumed_ = 0;
+
+    if (resampler_ != nullptr)
+    {
+        resampled_.assign (static_cast<size_t> (numChannels_), std::vector<float> (maxReadFrames_));
+        resampledPtrs_.clear();
+        for (auto& ch : resampled_)
+            resampledPtrs_.push_back (ch.data());
+        resetResampler (0);
+
+        prerollResampler_ = std::make_unique<Resampler> (numChannels_, reader_->getSampleRate(),
+                                                         outputSampleRate_, resamplerQuality_);
+    }
+
+    // Pre-roll buffers are allocated by the I/O thread when first filled
+    prerollFrames_ = static_cast<int> (std::ceil (prerollSeconds * getSampleRate()));
+    for (auto& slot : preroll_)
+    {
+        slot.state.store (PrerollSlot::empty, std::memory_order_relaxed);
+        slot.requested.store (-1, std::memory_order_relaxed);
+        slot.position.store (-1, std::memory_order_relaxed);
+        slot.frames.store (0, std::memory_order_relaxed);
+    }
+    activePreroll_ = -1;
+    prerollReadOffset_ = 0;
 
     return true;
 }
@@ -58,6 +125,20 @@ void DiskStreamer::close()
     stop();
 
     reader_.reset();
+    decodeCache_ = nullptr;
+    resampler_.reset();
+    prerollResampler_.reset();
+    for (auto& slot : preroll_)
+    {
+        slot.state.store (PrerollSlot::empty, std::memory_order_relaxed);
+        slot.requested.store (-1, std::memory_order_relaxed);
+        slot.data.clear();
+    }
+    activePreroll_ = -1;
+    prerollFrames_ = 0;
+    resampled_.clear();
+    resampledPtrs_.clear();
+    outputLength_ = 0;
     ringBuffers_.clear();
     numChannels_ = 0;
     ringCapacity_ = 0;
@@ -66,26 +147,96 @@ void DiskStreamer::close()
 
 void DiskStreamer::seek (int64_t positionInSamples)
 {
-    seekTarget_.store (positionInSamples, std::memory_order_release);
+    releasePreroll();
+
+    for (size_t i = 0; i < preroll_.size(); ++i)
+    {
+        auto& slot = preroll_[i];
+        if (slot.state.load (std::memory_order_acquire) != PrerollSlot::ready)
+            continue;
+
+        int64_t start = slot.position.load (std::memory_order_relaxed);
+        if (positionInSamples < start || positionInSamples >= start + slot.frames.load (std::memory_order_relaxed))
+            continue;
+
+        int expected = PrerollSlot::ready;
+        if (! slot.state.compare_exchange_strong (expected, PrerollSlot::inUse, std::memory_order_acq_rel))
+            continue;
+
+        // The slot may have been refilled between the test and the claim
+        start = slot.position.load (std::memory_order_relaxed);
+        int frames = slot.frames.load (std::memory_order_relaxed);
+        if (positionInSamples < start || positionInSamples >= start + frames)
+        {
+            slot.state.store (PrerollSlot::ready, std::memory_order_release);
+            continue;
+        }
+
+        activePreroll_ = static_cast<int> (i);
+        prerollReadOffset_ = static_cast<int> (positionInSamples - start);
+        prerollHits_.fetch_add (1, std::memory_order_relaxed);
 
-    // Wake the background thread to process the seek
-    cv_.notify_one();
+        // Play from memory; the ring picks up where the pre-roll ends
+        positionInSamples = start + frames;
+        break;
+    }
+
+    seekTarget_.store (positionInSamples, std::memory_order_relaxed);
+    seekRequested_.store (seekRequested_.load (std::memory_order_relaxed) + 1, std::memory_order_release);
+
+    // Wake an I/O thread to process the seek
+    if (running_.load (std::memory_order_relaxed))
+        scheduler_.wake();
 }
 
 int DiskStreamer::read (AudioBlock& output, int numSamples)
 {
-    if (reader_ == nullptr || numChannels_ == 0)
+    int outputChannels = output.getNumChannels();
+    int done = 0;
+
+    // Audio after a pre-rolled seek comes from memory first
+    if (activePreroll_ >= 0)
     {
-        output.clear();
-        return 0;
+        auto& slot = preroll_[static_cast<size_t> (activePreroll_)];
+        int frames = slot.frames.load (std::memory_order_relaxed);
+        done = std::min (numSamples, frames - prerollReadOffset_);
+
+        for (int ch = 0; ch < outputChannels; ++ch)
+        {
+            int srcCh = (ch < numChannels_) ? ch : 0;
+            std::memcpy (output.getChannel (ch), slot.data[static_cast<size_t> (srcCh)].data() + prerollReadOffset_,
+                         sizeof (float) * static_cast<size_t> (done));
+        }
+
+        prerollReadOffset_ += done;
+        if (prerollReadOffset_ >= frames)
+            releasePreroll();
+
+        if (done == numSamples)
+            return done;
+    }
+
+    // Until an I/O thread has refilled the ring for a pending seek it
+    // still holds audio from the old position
+    if (reader_ == nullptr || numChannels_ == 0 || isSeekPending())
+    {
+        output.clear (done, numSamples - done);
+        return done;
+    }
+
+    // Skip to where the refill for the latest seek starts
+    uint64_t requested = seekRequested_.load (std::memory_order_relaxed);
+    if (seekConsumed_ != requested)
+    {
+        readPos_.store (seekStartPos_.load (std::memory_order_relaxed), std::memory_order_release);
+        seekConsumed_ = requested;
     }
 
     size_t wp = writePos_.load (std::memory_order_acquire);
     size_t rp = readPos_.load (std::memory_order_relaxed);
     size_t available = wp - rp;
 
-    int framesToRead = std::min (static_cast<int> (available), numSamples);
-    int outputChannels = output.getNumChannels();
+    int framesToRead = std::min (static_cast<int> (available), numSamples - done);
 
     // Copy from ring buffers to output
     for (int f = 0; f < framesToRead; ++f)
@@ -95,24 +246,68 @@ int DiskStreamer::read (AudioBlock& output, int numSamples)
         for (int ch = 0; ch < outputChannels; ++ch)
         {
             int srcCh = (ch < numChannels_) ? ch : 0;
-            output.getChannel (ch)[f] = ringBuffers_[static_cast<size_t> (srcCh)][ringIdx];
+            output.getChannel (ch)[done + f] = ringBuffers_[static_cast<size_t> (srcCh)][ringIdx];
         }
     }
 
     // Fill remainder with silence on underrun
-    if (framesToRead < numSamples)
+    if (done + framesToRead < numSamples)
     {
         for (int ch = 0; ch < outputChannels; ++ch)
-            std::memset (output.getChannel (ch) + framesToRead, 0,
-                         sizeof (float) * static_cast<size_t> (numSamples - framesToRead));
+            std::memset (output.getChannel (ch) + done + framesToRead, 0,
+                         sizeof (float) * static_cast<size_t> (numSamples - done - framesToRead));
+
+        // Only a real underrun if the file still had data to give
+        if (running_.load (std::memory_order_relaxed)
+            && diskPosition_.load (std::memory_order_relaxed) < getLengthInSamples())
+            underrunCount_.fetch_add (1, std::memory_order_relaxed);
     }
 
     readPos_.store (rp + static_cast<size_t> (framesToRead), std::memory_order_release);
 
-    // Wake background thread — buffer space now available
-    cv_.notify_one();
+    // Below half full: ask for a refill (once until serviced)
+    if (available - static_cast<size_t> (framesToRead) < ringCapacity_ / 2
+        && running_.load (std::memory_order_relaxed)
+        && ! wakeRequested_.exchange (true, std::memory_order_relaxed))
+        scheduler_.wake();
+
+    return done + framesToRead;
+}
+
+void DiskStreamer::releasePreroll()
+{
+    if (activePreroll_ < 0)
+        return;
 
-    return framesToRead;
+    preroll_[static_cast<size_t> (activePreroll_)].state.store (PrerollSlot::ready, std::memory_order_release);
+    activePreroll_ = -1;
+}
+
+void DiskStreamer::setPrerollPoints (const std::vector<int64_t>& positions)
+{
+    bool changed = false;
+    for (size_t i = 0; i < preroll_.size(); ++i)
+    {
+        int64_t p = i < positions.size() ? std::max<int64_t> (positions[i], 0) : -1;
+        if (preroll_[i].requested.exchange (p, std::memory_order_release) != p)
+            changed = true;
+    }
+
+    if (changed && running_.load (std::memory_order_relaxed))
+        scheduler_.wake();
+}
+
+int DiskStreamer::getNumPrerollPointsReady() const
+{
+    int n = 0;
+    for (auto& slot : preroll_)
+    {
+        int state = slot.state.load (std::memory_order_acquire);
+        if ((state == PrerollSlot::ready || state == PrerollSlot::inUse)
+            && slot.frames.load (std::memory_order_relaxed) > 0)
+            ++n;
+    }
+    return n;
 }
 
 void DiskStreamer::start()
@@ -124,7 +319,7 @@ void DiskStreamer::start()
     if (! running_.compare_exchange_strong (expected, true))
         return;  // already running
 
-    readThread_ = std::thread (&DiskStreamer::readThreadFunc, this);
+    scheduler_.addStreamer (this);
 }
 
 void DiskStreamer::stop()
@@ -132,24 +327,21 @@ void DiskStreamer::stop()
     if (! running_.exchange (false))
         return;  // wasn't running
 
-    cv_.notify_one();
-
-    if (readThread_.joinable())
-        readThread_.join();
+    scheduler_.removeStreamer (this);
 }
 
 int64_t DiskStreamer::getLengthInSamples() const
 {
     if (reader_ == nullptr)
         return 0;
-    return reader_->getLengthInSamples();
+    return resampler_ != nullptr ? outputLength_ : reader_->getLengthInSamples();
 }
 
 double DiskStreamer::getSampleRate() const
 {
     if (reader_ == nullptr)
         return 0.0;
-    return reader_->getSampleRate();
+    return resampler_ != nullptr ? resampler_->getOutputRate() : reader_->getSampleRate();
 }
 
 int DiskStreamer::getNumChannels() const
@@ -157,85 +349,296 @@ int DiskStreamer::getNumChannels() const
     return numChannels_;
 }
 
-void DiskStreamer::readThreadFunc()
+bool DiskStreamer::needsService() const
+{
+    if (reader_ == nullptr)
+        return false;
+
+    if (isSeekPending() || prerollPending())
+        return true;
+
+    int64_t remaining = getLengthInSamples() - diskPosition_.load (std::memory_order_relaxed);
+    if (remaining <= 0)
+        return false;
+
+    size_t space = ringCapacity_ - getRingFramesUsed();
+
+    // Read when a worthwhile chunk fits, or when the tail of the file does
+    return space >= minReadFrames_ || (space > 0 && static_cast<int64_t> (space) >= remaining);
+}
+
+double DiskStreamer::getSecondsBuffered() const
+{
+    if (isSeekPending())
+        return -1.0;
+
+    double sr = getSampleRate();
+    return sr > 0.0 ? static_cast<double> (getRingFramesUsed()) / sr : 0.0;
+}
+
+size_t DiskStreamer::getRingFramesUsed() const
+{
+    // Positions only grow, so the later of the two is where reading resumes
+    size_t rp = std::max (readPos_.load (std::memory_order_acquire),
+                          seekStartPos_.load (std::memory_order_relaxed));
+    return writePos_.load (std::memory_order_relaxed) - rp;
+}
+
+double DiskStreamer::getDemandSamplesPerSecond() const
 {
-    // Temporary interleaved buffer for AudioFileReader::read()
-    const int chunkSize = 1024;
-    std::vector<float> interleaved (static_cast<size_t> (chunkSize * numChannels_));
+    return reader_ != nullptr ? reader_->getSampleRate() * numChannels_ : 0.0;
+}
 
-    while (running_.load (std::memory_order_relaxed))
+bool DiskStreamer::prerollPending() const
+{
+    for (auto& slot : preroll_)
     {
-        // Handle pending seek
-        int64_t seekPos = seekTarget_.exchange (-1, std::memory_order_acquire);
-        if (seekPos >= 0)
-        {
-            diskPosition_.store (seekPos, std::memory_order_relaxed);
+        int64_t requested = slot.requested.load (std::memory_order_relaxed);
+        int state = slot.state.load (std::memory_order_acquire);
 
-            // Reset ring buffer positions (consumer must not be reading during seek)
-            size_t pos = writePos_.load (std::memory_order_relaxed);
-            readPos_.store (pos, std::memory_order_release);
-        }
+        if (state == PrerollSlot::empty && requested >= 0)
+            return true;
+        if (state == PrerollSlot::ready && slot.position.load (std::memory_order_relaxed) != requested)
+            return true;
+    }
+    return false;
+}
+
+int64_t DiskStreamer::service (std::vector<float>& scratch)
+{
+    int64_t samples = serviceRing (scratch);
+
+    // Pre-roll is background work: only once the ring has been repositioned
+    if (! isSeekPending())
+        samples += servicePreroll (scratch);
+
+    return samples;
+}
 
-        // Calculate available space in ring buffer
-        size_t rp = readPos_.load (std::memory_order_acquire);
-        size_t wp = writePos_.load (std::memory_order_relaxed);
-        size_t used = wp - rp;
-        size_t space = ringCapacity_ - used;
+int64_t DiskStreamer::servicePreroll (std::vector<float>& scratch)
+{
+    for (auto& slot : preroll_)
+    {
+        int64_t requested = slot.requested.load (std::memory_order_acquire);
+        int state = slot.state.load (std::memory_order_acquire);
 
-        if (space == 0)
+        if (state == PrerollSlot::empty)
+        {
+            if (requested < 0)
+                continue;
+            slot.state.store (PrerollSlot::filling, std::memory_order_relaxed);
+        }
+        else if (state == PrerollSlot::ready && slot.position.load (std::memory_order_relaxed) != requested)
+        {
+            // Stale; reclaim it unless the audio thread just claimed it
+            if (! slot.state.compare_exchange_strong (state, PrerollSlot::filling, std::memory_order_acq_rel))
+                continue;
+        }
+        else
         {
-            // Buffer full — wait for consumer to drain
-            std::unique_lock<std::mutex> lock (mutex_);
-            cv_.wait_for (lock, std::chrono::milliseconds (5), [this]
-            {
-                size_t r = readPos_.load (std::memory_order_acquire);
-                size_t w = writePos_.load (std::memory_order_relaxed);
-                return (ringCapacity_ - (w - r)) > 0
-                    || ! running_.load (std::memory_order_relaxed)
-                    || seekTarget_.load (std::memory_order_relaxed) >= 0;
-            });
             continue;
         }
 
-        int64_t diskPos = diskPosition_.load (std::memory_order_relaxed);
-        int64_t fileLength = reader_->getLengthInSamples();
-
-        if (diskPos >= fileLength)
+        if (requested < 0)
         {
-            // Reached end of file — wait for seek or stop
-            std::unique_lock<std::mutex> lock (mutex_);
-            cv_.wait_for (lock, std::chrono::milliseconds (50), [this]
-            {
-                return ! running_.load (std::memory_order_relaxed)
-                    || seekTarget_.load (std::memory_order_relaxed) >= 0;
-            });
+            slot.position.store (-1, std::memory_order_relaxed);
+            slot.frames.store (0, std::memory_order_relaxed);
+            slot.state.store (PrerollSlot::empty, std::memory_order_release);
             continue;
         }
 
-        // Read a chunk from disk
-        int framesToRead = std::min (chunkSize, static_cast<int> (space));
-        framesToRead = static_cast<int> (
-            std::min (static_cast<int64_t> (framesToRead), fileLength - diskPos));
+        // A point past the end is recorded as an empty pre-roll so it isn't retried
+        int frames = static_cast<int> (std::clamp<int64_t> (getLengthInSamples() - requested, 0, prerollFrames_));
+        if (frames > 0)
+            frames = decodeAt (requested, frames, slot.data, scratch);
 
-        int64_t framesRead = reader_->read (interleaved.data(), diskPos, framesToRead);
+        slot.position.store (requested, std::memory_order_relaxed);
+        slot.frames.store (frames, std::memory_order_relaxed);
+        slot.state.store (PrerollSlot::ready, std::memory_order_release);
 
-        if (framesRead <= 0)
-            continue;
+        // One slot per call keeps other streamers' refills prompt
+        return static_cast<int64_t> (frames) * numChannels_;
+    }
 
-        // De-interleave into per-channel ring buffers
-        for (int64_t f = 0; f < framesRead; ++f)
+    return 0;
+}
+
+int DiskStreamer::decodeAt (int64_t position, int frames, std::vector<std::vector<float>>& dest,
+                            std::vector<float>& scratch)
+{
+    dest.resize (static_cast<size_t> (numChannels_));
+    for (auto& ch : dest)
+        ch.resize (static_cast<size_t> (prerollFrames_));
+
+    if (prerollResampler_ == nullptr)
+    {
+        scratch.resize (static_cast<size_t> (frames * numChannels_));
+        auto got = static_cast<int> (std::max<int64_t> (readFile (scratch.data(), position, frames), 0));
+
+        for (int ch = 0; ch < numChannels_; ++ch)
         {
-            size_t ringIdx = (wp + static_cast<size_t> (f)) & ringMask_;
-            for (int ch = 0; ch < numChannels_; ++ch)
-            {
-                ringBuffers_[static_cast<size_t> (ch)][ringIdx] =
-                    interleaved[static_cast<size_t> (f * numChannels_ + ch)];
-            }
+            float* dst = dest[static_cast<size_t> (ch)].data();
+            const float* src = scratch.data() + ch;
+            for (int f = 0; f < got; ++f)
+                dst[f] = src[f * numChannels_];
         }
+        return got;
+    }
+
+    // Same alignment as resetResampler(), on a resampler of its own so the
+    // ring's conversion state is untouched
+    auto& r = *prerollResampler_;
+    double t = static_cast<double> (position) * r.getRatio();
+    double whole = std::floor (t);
+    r.reset (t - whole);
+
+    int64_t filePos = static_cast<int64_t> (whole) - r.getLatency();
+    int inputFrames = r.getInputFramesNeeded (frames);
+    int64_t fileLength = reader_->getLengthInSamples();
+
+    scratch.assign (static_cast<size_t> (inputFrames * numChannels_), 0.0f);
 
-        writePos_.store (wp + static_cast<size_t> (framesRead), std::memory_order_release);
-        diskPosition_.store (diskPos + framesRead, std::memory_order_relaxed);
+    int64_t readStart = std::max<int64_t> (filePos, 0);
+    int64_t readEnd = std::min<int64_t> (filePos + inputFrames, fileLength);
+    if (readEnd > readStart)
+        readFile (scratch.data() + (readStart - filePos) * numChannels_, readStart, readEnd - readStart);
+
+    std::vector<float*> ptrs;
+    for (auto& ch : dest)
+        ptrs.push_back (ch.data());
+
+    return r.processInterleaved (scratch.data(), inputFrames, ptrs.data(), frames);
+}
+
+int64_t DiskStreamer::readFile (float* buffer, int64_t startFrame, int64_t numFrames)
+{
+    return decodeCache_ != nullptr ? decodeCache_->read (reader_, buffer, startFrame, numFrames)
+                                   : reader_->read (buffer, startFrame, numFrames);
+}
+
+int64_t DiskStreamer::serviceRing (std::vector<float>& scratch)
+{
+    wakeRequested_.store (false, std::memory_order_relaxed);
+
+    // A pending seek refills from the current write position; the reader
+    // skips there once the new audio is published below. readPos_ is the
+    // reader's alone, so nothing here moves it.
+    uint64_t seekRequest = seekRequested_.load (std::memory_order_acquire);
+    bool seeking = seekRequest != seekServed_.load (std::memory_order_relaxed);
+    if (seeking)
+    {
+        int64_t seekPos = seekTarget_.load (std::memory_order_relaxed);
+        diskPosition_.store (seekPos, std::memory_order_relaxed);
+        seekStartPos_.store (writePos_.load (std::memory_order_relaxed), std::memory_order_relaxed);
+
+        if (resampler_ != nullptr)
+            resetResampler (seekPos);
     }
+
+    int64_t samples = fillRing (scratch);
+
+    if (seeking)
+        seekServed_.store (seekRequest, std::memory_order_release);
+
+    return samples;
+}
+
+int64_t DiskStreamer::fillRing (std::vector<float>& scratch)
+{
+    size_t wp = writePos_.load (std::memory_order_relaxed);
+    size_t space = ringCapacity_ - getRingFramesUsed();
+
+    int64_t diskPos = diskPosition_.load (std::memory_order_relaxed);
+    int64_t length = getLengthInSamples();
+
+    if (space == 0 || diskPos >= length)
+        return 0;
+
+    int64_t framesToRead = static_cast<int64_t> (std::min (space, maxReadFrames_));
+    framesToRead = std::min (framesToRead, length - diskPos);
+
+    if (resampler_ != nullptr)
+        return serviceResampled (scratch, wp, static_cast<int> (framesToRead));
+
+    scratch.resize (static_cast<size_t> (framesToRead * numChannels_));
+    int64_t framesRead = readFile (scratch.data(), diskPos, framesToRead);
+
+    if (framesRead <= 0)
+        return 0;
+
+    // Let the kernel start on the next chunk while we de-interleave
+    if (decodeCache_ == nullptr)
+        reader_->adviseWillNeed (diskPos + framesRead, static_cast<int64_t> (maxReadFrames_));
+
+    // De-interleave into per-channel ring buffers
+    for (int ch = 0; ch < numChannels_; ++ch)
+    {
+        auto& ring = ringBuffers_[static_cast<size_t> (ch)];
+        const float* src = scratch.data() + ch;
+
+        for (int64_t f = 0; f < framesRead; ++f)
+            ring[(wp + static_cast<size_t> (f)) & ringMask_] = src[f * numChannels_];
+    }
+
+    writePos_.store (wp + static_cast<size_t> (framesRead), std::memory_order_release);
+    diskPosition_.store (diskPos + framesRead, std::memory_order_relaxed);
+
+    return framesRead * numChannels_;
+}
+
+void DiskStreamer::resetResampler (int64_t outputPosition)
+{
+    // Output frame n sits at input time n * ratio; start feeding the file
+    // far enough before that for the filter to be centred on it
+    double t = static_cast<double> (outputPosition) * resampler_->getRatio();
+    double whole = std::floor (t);
+
+    resampler_->reset (t - whole);
+    filePosition_ = static_cast<int64_t> (whole) - resampler_->getLatency();
+}
+
+int64_t DiskStreamer::serviceResampled (std::vector<float>& scratch, size_t wp, int outputFrames)
+{
+    int64_t fileLength = reader_->getLengthInSamples();
+    int inputFrames = resampler_->getInputFramesNeeded (outputFrames);
+
+    scratch.assign (static_cast<size_t> (inputFrames * numChannels_), 0.0f);
+
+    // Only the part of [filePosition_, filePosition_ + inputFrames) inside
+    // the file is read; the lead-in before 0 and the tail past the end
+    // stay zero so the filter flushes cleanly
+    int64_t readStart = std::max<int64_t> (filePosition_, 0);
+    int64_t readEnd = std::min<int64_t> (filePosition_ + inputFrames, fileLength);
+
+    if (readEnd > readStart)
+    {
+        float* dest = scratch.data() + (readStart - filePosition_) * numChannels_;
+        int64_t framesRead = readFile (dest, readStart, readEnd - readStart);
+        if (framesRead <= 0)
+            return 0;
+
+        if (decodeCache_ == nullptr)
+            reader_->adviseWillNeed (readEnd, static_cast<int64_t> (maxReadFrames_));
+    }
+
+    filePosition_ += inputFrames;
+
+    int produced = resampler_->processInterleaved (scratch.data(), inputFrames,
+                                                   resampledPtrs_.data(), outputFrames);
+
+    for (int ch = 0; ch < numChannels_; ++ch)
+    {
+        auto& ring = ringBuffers_[static_cast<size_t> (ch)];
+        const float* src = resampledPtrs_[static_cast<size_t> (ch)];
+
+        for (int f = 0; f < produced; ++f)
+            ring[(wp + static_cast<size_t> (f)) & ringMask_] = src[f];
+    }
+
+    writePos_.store (wp + static_cast<size_t> (produced), std::memory_order_release);
+    diskPosition_.fetch_add (produced, std::memory_order_relaxed);
+
+    return static_cast<int64_t> (inputFrames) * numChannels_;
 }
 
 } // namespace dc
@@ -2,35 +2,64 @@
 
 #include "AudioBlock.h"
 #include "AudioFileReader.h"
+#include "Resampler.h"
+#include <array>
 #include <atomic>
-#include <condition_variable>
 #include <cstdint>
 #include <filesystem>
 #include <memory>
-#include <mutex>
-#include <thread>
 #include <vector>
 
 namespace dc {
 
-/// Background-threaded disk reader for audio playback.
+class DecodeCache;
+class DiskIOScheduler;
+
+/// Disk reader with per-channel ring buffers for audio playback.
+///
+/// Refills are performed by a shared DiskIOScheduler thread pool rather
+/// than a thread per streamer. The audio thread drains the ring buffers via
+/// read(), which is lock-free and safe to call from the real-time thread.
 ///
-/// Reads audio from disk into per-channel ring buffers on a background thread.
-/// The audio thread drains the ring buffers via read(), which is lock-free
-/// and safe to call from the real-time thread.
+/// A few pre-roll points can be kept decoded in memory. A seek that lands
+/// inside one plays from memory straight away while the ring is refilled
+/// from the end of the pre-roll, so jumps to known places (clip starts,
+/// loop start, edit cursor) start without a gap.
 ///
-/// Background disk reader with ring buffer for real-time playback.
+/// Compressed files (FLAC, Ogg) are read through the process-wide
+/// DecodeCache, which decodes them ahead in large blocks on threads of
+/// its own, so the I/O thread copies decoded audio instead of decoding.
 class DiskStreamer
 {
 public:
-    /// @param bufferSizeInFrames  Ring buffer capacity in frames.
-    ///        Rounded up to the next power of 2. Default ~1s at 48kHz.
-    explicit DiskStreamer (int bufferSizeInFrames = 48000);
+    /// Pass as bufferSizeInFrames to size the ring from the scheduler's
+    /// measured disk throughput when the file is opened.
+    static constexpr int autoBufferSize = 0;
+
+    /// @param bufferSizeInFrames  Ring buffer capacity in frames, rounded up
+    ///        to the next power of 2, or autoBufferSize.
+    /// @param scheduler  I/O pool to use (nullptr = DiskIOScheduler::getInstance()).
+    explicit DiskStreamer (int bufferSizeInFrames = autoBufferSize,
+                           DiskIOScheduler* scheduler = nullptr);
     ~DiskStreamer();
 
     DiskStreamer (const DiskStreamer&) = delete;
     DiskStreamer& operator= (const DiskStreamer&) = delete;
 
+    /// Deliver audio at the given rate, converting on the I/O thread when
+    /// the file's rate differs. Takes effect at the next open(). Pass 0 to
+    /// deliver at the file's own rate (the default).
+    void setOutputSampleRate (double sampleRate,
+                              Resampler::Quality quality = Resampler::Quality::standard);
+
+    /// Decode through the given cache instead of DecodeCache::getInstance()
+    /// (nullptr = read the file directly). With forAllFormats, PCM files go
+    /// through the cache as well. Takes effect at the next open().
+    void setDecodeCache (DecodeCache* cache, bool forAllFormats = false);
+
+    /// True when the open file is read through a DecodeCache.
+    bool isDecodingAhead() const { return decodeCache_ != nullptr; }
+
     /// Open an audio file. Allocates ring buffers but does NOT start the
     /// background read thread. Returns false if the file cannot be opened.
     bool open (const std::filesystem::path& path);
@@ -38,31 +67,150 @@ public:
     /// Close the file and release ring buffers.
     void close();
 
-    /// Request a seek to an absolute sample position.
-    /// The background thread will reposition and refill the ring buffer.
+    /// Request a seek to an absolute sample position (at the delivered
+    /// rate). An I/O thread will reposition and refill the ring buffer.
+    /// Audio-thread safe. Positions covered by a decoded pre-roll play from
+    /// memory until the ring has caught up.
     void seek (int64_t positionInSamples);
 
+    /// Keep prerollSeconds of audio after each position (at the delivered
+    /// rate) decoded in memory; at most maxPrerollPoints are used. The I/O
+    /// thread decodes them in the background. Not for the audio thread.
+    void setPrerollPoints (const std::vector<int64_t>& positions);
+
+    static constexpr int maxPrerollPoints = 4;
+    static constexpr double prerollSeconds = 0.25;
+
+    /// Seeks served from a pre-roll point.
+    uint64_t getPrerollHitCount() const { return prerollHits_.load (std::memory_order_relaxed); }
+
+    /// Number of pre-roll points currently decoded and ready.
+    int getNumPrerollPointsReady() const;
+
     /// Read from ring buffers into output. Audio-thread safe (non-blocking).
     /// Returns the number of frames actually read (may be < numSamples on
     /// underrun). Missing frames are filled with silence.
     int read (AudioBlock& output, int numSamples);
 
-    /// Start the background read thread.
+    /// Register with the scheduler so the ring starts filling.
     void start();
 
-    /// Stop the background read thread and join.
+    /// Unregister from the scheduler. Returns once no I/O thread is
+    /// touching this streamer.
     void stop();
 
+    /// Length and rate of the audio read() delivers (the output rate when
+    /// converting, otherwise the file's).
     int64_t getLengthInSamples() const;
     double getSampleRate() const;
     int getNumChannels() const;
 
+    /// True when the file is converted to the output rate on the fly.
+    bool isResampling() const { return resampler_ != nullptr; }
+
+    /// Ring capacity in frames (0 when no file is open)
+    int getBufferSize() const { return static_cast<int> (ringCapacity_); }
+
+    /// Frames in the ring ahead of the reader (0 while a seek is
+    /// pending). Audio-thread safe.
+    int getBufferedFrames() const
+    {
+        if (isSeekPending())
+            return 0;
+
+        size_t rp = seekConsumed_ == seekRequested_.load (std::memory_order_relaxed)
+                        ? readPos_.load (std::memory_order_relaxed)
+                        : seekStartPos_.load (std::memory_order_relaxed);
+        return static_cast<int> (writePos_.load (std::memory_order_acquire) - rp);
+    }
+
+    /// Number of read() calls that came up short while file data remained.
+    uint64_t getUnderrunCount() const { return underrunCount_.load (std::memory_order_relaxed); }
+    void resetUnderrunCount() { underrunCount_.store (0, std::memory_order_relaxed); }
+
 private:
+    friend class DiskIOScheduler;
+
     static size_t nextPowerOf2 (size_t v);
 
-    void readThreadFunc();
+    // --- Called by DiskIOScheduler on an I/O thread ---
+
+    /// True if a seek is pending or enough ring space is free for a
+    /// worthwhile read.
+    bool needsService() const;
+
+    /// Audio buffered ahead of the reader, in seconds. Lower = more urgent.
+    /// Pending seeks report -1.
+    double getSecondsBuffered() const;
+
+    /// Decoded samples per second this streamer consumes while playing.
+    double getDemandSamplesPerSecond() const;
 
-    std::unique_ptr<AudioFileReader> reader_;
+    /// Refill the ring, then decode one pending pre-roll point.
+    /// Returns the number of samples (frames x channels) read.
+    int64_t service (std::vector<float>& scratch);
+
+    /// Handle a pending seek and perform one sequential read into the ring.
+    int64_t serviceRing (std::vector<float>& scratch);
+
+    /// One sequential read into the free part of the ring.
+    int64_t fillRing (std::vector<float>& scratch);
+
+    /// Position the resampler so the next output frame is outputPosition.
+    void resetResampler (int64_t outputPosition);
+
+    /// service() path when converting: read what the resampler needs for
+    /// outputFrames frames and write its output to the ring at wp.
+    int64_t serviceResampled (std::vector<float>& scratch, size_t wp, int outputFrames);
+
+    struct PrerollSlot
+    {
+        // empty/filling: owned by the I/O thread; ready: readable by
+        // anyone; inUse: being played by the audio thread
+        enum State { empty, filling, ready, inUse };
+
+        std::atomic<int> state { empty };
+        std::atomic<int64_t> requested { -1 };
+        std::atomic<int64_t> position { -1 };
+        std::atomic<int> frames { 0 };
+        std::vector<std::vector<float>> data;
+    };
+
+    /// Decode one pre-roll slot whose requested position changed.
+    /// Returns the number of samples read (0 if nothing was pending).
+    int64_t servicePreroll (std::vector<float>& scratch);
+
+    /// Decode frames output frames at position into dest (per channel).
+    /// Returns the frames decoded.
+    int decodeAt (int64_t position, int frames, std::vector<std::vector<float>>& dest,
+                  std::vector<float>& scratch);
+
+    bool prerollPending() const;
+
+    /// True until an I/O thread has published the ring for the latest seek.
+    bool isSeekPending() const
+    {
+        return seekServed_.load (std::memory_order_acquire) != seekRequested_.load (std::memory_order_acquire);
+    }
+
+    /// Ring frames in use as the I/O thread sees them: after a seek the
+    /// reader jumps to seekStartPos_, so nothing before it is kept.
+    size_t getRingFramesUsed() const;
+
+    /// Interleaved frames from the file, through the decode cache if used.
+    int64_t readFile (float* buffer, int64_t startFrame, int64_t numFrames);
+
+    /// Stop playing from the active pre-roll slot (audio thread).
+    void releasePreroll();
+
+    DiskIOScheduler& scheduler_;
+
+    std::shared_ptr<AudioFileReader> reader_;
+
+    // Decode-ahead for compressed files (set at open)
+    DecodeCache* requestedDecodeCache_;
+    bool decodeAllFormats_ = false;
+    DecodeCache* decodeCache_ = nullptr;
 
     // Per-channel ring buffers
     int numChannels_ = 0;
@@ -70,21 +218,48 @@ private:
     size_t ringMask_ = 0;      // ringCapacity_ - 1
     std::vector<std::vector<float>> ringBuffers_;
 
-    // Ring buffer positions (frame-based, monotonically increasing)
+    // Ring buffer positions (frame-based, monotonically increasing).
+    // readPos_ is written only by the reader, writePos_ only by the I/O thread.
     std::atomic<size_t> readPos_ { 0 };
     std::atomic<size_t> writePos_ { 0 };
 
-    // Seek support
-    std::atomic<int64_t> seekTarget_ { -1 };
+    // Seek handoff. The reader bumps seekRequested_ after storing the
+    // target. The I/O thread refills from writePos_ and then publishes that
+    // start with seekServed_; the reader moves its own readPos_ there.
+    std::atomic<int64_t> seekTarget_ { 0 };
+    std::atomic<uint64_t> seekRequested_ { 0 };
+    std::atomic<uint64_t> seekServed_ { 0 };
+    std::atomic<size_t> seekStartPos_ { 0 };
+    uint64_t seekConsumed_ = 0;    // reader only: last seek readPos_ was moved for
 
-    // Current file read position
+    // Frames delivered into the ring so far (at the delivered rate)
     std::atomic<int64_t> diskPosition_ { 0 };
 
-    // Background thread
-    std::thread readThread_;
+    // Sample-rate conversion (I/O thread only after open)
+    double outputSampleRate_ = 0.0;
+    Resampler::Quality resamplerQuality_ = Resampler::Quality::standard;
+    std::unique_ptr<Resampler> resampler_;
+    int64_t outputLength_ = 0;
+    int64_t filePosition_ = 0;     // next file frame to feed; negative = lead-in zeros
+    std::vector<std::vector<float>> resampled_;
+    std::vector<float*> resampledPtrs_;
+
+    // Pre-roll (slots filled on the I/O thread, played on the audio thread)
+    std::array<PrerollSlot, maxPrerollPoints> preroll_;
+    int prerollFrames_ = 0;
+    std::unique_ptr<Resampler> prerollResampler_;
+    int activePreroll_ = -1;       // audio thread only
+    int prerollReadOffset_ = 0;    // audio thread only
+    std::atomic<uint64_t> prerollHits_ { 0 };
+
+    // Scheduling state
     std::atomic<bool> running_ { false };
-    std::mutex mutex_;
-    std::condition_variable cv_;
+    std::atomic<bool> wakeRequested_ { false };
+    bool inService_ = false;   // guarded by the scheduler's mutex
+    size_t minReadFrames_ = 0;
+    size_t maxReadFrames_ = 0;
+
+    std::atomic<uint64_t> underrunCount_ { 0 };
 
     int requestedBufferSize_;
 };
@@ -0,0 +1,122 @@
+#include "LivePeaks.h"
+#include <algorithm>
+
+namespace dc {
+
+LivePeaks::LivePeaks (int numChannels, double sampleRate)
+    : numChannels_ (std::max (numChannels, 1)),
+      sampleRate_ (sampleRate),
+      series_ (new Series[static_cast<size_t> (PeakFile::numLevels * numChannels_)]),
+      accumulator_ (numChannels_, [this] (int level, int channel, int64_t bucket, PeakFile::MinMax minMax, float rms)
+      {
+          append (level, channel, bucket, minMax, rms);
+      })
+{
+}
+
+LivePeaks::~LivePeaks() = default;
+
+LivePeaks::Series* LivePeaks::series (int level, int channel) const
+{
+    if (level < 0 || level >= PeakFile::numLevels || channel < 0 || channel >= numChannels_)
+        return nullptr;
+
+    return &series_[static_cast<size_t> (level * numChannels_ + channel)];
+}
+
+void LivePeaks::add (const float* interleaved, int64_t frames)
+{
+    if (frames <= 0 || isComplete())
+        return;
+
+    accumulator_.add (interleaved, frames);
+    framesDone_.store (accumulator_.getFramesAdded(), std::memory_order_release);
+}
+
+void LivePeaks::finish()
+{
+    if (isComplete())
+        return;
+
+    accumulator_.finish();
+    complete_.store (true, std::memory_order_release);
+}
+
+void LivePeaks::append (int level, int channel, int64_t bucket, PeakFile::MinMax minMax, float rms)
+{
+    auto* s = series (level, channel);
+    if (s == nullptr)
+        return;
+
+    if (bucket >= s->capacity)
+    {
+        // Double into fresh arrays; readers may still be using the old ones
+        auto capacity = std::max (initialCapacity, s->capacity * 2);
+        auto count = s->count.load (std::memory_order_relaxed);
+
+        std::unique_ptr<PeakFile::MinMax[]> minMaxArray (new PeakFile::MinMax[static_cast<size_t> (capacity)]);
+        std::unique_ptr<float[]> rmsArray (new float[static_cast<size_t> (capacity)]);
+
+        if (count > 0)
+        {
+            std::copy (s->minMaxArrays.back().get(), s->minMaxArrays.back().get() + count, minMaxArray.get());
+            std::copy (s->rmsArrays.back().get(), s->rmsArrays.back().get() + count, rmsArray.get());
+        }
+
+        s->minMax.store (minMaxArray.get(), std::memory_order_release);
+        s->rms.store (rmsArray.get(), std::memory_order_release);
+        s->minMaxArrays.push_back (std::move (minMaxArray));
+        s->rmsArrays.push_back (std::move (rmsArray));
+        s->capacity = capacity;
+    }
+
+    s->minMaxArrays.back()[static_cast<size_t> (bucket)] = minMax;
+    s->rmsArrays.back()[static_cast<size_t> (bucket)] = rms;
+    s->count.store (bucket + 1, std::memory_order_release);
+}
+
+int64_t LivePeaks::getNumBucketsReady (int level, int channel) const
+{
+    auto* s = series (level, channel);
+    return s != nullptr ? s->count.load (std::memory_order_acquire) : 0;
+}
+
+const PeakFile::MinMax* LivePeaks::getMinMax (int level, int channel) const
+{
+    auto* s = series (level, channel);
+    return s != nullptr ? s->minMax.load (std::memory_order_acquire) : nullptr;
+}
+
+const float* LivePeaks::getRms (int level, int channel) const
+{
+    auto* s = series (level, channel);
+    return s != nullptr ? s->rms.load (std::memory_order_acquire) : nullptr;
+}
+
+std::shared_ptr<PeakFile> LivePeaks::writePeakFile (const std::filesystem::path& peakFile,
+                                                    const PeakFile::SourceStamp& source) const
+{
+    if (! isComplete())
+        return nullptr;
+
+    auto file = PeakFile::create (peakFile, source, numChannels_, sampleRate_, getFramesDone());
+    if (file == nullptr)
+        return nullptr;
+
+    for (int level = 0; level < PeakFile::numLevels; ++level)
+    {
+        for (int ch = 0; ch < numChannels_; ++ch)
+        {
+            const auto* minMax = getMinMax (level, ch);
+            const auto* rms = getRms (level, ch);
+            auto n = std::min (getNumBucketsReady (level, ch), file->getNumBuckets (level));
+
+            for (int64_t b = 0; b < n; ++b)
+                file->store (level, ch, b, minMax[b], rms[b]);
+        }
+    }
+
+    return file->finish() ? file : nullptr;
+}
+
+} // namespace dc
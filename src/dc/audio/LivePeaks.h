@@ -0,0 +1,89 @@
+#pragma once
+
+#include "PeakFile.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace dc {
+
+/// Waveform peaks of audio that is still being recorded.
+///
+/// The same pyramid as a PeakFile, but in memory and growing: the thread
+/// writing the take appends audio with add(), and any other thread can
+/// draw the buckets finished so far. Bucket arrays grow by doubling, so
+/// appending is amortised O(1); superseded arrays are kept until the
+/// LivePeaks is destroyed, so a pointer a reader got from getMinMax()
+/// stays valid for the buckets that were ready when it got it.
+///
+/// When the take ends, finish() completes the partial buckets and
+/// writePeakFile() stores the result without reading the audio again.
+class LivePeaks
+{
+public:
+    LivePeaks (int numChannels, double sampleRate);
+    ~LivePeaks();
+
+    LivePeaks (const LivePeaks&) = delete;
+    LivePeaks& operator= (const LivePeaks&) = delete;
+
+    int getNumChannels() const { return numChannels_; }
+    double getSampleRate() const { return sampleRate_; }
+
+    // --- Writer (one thread) ---
+
+    /// Append frames of interleaved audio.
+    void add (const float* interleaved, int64_t frames);
+
+    /// Emit the partial buckets at the end of the take.
+    void finish();
+
+    /// Store the finished peaks as a complete peak file of the recorded
+    /// file (see PeakFile::create()). nullptr on failure or before finish().
+    std::shared_ptr<PeakFile> writePeakFile (const std::filesystem::path& peakFile,
+                                             const PeakFile::SourceStamp& source) const;
+
+    // --- Readers (any thread) ---
+
+    /// Frames appended so far.
+    int64_t getFramesDone() const { return framesDone_.load (std::memory_order_acquire); }
+    bool isComplete() const { return complete_.load (std::memory_order_acquire); }
+
+    /// Buckets of a level holding final values.
+    int64_t getNumBucketsReady (int level, int channel = 0) const;
+
+    /// Bucket arrays of one channel at one level, getNumBucketsReady() long.
+    const PeakFile::MinMax* getMinMax (int level, int channel) const;
+    const float* getRms (int level, int channel) const;
+
+private:
+    struct Series
+    {
+        std::atomic<PeakFile::MinMax*> minMax { nullptr };
+        std::atomic<float*> rms { nullptr };
+        std::atomic<int64_t> count { 0 };
+        int64_t capacity = 0;
+
+        // Every array ever allocated, current last
+        std::vector<std::unique_ptr<PeakFile::MinMax[]>> minMaxArrays;
+        std::vector<std::unique_ptr<float[]>> rmsArrays;
+    };
+
+    static constexpr int64_t initialCapacity = 256;
+
+    Series* series (int level, int channel) const;
+    void append (int level, int channel, int64_t bucket, PeakFile::MinMax minMax, float rms);
+
+    int numChannels_;
+    double sampleRate_;
+    std::unique_ptr<Series[]> series_;
+    PeakAccumulator accumulator_;
+
+    std::atomic<int64_t> framesDone_ { 0 };
+    std::atomic<bool> complete_ { false };
+};
+
+} // namespace dc
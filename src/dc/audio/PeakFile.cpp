@@ -0,0 +1,395 @@
+#include "PeakFile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dc {
+
+namespace {
+
+constexpr char magic[4] = { 'D', 'C', 'P', 'K' };
+constexpr uint32_t formatVersion = 1;
+
+uint64_t alignUp (uint64_t n, uint64_t alignment)
+{
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+/// On-disk header, native byte order: peak files are a local cache and
+/// are rebuilt rather than moved between machines.
+struct PeakFile::Header
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t numChannels;
+    uint32_t numLevels;
+    double sampleRate;
+    int64_t lengthInFrames;
+    uint64_t sourceSize;
+    int64_t sourceModified;
+    uint32_t complete;
+    uint32_t reserved;
+    Level levels[PeakFile::numLevels];
+};
+
+PeakFile::SourceStamp PeakFile::SourceStamp::of (const std::filesystem::path& file)
+{
+    std::error_code ec;
+    SourceStamp stamp;
+
+    auto size = std::filesystem::file_size (file, ec);
+    if (ec)
+        return stamp;
+
+    auto modified = std::filesystem::last_write_time (file, ec);
+    if (ec)
+        return stamp;
+
+    stamp.size = size;
+    stamp.modified = static_cast<int64_t> (modified.time_since_epoch().count());
+    return stamp;
+}
+
+PeakFile::~PeakFile()
+{
+    if (base_ != nullptr)
+        munmap (base_, mapLength_);
+
+    // A build that never finished leaves nothing behind
+    if (! buildPath_.empty() && ! isComplete())
+    {
+        std::error_code ec;
+        std::filesystem::remove (buildPath_, ec);
+    }
+}
+
+std::array<PeakFile::Level, PeakFile::numLevels> PeakFile::layout (int numChannels, int64_t lengthInFrames,
+                                                                     uint64_t& totalBytes)
+{
+    std::array<Level, numLevels> levels {};
+    uint64_t offset = alignUp (sizeof (Header), 64);
+
+    for (int level = 0; level < numLevels; ++level)
+    {
+        auto spb = samplesPerBucket (level);
+        auto& l = levels[static_cast<size_t> (level)];
+
+        l.offset = offset;
+        l.numBuckets = (lengthInFrames + spb - 1) / spb;
+
+        auto channelBytes = static_cast<uint64_t> (l.numBuckets) * (sizeof (MinMax) + sizeof (float));
+        offset = alignUp (offset + channelBytes * static_cast<uint64_t> (numChannels), 64);
+    }
+
+    totalBytes = offset;
+    return levels;
+}
+
+std::shared_ptr<PeakFile> PeakFile::create (const std::filesystem::path& peakFile, const SourceStamp& source,
+                                            int numChannels, double sampleRate, int64_t lengthInFrames)
+{
+    if (numChannels <= 0 || lengthInFrames < 0)
+        return nullptr;
+
+    std::error_code ec;
+    std::filesystem::create_directories (peakFile.parent_path(), ec);
+
+    std::shared_ptr<PeakFile> peaks (new PeakFile());
+    peaks->path_ = peakFile;
+    peaks->buildPath_ = peakFile;
+    peaks->buildPath_ += ".tmp";
+    peaks->source_ = source;
+    peaks->numChannels_ = numChannels;
+    peaks->sampleRate_ = sampleRate;
+    peaks->lengthInFrames_ = lengthInFrames;
+
+    uint64_t totalBytes = 0;
+    peaks->levels_ = layout (numChannels, lengthInFrames, totalBytes);
+
+    int fd = ::open (peaks->buildPath_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return nullptr;
+
+    if (ftruncate (fd, static_cast<off_t> (totalBytes)) != 0)
+    {
+        ::close (fd);
+        std::filesystem::remove (peaks->buildPath_, ec);
+        return nullptr;
+    }
+
+    void* mapped = mmap (nullptr, static_cast<size_t> (totalBytes), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close (fd);
+
+    if (mapped == MAP_FAILED)
+    {
+        std::filesystem::remove (peaks->buildPath_, ec);
+        return nullptr;
+    }
+
+    peaks->base_ = static_cast<uint8_t*> (mapped);
+    peaks->mapLength_ = static_cast<size_t> (totalBytes);
+
+    auto* header = reinterpret_cast<Header*> (peaks->base_);
+    std::memcpy (header->magic, magic, sizeof (magic));
+    header->version = formatVersion;
+    header->numChannels = static_cast<uint32_t> (numChannels);
+    header->numLevels = numLevels;
+    header->sampleRate = sampleRate;
+    header->lengthInFrames = lengthInFrames;
+    header->sourceSize = source.size;
+    header->sourceModified = source.modified;
+    header->complete = 0;
+    std::copy (peaks->levels_.begin(), peaks->levels_.end(), header->levels);
+
+    return peaks;
+}
+
+std::shared_ptr<PeakFile> PeakFile::open (const std::filesystem::path& peakFile, const SourceStamp& source)
+{
+    int fd = ::open (peakFile.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat st {};
+    if (fstat (fd, &st) != 0 || static_cast<size_t> (st.st_size) < sizeof (Header))
+    {
+        ::close (fd);
+        return nullptr;
+    }
+
+    auto length = static_cast<size_t> (st.st_size);
+    void* mapped = mmap (nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close (fd);
+
+    if (mapped == MAP_FAILED)
+        return nullptr;
+
+    std::shared_ptr<PeakFile> peaks (new PeakFile());
+    peaks->base_ = static_cast<uint8_t*> (mapped);
+    peaks->mapLength_ = length;
+
+    const auto* header = reinterpret_cast<const Header*> (peaks->base_);
+    if (std::memcmp (header->magic, magic, sizeof (magic)) != 0
+        || header->version != formatVersion
+        || header->numLevels != numLevels
+        || header->complete == 0
+        || header->numChannels == 0
+        || header->lengthInFrames < 0
+        || header->sourceSize != source.size
+        || header->sourceModified != source.modified)
+        return nullptr;
+
+    uint64_t totalBytes = 0;
+    auto levels = layout (static_cast<int> (header->numChannels), header->lengthInFrames, totalBytes);
+
+    if (totalBytes > length)
+        return nullptr;
+
+    for (int level = 0; level < numLevels; ++level)
+    {
+        const auto& expected = levels[static_cast<size_t> (level)];
+        if (header->levels[level].offset != expected.offset || header->levels[level].numBuckets != expected.numBuckets)
+            return nullptr;
+    }
+
+    peaks->path_ = peakFile;
+    peaks->source_ = source;
+    peaks->numChannels_ = static_cast<int> (header->numChannels);
+    peaks->sampleRate_ = header->sampleRate;
+    peaks->lengthInFrames_ = header->lengthInFrames;
+    peaks->levels_ = levels;
+    peaks->framesDone_.store (header->lengthInFrames);
+    peaks->complete_.store (true);
+
+    return peaks;
+}
+
+int64_t PeakFile::getNumBuckets (int level) const
+{
+    if (level < 0 || level >= numLevels)
+        return 0;
+
+    return levels_[static_cast<size_t> (level)].numBuckets;
+}
+
+int64_t PeakFile::getNumBucketsReady (int level) const
+{
+    if (isComplete())
+        return getNumBuckets (level);
+
+    if (level < 0 || level >= numLevels)
+        return 0;
+
+    return std::min (getFramesDone() / samplesPerBucket (level), getNumBuckets (level));
+}
+
+uint8_t* PeakFile::channelBase (int level, int channel) const
+{
+    const auto& l = levels_[static_cast<size_t> (level)];
+    auto channelBytes = static_cast<uint64_t> (l.numBuckets) * (sizeof (MinMax) + sizeof (float));
+    return base_ + l.offset + channelBytes * static_cast<uint64_t> (channel);
+}
+
+const PeakFile::MinMax* PeakFile::getMinMax (int level, int channel) const
+{
+    if (level < 0 || level >= numLevels || channel < 0 || channel >= numChannels_)
+        return nullptr;
+
+    return reinterpret_cast<const MinMax*> (channelBase (level, channel));
+}
+
+const float* PeakFile::getRms (int level, int channel) const
+{
+    if (level < 0 || level >= numLevels || channel < 0 || channel >= numChannels_)
+        return nullptr;
+
+    auto numBuckets = static_cast<size_t> (getNumBuckets (level));
+    return reinterpret_cast<const float*> (channelBase (level, channel) + numBuckets * sizeof (MinMax));
+}
+
+int PeakFile::levelFor (double samplesPerPixel)
+{
+    for (int level = numLevels - 1; level > 0; --level)
+        if (static_cast<double> (samplesPerBucket (level)) <= samplesPerPixel)
+            return level;
+
+    return 0;
+}
+
+void PeakFile::store (int level, int channel, int64_t bucket, MinMax minMax, float rms)
+{
+    if (level < 0 || level >= numLevels || channel < 0 || channel >= numChannels_
+        || bucket < 0 || bucket >= getNumBuckets (level))
+        return;
+
+    auto* base = channelBase (level, channel);
+    reinterpret_cast<MinMax*> (base)[bucket] = minMax;
+    reinterpret_cast<float*> (base + static_cast<size_t> (getNumBuckets (level)) * sizeof (MinMax))[bucket] = rms;
+}
+
+void PeakFile::setFramesDone (int64_t frames)
+{
+    framesDone_.store (std::min (frames, lengthInFrames_), std::memory_order_release);
+}
+
+bool PeakFile::finish()
+{
+    if (base_ == nullptr || buildPath_.empty() || isComplete())
+        return false;
+
+    reinterpret_cast<Header*> (base_)->complete = 1;
+
+    if (msync (base_, mapLength_, MS_SYNC) != 0)
+        return false;
+
+    std::error_code ec;
+    std::filesystem::rename (buildPath_, path_, ec);
+    if (ec)
+        return false;
+
+    framesDone_.store (lengthInFrames_, std::memory_order_release);
+    complete_.store (true, std::memory_order_release);
+    return true;
+}
+
+//==============================================================================
+
+PeakAccumulator::PeakAccumulator (int numChannels, Sink sink)
+    : numChannels_ (std::max (numChannels, 1)),
+      sink_ (std::move (sink)),
+      buckets_ (static_cast<size_t> (PeakFile::numLevels * numChannels_))
+{
+}
+
+void PeakAccumulator::add (const float* interleaved, int64_t frames)
+{
+    for (int64_t f = 0; f < frames; ++f)
+        for (int ch = 0; ch < numChannels_; ++ch)
+            addSample (ch, interleaved[f * numChannels_ + ch]);
+
+    framesAdded_ += std::max<int64_t> (frames, 0);
+}
+
+void PeakAccumulator::add (const float* const* channels, int frames)
+{
+    for (int ch = 0; ch < numChannels_; ++ch)
+        for (int f = 0; f < frames; ++f)
+            addSample (ch, channels[ch][f]);
+
+    framesAdded_ += std::max (frames, 0);
+}
+
+void PeakAccumulator::addSample (int channel, float v)
+{
+    auto& b = bucket (0, channel);
+
+    if (b.inputs == 0)
+    {
+        b.min = v;
+        b.max = v;
+    }
+    else
+    {
+        b.min = std::min (b.min, v);
+        b.max = std::max (b.max, v);
+    }
+
+    b.sumSquares += static_cast<double> (v) * static_cast<double> (v);
+    ++b.samples;
+
+    if (++b.inputs == PeakFile::baseSamplesPerBucket)
+        emit (0, channel);
+}
+
+void PeakAccumulator::emit (int level, int channel)
+{
+    auto& b = bucket (level, channel);
+
+    auto rms = static_cast<float> (std::sqrt (b.sumSquares / static_cast<double> (std::max<int64_t> (b.samples, 1))));
+    sink_ (level, channel, b.index, { b.min, b.max }, rms);
+
+    if (level + 1 < PeakFile::numLevels)
+    {
+        auto& parent = bucket (level + 1, channel);
+
+        if (parent.inputs == 0)
+        {
+            parent.min = b.min;
+            parent.max = b.max;
+        }
+        else
+        {
+            parent.min = std::min (parent.min, b.min);
+            parent.max = std::max (parent.max, b.max);
+        }
+
+        parent.sumSquares += b.sumSquares;
+        parent.samples += b.samples;
+
+        if (++parent.inputs == PeakFile::levelFactor)
+            emit (level + 1, channel);
+    }
+
+    ++b.index;
+    b.inputs = 0;
+    b.samples = 0;
+    b.sumSquares = 0.0;
+}
+
+void PeakAccumulator::finish()
+{
+    // Ascending, so each partial bucket reaches its parent before it is flushed
+    for (int level = 0; level < PeakFile::numLevels; ++level)
+        for (int ch = 0; ch < numChannels_; ++ch)
+            if (bucket (level, ch).inputs > 0)
+                emit (level, ch);
+}
+
+} // namespace dc
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace dc {
+
+/// Waveform peaks of an audio file: per-channel min/max/RMS at a pyramid
+/// of resolutions, stored on disk and mmap-ed.
+///
+/// Level 0 summarises baseSamplesPerBucket frames per bucket; each level
+/// above summarises levelFactor buckets of the one below. A file is
+/// created at its final size and filled front to back while the source
+/// is scanned, so a PeakFile that is still being built can already be
+/// displayed up to getFramesDone().
+///
+/// The header records the source's size and modification time; a peak
+/// file whose source has changed since is not opened.
+class PeakFile
+{
+public:
+    struct MinMax
+    {
+        float min = 0.0f;
+        float max = 0.0f;
+    };
+
+    /// What a peak file was built from.
+    struct SourceStamp
+    {
+        uint64_t size = 0;
+        int64_t modified = 0;   // file_time_type ticks
+
+        bool operator== (const SourceStamp& o) const { return size == o.size && modified == o.modified; }
+
+        /// Stamp of a file on disk; size 0 and modified 0 if it can't be read.
+        static SourceStamp of (const std::filesystem::path& file);
+    };
+
+    static constexpr int numLevels = 8;
+    static constexpr int64_t baseSamplesPerBucket = 256;
+    static constexpr int64_t levelFactor = 4;
+
+    static constexpr int64_t samplesPerBucket (int level)
+    {
+        int64_t spb = baseSamplesPerBucket;
+        for (int i = 0; i < level; ++i)
+            spb *= levelFactor;
+        return spb;
+    }
+
+    ~PeakFile();
+
+    PeakFile (const PeakFile&) = delete;
+    PeakFile& operator= (const PeakFile&) = delete;
+
+    /// Map a complete peak file built from source. nullptr if it is
+    /// missing, damaged or stale.
+    static std::shared_ptr<PeakFile> open (const std::filesystem::path& peakFile, const SourceStamp& source);
+
+    /// Create a peak file at its final size, ready to be filled with
+    /// store(). It is written under a temporary name and appears at
+    /// peakFile when finish() succeeds. nullptr on failure.
+    static std::shared_ptr<PeakFile> create (const std::filesystem::path& peakFile, const SourceStamp& source,
+                                             int numChannels, double sampleRate, int64_t lengthInFrames);
+
+    int getNumChannels() const { return numChannels_; }
+    double getSampleRate() const { return sampleRate_; }
+    int64_t getLengthInFrames() const { return lengthInFrames_; }
+    const SourceStamp& getSource() const { return source_; }
+    const std::filesystem::path& getPath() const { return path_; }
+
+    /// Buckets at level once the file is complete.
+    int64_t getNumBuckets (int level) const;
+
+    /// Buckets at level holding final values (all of them when complete).
+    int64_t getNumBucketsReady (int level) const;
+
+    /// Bucket arrays of one channel at one level (getNumBuckets() long).
+    const MinMax* getMinMax (int level, int channel) const;
+    const float* getRms (int level, int channel) const;
+
+    /// Source frames summarised so far.
+    int64_t getFramesDone() const { return framesDone_.load (std::memory_order_acquire); }
+    bool isComplete() const { return complete_.load (std::memory_order_acquire); }
+
+    /// Highest level whose buckets are no wider than samplesPerPixel.
+    static int levelFor (double samplesPerPixel);
+
+    // --- Building (the thread that created the file) ---
+
+    void store (int level, int channel, int64_t bucket, MinMax minMax, float rms);
+
+    /// Publish buckets covering the first frames source frames.
+    void setFramesDone (int64_t frames);
+
+    /// Mark complete, flush and move into place. Returns false on failure.
+    bool finish();
+
+private:
+    PeakFile() = default;
+
+    struct Header;
+    struct Level
+    {
+        uint64_t offset = 0;
+        int64_t numBuckets = 0;
+    };
+
+    static std::array<Level, numLevels> layout (int numChannels, int64_t lengthInFrames, uint64_t& totalBytes);
+
+    uint8_t* channelBase (int level, int channel) const;
+
+    std::filesystem::path path_;
+    std::filesystem::path buildPath_;   // temporary name while building
+    SourceStamp source_;
+    int numChannels_ = 0;
+    double sampleRate_ = 0.0;
+    int64_t lengthInFrames_ = 0;
+    std::array<Level, numLevels> levels_ {};
+
+    uint8_t* base_ = nullptr;
+    size_t mapLength_ = 0;
+
+    std::atomic<int64_t> framesDone_ { 0 };
+    std::atomic<bool> complete_ { false };
+};
+
+/// Computes a peak pyramid incrementally from interleaved audio.
+///
+/// Every finished bucket, at any level, is handed to the sink as soon as
+/// its last input arrives; levels above 0 are built from the buckets
+/// below, never from samples. Appending costs amortised O(1) per frame
+/// and no memory beyond one bucket per level and channel.
+class PeakAccumulator
+{
+public:
+    using Sink = std::function<void (int level, int channel, int64_t bucket, PeakFile::MinMax minMax, float rms)>;
+
+    PeakAccumulator (int numChannels, Sink sink);
+
+    /// Add frames of interleaved audio.
+    void add (const float* interleaved, int64_t frames);
+
+    /// Add frames from per-channel buffers.
+    void add (const float* const* channels, int frames);
+
+    /// Emit the partial buckets at the end of the stream.
+    void finish();
+
+    int64_t getFramesAdded() const { return framesAdded_; }
+
+private:
+    struct Bucket
+    {
+        float min = 0.0f;
+        float max = 0.0f;
+        double sumSquares = 0.0;
+        int64_t samples = 0;
+        int64_t inputs = 0;         // samples (level 0) or child buckets
+        int64_t index = 0;          // next bucket number at this level
+    };
+
+    Bucket& bucket (int level, int channel) { return buckets_[static_cast<size_t> (level * numChannels_ + channel)]; }
+
+    void addSample (int channel, float v);
+    void emit (int level, int channel);
+
+    int numChannels_;
+    Sink sink_;
+    std::vector<Bucket> buckets_;
+    int64_t framesAdded_ = 0;
+};
+
+} // namespace dc
@@ -0,0 +1,282 @@
+#include "PeakStore.h"
+#include "AudioFileReader.h"
+#include "dc/foundation/file_utils.h"
+#include "dc/foundation/sha256.h"
+#include <algorithm>
+#include <cctype>
+#include <vector>
+
+namespace dc {
+
+namespace {
+
+bool isContentHash (const std::string& name)
+{
+    return name.size() == 64
+        && std::all_of (name.begin(), name.end(), [] (unsigned char c) { return std::isxdigit (c) != 0; });
+}
+
+} // namespace
+
+PeakStore::PeakStore()
+{
+    thread_ = std::thread ([this] { workerLoop(); });
+}
+
+PeakStore::~PeakStore()
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        stopping_.store (true);
+    }
+    workCv_.notify_all();
+
+    if (thread_.joinable())
+        thread_.join();
+}
+
+PeakStore& PeakStore::getInstance()
+{
+    static PeakStore instance;
+    return instance;
+}
+
+void PeakStore::setDirectory (const std::filesystem::path& directory)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    directory_ = directory;
+}
+
+std::filesystem::path PeakStore::getDirectory() const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+
+    if (directory_.empty())
+        return getUserAppDataDirectory() / directoryName;
+
+    return directory_;
+}
+
+std::filesystem::path PeakStore::getPeakPath (const std::filesystem::path& audioFile) const
+{
+    auto stem = audioFile.stem().string();
+
+    std::string name = isContentHash (stem)
+        ? stem
+        : sha256Hex (std::filesystem::absolute (audioFile).lexically_normal().string());
+
+    return getDirectory() / (name + ".peaks");
+}
+
+std::shared_ptr<PeakFile> PeakStore::find (const std::filesystem::path& audioFile)
+{
+    auto stamp = PeakFile::SourceStamp::of (audioFile);
+    if (stamp.modified == 0)
+        return nullptr;
+
+    auto peakPath = getPeakPath (audioFile);
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    return findLocked (audioFile, peakPath, stamp);
+}
+
+std::shared_ptr<PeakFile> PeakStore::request (const std::filesystem::path& audioFile)
+{
+    auto stamp = PeakFile::SourceStamp::of (audioFile);
+    if (stamp.modified == 0)
+        return nullptr;
+
+    auto peakPath = getPeakPath (audioFile);
+    std::shared_ptr<PeakFile> peaks;
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+
+        peaks = findLocked (audioFile, peakPath, stamp);
+        if (peaks != nullptr)
+            return peaks;
+
+        peaks = createLocked (audioFile, peakPath, stamp);
+    }
+
+    if (peaks != nullptr)
+        workCv_.notify_one();
+
+    return peaks;
+}
+
+std::shared_ptr<PeakFile> PeakStore::acquire (const std::filesystem::path& audioFile)
+{
+    auto stamp = PeakFile::SourceStamp::of (audioFile);
+    if (stamp.modified == 0)
+        return nullptr;
+
+    auto peakPath = getPeakPath (audioFile);
+    std::unique_lock<std::mutex> lock (mutex_);
+
+    auto peaks = findLocked (audioFile, peakPath, stamp);
+    if (peaks == nullptr)
+        peaks = createLocked (audioFile, peakPath, stamp);
+
+    if (peaks == nullptr)
+        return nullptr;
+
+    for (;;)
+    {
+        if (peaks->isComplete())
+            return peaks;
+
+        auto build = builds_.find (peakPath);
+        if (build == builds_.end() || build->second.peaks != peaks)
+            return nullptr;     // the build failed
+
+        if (! build->second.started)
+            break;
+
+        doneCv_.wait (lock);
+    }
+
+    // Nobody has started on it: scan it here rather than wait for the worker
+    builds_[peakPath].started = true;
+    lock.unlock();
+
+    scan (audioFile, *peaks);
+
+    lock.lock();
+    builds_.erase (peakPath);
+    doneCv_.notify_all();
+
+    return peaks->isComplete() ? peaks : nullptr;
+}
+
+std::shared_ptr<PeakFile> PeakStore::save (const std::filesystem::path& audioFile, const LivePeaks& peaks)
+{
+    auto stamp = PeakFile::SourceStamp::of (audioFile);
+    if (stamp.modified == 0)
+        return nullptr;
+
+    auto peakPath = getPeakPath (audioFile);
+    auto file = peaks.writePeakFile (peakPath, stamp);
+    if (file == nullptr)
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    mapped_[peakPath] = file;
+    return file;
+}
+
+bool PeakStore::isBuilding() const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return ! builds_.empty();
+}
+
+std::shared_ptr<PeakFile> PeakStore::findLocked (const std::filesystem::path& audioFile,
+                                                 const std::filesystem::path& peakPath,
+                                                 const PeakFile::SourceStamp& stamp)
+{
+    auto build = builds_.find (peakPath);
+    if (build != builds_.end() && build->second.peaks->getSource() == stamp && build->second.source == audioFile)
+        return build->second.peaks;
+
+    auto known = mapped_.find (peakPath);
+    if (known != mapped_.end())
+    {
+        auto peaks = known->second.lock();
+        if (peaks != nullptr && peaks->isComplete() && peaks->getSource() == stamp)
+            return peaks;
+    }
+
+    auto peaks = PeakFile::open (peakPath, stamp);
+    if (peaks != nullptr)
+        mapped_[peakPath] = peaks;
+
+    return peaks;
+}
+
+std::shared_ptr<PeakFile> PeakStore::createLocked (const std::filesystem::path& audioFile,
+                                                   const std::filesystem::path& peakPath,
+                                                   const PeakFile::SourceStamp& stamp)
+{
+    if (builds_.count (peakPath) != 0)
+        return nullptr;     // a build for an older version of the file is still finishing
+
+    auto reader = AudioFileReader::open (audioFile);
+    if (reader == nullptr)
+        return nullptr;
+
+    auto peaks = PeakFile::create (peakPath, stamp, reader->getNumChannels(),
+                                   reader->getSampleRate(), reader->getLengthInSamples());
+    if (peaks == nullptr)
+        return nullptr;
+
+    builds_[peakPath] = { audioFile, peaks, false };
+    mapped_[peakPath] = peaks;
+    return peaks;
+}
+
+bool PeakStore::scan (const std::filesystem::path& source, PeakFile& peaks)
+{
+    auto reader = AudioFileReader::open (source);
+    if (reader == nullptr || reader->getNumChannels() != peaks.getNumChannels())
+        return false;
+
+    PeakAccumulator accumulator (peaks.getNumChannels(),
+        [&peaks] (int level, int channel, int64_t bucket, PeakFile::MinMax minMax, float rms)
+        {
+            peaks.store (level, channel, bucket, minMax, rms);
+        });
+
+    auto length = peaks.getLengthInFrames();
+    std::vector<float> buffer (static_cast<size_t> (scanChunkFrames * peaks.getNumChannels()));
+
+    for (int64_t position = 0; position < length;)
+    {
+        if (stopping_.load())
+            return false;
+
+        auto got = reader->read (buffer.data(), position, std::min (scanChunkFrames, length - position));
+        if (got <= 0)
+            break;      // shorter than its header says: the rest stays silent
+
+        accumulator.add (buffer.data(), got);
+        position += got;
+        peaks.setFramesDone (position);
+    }
+
+    accumulator.finish();
+    return peaks.finish();
+}
+
+void PeakStore::workerLoop()
+{
+    for (;;)
+    {
+        std::filesystem::path peakPath;
+        Build build;
+        {
+            std::unique_lock<std::mutex> lock (mutex_);
+            workCv_.wait (lock, [this]
+            {
+                return stopping_.load()
+                    || std::any_of (builds_.begin(), builds_.end(), [] (const auto& b) { return ! b.second.started; });
+            });
+
+            if (stopping_.load())
+                return;
+
+            auto it = std::find_if (builds_.begin(), builds_.end(), [] (const auto& b) { return ! b.second.started; });
+            it->second.started = true;
+            peakPath = it->first;
+            build = it->second;
+        }
+
+        scan (build.source, *build.peaks);
+        build.peaks.reset();
+
+        std::lock_guard<std::mutex> lock (mutex_);
+        builds_.erase (peakPath);
+        doneCv_.notify_all();
+    }
+}
+
+} // namespace dc
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "LivePeaks.h"
+#include "PeakFile.h"
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace dc {
+
+/// Process-wide home of waveform peak files.
+///
+/// Peak files live in a directory beside the session's media
+/// (<session>/peaks), or in the user's app data directory before a
+/// session has been saved. A pool entry's peak file is named by the
+/// entry's content hash; any other file by a hash of its path. Either
+/// way the header's source size and modification time decide whether a
+/// peak file is still current, so edited files are rescanned.
+///
+/// Each peak file is mapped once however many clips show it, and is
+/// built at most once at a time: callers asking for peaks that are being
+/// built get the same, growing PeakFile.
+class PeakStore
+{
+public:
+    PeakStore();
+    ~PeakStore();
+
+    PeakStore (const PeakStore&) = delete;
+    PeakStore& operator= (const PeakStore&) = delete;
+
+    static PeakStore& getInstance();
+
+    /// Peaks subdirectory of a session directory.
+    static constexpr const char* directoryName = "peaks";
+
+    /// Where new peak files go; empty restores the app data default.
+    void setDirectory (const std::filesystem::path& directory);
+    std::filesystem::path getDirectory() const;
+
+    /// The peak file that belongs to audioFile.
+    std::filesystem::path getPeakPath (const std::filesystem::path& audioFile) const;
+
+    /// Current peaks of audioFile, complete or still being built, without
+    /// building anything. nullptr if there are none.
+    std::shared_ptr<PeakFile> find (const std::filesystem::path& audioFile);
+
+    /// Complete peaks of audioFile, scanning it on the calling thread if
+    /// needed (or waiting for a background build already under way).
+    /// nullptr if the file can't be read.
+    std::shared_ptr<PeakFile> acquire (const std::filesystem::path& audioFile);
+
+    /// Peaks of audioFile, starting a background build if there are no
+    /// current ones. The result fills in as the build proceeds (see
+    /// PeakFile::getFramesDone()). nullptr if the file can't be read.
+    std::shared_ptr<PeakFile> request (const std::filesystem::path& audioFile);
+
+    /// Store peaks built while audioFile was recorded as its peak file,
+    /// so it is never scanned. Call once the file is closed. nullptr on
+    /// failure (the file is then scanned when its peaks are asked for).
+    std::shared_ptr<PeakFile> save (const std::filesystem::path& audioFile, const LivePeaks& peaks);
+
+    /// True while any peak file is queued or being built in the background.
+    bool isBuilding() const;
+
+    /// Frames read per step while scanning a file.
+    static constexpr int64_t scanChunkFrames = 1 << 16;
+
+private:
+    struct Build
+    {
+        std::filesystem::path source;
+        std::shared_ptr<PeakFile> peaks;
+        bool started = false;
+    };
+
+    /// Scan source into peaks; true if the file is complete.
+    bool scan (const std::filesystem::path& source, PeakFile& peaks);
+
+    // Require mutex_ held
+    std::shared_ptr<PeakFile> findLocked (const std::filesystem::path& audioFile,
+                                          const std::filesystem::path& peakPath,
+                                          const PeakFile::SourceStamp& stamp);
+    std::shared_ptr<PeakFile> createLocked (const std::filesystem::path& audioFile,
+                                            const std::filesystem::path& peakPath,
+                                            const PeakFile::SourceStamp& stamp);
+
+    void workerLoop();
+
+    mutable std::mutex mutex_;
+    std::condition_variable workCv_;
+    std::condition_variable doneCv_;
+
+    std::filesystem::path directory_;
+    std::map<std::filesystem::path, std::weak_ptr<PeakFile>> mapped_;   // by peak path
+    std::map<std::filesystem::path, Build> builds_;                     // by peak path
+
+    std::thread thread_;
+    std::atomic<bool> stopping_ { false };
+};
+
+} // namespace dc
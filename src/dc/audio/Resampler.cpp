@@ -0,0 +1,366 @@
+#include "Resampler.h"
+#include "AudioFileReader.h"
+#include "AudioFileWriter.h"
+#include "dc/foundation/types.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace dc {
+
+namespace {
+
+#if defined (__AVX__)
+constexpr int W = 8;
+#else
+constexpr int W = 4;
+#endif
+
+typedef float VecF __attribute__ ((vector_size (sizeof (float) * W)));
+
+constexpr double twoPow32 = 4294967296.0;
+
+inline VecF splat (float x)
+{
+    VecF v;
+    for (int i = 0; i < W; ++i)
+        v[i] = x;
+    return v;
+}
+
+inline VecF load (const float* p)
+{
+    VecF v;
+    std::memcpy (&v, p, sizeof (VecF));
+    return v;
+}
+
+inline float horizontalSum (VecF v)
+{
+    float sum = 0.0f;
+    for (int i = 0; i < W; ++i)
+        sum += v[i];
+    return sum;
+}
+
+/// Dot x with two adjacent phase rows and interpolate between them.
+/// numTaps is a multiple of 8, so of W.
+inline float interpolatedDot (const float* x, const float* c0, const float* c1,
+                              int numTaps, float frac)
+{
+    VecF a0 = splat (0.0f);
+    VecF a1 = splat (0.0f);
+
+    for (int i = 0; i < numTaps; i += W)
+    {
+        VecF xv = load (x + i);
+        a0 += xv * load (c0 + i);
+        a1 += xv * load (c1 + i);
+    }
+
+    return horizontalSum (a0 + (a1 - a0) * splat (frac));
+}
+
+/// Zeroth-order modified Bessel function of the first kind
+double besselI0 (double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x * 0.5;
+
+    for (int k = 1; k < 64; ++k)
+    {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-12)
+            break;
+    }
+    return sum;
+}
+
+struct QualitySpec
+{
+    int taps;       // at unity or upsampling ratio
+    double beta;    // Kaiser window shape
+};
+
+QualitySpec specFor (Resampler::Quality q)
+{
+    switch (q)
+    {
+        case Resampler::Quality::draft:    return { 16, 5.65 };
+        case Resampler::Quality::standard: return { 64, 9.0 };
+        case Resampler::Quality::high:     return { 128, 11.5 };
+    }
+    return { 64, 9.0 };
+}
+
+} // anonymous namespace
+
+Resampler::Resampler (int numChannels, double inputRate, double outputRate, Quality quality)
+    : numChannels_ (std::max (numChannels, 1)),
+      inputRate_ (inputRate > 0.0 ? inputRate : 44100.0),
+      outputRate_ (outputRate > 0.0 ? outputRate : inputRate_),
+      quality_ (quality)
+{
+    step_ = static_cast<uint64_t> (std::llround (getRatio() * twoPow32));
+    buildFilter();
+    history_.resize (static_cast<size_t> (numChannels_));
+    reset();
+}
+
+void Resampler::buildFilter()
+{
+    auto spec = specFor (quality_);
+    double ratio = getRatio();
+
+    // When decimating the filter must cut at the output Nyquist, which
+    // needs proportionally more input taps for the same transition width
+    double widen = std::clamp (ratio, 1.0, 4.0);
+    numTaps_ = static_cast<int> (std::ceil (spec.taps * widen / 8.0)) * 8;
+
+    // Put the stopband edge at the lower Nyquist so nothing above it
+    // aliases, and centre the cutoff in the Kaiser transition band
+    double attenuation = spec.beta / 0.1102 + 8.7;
+    double stopEdge = 0.5 / widen;
+    double transition = (attenuation - 7.95) / (14.36 * numTaps_);
+    double cutoff = stopEdge - 0.5 * transition;
+
+    int half = numTaps_ / 2;
+    double i0Beta = besselI0 (spec.beta);
+
+    coeffs_.assign (static_cast<size_t> ((numPhases + 1) * numTaps_), 0.0f);
+
+    for (int p = 0; p <= numPhases; ++p)
+    {
+        double frac = static_cast<double> (p) / numPhases;
+        float* row = coeffs_.data() + p * numTaps_;
+        double sum = 0.0;
+        std::vector<double> h (static_cast<size_t> (numTaps_));
+
+        for (int k = 0; k < numTaps_; ++k)
+        {
+            double t = static_cast<double> (k - (half - 1)) - frac;
+            double x = 2.0 * cutoff * t;
+            double sinc = std::abs (x) < 1e-12 ? 1.0 : std::sin (dc::pi<double> * x) / (dc::pi<double> * x);
+
+            double r = t / half;
+            double window = std::abs (r) >= 1.0 ? 0.0 : besselI0 (spec.beta * std::sqrt (1.0 - r * r)) / i0Beta;
+
+            h[static_cast<size_t> (k)] = 2.0 * cutoff * sinc * window;
+            sum += h[static_cast<size_t> (k)];
+        }
+
+        // Unity DC gain at every phase
+        for (int k = 0; k < numTaps_; ++k)
+            row[k] = static_cast<float> (h[static_cast<size_t> (k)] / sum);
+    }
+}
+
+void Resampler::reset (double fractionalStart)
+{
+    historyFrames_ = 0;
+    fractionalStart = std::clamp (fractionalStart, 0.0, 1.0 - 1e-12);
+    pos_ = static_cast<uint64_t> (fractionalStart * twoPow32);
+}
+
+int Resampler::getInputFramesNeeded (int numOutputFrames) const
+{
+    if (numOutputFrames <= 0)
+        return 0;
+
+    uint64_t lastPos = pos_ + step_ * static_cast<uint64_t> (numOutputFrames - 1);
+    int64_t needed = static_cast<int64_t> (lastPos >> 32) + numTaps_ - historyFrames_;
+    return static_cast<int> (std::max<int64_t> (needed, 0));
+}
+
+int64_t Resampler::getOutputLength (int64_t numInputFrames) const
+{
+    return static_cast<int64_t> (std::ceil (static_cast<double> (numInputFrames) / getRatio() - 1e-9));
+}
+
+int Resampler::process (const float* const* input, int numInputFrames,
+                        float* const* output, int maxOutputFrames)
+{
+    if (numInputFrames > 0)
+    {
+        size_t needed = static_cast<size_t> (historyFrames_ + numInputFrames);
+        for (int ch = 0; ch < numChannels_; ++ch)
+        {
+            auto& h = history_[static_cast<size_t> (ch)];
+            if (h.size() < needed)
+                h.resize (needed);
+            std::memcpy (h.data() + historyFrames_, input[ch],
+                         sizeof (float) * static_cast<size_t> (numInputFrames));
+        }
+        historyFrames_ += numInputFrames;
+    }
+
+    return produce (output, maxOutputFrames);
+}
+
+int Resampler::processInterleaved (const float* input, int numInputFrames,
+                                   float* const* output, int maxOutputFrames)
+{
+    if (numInputFrames > 0)
+    {
+        size_t needed = static_cast<size_t> (historyFrames_ + numInputFrames);
+        for (int ch = 0; ch < numChannels_; ++ch)
+        {
+            auto& h = history_[static_cast<size_t> (ch)];
+            if (h.size() < needed)
+                h.resize (needed);
+
+            float* dst = h.data() + historyFrames_;
+            const float* src = input + ch;
+            for (int f = 0; f < numInputFrames; ++f)
+                dst[f] = src[f * numChannels_];
+        }
+        historyFrames_ += numInputFrames;
+    }
+
+    return produce (output, maxOutputFrames);
+}
+
+int Resampler::produce (float* const* output, int maxOutputFrames)
+{
+    int produced = 0;
+
+    while (produced < maxOutputFrames)
+    {
+        auto idx = static_cast<int> (pos_ >> 32);
+        if (idx + numTaps_ > historyFrames_)
+            break;
+
+        // Top bits of the fraction pick the phase row, the rest
+        // interpolate towards the next row
+        uint64_t phaseFixed = (pos_ & 0xffffffffu) * static_cast<uint64_t> (numPhases);
+        auto phase = static_cast<int> (phaseFixed >> 32);
+        auto frac = static_cast<float> (static_cast<double> (phaseFixed & 0xffffffffu) / twoPow32);
+
+        const float* c0 = coeffs_.data() + phase * numTaps_;
+        const float* c1 = c0 + numTaps_;
+
+        for (int ch = 0; ch < numChannels_; ++ch)
+            output[ch][produced] = interpolatedDot (history_[static_cast<size_t> (ch)].data() + idx,
+                                                    c0, c1, numTaps_, frac);
+
+        pos_ += step_;
+        ++produced;
+    }
+
+    // Drop input that no future output can reach
+    auto consumed = static_cast<int> (std::min<uint64_t> (pos_ >> 32, static_cast<uint64_t> (historyFrames_)));
+    if (consumed > 0)
+    {
+        int remaining = historyFrames_ - consumed;
+        for (auto& h : history_)
+            std::memmove (h.data(), h.data() + consumed, sizeof (float) * static_cast<size_t> (remaining));
+
+        historyFrames_ = remaining;
+        pos_ -= static_cast<uint64_t> (consumed) << 32;
+    }
+
+    return produced;
+}
+
+bool Resampler::convertFile (const std::filesystem::path& src,
+                             const std::filesystem::path& dst,
+                             double outputRate,
+                             Quality quality,
+                             std::atomic<float>* progress,
+                             const std::atomic<bool>* cancel)
+{
+    auto reader = AudioFileReader::open (src);
+    if (reader == nullptr || outputRate <= 0.0)
+        return false;
+
+    int numChannels = reader->getNumChannels();
+    int64_t inputLength = reader->getLengthInSamples();
+
+    auto writer = AudioFileWriter::create (dst, AudioFileWriter::Format::WAV_32F, numChannels, outputRate);
+    if (writer == nullptr)
+        return false;
+
+    Resampler resampler (numChannels, reader->getSampleRate(), outputRate, quality);
+    int64_t outputLength = resampler.getOutputLength (inputLength);
+
+    constexpr int chunkFrames = 16384;
+    int maxOut = static_cast<int> (std::ceil ((chunkFrames + resampler.getNumTaps()) / resampler.getRatio())) + 2;
+
+    std::vector<float> in (static_cast<size_t> (chunkFrames * numChannels), 0.0f);
+    std::vector<std::vector<float>> out (static_cast<size_t> (numChannels),
+                                         std::vector<float> (static_cast<size_t> (maxOut)));
+    std::vector<float*> outPtrs;
+    for (auto& o : out)
+        outPtrs.push_back (o.data());
+
+    AudioBlock outBlock (outPtrs.data(), numChannels, maxOut);
+
+    // Lead-in of zeros so the first output frame is centred on input 0
+    resampler.processInterleaved (in.data(), resampler.getLatency(), outPtrs.data(), 0);
+
+    int64_t readPos = 0;
+    int64_t written = 0;
+    bool ok = true;
+
+    while (written < outputLength)
+    {
+        if (cancel != nullptr && cancel->load (std::memory_order_relaxed))
+        {
+            ok = false;
+            break;
+        }
+
+        // Past the end of the file, keep feeding zeros to flush the tail
+        int64_t framesRead = 0;
+        if (readPos < inputLength)
+        {
+            framesRead = reader->read (in.data(), readPos, std::min<int64_t> (chunkFrames, inputLength - readPos));
+            if (framesRead <= 0)
+            {
+                ok = false;
+                break;
+            }
+            readPos += framesRead;
+        }
+        else
+        {
+            std::fill (in.begin(), in.end(), 0.0f);
+            framesRead = chunkFrames;
+        }
+
+        int produced = resampler.processInterleaved (in.data(), static_cast<int> (framesRead), outPtrs.data(), maxOut);
+
+        while (produced > 0 && written < outputLength)
+        {
+            int n = static_cast<int> (std::min<int64_t> (produced, outputLength - written));
+            if (! writer->write (outBlock, n))
+            {
+                ok = false;
+                break;
+            }
+            written += n;
+            produced = resampler.process (nullptr, 0, outPtrs.data(), maxOut);
+        }
+
+        if (! ok)
+            break;
+
+        if (progress != nullptr)
+            progress->store (static_cast<float> (written) / static_cast<float> (std::max<int64_t> (outputLength, 1)),
+                             std::memory_order_relaxed);
+    }
+
+    writer->close();
+
+    if (! ok)
+    {
+        std::error_code ec;
+        std::filesystem::remove (dst, ec);
+    }
+
+    return ok;
+}
+
+} // namespace dc
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace dc {
+
+/// Streaming polyphase sample-rate converter for planar float audio.
+///
+/// A Kaiser-windowed sinc low-pass is tabulated at a fixed number of
+/// sub-sample phases; each output frame interpolates linearly between the
+/// two nearest phases. The tap loop runs on float vectors, so the cost per
+/// output sample is roughly taps / vector-width multiply-adds per channel.
+///
+/// Not real-time safe: the internal history may grow. DiskStreamer runs it
+/// on its I/O thread, never on the audio thread.
+class Resampler
+{
+public:
+    enum class Quality
+    {
+        draft,      ///< 16 taps, ~60 dB stopband. Previews, scrubbing.
+        standard,   ///< 64 taps, ~90 dB stopband. Playback default.
+        high        ///< 128 taps, ~115 dB stopband. Offline conversion.
+    };
+
+    Resampler (int numChannels, double inputRate, double outputRate,
+               Quality quality = Quality::standard);
+
+    int getNumChannels() const { return numChannels_; }
+    double getInputRate() const { return inputRate_; }
+    double getOutputRate() const { return outputRate_; }
+    Quality getQuality() const { return quality_; }
+    int getNumTaps() const { return numTaps_; }
+
+    /// Input frames consumed per output frame.
+    double getRatio() const { return inputRate_ / outputRate_; }
+
+    /// Input frames the filter looks back before the frame it is centred
+    /// on. To start output exactly at input position t, reset (frac(t))
+    /// and feed input starting at floor(t) - getLatency() (zeros before
+    /// the start of the file).
+    int getLatency() const { return numTaps_ / 2 - 1; }
+
+    /// Forget all buffered input and start at the given fractional
+    /// position (0..1) within the first frame fed next.
+    void reset (double fractionalStart = 0.0);
+
+    /// Additional input frames required before process() can produce
+    /// numOutputFrames frames.
+    int getInputFramesNeeded (int numOutputFrames) const;
+
+    /// Append numInputFrames frames (one pointer per channel, may be null
+    /// when numInputFrames is 0) and write up to maxOutputFrames frames to
+    /// output. Input that cannot be used yet is kept for the next call.
+    /// Returns the number of frames written.
+    int process (const float* const* input, int numInputFrames,
+                 float* const* output, int maxOutputFrames);
+
+    /// Same, reading interleaved input.
+    int processInterleaved (const float* input, int numInputFrames,
+                            float* const* output, int maxOutputFrames);
+
+    /// Output length for an input of numInputFrames frames.
+    int64_t getOutputLength (int64_t numInputFrames) const;
+
+    /// Convert a whole file to outputRate, writing 32-bit float WAV.
+    /// Intended for a one-time background conversion at import.
+    /// progress (optional) is updated 0..1; setting cancel aborts.
+    /// Returns false on failure or cancellation (dst is removed).
+    static bool convertFile (const std::filesystem::path& src,
+                             const std::filesystem::path& dst,
+                             double outputRate,
+                             Quality quality = Quality::high,
+                             std::atomic<float>* progress = nullptr,
+                             const std::atomic<bool>* cancel = nullptr);
+
+    static constexpr int numPhases = 256;
+
+private:
+    void buildFilter();
+    int produce (float* const* output, int maxOutputFrames);
+
+    int numChannels_;
+    double inputRate_;
+    double outputRate_;
+    Quality quality_;
+    int numTaps_ = 0;
+
+    // (numPhases + 1) rows of numTaps_ coefficients; row p is the filter
+    // for fractional offset p / numPhases
+    std::vector<float> coeffs_;
+
+    // Buffered input per channel; frames before pos_ are discarded lazily
+    std::vector<std::vector<float>> history_;
+    int historyFrames_ = 0;
+
+    // Read position in history_, 32.32 fixed point
+    uint64_t pos_ = 0;
+    uint64_t step_ = 0;
+};
+
+} // namespace dc
@@ -0,0 +1,465 @@
+#include "SampleCache.h"
+#include "AudioFileReader.h"
+#include "Resampler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dc {
+
+namespace {
+
+uint16_t readLE16 (const unsigned char* p)
+{
+    return static_cast<uint16_t> (p[0] | (p[1] << 8));
+}
+
+uint32_t readLE32 (const unsigned char* p)
+{
+    return static_cast<uint32_t> (p[0]) | (static_cast<uint32_t> (p[1]) << 8)
+         | (static_cast<uint32_t> (p[2]) << 16) | (static_cast<uint32_t> (p[3]) << 24);
+}
+
+std::string makeKey (const std::filesystem::path& file, double sampleRate)
+{
+    return file.lexically_normal().string() + '@' + std::to_string (std::llround (sampleRate));
+}
+
+/// Decode the whole file and convert it to outputRate, interleaved
+bool decodeResampled (AudioFileReader& reader, double outputRate, std::vector<float>& dest)
+{
+    int numChannels = reader.getNumChannels();
+    int64_t inputLength = reader.getLengthInSamples();
+
+    Resampler resampler (numChannels, reader.getSampleRate(), outputRate, Resampler::Quality::high);
+    int64_t outputLength = resampler.getOutputLength (inputLength);
+    dest.assign (static_cast<size_t> (outputLength * numChannels), 0.0f);
+
+    constexpr int chunkFrames = 8192;
+    int maxOut = static_cast<int> (std::ceil ((chunkFrames + resampler.getNumTaps()) / resampler.getRatio())) + 2;
+
+    std::vector<float> in (static_cast<size_t> (chunkFrames * numChannels), 0.0f);
+    std::vector<std::vector<float>> out (static_cast<size_t> (numChannels),
+                                         std::vector<float> (static_cast<size_t> (maxOut)));
+    std::vector<float*> outPtrs;
+    for (auto& o : out)
+        outPtrs.push_back (o.data());
+
+    // Lead-in of zeros so the first output frame is centred on input 0
+    resampler.processInterleaved (in.data(), resampler.getLatency(), outPtrs.data(), 0);
+
+    int64_t readPos = 0;
+    int64_t written = 0;
+
+    while (written < outputLength)
+    {
+        int64_t framesRead = chunkFrames;
+        if (readPos < inputLength)
+        {
+            framesRead = reader.read (in.data(), readPos, std::min<int64_t> (chunkFrames, inputLength - readPos));
+            if (framesRead <= 0)
+                return false;
+            readPos += framesRead;
+        }
+        else
+        {
+            std::fill (in.begin(), in.end(), 0.0f);
+        }
+
+        int produced = resampler.processInterleaved (in.data(), static_cast<int> (framesRead), outPtrs.data(), maxOut);
+
+        while (produced > 0 && written < outputLength)
+        {
+            auto n = std::min<int64_t> (produced, outputLength - written);
+            float* dst = dest.data() + written * numChannels;
+
+            for (int64_t f = 0; f < n; ++f)
+                for (int ch = 0; ch < numChannels; ++ch)
+                    dst[f * numChannels + ch] = out[static_cast<size_t> (ch)][static_cast<size_t> (f)];
+
+            written += n;
+            produced = resampler.process (nullptr, 0, outPtrs.data(), maxOut);
+        }
+    }
+
+    return true;
+}
+
+} // anonymous namespace
+
+// ─── CachedSample ───────────────────────────────────────────────
+
+CachedSample::~CachedSample()
+{
+    if (mapBase_ != nullptr)
+        munmap (mapBase_, mapLength_);
+}
+
+bool CachedSample::isTruncated() const
+{
+    if (mapBase_ == nullptr)
+        return false;
+
+    // A file deleted or replaced by rename leaves the mapped inode intact;
+    // only the same inode grown shorter loses pages
+    struct stat st {};
+    if (::stat (mapPath_.c_str(), &st) != 0)
+        return false;
+
+    return static_cast<uint64_t> (st.st_dev) == mapDevice_
+        && static_cast<uint64_t> (st.st_ino) == mapInode_
+        && static_cast<uint64_t> (st.st_size) < mapLength_;
+}
+
+int CachedSample::read (AudioBlock& output, int64_t startFrame, int numSamples) const
+{
+    output.clear (0, numSamples);
+
+    int64_t from = std::max<int64_t> (startFrame, 0);
+    int64_t to = std::min<int64_t> (startFrame + numSamples, numFrames_);
+    if (from >= to)
+        return 0;
+
+    int dstOffset = static_cast<int> (from - startFrame);
+    auto n = static_cast<int> (to - from);
+    const float* src = data_ + from * numChannels_;
+
+    for (int ch = 0; ch < output.getNumChannels(); ++ch)
+    {
+        float* dst = output.getChannel (ch) + dstOffset;
+        const float* s = src + std::min (ch, numChannels_ - 1);
+
+        for (int f = 0; f < n; ++f)
+            dst[f] = s[f * numChannels_];
+    }
+
+    return n;
+}
+
+// ─── SampleCache ────────────────────────────────────────────────
+
+SampleCache::SampleCache (size_t memoryBudgetBytes, size_t maxSampleBytes)
+    : memoryBudget_ (memoryBudgetBytes),
+      maxSampleBytes_ (maxSampleBytes)
+{
+}
+
+SampleCache::~SampleCache() = default;
+
+SampleCache& SampleCache::getInstance()
+{
+    static SampleCache instance;
+    return instance;
+}
+
+std::shared_ptr<const CachedSample> SampleCache::acquire (const std::filesystem::path& file,
+                                                          double sampleRate)
+{
+    std::error_code ec;
+    auto modified = std::filesystem::last_write_time (file, ec);
+    if (ec)
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        ++stats_.uncacheable;
+        return nullptr;
+    }
+
+    auto key = makeKey (file, sampleRate);
+    size_t maxBytes;
+
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+
+        auto it = entries_.find (key);
+        if (it != entries_.end() && it->second.modificationTime == modified
+            && ! it->second.sample->isTruncated())
+        {
+            lru_.splice (lru_.begin(), lru_, it->second.lruPosition);
+            ++stats_.hits;
+            return it->second.sample;
+        }
+
+        // Changed or cut short on disk since it was cached
+        if (it != entries_.end())
+            erase (it);
+
+        maxBytes = maxSampleBytes_;
+    }
+
+    // Load without the lock so other lookups aren't held up by the disk
+    std::shared_ptr<const CachedSample> sample = load (file, sampleRate, maxBytes);
+
+    std::lock_guard<std::mutex> lock (mutex_);
+
+    if (sample == nullptr)
+    {
+        ++stats_.uncacheable;
+        return nullptr;
+    }
+
+    ++stats_.misses;
+
+    // Another thread may have loaded the same file meanwhile
+    auto it = entries_.find (key);
+    if (it != entries_.end())
+    {
+        if (it->second.modificationTime == modified)
+            return it->second.sample;
+        erase (it);
+    }
+
+    Entry entry;
+    entry.modificationTime = modified;
+    entry.sample = sample;
+    insert (key, std::move (entry));
+    evictToBudget();
+
+    return sample;
+}
+
+std::shared_ptr<CachedSample> SampleCache::load (const std::filesystem::path& file,
+                                                 double sampleRate, size_t maxBytes) const
+{
+    auto reader = AudioFileReader::open (file);
+    if (reader == nullptr || reader->getNumChannels() <= 0)
+        return nullptr;
+
+    double fileRate = reader->getSampleRate();
+    if (sampleRate <= 0.0)
+        sampleRate = fileRate;
+    bool resample = sampleRate != fileRate;
+
+    int numChannels = reader->getNumChannels();
+    int64_t numFrames = reader->getLengthInSamples();
+    if (resample)
+        numFrames = Resampler (numChannels, fileRate, sampleRate).getOutputLength (numFrames);
+
+    auto bytes = static_cast<uint64_t> (numFrames) * static_cast<uint64_t> (numChannels) * sizeof (float);
+    if (numFrames <= 0 || bytes > maxBytes)
+        return nullptr;
+
+    if (! resample)
+        if (auto mapped = mapFloatWav (file))
+            return mapped;
+
+    std::shared_ptr<CachedSample> sample (new CachedSample());
+    sample->numChannels_ = numChannels;
+    sample->sampleRate_ = sampleRate;
+
+    if (resample)
+    {
+        if (! decodeResampled (*reader, sampleRate, sample->decoded_))
+            return nullptr;
+    }
+    else
+    {
+        sample->decoded_.assign (static_cast<size_t> (numFrames * numChannels), 0.0f);
+        if (reader->read (sample->decoded_.data(), 0, numFrames) != numFrames)
+            return nullptr;
+    }
+
+    sample->numFrames_ = static_cast<int64_t> (sample->decoded_.size()) / numChannels;
+    sample->data_ = sample->decoded_.data();
+    sample->residentBytes_ = sample->decoded_.size() * sizeof (float);
+    return sample;
+}
+
+std::shared_ptr<CachedSample> SampleCache::mapFloatWav (const std::filesystem::path& file)
+{
+#if defined (__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    int fd = ::open (file.string().c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat st {};
+    if (fstat (fd, &st) != 0 || st.st_size < 44)
+    {
+        ::close (fd);
+        return nullptr;
+    }
+    auto fileSize = static_cast<uint64_t> (st.st_size);
+
+    // Walk the RIFF chunks for a 32-bit IEEE float fmt and the data chunk
+    unsigned char header[12];
+    if (pread (fd, header, sizeof (header), 0) != static_cast<ssize_t> (sizeof (header))
+        || std::memcmp (header, "RIFF", 4) != 0 || std::memcmp (header + 8, "WAVE", 4) != 0)
+    {
+        ::close (fd);
+        return nullptr;
+    }
+
+    int numChannels = 0;
+    double sampleRate = 0.0;
+    bool isFloat32 = false;
+    uint64_t dataOffset = 0;
+    uint64_t dataBytes = 0;
+
+    uint64_t pos = 12;
+    while (pos + 8 <= fileSize)
+    {
+        unsigned char chunk[8];
+        if (pread (fd, chunk, 8, static_cast<off_t> (pos)) != 8)
+            break;
+
+        uint64_t chunkSize = readLE32 (chunk + 4);
+
+        if (std::memcmp (chunk, "fmt ", 4) == 0 && chunkSize >= 16)
+        {
+            unsigned char fmt[40] = {};
+            auto n = static_cast<size_t> (std::min<uint64_t> (chunkSize, sizeof (fmt)));
+            if (pread (fd, fmt, n, static_cast<off_t> (pos + 8)) != static_cast<ssize_t> (n))
+                break;
+
+            // WAVE_FORMAT_IEEE_FLOAT, or EXTENSIBLE with a float sub-format
+            uint16_t tag = readLE16 (fmt);
+            if (tag == 0xfffe && n >= 26)
+                tag = readLE16 (fmt + 24);
+
+            numChannels = readLE16 (fmt + 2);
+            sampleRate = static_cast<double> (readLE32 (fmt + 4));
+            isFloat32 = tag == 3 && readLE16 (fmt + 14) == 32;
+        }
+        else if (std::memcmp (chunk, "data", 4) == 0)
+        {
+            dataOffset = pos + 8;
+            // Streamed writers may leave the size unset; trust the file length
+            dataBytes = std::min<uint64_t> (chunkSize, fileSize - dataOffset);
+            if (chunkSize == 0 || chunkSize == 0xffffffffu)
+                dataBytes = fileSize - dataOffset;
+            break;
+        }
+
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    if (! isFloat32 || numChannels <= 0 || dataOffset == 0 || dataOffset % sizeof (float) != 0)
+    {
+        ::close (fd);
+        return nullptr;
+    }
+
+    auto frameBytes = static_cast<uint64_t> (numChannels) * sizeof (float);
+    int64_t numFrames = static_cast<int64_t> (dataBytes / frameBytes);
+    if (numFrames <= 0)
+    {
+        ::close (fd);
+        return nullptr;
+    }
+
+    auto mapLength = static_cast<size_t> (dataOffset + static_cast<uint64_t> (numFrames) * frameBytes);
+    void* base = mmap (nullptr, mapLength, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close (fd);
+    if (base == MAP_FAILED)
+        return nullptr;
+
+    // Fault the pages in now rather than on the audio thread
+    madvise (base, mapLength, MADV_WILLNEED);
+
+    std::shared_ptr<CachedSample> sample (new CachedSample());
+    sample->numChannels_ = numChannels;
+    sample->numFrames_ = numFrames;
+    sample->sampleRate_ = sampleRate;
+    sample->mapBase_ = base;
+    sample->mapLength_ = mapLength;
+    sample->mapPath_ = file.string();
+    sample->mapDevice_ = static_cast<uint64_t> (st.st_dev);
+    sample->mapInode_ = static_cast<uint64_t> (st.st_ino);
+    sample->data_ = reinterpret_cast<const float*> (static_cast<const char*> (base) + dataOffset);
+    sample->residentBytes_ = mapLength;
+    return sample;
+#else
+    (void) file;
+    return nullptr;
+#endif
+}
+
+void SampleCache::insert (const std::string& key, Entry entry)
+{
+    lru_.push_front (key);
+    entry.lruPosition = lru_.begin();
+
+    stats_.residentBytes += entry.sample->getResidentBytes();
+    if (entry.sample->isMapped())
+        stats_.mappedBytes += entry.sample->getResidentBytes();
+    ++stats_.numEntries;
+
+    entries_.emplace (key, std::move (entry));
+}
+
+void SampleCache::erase (std::unordered_map<std::string, Entry>::iterator it)
+{
+    const auto& sample = it->second.sample;
+    stats_.residentBytes -= sample->getResidentBytes();
+    if (sample->isMapped())
+        stats_.mappedBytes -= sample->getResidentBytes();
+    --stats_.numEntries;
+
+    lru_.erase (it->second.lruPosition);
+    entries_.erase (it);
+}
+
+void SampleCache::evictToBudget()
+{
+    // Oldest first. Samples a player still holds would stay allocated
+    // anyway, so they are skipped rather than dropped.
+    auto it = lru_.end();
+    while (it != lru_.begin() && stats_.residentBytes > memoryBudget_)
+    {
+        --it;
+        auto entry = entries_.find (*it);
+        if (entry->second.sample.use_count() > 1)
+            continue;
+
+        ++it;
+        erase (entry);
+        ++stats_.evictions;
+    }
+}
+
+void SampleCache::setMaxSampleBytes (size_t bytes)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    maxSampleBytes_ = bytes;
+}
+
+size_t SampleCache::getMaxSampleBytes() const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return maxSampleBytes_;
+}
+
+void SampleCache::setMemoryBudget (size_t bytes)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    memoryBudget_ = bytes;
+    evictToBudget();
+}
+
+size_t SampleCache::getMemoryBudget() const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return memoryBudget_;
+}
+
+void SampleCache::clear()
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    entries_.clear();
+    lru_.clear();
+    stats_.residentBytes = 0;
+    stats_.mappedBytes = 0;
+    stats_.numEntries = 0;
+}
+
+SampleCache::Stats SampleCache::getStats() const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return stats_;
+}
+
+} // namespace dc
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "AudioBlock.h"
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dc {
+
+/// A whole audio file held in memory as interleaved float frames.
+///
+/// Immutable once created, so any number of threads (including the audio
+/// thread) may read it without locking. Lifetime is shared: the memory is
+/// released when the cache has evicted it and the last reader drops its
+/// reference.
+class CachedSample
+{
+public:
+    ~CachedSample();
+
+    int getNumChannels() const { return numChannels_; }
+    int64_t getNumFrames() const { return numFrames_; }
+    double getSampleRate() const { return sampleRate_; }
+
+    /// Interleaved frames, getNumFrames() * getNumChannels() floats.
+    const float* getData() const { return data_; }
+
+    /// Bytes of memory backing this sample (mapped or decoded).
+    size_t getResidentBytes() const { return residentBytes_; }
+
+    /// True if the frames are mapped straight from a float WAV file.
+    bool isMapped() const { return mapBase_ != nullptr; }
+
+    /// True if the mapped file has since been cut shorter than the mapping.
+    /// Reading the lost pages would raise SIGBUS, so holders should stop
+    /// reading and acquire() the file again. Always false for decoded
+    /// samples. Calls stat(); not for the audio thread.
+    bool isTruncated() const;
+
+    /// De-interleave numSamples frames starting at startFrame into output.
+    /// Frames outside the file read as silence; a mono sample is copied to
+    /// every output channel. Real-time safe.
+    /// Returns the number of frames that came from the file.
+    int read (AudioBlock& output, int64_t startFrame, int numSamples) const;
+
+private:
+    friend class SampleCache;
+    CachedSample() = default;
+
+    CachedSample (const CachedSample&) = delete;
+    CachedSample& operator= (const CachedSample&) = delete;
+
+    int numChannels_ = 0;
+    int64_t numFrames_ = 0;
+    double sampleRate_ = 0.0;
+    const float* data_ = nullptr;
+    size_t residentBytes_ = 0;
+
+    std::vector<float> decoded_;
+    void* mapBase_ = nullptr;
+    size_t mapLength_ = 0;
+    std::string mapPath_;           // the mapped inode, to spot truncation
+    uint64_t mapDevice_ = 0;
+    uint64_t mapInode_ = 0;
+};
+
+/// Process-wide cache of short audio files, fully loaded into memory.
+///
+/// One-shots, loops and drum hits played from several clips or tracks
+/// share a single copy instead of each streaming through its own ring.
+/// Entries are keyed by path, modification time and sample rate, so an
+/// edited file is reloaded and a file used at another rate is converted
+/// once. 32-bit float WAV files at the requested rate are mmap-ed rather
+/// than decoded.
+///
+/// Entries beyond the memory budget are evicted least recently used
+/// first. Files that can't be cached are not remembered, so asking for
+/// them again re-checks the file. Samples still referenced by a player are never freed under it;
+/// they stay valid until released.
+///
+/// acquire() may block on file I/O and must not be called on the audio
+/// thread. Reading an acquired CachedSample is lock-free.
+class SampleCache
+{
+public:
+    explicit SampleCache (size_t memoryBudgetBytes = defaultMemoryBudgetBytes,
+                          size_t maxSampleBytes = defaultMaxSampleBytes);
+    ~SampleCache();
+
+    SampleCache (const SampleCache&) = delete;
+    SampleCache& operator= (const SampleCache&) = delete;
+
+    /// Process-wide cache used by playback.
+    static SampleCache& getInstance();
+
+    static constexpr size_t defaultMemoryBudgetBytes = 512u * 1024u * 1024u;
+    static constexpr size_t defaultMaxSampleBytes = 16u * 1024u * 1024u;
+
+    /// Load (or find) the file at sampleRate (0 = the file's own rate).
+    /// Returns nullptr if the file can't be read or its in-memory size
+    /// exceeds the per-sample threshold; callers should stream it instead.
+    std::shared_ptr<const CachedSample> acquire (const std::filesystem::path& file,
+                                                 double sampleRate = 0.0);
+
+    /// Largest file, in bytes of float frames at the requested rate,
+    /// that is cached. Applies to files loaded after the call.
+    void setMaxSampleBytes (size_t bytes);
+    size_t getMaxSampleBytes() const;
+
+    /// Total bytes the cache keeps resident. Lowering it evicts at once.
+    void setMemoryBudget (size_t bytes);
+    size_t getMemoryBudget() const;
+
+    /// Drop every entry (samples in use stay valid for their holders).
+    void clear();
+
+    struct Stats
+    {
+        int64_t hits = 0;
+        int64_t misses = 0;             // loaded from disk
+        int64_t uncacheable = 0;        // too large or unreadable
+        int64_t evictions = 0;
+        size_t residentBytes = 0;       // held by the cache
+        size_t mappedBytes = 0;         // part of residentBytes that is mmap-ed
+        int numEntries = 0;
+
+        double getHitRate() const
+        {
+            auto total = hits + misses;
+            return total > 0 ? static_cast<double> (hits) / static_cast<double> (total) : 0.0;
+        }
+    };
+
+    Stats getStats() const;
+
+private:
+    struct Entry
+    {
+        std::filesystem::file_time_type modificationTime;
+        std::shared_ptr<const CachedSample> sample;
+        std::list<std::string>::iterator lruPosition;
+    };
+
+    std::shared_ptr<CachedSample> load (const std::filesystem::path& file, double sampleRate,
+                                        size_t maxBytes) const;
+    static std::shared_ptr<CachedSample> mapFloatWav (const std::filesystem::path& file);
+
+    void insert (const std::string& key, Entry entry);
+    void erase (std::unordered_map<std::string, Entry>::iterator it);
+    void evictToBudget();   // requires mutex_ held
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> lru_;    // most recently used at the front
+
+    size_t memoryBudget_;
+    size_t maxSampleBytes_;
+    Stats stats_;
+};
+
+} // namespace dc
@@ -1,4 +1,5 @@
 #include "ThreadedRecorder.h"
+#include "PeakStore.h"
 #include <algorithm>
 #include <cstring>
 
@@ -38,6 +39,8 @@ bool ThreadedRecorder::start (const std::filesystem::path& path,
     if (writer_ == nullptr)
         return false;
 
+    path_ = path;
+    peaks_ = std::make_shared<LivePeaks> (numChannels, sampleRate);
     numChannels_ = numChannels;
     ringCapacity_ = nextPowerOf2 (static_cast<size_t> (requestedBufferSize_));
     ringMask_ = ringCapacity_ - 1;
@@ -126,6 +129,7 @@ void ThreadedRecorder::stop()
             }
 
             writer_->write (chunk.data(), framesToWrite);
+            peaks_->add (chunk.data(), framesToWrite);
             recordedSamples_.fetch_add (framesToWrite, std::memory_order_relaxed);
 
             rp += static_cast<size_t> (framesToWrite);
@@ -137,6 +141,11 @@ void ThreadedRecorder::stop()
 
     writer_->close();
     writer_.reset();
+
+    // The take's peak file comes from what was written, not a rescan
+    peaks_->finish();
+    PeakStore::getInstance().save (path_, *peaks_);
+
     ringBuffer_.clear();
     numChannels_ = 0;
     ringCapacity_ = 0;
@@ -193,6 +202,7 @@ void ThreadedRecorder::writeThreadFunc()
         }
 
         writer_->write (chunk.data(), framesToWrite);
+        peaks_->add (chunk.data(), framesToWrite);
         recordedSamples_.fetch_add (framesToWrite, std::memory_order_relaxed);
         readPos_.store (rp + static_cast<size_t> (framesToWrite), std::memory_order_release);
     }
@@ -2,6 +2,7 @@
 
 #include "AudioBlock.h"
 #include "AudioFileWriter.h"
+#include "LivePeaks.h"
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
@@ -53,12 +54,18 @@ public:
     /// Returns the total number of sample frames written to disk so far.
     int64_t getRecordedSampleCount() const;
 
+    /// Waveform peaks of the take, growing as it is written. stop()
+    /// completes them and stores them as the file's peak file.
+    std::shared_ptr<LivePeaks> getPeaks() const { return peaks_; }
+
 private:
     static size_t nextPowerOf2 (size_t v);
 
     void writeThreadFunc();
 
     std::unique_ptr<AudioFileWriter> writer_;
+    std::filesystem::path path_;
+    std::shared_ptr<LivePeaks> peaks_;
 
     // Interleaved ring buffer
     int numChannels_ = 0;
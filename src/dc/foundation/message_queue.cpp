@@ -5,6 +5,11 @@ namespace dc {
 void MessageQueue::post(std::function<void()> fn)
 {
     std::lock_guard<std::mutex> lock(mutex_);
+
+    // Later posts find the message thread already woken
+    if (queue_.empty() && wake_)
+        wake_();
+
     queue_.push_back(std::move(fn));
 }
 
@@ -27,4 +32,10 @@ size_t MessageQueue::pending() const
     return queue_.size();
 }
 
+void MessageQueue::setWakeCallback(std::function<void()> fn)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    wake_ = std::move(fn);
+}
+
 } // namespace dc
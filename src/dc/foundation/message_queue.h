@@ -19,8 +19,15 @@ public:
     /// Number of pending callbacks
     size_t pending() const;
 
+    /// Called from post() when the queue goes from empty to non-empty, so a
+    /// message thread blocked waiting for events can be woken. Runs on the
+    /// posting thread with the queue locked, so it must be quick and must
+    /// not post.
+    void setWakeCallback(std::function<void()> fn);
+
 private:
     mutable std::mutex mutex_;
+    std::function<void()> wake_;
     std::vector<std::function<void()>> queue_;
     std::vector<std::function<void()>> processing_;  // swap buffer
 };
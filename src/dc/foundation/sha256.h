@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace dc {
+
+/// Incremental SHA-256 (FIPS 180-4).
+class Sha256
+{
+public:
+    using Digest = std::array<uint8_t, 32>;
+
+    Sha256();
+
+    void update(const void* data, size_t size);
+    void update(std::string_view data) { update(data.data(), data.size()); }
+
+    /// Finish and return the digest. The hasher is reset afterwards.
+    Digest finish();
+
+    static std::string toHex(const Digest& digest);
+
+private:
+    void reset();
+    void processBlock(const uint8_t* block);
+
+    std::array<uint32_t, 8> state_;
+    std::array<uint8_t, 64> buffer_;
+    size_t bufferSize_ = 0;
+    uint64_t totalBytes_ = 0;
+};
+
+/// Hex SHA-256 of a string.
+std::string sha256Hex(std::string_view data);
+
+/// Hex SHA-256 of a file's contents, or an empty string if it can't be read.
+std::string sha256HexOfFile(const std::filesystem::path& path);
+
+} // namespace dc
@@ -0,0 +1,595 @@
+#include "dc/midi/MidiFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <thread>
+
+namespace {
+
+constexpr uint8_t kMetaEvent      = 0xFF;
+constexpr uint8_t kSysExStart     = 0xF0;
+constexpr uint8_t kSysExEscape    = 0xF7;
+constexpr uint8_t kMetaTrackName  = 0x03;
+constexpr uint8_t kMetaEndOfTrack = 0x2F;
+constexpr uint8_t kMetaTempo      = 0x51;
+constexpr uint8_t kMetaTimeSig    = 0x58;
+
+uint32_t readUInt32BE(const uint8_t* p)
+{
+    return (static_cast<uint32_t>(p[0]) << 24) |
+           (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) |
+           static_cast<uint32_t>(p[3]);
+}
+
+uint16_t readUInt16BE(const uint8_t* p)
+{
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+/// Read a variable-length quantity. Returns false on truncation or overlong encoding.
+bool readVarLen(const uint8_t*& p, const uint8_t* end, uint32_t& value)
+{
+    value = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        if (p >= end)
+            return false;
+
+        uint8_t b = *p++;
+        value = (value << 7) | (b & 0x7F);
+        if ((b & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+void writeVarLen(std::vector<uint8_t>& out, uint32_t value)
+{
+    uint8_t bytes[4];
+    int n = 0;
+    bytes[n++] = static_cast<uint8_t>(value & 0x7F);
+    while ((value >>= 7) != 0 && n < 4)
+        bytes[n++] = static_cast<uint8_t>((value & 0x7F) | 0x80);
+
+    while (n > 0)
+        out.push_back(bytes[--n]);
+}
+
+void writeUInt32BE(std::vector<uint8_t>& out, uint32_t v)
+{
+    out.push_back(static_cast<uint8_t>(v >> 24));
+    out.push_back(static_cast<uint8_t>(v >> 16));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+void writeUInt16BE(std::vector<uint8_t>& out, uint16_t v)
+{
+    out.push_back(static_cast<uint8_t>(v >> 8));
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+/// Number of data bytes following a channel status byte
+int channelDataLength(uint8_t status)
+{
+    uint8_t type = status & 0xF0;
+    return (type == 0xC0 || type == 0xD0) ? 1 : 2;
+}
+
+/// Number of data bytes following a system common or real-time status
+/// (0xF1-0xFE). These don't belong in a file and are skipped.
+int systemDataLength(uint8_t status)
+{
+    switch (status)
+    {
+        case 0xF1: case 0xF3: return 1;   // MTC quarter frame, song select
+        case 0xF2:            return 2;   // song position
+        default:              return 0;
+    }
+}
+
+struct TrackChunk
+{
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+struct ParsedTrack
+{
+    dc::MidiFile::Track track;
+    std::vector<dc::MidiFile::TempoChange> tempoChanges;
+    std::vector<dc::MidiFile::TimeSignatureChange> timeSigChanges;
+};
+
+/// Decode one MTrk chunk. Malformed data ends the track early rather than
+/// failing the whole file — partially damaged files still import.
+void parseTrack(const TrackChunk& chunk, double ticksPerBeat, ParsedTrack& out)
+{
+    const uint8_t* p = chunk.data;
+    const uint8_t* end = chunk.data + chunk.size;
+
+    std::vector<dc::TimedMidiEvent> events;
+    events.reserve(chunk.size / 3);
+
+    uint64_t tick = 0;
+    uint8_t runningStatus = 0;
+
+    while (p < end)
+    {
+        uint32_t delta;
+        if (!readVarLen(p, end, delta) || p >= end)
+            break;
+
+        tick += delta;
+        const double timeInBeats = static_cast<double>(tick) / ticksPerBeat;
+        const uint8_t first = *p;
+
+        if (first == kMetaEvent)
+        {
+            if (end - p < 2)
+                break;
+
+            uint8_t type = p[1];
+            p += 2;
+
+            uint32_t len;
+            if (!readVarLen(p, end, len) || static_cast<size_t>(end - p) < len)
+                break;
+
+            const uint8_t* d = p;
+            p += len;
+            runningStatus = 0;   // meta events cancel running status
+
+            if (type == kMetaEndOfTrack)
+                break;
+
+            if (type == kMetaTempo && len >= 3)
+            {
+                uint32_t usPerBeat = (static_cast<uint32_t>(d[0]) << 16) |
+                                     (static_cast<uint32_t>(d[1]) << 8) | d[2];
+                if (usPerBeat > 0)
+                    out.tempoChanges.push_back({timeInBeats, 60000000.0 / usPerBeat});
+            }
+            else if (type == kMetaTimeSig && len >= 2)
+            {
+                int denominator = 1 << std::min<int>(d[1], 6);
+                out.timeSigChanges.push_back({timeInBeats, std::max<int>(1, d[0]), denominator});
+            }
+            else if (type == kMetaTrackName && out.track.name.empty())
+            {
+                out.track.name.assign(reinterpret_cast<const char*>(d), len);
+            }
+        }
+        else if (first == kSysExStart || first == kSysExEscape)
+        {
+            ++p;
+            uint32_t len;
+            if (!readVarLen(p, end, len) || static_cast<size_t>(end - p) < len)
+                break;
+
+            if (first == kSysExStart)
+            {
+                std::vector<uint8_t> bytes;
+                bytes.reserve(len + 1);
+                bytes.push_back(kSysExStart);
+                bytes.insert(bytes.end(), p, p + len);
+
+                dc::TimedMidiEvent evt;
+                evt.timeInBeats = timeInBeats;
+                evt.message = dc::MidiMessage(bytes.data(), static_cast<int>(bytes.size()));
+                events.push_back(std::move(evt));
+            }
+
+            p += len;
+            runningStatus = 0;   // so do sysex events
+        }
+        else if (first > kSysExStart)
+        {
+            // System common and real-time bytes: stray in a file, so skip
+            // them. Common messages cancel running status.
+            ++p;
+            int dataLen = systemDataLength(first);
+            if (end - p < dataLen)
+                break;
+
+            p += dataLen;
+            if (first < 0xF8)
+                runningStatus = 0;
+        }
+        else
+        {
+            uint8_t status;
+            if (first & 0x80)
+            {
+                status = first;
+                runningStatus = status;
+                ++p;
+            }
+            else
+            {
+                status = runningStatus;
+                if (status == 0)
+                    break;  // data byte with no running status
+            }
+
+            int dataLen = channelDataLength(status);
+            if (end - p < dataLen)
+                break;
+
+            uint8_t d1 = p[0];
+            uint8_t d2 = dataLen > 1 ? p[1] : 0;
+            p += dataLen;
+
+            dc::TimedMidiEvent evt;
+            evt.timeInBeats = timeInBeats;
+            evt.message = dc::MidiMessage(status, d1, d2);
+            events.push_back(std::move(evt));
+        }
+    }
+
+    // Delta times are non-negative, so events are already in time order
+    out.track.sequence.addEvents(std::move(events));
+    out.track.sequence.updateMatchedPairs();
+}
+
+/// SMPTE ticks are absolute time and were parsed as beats at 120 bpm.
+/// Re-time everything through the file's own tempo events so the beat
+/// grid follows them; 120 bpm holds before the first one.
+void applySmpteTempoMap(std::vector<ParsedTrack>& parsed)
+{
+    std::vector<dc::MidiFile::TempoChange> tempos;
+    for (const auto& p : parsed)
+        tempos.insert(tempos.end(), p.tempoChanges.begin(), p.tempoChanges.end());
+
+    if (tempos.empty())
+        return;
+
+    std::stable_sort(tempos.begin(), tempos.end(),
+        [](const auto& a, const auto& b) { return a.timeInBeats < b.timeInBeats; });
+
+    // Beat position of each tempo change
+    std::vector<double> beatsAt(tempos.size());
+    double prevTime = 0.0;
+    double prevBeats = 0.0;
+    double prevBpm = 120.0;
+
+    for (size_t i = 0; i < tempos.size(); ++i)
+    {
+        beatsAt[i] = prevBeats + (tempos[i].timeInBeats - prevTime) * prevBpm / 120.0;
+        prevTime = tempos[i].timeInBeats;
+        prevBeats = beatsAt[i];
+        prevBpm = tempos[i].bpm;
+    }
+
+    auto toBeats = [&](double time)
+    {
+        auto it = std::upper_bound(tempos.begin(), tempos.end(), time,
+            [](double t, const dc::MidiFile::TempoChange& c) { return t < c.timeInBeats; });
+        if (it == tempos.begin())
+            return time;
+
+        auto i = static_cast<size_t>(it - tempos.begin()) - 1;
+        return beatsAt[i] + (time - tempos[i].timeInBeats) * tempos[i].bpm / 120.0;
+    };
+
+    // The mapping is monotonic, so event order and note pairs hold
+    for (auto& p : parsed)
+    {
+        for (auto& tc : p.tempoChanges)
+            tc.timeInBeats = toBeats(tc.timeInBeats);
+        for (auto& ts : p.timeSigChanges)
+            ts.timeInBeats = toBeats(ts.timeInBeats);
+
+        auto& seq = p.track.sequence;
+        for (int i = 0; i < seq.getNumEvents(); ++i)
+            seq.getEvent(i).timeInBeats = toBeats(seq.getEvent(i).timeInBeats);
+    }
+}
+
+void appendChannelEvents(std::vector<uint8_t>& out, const dc::MidiSequence& seq,
+                         double ticksPerBeat, uint64_t& lastTick)
+{
+    uint8_t runningStatus = 0;
+
+    for (const auto& evt : seq.getEvents())
+    {
+        const auto& msg = evt.message;
+        const uint8_t* raw = msg.getRawData();
+        const int size = msg.getRawDataSize();
+
+        if (size <= 0)
+            continue;
+
+        auto tick = static_cast<uint64_t>(std::llround(std::max(0.0, evt.timeInBeats) * ticksPerBeat));
+        uint64_t delta = tick > lastTick ? tick - lastTick : 0;
+
+        if (raw[0] == kSysExStart)
+        {
+            writeVarLen(out, static_cast<uint32_t>(delta));
+            out.push_back(kSysExStart);
+            writeVarLen(out, static_cast<uint32_t>(size - 1));
+            out.insert(out.end(), raw + 1, raw + size);
+            runningStatus = 0;
+        }
+        else if (raw[0] >= 0x80 && raw[0] < 0xF0)
+        {
+            int dataLen = channelDataLength(raw[0]);
+            writeVarLen(out, static_cast<uint32_t>(delta));
+
+            if (raw[0] != runningStatus)
+            {
+                out.push_back(raw[0]);
+                runningStatus = raw[0];
+            }
+
+            for (int i = 1; i <= dataLen; ++i)
+                out.push_back(i < size ? static_cast<uint8_t>(raw[i] & 0x7F) : 0);
+        }
+        else
+        {
+            continue;  // system common / realtime messages are not stored in SMF
+        }
+
+        lastTick = std::max(lastTick, tick);
+    }
+}
+
+void appendMeta(std::vector<uint8_t>& out, uint32_t delta, uint8_t type,
+                const uint8_t* data, uint32_t len)
+{
+    writeVarLen(out, delta);
+    out.push_back(kMetaEvent);
+    out.push_back(type);
+    writeVarLen(out, len);
+    out.insert(out.end(), data, data + len);
+}
+
+void appendTrackChunk(std::vector<uint8_t>& file, const std::vector<uint8_t>& body)
+{
+    file.insert(file.end(), {'M', 'T', 'r', 'k'});
+    writeUInt32BE(file, static_cast<uint32_t>(body.size()));
+    file.insert(file.end(), body.begin(), body.end());
+}
+
+} // anonymous namespace
+
+namespace dc {
+
+std::unique_ptr<MidiFile> MidiFile::read(const std::filesystem::path& path, int maxThreads)
+{
+    std::error_code ec;
+    auto fileSize = std::filesystem::file_size(path, ec);
+    if (ec)
+        return nullptr;
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return nullptr;
+
+    std::vector<uint8_t> bytes(static_cast<size_t>(fileSize));
+    in.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (static_cast<size_t>(in.gcount()) != bytes.size())
+        return nullptr;
+
+    return readFromMemory(bytes.data(), bytes.size(), maxThreads);
+}
+
+std::unique_ptr<MidiFile> MidiFile::readFromMemory(const uint8_t* data, size_t size, int maxThreads)
+{
+    if (data == nullptr || size < 14 || std::memcmp(data, "MThd", 4) != 0)
+        return nullptr;
+
+    uint32_t headerLen = readUInt32BE(data + 4);
+    if (headerLen < 6 || headerLen > size - 8)
+        return nullptr;
+
+    uint16_t format = readUInt16BE(data + 8);
+    uint16_t division = readUInt16BE(data + 12);
+    if (format > 2 || division == 0)
+        return nullptr;
+
+    auto file = std::make_unique<MidiFile>();
+    double ticksPerBeat;
+    const bool smpte = (division & 0x8000) != 0;
+
+    if (smpte)
+    {
+        // SMPTE timing: ticks are absolute time. Parse at 120 bpm, then
+        // re-time through the file's tempo events (if any).
+        int fps = -static_cast<int8_t>(division >> 8);
+        int ticksPerFrame = division & 0xFF;
+        if (fps <= 0 || ticksPerFrame == 0)
+            return nullptr;
+
+        ticksPerBeat = fps * ticksPerFrame * 0.5;
+        file->ticksPerQuarterNote_ = static_cast<int>(ticksPerBeat);
+    }
+    else
+    {
+        ticksPerBeat = division;
+        file->ticksPerQuarterNote_ = division;
+    }
+
+    // Locate the track chunks (cheap: only chunk headers are touched)
+    std::vector<TrackChunk> chunks;
+    size_t pos = 8 + headerLen;
+
+    while (pos + 8 <= size)
+    {
+        uint32_t chunkLen = readUInt32BE(data + pos + 4);
+        size_t available = std::min<size_t>(chunkLen, size - pos - 8);
+
+        if (std::memcmp(data + pos, "MTrk", 4) == 0)
+            chunks.push_back({data + pos + 8, available});
+
+        pos += 8 + available;
+    }
+
+    // Decode tracks in parallel — they are independent once split
+    std::vector<ParsedTrack> parsed(chunks.size());
+
+    int numThreads = maxThreads > 0 ? maxThreads
+                                    : static_cast<int>(std::thread::hardware_concurrency());
+    numThreads = std::clamp(numThreads, 1, std::max(1, static_cast<int>(chunks.size())));
+
+    std::atomic<size_t> nextChunk{0};
+    auto worker = [&]
+    {
+        for (size_t i = nextChunk++; i < chunks.size(); i = nextChunk++)
+            parseTrack(chunks[i], ticksPerBeat, parsed[i]);
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(static_cast<size_t>(numThreads - 1));
+    for (int t = 1; t < numThreads; ++t)
+        threads.emplace_back(worker);
+
+    worker();
+
+    for (auto& t : threads)
+        t.join();
+
+    if (smpte)
+        applySmpteTempoMap(parsed);
+
+    for (auto& p : parsed)
+    {
+        for (auto& tc : p.tempoChanges)
+            file->addTempoChange(tc.timeInBeats, tc.bpm);
+        for (auto& ts : p.timeSigChanges)
+            file->addTimeSignatureChange(ts.timeInBeats, ts.numerator, ts.denominator);
+
+        file->tracks_.push_back(std::move(p.track));
+    }
+
+    return file;
+}
+
+bool MidiFile::write(const std::filesystem::path& path) const
+{
+    auto bytes = writeToMemory();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        return false;
+
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(out);
+}
+
+std::vector<uint8_t> MidiFile::writeToMemory() const
+{
+    const double ticksPerBeat = ticksPerQuarterNote_;
+    std::vector<uint8_t> file;
+
+    // Header
+    file.insert(file.end(), {'M', 'T', 'h', 'd'});
+    writeUInt32BE(file, 6);
+    writeUInt16BE(file, 1);
+    writeUInt16BE(file, static_cast<uint16_t>(tracks_.size() + 1));
+    writeUInt16BE(file, static_cast<uint16_t>(std::clamp(ticksPerQuarterNote_, 1, 0x7FFF)));
+
+    // Conductor track: tempo + time signature, merged in time order
+    {
+        std::vector<uint8_t> body;
+        uint64_t lastTick = 0;
+        size_t ti = 0, si = 0;
+
+        while (ti < tempoChanges_.size() || si < timeSigChanges_.size())
+        {
+            bool takeTempo = si >= timeSigChanges_.size()
+                || (ti < tempoChanges_.size()
+                    && tempoChanges_[ti].timeInBeats <= timeSigChanges_[si].timeInBeats);
+
+            double time = takeTempo ? tempoChanges_[ti].timeInBeats : timeSigChanges_[si].timeInBeats;
+            auto tick = static_cast<uint64_t>(std::llround(std::max(0.0, time) * ticksPerBeat));
+            auto delta = static_cast<uint32_t>(tick > lastTick ? tick - lastTick : 0);
+            lastTick = std::max(lastTick, tick);
+
+            if (takeTempo)
+            {
+                auto us = static_cast<uint32_t>(std::clamp(
+                    std::llround(60000000.0 / tempoChanges_[ti].bpm), 1LL, 0xFFFFFFLL));
+                uint8_t d[3] = {static_cast<uint8_t>(us >> 16), static_cast<uint8_t>(us >> 8),
+                                static_cast<uint8_t>(us)};
+                appendMeta(body, delta, kMetaTempo, d, 3);
+                ++ti;
+            }
+            else
+            {
+                const auto& ts = timeSigChanges_[si];
+                uint8_t log2Den = 0;
+                while ((1 << log2Den) < ts.denominator && log2Den < 6)
+                    ++log2Den;
+                uint8_t d[4] = {static_cast<uint8_t>(ts.numerator), log2Den, 24, 8};
+                appendMeta(body, delta, kMetaTimeSig, d, 4);
+                ++si;
+            }
+        }
+
+        appendMeta(body, 0, kMetaEndOfTrack, nullptr, 0);
+        appendTrackChunk(file, body);
+    }
+
+    // One chunk per track
+    for (const auto& track : tracks_)
+    {
+        std::vector<uint8_t> body;
+        body.reserve(static_cast<size_t>(track.sequence.getNumEvents()) * 4 + 32);
+
+        if (!track.name.empty())
+            appendMeta(body, 0, kMetaTrackName,
+                       reinterpret_cast<const uint8_t*>(track.name.data()),
+                       static_cast<uint32_t>(track.name.size()));
+
+        uint64_t lastTick = 0;
+        appendChannelEvents(body, track.sequence, ticksPerBeat, lastTick);
+        appendMeta(body, 0, kMetaEndOfTrack, nullptr, 0);
+        appendTrackChunk(file, body);
+    }
+
+    return file;
+}
+
+void MidiFile::addTempoChange(double timeInBeats, double bpm)
+{
+    TempoChange tc{timeInBeats, bpm};
+    auto it = std::upper_bound(tempoChanges_.begin(), tempoChanges_.end(), timeInBeats,
+        [](double t, const TempoChange& c) { return t < c.timeInBeats; });
+    tempoChanges_.insert(it, tc);
+}
+
+void MidiFile::addTimeSignatureChange(double timeInBeats, int numerator, int denominator)
+{
+    TimeSignatureChange ts{timeInBeats, numerator, denominator};
+    auto it = std::upper_bound(timeSigChanges_.begin(), timeSigChanges_.end(), timeInBeats,
+        [](double t, const TimeSignatureChange& c) { return t < c.timeInBeats; });
+    timeSigChanges_.insert(it, ts);
+}
+
+double MidiFile::getLengthInBeats() const
+{
+    double length = 0.0;
+    for (const auto& track : tracks_)
+    {
+        const auto& events = track.sequence.getEvents();
+        if (!events.empty())
+            length = std::max(length, events.back().timeInBeats);
+    }
+    return length;
+}
+
+int MidiFile::getTotalNumEvents() const
+{
+    int total = 0;
+    for (const auto& track : tracks_)
+        total += track.sequence.getNumEvents();
+    return total;
+}
+
+} // namespace dc
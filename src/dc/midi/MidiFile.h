@@ -0,0 +1,93 @@
+#pragma once
+
+#include "dc/midi/MidiSequence.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dc {
+
+/// Standard MIDI File (SMF type 0 and 1) reader and writer.
+///
+/// Reading loads the file in one pass, locates every MTrk chunk, then
+/// decodes the tracks in parallel straight into MidiSequence objects
+/// (times in quarter-note beats). Tempo and time-signature meta events
+/// are collected separately so callers can map them into their tempo map.
+///
+/// Writing produces a type 1 file: a conductor track holding the tempo
+/// and time-signature changes, followed by one MTrk per Track.
+class MidiFile
+{
+public:
+    struct TempoChange
+    {
+        double timeInBeats = 0.0;
+        double bpm = 120.0;
+    };
+
+    struct TimeSignatureChange
+    {
+        double timeInBeats = 0.0;
+        int numerator = 4;
+        int denominator = 4;
+    };
+
+    struct Track
+    {
+        std::string name;
+        MidiSequence sequence;
+    };
+
+    MidiFile() = default;
+
+    /// Parse a file from disk. Returns nullptr on I/O or format error.
+    /// @param maxThreads  Upper bound on parser threads (0 = hardware concurrency).
+    static std::unique_ptr<MidiFile> read(const std::filesystem::path& path,
+                                          int maxThreads = 0);
+
+    /// Parse an in-memory SMF image. Returns nullptr on format error.
+    static std::unique_ptr<MidiFile> readFromMemory(const uint8_t* data, size_t size,
+                                                    int maxThreads = 0);
+
+    /// Write as SMF type 1. Returns false on I/O error.
+    bool write(const std::filesystem::path& path) const;
+
+    /// Encode as an SMF type 1 image.
+    std::vector<uint8_t> writeToMemory() const;
+
+    // --- Contents ---
+
+    int getTicksPerQuarterNote() const { return ticksPerQuarterNote_; }
+    void setTicksPerQuarterNote(int ticks) { ticksPerQuarterNote_ = ticks; }
+
+    int getNumTracks() const { return static_cast<int>(tracks_.size()); }
+    const Track& getTrack(int index) const { return tracks_[static_cast<size_t>(index)]; }
+    Track& getTrack(int index) { return tracks_[static_cast<size_t>(index)]; }
+    void addTrack(Track track) { tracks_.push_back(std::move(track)); }
+
+    /// Tempo changes sorted by time. Empty if the file had none (120 bpm implied).
+    const std::vector<TempoChange>& getTempoChanges() const { return tempoChanges_; }
+    void addTempoChange(double timeInBeats, double bpm);
+
+    /// Time-signature changes sorted by time. Empty if the file had none (4/4 implied).
+    const std::vector<TimeSignatureChange>& getTimeSignatureChanges() const { return timeSigChanges_; }
+    void addTimeSignatureChange(double timeInBeats, int numerator, int denominator);
+
+    /// Time of the last event across all tracks, in beats
+    double getLengthInBeats() const;
+
+    /// Total number of channel/sysex events across all tracks
+    int getTotalNumEvents() const;
+
+private:
+    int ticksPerQuarterNote_ = 960;
+    std::vector<Track> tracks_;
+    std::vector<TempoChange> tempoChanges_;
+    std::vector<TimeSignatureChange> timeSigChanges_;
+};
+
+} // namespace dc
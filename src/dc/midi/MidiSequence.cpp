@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <iterator>
 
 namespace {
 
@@ -46,6 +47,31 @@ void MidiSequence::addEvent(const MidiMessage& msg, double timeInBeats)
     events_.insert(it, std::move(evt));
 }
 
+void MidiSequence::addEvents(std::vector<TimedMidiEvent> events)
+{
+    auto byTime = [](const TimedMidiEvent& a, const TimedMidiEvent& b)
+    {
+        return a.timeInBeats < b.timeInBeats;
+    };
+
+    if (!std::is_sorted(events.begin(), events.end(), byTime))
+        std::stable_sort(events.begin(), events.end(), byTime);
+
+    if (events_.empty())
+    {
+        events_ = std::move(events);
+        return;
+    }
+
+    auto oldSize = static_cast<std::ptrdiff_t>(events_.size());
+    events_.reserve(events_.size() + events.size());
+    std::move(events.begin(), events.end(), std::back_inserter(events_));
+
+    // New events land after existing events with equal timestamps, like addEvent
+    if (events_[static_cast<size_t>(oldSize)].timeInBeats < events_[static_cast<size_t>(oldSize - 1)].timeInBeats)
+        std::inplace_merge(events_.begin(), events_.begin() + oldSize, events_.end(), byTime);
+}
+
 void MidiSequence::removeEvent(int index)
 {
     if (index >= 0 && index < static_cast<int>(events_.size()))
@@ -83,31 +109,45 @@ void MidiSequence::sort()
 
 void MidiSequence::updateMatchedPairs()
 {
-    // Reset all matched pair indices
-    for (auto& evt : events_)
-        evt.matchedPairIndex = -1;
+    // One FIFO of pending noteOns per (channel, note), threaded through
+    // `next` so the whole pass is O(n) with no per-key allocation.
+    constexpr int kNumKeys = 16 * 128;
+    int head[kNumKeys];
+    int tail[kNumKeys];
+    std::fill(std::begin(head), std::end(head), -1);
+    std::fill(std::begin(tail), std::end(tail), -1);
+
+    std::vector<int> next(events_.size(), -1);
 
-    // For each noteOn, find the next matching noteOff
     for (int i = 0; i < static_cast<int>(events_.size()); ++i)
     {
-        if (!events_[static_cast<size_t>(i)].message.isNoteOn())
+        auto& evt = events_[static_cast<size_t>(i)];
+        evt.matchedPairIndex = -1;
+
+        const auto& msg = evt.message;
+        bool on = msg.isNoteOn();
+        if (!on && !msg.isNoteOff())
             continue;
 
-        int note = events_[static_cast<size_t>(i)].message.getNoteNumber();
-        int chan = events_[static_cast<size_t>(i)].message.getChannel();
+        int key = ((msg.getChannel() - 1) & 15) * 128 + (msg.getNoteNumber() & 127);
 
-        for (int j = i + 1; j < static_cast<int>(events_.size()); ++j)
+        if (on)
         {
-            auto& candidate = events_[static_cast<size_t>(j)];
-            if (candidate.message.isNoteOff()
-                && candidate.message.getNoteNumber() == note
-                && candidate.message.getChannel() == chan
-                && candidate.matchedPairIndex == -1)
-            {
-                events_[static_cast<size_t>(i)].matchedPairIndex = j;
-                candidate.matchedPairIndex = i;
-                break;
-            }
+            if (tail[key] >= 0)
+                next[static_cast<size_t>(tail[key])] = i;
+            else
+                head[key] = i;
+            tail[key] = i;
+        }
+        else if (head[key] >= 0)
+        {
+            int onIndex = head[key];
+            head[key] = next[static_cast<size_t>(onIndex)];
+            if (head[key] < 0)
+                tail[key] = -1;
+
+            events_[static_cast<size_t>(onIndex)].matchedPairIndex = i;
+            evt.matchedPairIndex = onIndex;
         }
     }
 }
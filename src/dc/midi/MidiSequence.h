@@ -25,6 +25,11 @@ public:
     /// Add an event (maintains sorted order by timeInBeats)
     void addEvent(const MidiMessage& msg, double timeInBeats);
 
+    /// Add many events at once. The batch is sorted and merged in a single
+    /// pass, so importing N events costs O(N log N) rather than O(N^2).
+    /// Call updateMatchedPairs() afterwards if note pairing is needed.
+    void addEvents(std::vector<TimedMidiEvent> events);
+
     /// Remove an event by index
     void removeEvent(int index);
 
@@ -41,7 +46,9 @@ public:
     /// Sort events by timestamp (called after bulk modifications)
     void sort();
 
-    /// Match noteOn/noteOff pairs (sets matchedPairIndex)
+    /// Match noteOn/noteOff pairs (sets matchedPairIndex).
+    /// Each noteOff pairs with the earliest unmatched noteOn of the same
+    /// channel and note number. Linear in the number of events.
     void updateMatchedPairs();
 
     /// Get events in a time range (for playback).
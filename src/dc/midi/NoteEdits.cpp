@@ -0,0 +1,166 @@
+#include "dc/midi/NoteEdits.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+constexpr double kMinLengthBeats = 1.0 / 256.0;
+
+/// SplitMix64 finaliser: a stateless, well-mixed hash of (seed, index)
+inline uint64_t mix(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/// Uniform in [-1, 1)
+inline double bipolar(uint64_t bits)
+{
+    return static_cast<double>(bits >> 11) * (2.0 / 9007199254740992.0) - 1.0;
+}
+
+} // anonymous namespace
+
+namespace dc {
+
+void NoteArray::reserve(size_t n)
+{
+    startBeats.reserve(n);
+    lengthBeats.reserve(n);
+    noteNumbers.reserve(n);
+    velocities.reserve(n);
+}
+
+void NoteArray::add(int noteNumber, double startBeat, double length, int velocity)
+{
+    startBeats.push_back(startBeat);
+    lengthBeats.push_back(length);
+    noteNumbers.push_back(noteNumber);
+    velocities.push_back(velocity);
+}
+
+void quantizeNotes(NoteArray& notes, const QuantizeSettings& settings)
+{
+    if (settings.gridBeats <= 0.0)
+        return;
+
+    const size_t n = notes.size();
+    const double grid = settings.gridBeats;
+    const double invGrid = 1.0 / grid;
+    const double strength = std::clamp(settings.strength, 0.0, 1.0);
+    const double swingOffset = std::clamp(settings.swing, 0.0, 0.99) * grid;
+
+    double* start = notes.startBeats.data();
+    double* length = notes.lengthBeats.data();
+
+    auto target = [=](double beat)
+    {
+        double q = std::nearbyint(beat * invGrid);
+        double odd = q - 2.0 * std::floor(q * 0.5);   // 1 on off-beat grid lines
+        return q * grid + odd * swingOffset;
+    };
+
+    if (settings.quantizeEnds)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            double s = start[i];
+            double e = s + length[i];
+            double ns = s + (target(s) - s) * strength;
+            double ne = e + (target(e) - e) * strength;
+            start[i] = std::max(0.0, ns);
+            length[i] = std::max(kMinLengthBeats, ne - ns);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            double s = start[i];
+            start[i] = std::max(0.0, s + (target(s) - s) * strength);
+        }
+    }
+}
+
+void humanizeNotes(NoteArray& notes, double timingRange, double velocityRange, uint64_t seed)
+{
+    const size_t n = notes.size();
+    double* start = notes.startBeats.data();
+    int32_t* vel = notes.velocities.data();
+
+    const uint64_t base = mix(seed);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint64_t h = mix(base ^ (static_cast<uint64_t>(i) * 2));
+        uint64_t v = mix(base ^ (static_cast<uint64_t>(i) * 2 + 1));
+
+        start[i] = std::max(0.0, start[i] + bipolar(h) * timingRange);
+
+        double newVel = static_cast<double>(vel[i]) + bipolar(v) * velocityRange;
+        vel[i] = static_cast<int32_t>(std::clamp(std::lround(newVel), 1L, 127L));
+    }
+}
+
+void transposeNotes(NoteArray& notes, int semitones)
+{
+    const size_t n = notes.size();
+    int32_t* num = notes.noteNumbers.data();
+
+    for (size_t i = 0; i < n; ++i)
+        num[i] = std::clamp(num[i] + semitones, 0, 127);
+}
+
+void scaleNoteVelocities(NoteArray& notes, double factor, double offset)
+{
+    const size_t n = notes.size();
+    int32_t* vel = notes.velocities.data();
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        double v = std::nearbyint(static_cast<double>(vel[i]) * factor + offset);
+        vel[i] = static_cast<int32_t>(std::clamp(v, 1.0, 127.0));
+    }
+}
+
+void legatoNotes(NoteArray& notes, double gapBeats)
+{
+    const size_t n = notes.size();
+    if (n < 2)
+        return;
+
+    // Visit notes in start order without reordering the arrays
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+    {
+        return notes.startBeats[a] < notes.startBeats[b];
+    });
+
+    // Walk backwards tracking the nearest strictly-later start, so chords
+    // (equal starts) all extend to the same next onset.
+    double nextStart = -1.0;
+    size_t k = n;
+    while (k > 0)
+    {
+        size_t groupEnd = k;
+        double s = notes.startBeats[order[k - 1]];
+        while (k > 0 && notes.startBeats[order[k - 1]] == s)
+            --k;
+
+        if (nextStart >= 0.0)
+        {
+            double len = std::max(kMinLengthBeats, nextStart - s - gapBeats);
+            for (size_t j = k; j < groupEnd; ++j)
+                notes.lengthBeats[order[j]] = len;
+        }
+
+        nextStart = s;
+    }
+}
+
+} // namespace dc
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dc {
+
+/// Structure-of-arrays note selection for bulk editing.
+///
+/// Each kernel below makes one branch-light pass over contiguous arrays so
+/// the compiler can vectorise it. Callers gather the selected notes into a
+/// NoteArray, run one or more kernels, then write the result back in one go.
+struct NoteArray
+{
+    std::vector<double> startBeats;
+    std::vector<double> lengthBeats;
+    std::vector<int32_t> noteNumbers;  // 0..127
+    std::vector<int32_t> velocities;   // 1..127
+
+    size_t size() const { return startBeats.size(); }
+    bool empty() const { return startBeats.empty(); }
+
+    void reserve(size_t n);
+    void add(int noteNumber, double startBeat, double lengthBeats, int velocity);
+};
+
+struct QuantizeSettings
+{
+    double gridBeats = 0.25;
+
+    /// 0 = leave untouched, 1 = snap fully to the grid
+    double strength = 1.0;
+
+    /// Delay applied to every odd grid line, as a fraction of one grid step
+    /// (0 = straight, 1/3 = triplet feel)
+    double swing = 0.0;
+
+    /// Also snap note ends (lengths follow the quantized end point)
+    bool quantizeEnds = false;
+};
+
+/// Move note starts (and optionally ends) towards the swung grid
+void quantizeNotes(NoteArray& notes, const QuantizeSettings& settings);
+
+/// Add uniform random offsets of up to +/- timingRange beats and
+/// +/- velocityRange. The offsets are a pure function of (seed, index),
+/// so the same seed reproduces the same result.
+void humanizeNotes(NoteArray& notes, double timingRange, double velocityRange, uint64_t seed);
+
+/// Shift pitches, clamped to 0..127
+void transposeNotes(NoteArray& notes, int semitones);
+
+/// velocity = velocity * factor + offset, clamped to 1..127
+void scaleNoteVelocities(NoteArray& notes, double factor, double offset = 0.0);
+
+/// Extend each note to the next later note start in the selection, minus
+/// gapBeats. The last note(s) keep their length.
+void legatoNotes(NoteArray& notes, double gapBeats = 0.0);
+
+} // namespace dc
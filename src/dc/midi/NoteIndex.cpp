@@ -0,0 +1,207 @@
+#include "dc/midi/NoteIndex.h"
+
+#include <algorithm>
+
+namespace dc {
+
+struct NoteIndex::TreeNode
+{
+    const Note* note = nullptr;     // owned by notes_
+    double startBeat = 0.0;
+    double endBeat = 0.0;
+    double maxEnd = 0.0;            // latest end beat in this subtree
+    int id = -1;
+    uint32_t priority = 0;
+    TreePtr left, right;
+
+    bool before(double start, int otherId) const
+    {
+        return startBeat < start || (startBeat == start && id < otherId);
+    }
+};
+
+NoteIndex::NoteIndex() = default;
+NoteIndex::~NoteIndex() = default;
+NoteIndex::NoteIndex(NoteIndex&&) noexcept = default;
+NoteIndex& NoteIndex::operator=(NoteIndex&&) noexcept = default;
+
+int NoteIndex::pitchOf(int noteNumber)
+{
+    return std::clamp(noteNumber, 0, numPitches - 1);
+}
+
+void NoteIndex::clear()
+{
+    notes_.clear();
+    for (auto& pitch : byPitch_)
+        pitch.reset();
+}
+
+void NoteIndex::insert(const Note& note)
+{
+    remove(note.id);
+
+    auto& stored = notes_[note.id];
+    stored = note;
+
+    auto node = std::make_unique<TreeNode>();
+    node->note = &stored;
+    node->startBeat = note.startBeat;
+    node->endBeat = note.endBeat();
+    node->maxEnd = node->endBeat;
+    node->id = note.id;
+
+    // xorshift32
+    seed_ ^= seed_ << 13;
+    seed_ ^= seed_ >> 17;
+    seed_ ^= seed_ << 5;
+    node->priority = seed_;
+
+    auto& root = byPitch_[static_cast<size_t>(pitchOf(note.noteNumber))];
+    TreePtr before, rest;
+    split(std::move(root), note.startBeat, note.id, before, rest);
+    root = merge(merge(std::move(before), std::move(node)), std::move(rest));
+}
+
+bool NoteIndex::remove(int id)
+{
+    auto it = notes_.find(id);
+    if (it == notes_.end())
+        return false;
+
+    auto& root = byPitch_[static_cast<size_t>(pitchOf(it->second.noteNumber))];
+    erase(root, it->second.startBeat, id);
+    notes_.erase(it);
+    return true;
+}
+
+const NoteIndex::Note* NoteIndex::find(int id) const
+{
+    auto it = notes_.find(id);
+    return it != notes_.end() ? &it->second : nullptr;
+}
+
+void NoteIndex::query(double startBeat, double endBeat, int lowNote, int highNote,
+                      std::vector<const Note*>& result) const
+{
+    for (int p = pitchOf(lowNote); p <= pitchOf(highNote); ++p)
+        collect(byPitch_[static_cast<size_t>(p)].get(), startBeat, endBeat, result);
+}
+
+const NoteIndex::Note* NoteIndex::noteAt(int noteNumber, double beat) const
+{
+    if (noteNumber < 0 || noteNumber >= numPitches)
+        return nullptr;
+
+    auto* node = latestAt(byPitch_[static_cast<size_t>(noteNumber)].get(), beat);
+    return node != nullptr ? node->note : nullptr;
+}
+
+// --- Treap ---
+
+void NoteIndex::update(TreeNode& node)
+{
+    node.maxEnd = node.endBeat;
+    if (node.left)
+        node.maxEnd = std::max(node.maxEnd, node.left->maxEnd);
+    if (node.right)
+        node.maxEnd = std::max(node.maxEnd, node.right->maxEnd);
+}
+
+void NoteIndex::split(TreePtr tree, double startBeat, int id, TreePtr& before, TreePtr& rest)
+{
+    if (! tree)
+    {
+        before.reset();
+        rest.reset();
+        return;
+    }
+
+    if (tree->before(startBeat, id))
+    {
+        split(std::move(tree->right), startBeat, id, tree->right, rest);
+        update(*tree);
+        before = std::move(tree);
+    }
+    else
+    {
+        split(std::move(tree->left), startBeat, id, before, tree->left);
+        update(*tree);
+        rest = std::move(tree);
+    }
+}
+
+NoteIndex::TreePtr NoteIndex::merge(TreePtr before, TreePtr after)
+{
+    if (! before)
+        return after;
+    if (! after)
+        return before;
+
+    if (before->priority > after->priority)
+    {
+        before->right = merge(std::move(before->right), std::move(after));
+        update(*before);
+        return before;
+    }
+
+    after->left = merge(std::move(before), std::move(after->left));
+    update(*after);
+    return after;
+}
+
+bool NoteIndex::erase(TreePtr& tree, double startBeat, int id)
+{
+    if (! tree)
+        return false;
+
+    if (tree->id == id && tree->startBeat == startBeat)
+    {
+        tree = merge(std::move(tree->left), std::move(tree->right));
+        return true;
+    }
+
+    bool erased = tree->before(startBeat, id) ? erase(tree->right, startBeat, id)
+                                              : erase(tree->left, startBeat, id);
+    if (erased)
+        update(*tree);
+    return erased;
+}
+
+void NoteIndex::collect(const TreeNode* node, double startBeat, double endBeat,
+                        std::vector<const Note*>& result)
+{
+    // Nothing below ends late enough to reach the range
+    if (node == nullptr || node->maxEnd < startBeat)
+        return;
+
+    collect(node->left.get(), startBeat, endBeat, result);
+
+    if (node->startBeat >= endBeat)
+        return;
+
+    if (node->endBeat > startBeat || node->startBeat >= startBeat)
+        result.push_back(node->note);
+
+    collect(node->right.get(), startBeat, endBeat, result);
+}
+
+const NoteIndex::TreeNode* NoteIndex::latestAt(const TreeNode* node, double beat)
+{
+    if (node == nullptr || node->maxEnd <= beat)
+        return nullptr;
+
+    if (node->startBeat > beat)
+        return latestAt(node->left.get(), beat);
+
+    // Later starts are on the right
+    if (auto* later = latestAt(node->right.get(), beat))
+        return later;
+
+    if (beat < node->endBeat)
+        return node;
+
+    return latestAt(node->left.get(), beat);
+}
+
+} // namespace dc
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace dc {
+
+/// Spatial index of a clip's notes by pitch and time, for drawing and
+/// hit-testing clips with many thousands of notes.
+///
+/// Each of the 128 pitches keeps its notes in a balanced tree (a treap)
+/// ordered by start beat, where every subtree records the latest end beat
+/// inside it. Queries skip subtrees that end before the range, so a query
+/// costs O(p log n + k) for p pitches and k results however long the notes
+/// are. Notes are inserted, moved and removed one at a time.
+class NoteIndex
+{
+public:
+    struct Note
+    {
+        int id = -1;            ///< caller's key, unique within the index
+        int noteNumber = 60;
+        double startBeat = 0.0;
+        double lengthBeats = 0.0;
+        int velocity = 100;
+
+        double endBeat() const { return startBeat + lengthBeats; }
+    };
+
+    static constexpr int numPitches = 128;
+
+    NoteIndex();
+    ~NoteIndex();
+    NoteIndex(NoteIndex&&) noexcept;
+    NoteIndex& operator=(NoteIndex&&) noexcept;
+
+    void clear();
+
+    /// Add a note, or move it if its id is already present
+    void insert(const Note& note);
+
+    /// Returns false if the id is not present
+    bool remove(int id);
+
+    const Note* find(int id) const;
+    size_t size() const { return notes_.size(); }
+    bool empty() const { return notes_.empty(); }
+
+    /// Notes overlapping [startBeat, endBeat) with pitches lowNote..highNote,
+    /// ordered by pitch then start
+    void query(double startBeat, double endBeat, int lowNote, int highNote,
+               std::vector<const Note*>& result) const;
+
+    /// The latest-starting note at noteNumber that sounds at beat, or nullptr
+    const Note* noteAt(int noteNumber, double beat) const;
+
+private:
+    struct TreeNode;
+    using TreePtr = std::unique_ptr<TreeNode>;
+
+    static int pitchOf(int noteNumber);
+
+    // Treap upkeep; keys are (start beat, id)
+    static void update(TreeNode& node);
+    static void split(TreePtr tree, double startBeat, int id, TreePtr& before, TreePtr& rest);
+    static TreePtr merge(TreePtr before, TreePtr after);
+    static bool erase(TreePtr& tree, double startBeat, int id);
+
+    static void collect(const TreeNode* node, double startBeat, double endBeat,
+                        std::vector<const Note*>& result);
+    static const TreeNode* latestAt(const TreeNode* node, double beat);
+
+    std::unordered_map<int, Note> notes_;
+    std::array<TreePtr, numPitches> byPitch_;
+    uint32_t seed_ = 0x9e3779b9u;     // treap priorities
+};
+
+} // namespace dc
@@ -101,6 +101,22 @@ void PropertyTree::setProperty (PropertyId name, Variant value,
     setPropertyInternal (name, std::move (value));
 }
 
+void PropertyTree::setPropertySilently (PropertyId name, Variant value)
+{
+    assert (data_ != nullptr);
+
+    for (auto& [k, v] : data_->properties)
+    {
+        if (k == name)
+        {
+            v = std::move (value);
+            return;
+        }
+    }
+
+    data_->properties.emplace_back (name, std::move (value));
+}
+
 Variant PropertyTree::removeProperty (PropertyId name,
                                       UndoManager* undoManager)
 {
@@ -53,6 +53,11 @@ public:
     void setProperty (PropertyId name, Variant value,
                       UndoManager* undoManager = nullptr);
 
+    /// Set property without recording undo or notifying listeners.
+    /// For bulk edits that touch many nodes and then publish a single
+    /// change themselves (see MidiClip::applyNoteEdits).
+    void setPropertySilently (PropertyId name, Variant value);
+
     /// Remove property. Returns previous value.
     Variant removeProperty (PropertyId name,
                             UndoManager* undoManager = nullptr);
@@ -1,5 +1,4 @@
 #include "AudioRecorder.h"
-#include "dc/audio/AudioFileWriter.h"
 #include <filesystem>
 
 namespace dc
@@ -17,36 +16,41 @@ AudioRecorder::~AudioRecorder()
 bool AudioRecorder::startRecording (const std::filesystem::path& outputFile, double sampleRate,
                                     int numChannels, int bitsPerSample)
 {
-    stopRecording();
-
     if (outputFile.empty())
         return false;
 
-    // Ensure the parent directory exists
-    std::filesystem::create_directories (outputFile.parent_path());
-
-    // Delete existing file so the writer can create a fresh one
-    if (std::filesystem::exists (outputFile))
-        std::filesystem::remove (outputFile);
-
-    // Map bitsPerSample to dc::AudioFileWriter::Format
-    dc::AudioFileWriter::Format format;
+    // Map bitsPerSample to dc::CaptureEngine::SampleFormat
+    dc::CaptureEngine::InputSpec spec;
+    spec.file = outputFile;
+    spec.numChannels = numChannels;
     switch (bitsPerSample)
     {
-        case 16: format = dc::AudioFileWriter::Format::WAV_16; break;
-        case 32: format = dc::AudioFileWriter::Format::WAV_32F; break;
-        default: format = dc::AudioFileWriter::Format::WAV_24; break;
+        case 16: spec.format = dc::CaptureEngine::SampleFormat::int16; break;
+        case 32: spec.format = dc::CaptureEngine::SampleFormat::float32; break;
+        default: spec.format = dc::CaptureEngine::SampleFormat::int24; break;
     }
 
-    recorder = std::make_unique<dc::ThreadedRecorder>();
+    return startRecording (std::vector<dc::CaptureEngine::InputSpec> { spec }, sampleRate);
+}
+
+bool AudioRecorder::startRecording (const std::vector<dc::CaptureEngine::InputSpec>& inputs,
+                                    double sampleRate)
+{
+    stopRecording();
+
+    if (inputs.empty())
+        return false;
 
-    if (! recorder->start (outputFile, format, numChannels, sampleRate))
+    // The engine creates parent directories and replaces existing files
+    engine = std::make_unique<dc::CaptureEngine>();
+
+    if (! engine->start (inputs, sampleRate))
     {
-        recorder.reset();
+        engine.reset();
         return false;
     }
 
-    recordedFile = outputFile;
+    recordedFile = inputs.front().file;
     recordedSamples.store (0);
     recording.store (true);
 
@@ -57,23 +61,32 @@ void AudioRecorder::stopRecording()
 {
     recording.store (false);
 
-    if (recorder)
-    {
-        recorder->stop();
-        recorder.reset();
-    }
+    // Keep the engine so metrics of the finished take stay readable
+    if (engine)
+        engine->stop();
 }
 
 void AudioRecorder::writeAudioBlock (const dc::AudioBlock& block, int numSamples)
+{
+    writeInputBlock (0, block, numSamples);
+}
+
+void AudioRecorder::writeInputBlock (int input, const dc::AudioBlock& block, int numSamples)
 {
     if (! recording.load())
         return;
 
-    if (recorder)
+    if (engine)
     {
-        recorder->write (block, numSamples);
-        recordedSamples.fetch_add (static_cast<int64_t> (numSamples));
+        engine->write (input, block, numSamples);
+        if (input == 0)
+            recordedSamples.fetch_add (static_cast<int64_t> (numSamples));
     }
 }
 
+dc::CaptureEngine::Metrics AudioRecorder::getCaptureMetrics() const
+{
+    return engine ? engine->getMetrics() : dc::CaptureEngine::Metrics {};
+}
+
 } // namespace dc
@@ -1,9 +1,10 @@
 #pragma once
-#include "dc/audio/ThreadedRecorder.h"
+#include "dc/audio/CaptureEngine.h"
 #include "dc/audio/AudioBlock.h"
 #include <atomic>
 #include <filesystem>
 #include <memory>
+#include <vector>
 
 namespace dc
 {
@@ -17,17 +18,34 @@ public:
     // Start recording to a file
     bool startRecording (const std::filesystem::path& outputFile, double sampleRate,
                          int numChannels = 2, int bitsPerSample = 24);
+
+    // Start recording several inputs at once, one file each, through a
+    // single batched writer
+    bool startRecording (const std::vector<dc::CaptureEngine::InputSpec>& inputs, double sampleRate);
+
     void stopRecording();
     bool isRecording() const { return recording.load(); }
 
-    // Call from audio callback to feed samples
+    // Call from audio callback to feed samples (input 0)
     void writeAudioBlock (const dc::AudioBlock& block, int numSamples);
 
+    // Call from audio callback to feed one input of a multi-input recording
+    void writeInputBlock (int input, const dc::AudioBlock& block, int numSamples);
+
     std::filesystem::path getRecordedFile() const { return recordedFile; }
     int64_t getRecordedSampleCount() const { return recordedSamples.load(); }
+    int getNumInputs() const { return engine ? engine->getNumInputs() : 0; }
+
+    // Waveform peaks of an input's take, growing while recording; share
+    // them through a WaveformCache to draw the clip live
+    std::shared_ptr<dc::LivePeaks> getLivePeaks (int input = 0) const { return engine ? engine->getPeaks (input) : nullptr; }
+
+    // Disk throughput, ring headroom and dropped samples of the current
+    // (or last) recording
+    dc::CaptureEngine::Metrics getCaptureMetrics() const;
 
 private:
-    std::unique_ptr<dc::ThreadedRecorder> recorder;
+    std::unique_ptr<dc::CaptureEngine> engine;
 
     std::atomic<bool> recording { false };
     std::atomic<int64_t> recordedSamples { 0 };
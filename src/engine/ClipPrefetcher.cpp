@@ -0,0 +1,103 @@
+#include "ClipPrefetcher.h"
+#include "TrackProcessor.h"
+#include <algorithm>
+#include <chrono>
+
+namespace dc
+{
+
+namespace
+{
+
+// Poll interval when nobody calls wake(); well inside the look-ahead
+constexpr auto pollInterval = std::chrono::milliseconds (10);
+
+} // anonymous namespace
+
+ClipPrefetcher::ClipPrefetcher()
+    : thread_ (&ClipPrefetcher::threadFunc, this)
+{
+}
+
+ClipPrefetcher::~ClipPrefetcher()
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        running_ = false;
+    }
+    cv_.notify_all();
+
+    if (thread_.joinable())
+        thread_.join();
+}
+
+ClipPrefetcher& ClipPrefetcher::getInstance()
+{
+    static ClipPrefetcher instance;
+    return instance;
+}
+
+void ClipPrefetcher::addProcessor (TrackProcessor* processor)
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        if (std::find (processors_.begin(), processors_.end(), processor) == processors_.end())
+            processors_.push_back (processor);
+    }
+    wake();
+}
+
+void ClipPrefetcher::removeProcessor (TrackProcessor* processor)
+{
+    std::unique_lock<std::mutex> lock (mutex_);
+    processors_.erase (std::remove (processors_.begin(), processors_.end(), processor),
+                       processors_.end());
+
+    // Passes run without mutex_; wait until one has left this processor
+    passDone_.wait (lock, [this, processor] { return busy_ != processor; });
+}
+
+void ClipPrefetcher::wake()
+{
+    // Called from the audio thread: never take mutex_ here. A notify that races the wait
+    // is picked up by the next poll.
+    wakeRequested_.store (true, std::memory_order_release);
+    cv_.notify_one();
+}
+
+void ClipPrefetcher::threadFunc()
+{
+    std::unique_lock<std::mutex> lock (mutex_);
+
+    while (running_)
+    {
+        cv_.wait_for (lock, pollInterval, [this]
+        {
+            return wakeRequested_.load (std::memory_order_acquire) || ! running_;
+        });
+        wakeRequested_.store (false, std::memory_order_relaxed);
+
+        if (! running_)
+            break;
+
+        // Each processor is prefetched without mutex_, so a slow file on
+        // one track holds up neither the others nor removeProcessor()
+        pass_ = processors_;
+        for (auto* p : pass_)
+        {
+            if (! running_)
+                break;
+            if (std::find (processors_.begin(), processors_.end(), p) == processors_.end())
+                continue;   // removed since the pass began
+
+            busy_ = p;
+            lock.unlock();
+            p->prefetchClips();
+            lock.lock();
+            busy_ = nullptr;
+            passDone_.notify_all();
+        }
+    }
+}
+
+} // namespace dc
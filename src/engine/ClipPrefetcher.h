@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dc
+{
+
+class TrackProcessor;
+
+/// Background thread that keeps each TrackProcessor's clip voices
+/// populated ahead of the playhead.
+///
+/// Opening a file and allocating a DiskStreamer ring are not real-time
+/// safe, so the audio thread never does either. This thread periodically
+/// (or when woken) asks every registered TrackProcessor to open streams
+/// for clips that start within its look-ahead window and to tear down
+/// voices the audio thread has finished with.
+class ClipPrefetcher
+{
+public:
+    ClipPrefetcher();
+    ~ClipPrefetcher();
+
+    /// Process-wide prefetcher shared by all TrackProcessors.
+    static ClipPrefetcher& getInstance();
+
+    void addProcessor (TrackProcessor* processor);
+
+    /// Unregister a processor. Blocks until any prefetch pass on it has
+    /// finished, so the processor may be destroyed once this returns.
+    void removeProcessor (TrackProcessor* processor);
+
+    /// Request a prefetch pass soon (playhead jumped, voice finished,
+    /// clip list changed). Safe to call from the audio thread.
+    void wake();
+
+private:
+    void threadFunc();
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable passDone_;        // busy_ moved on
+    std::vector<TrackProcessor*> processors_;
+    std::vector<TrackProcessor*> pass_;       // prefetch thread only
+    TrackProcessor* busy_ = nullptr;          // being prefetched, outside mutex_
+    bool running_ = true;
+    std::atomic<bool> wakeRequested_ { false };
+    std::thread thread_;   // last: starts in the constructor
+
+    ClipPrefetcher (const ClipPrefetcher&) = delete;
+    ClipPrefetcher& operator= (const ClipPrefetcher&) = delete;
+};
+
+} // namespace dc
@@ -0,0 +1,329 @@
+#include "SimpleSynthProcessor.h"
+#include "dc/foundation/types.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace dc
+{
+
+namespace
+{
+
+constexpr int W = SimpleSynthProcessor::laneWidth;
+
+typedef float   VecF __attribute__ ((vector_size (sizeof (float) * W)));
+typedef int32_t VecI __attribute__ ((vector_size (sizeof (int32_t) * W)));
+
+constexpr float decayPerSample = 0.99995f;
+constexpr float releaseFactor  = 0.1f;
+constexpr float silenceLevel   = 0.0001f;
+
+inline VecF splat (float x)
+{
+    VecF v;
+    for (int i = 0; i < W; ++i)
+        v[i] = x;
+    return v;
+}
+
+inline VecF load (const float* p)
+{
+    VecF v;
+    std::memcpy (&v, p, sizeof (VecF));
+    return v;
+}
+
+inline void store (float* p, VecF v)
+{
+    std::memcpy (p, &v, sizeof (VecF));
+}
+
+inline VecF select (VecI mask, VecF a, VecF b)
+{
+    return (VecF) ((mask & (VecI) a) | (~mask & (VecI) b));
+}
+
+inline VecF vabs (VecF x)
+{
+    VecI bits = (VecI) x;
+    VecI absMask;
+    for (int i = 0; i < W; ++i)
+        absMask[i] = 0x7fffffff;
+    return (VecF) (bits & absMask);
+}
+
+inline float horizontalSum (VecF v)
+{
+    float sum = 0.0f;
+    for (int i = 0; i < W; ++i)
+        sum += v[i];
+    return sum;
+}
+
+/// sin(2*pi*phase) for phase in [0, 1).
+/// Folds into a quarter period and evaluates a 9th-order odd polynomial
+/// (max error ~4e-6), so the whole lane stays branchless.
+inline VecF sineOsc (VecF ph)
+{
+    const VecF half = splat (0.5f);
+    const VecF quarter = splat (0.25f);
+
+    VecF t = ph - half;                                   // [-0.5, 0.5)
+    VecF a = vabs (t);
+    VecF r = quarter - vabs (quarter - a);                // [0, 0.25]
+    VecF x = r * splat (2.0f * dc::pi<float>);
+    VecF x2 = x * x;
+
+    VecF p = splat (1.0f / 362880.0f);
+    p = p * x2 - splat (1.0f / 5040.0f);
+    p = p * x2 + splat (1.0f / 120.0f);
+    p = p * x2 - splat (1.0f / 6.0f);
+    p = p * x2 + splat (1.0f);
+    VecF s = p * x;
+
+    // sin(2*pi*ph) == -sin(2*pi*t); restore the sign of t, then negate
+    VecI signBit = (VecI) t & (VecI) splat (-0.0f);
+    return (VecF) ((VecI) s ^ signBit ^ (VecI) splat (-0.0f));
+}
+
+/// Two-sample polynomial band-limited step residual around phase 0.
+inline VecF polyBlep (VecF t, VecF dt)
+{
+    const VecF one = splat (1.0f);
+    const VecF zero = splat (0.0f);
+
+    // Guard against dt == 0 on inactive lanes
+    VecF safeDt = select (dt > zero, dt, one);
+
+    VecF a = t / safeDt;                                  // just after the step
+    VecF rising = a + a - a * a - one;
+
+    VecF b = (t - one) / safeDt;                          // just before the step
+    VecF falling = b * b + b + b + one;
+
+    VecF result = select (t < dt, rising, zero);
+    return select (t > one - dt, falling, result);
+}
+
+inline VecF sawOsc (VecF ph, VecF inc)
+{
+    return ph + ph - splat (1.0f) - polyBlep (ph, inc);
+}
+
+inline VecF squareOsc (VecF ph, VecF inc)
+{
+    const VecF one = splat (1.0f);
+    VecF naive = select (ph < splat (0.5f), one, -one);
+
+    VecF shifted = ph + splat (0.5f);
+    shifted = select (shifted >= one, shifted - one, shifted);
+
+    return naive + polyBlep (ph, inc) - polyBlep (shifted, inc);
+}
+
+/// Inner render loop, specialised per oscillator so the waveform choice
+/// is hoisted out of the per-sample loop.
+template <typename Oscillator>
+void renderLanes (float* out, int startSample, int endSample,
+                  VecF* ph, const VecF* inc, VecF* lvl, int numGroups,
+                  Oscillator osc)
+{
+    const VecF one = splat (1.0f);
+    const VecF decay = splat (decayPerSample);
+
+    for (int s = startSample; s < endSample; ++s)
+    {
+        VecF acc = splat (0.0f);
+
+        for (int i = 0; i < numGroups; ++i)
+        {
+            acc += osc (ph[i], inc[i]) * lvl[i];
+
+            VecF next = ph[i] + inc[i];
+            ph[i] = select (next >= one, next - one, next);
+            lvl[i] *= decay;
+        }
+
+        out[s] += horizontalSum (acc);
+    }
+}
+
+} // anonymous namespace
+
+void SimpleSynthProcessor::prepare (double sampleRate, int /*maxBlockSize*/)
+{
+    currentSampleRate = sampleRate;
+    allNotesOff();
+}
+
+int SimpleSynthProcessor::getNumActiveVoices() const
+{
+    return __builtin_popcount (activeMask.load (std::memory_order_relaxed));
+}
+
+void SimpleSynthProcessor::process (AudioBlock& audio, MidiBlock& midi, int numSamples)
+{
+    audio.clear();
+
+    auto* left  = audio.getChannel (0);
+    auto* right = audio.getNumChannels() > 1 ? audio.getChannel (1) : nullptr;
+
+    // Render up to each event's sample offset, then apply it, so note
+    // starts and releases are sample-accurate within the block.
+    int rendered = 0;
+
+    for (auto it = midi.begin(); it != midi.end(); ++it)
+    {
+        auto event = *it;
+        const auto& msg = event.message;
+        int offset = std::clamp (event.sampleOffset, 0, numSamples);
+
+        if (offset > rendered)
+        {
+            renderVoices (left, rendered, offset);
+            rendered = offset;
+        }
+
+        if (msg.isNoteOn())
+            noteOn (msg.getNoteNumber(), msg.getVelocity());
+        else if (msg.isNoteOff())
+            noteOff (msg.getNoteNumber());
+        else if (msg.isController() && (msg.getControllerNumber() == 123 || msg.getControllerNumber() == 120))
+            allNotesOff();
+    }
+
+    if (rendered < numSamples)
+        renderVoices (left, rendered, numSamples);
+
+    retireSilentVoices();
+
+    // Soft-clip to prevent blowups
+    for (int s = 0; s < numSamples; ++s)
+        left[s] = std::tanh (left[s] * 0.5f);
+
+    if (right != nullptr)
+        std::memcpy (right, left, sizeof (float) * static_cast<size_t> (numSamples));
+}
+
+void SimpleSynthProcessor::renderVoices (float* out, int startSample, int endSample)
+{
+    uint32_t mask = activeMask.load (std::memory_order_relaxed);
+    if (mask == 0)
+        return;
+
+    // Gather the groups that have at least one active lane
+    int groups[numVoiceGroups];
+    int numGroups = 0;
+    const uint32_t laneBits = (1u << laneWidth) - 1u;
+
+    for (int g = 0; g < numVoiceGroups; ++g)
+        if ((mask >> (g * laneWidth)) & laneBits)
+            groups[numGroups++] = g;
+
+    VecF ph[numVoiceGroups], inc[numVoiceGroups], lvl[numVoiceGroups];
+
+    for (int i = 0; i < numGroups; ++i)
+    {
+        int base = groups[i] * laneWidth;
+        ph[i]  = load (phase.data() + base);
+        inc[i] = load (phaseInc.data() + base);
+        lvl[i] = load (level.data() + base);
+    }
+
+    switch (waveform.load (std::memory_order_relaxed))
+    {
+        case Waveform::saw:
+            renderLanes (out, startSample, endSample, ph, inc, lvl, numGroups, sawOsc);
+            break;
+        case Waveform::square:
+            renderLanes (out, startSample, endSample, ph, inc, lvl, numGroups, squareOsc);
+            break;
+        case Waveform::sine:
+        default:
+            renderLanes (out, startSample, endSample, ph, inc, lvl, numGroups,
+                         [] (VecF p, VecF) { return sineOsc (p); });
+            break;
+    }
+
+    for (int i = 0; i < numGroups; ++i)
+    {
+        int base = groups[i] * laneWidth;
+        store (phase.data() + base, ph[i]);
+        store (level.data() + base, lvl[i]);
+    }
+}
+
+void SimpleSynthProcessor::retireSilentVoices()
+{
+    uint32_t mask = activeMask.load (std::memory_order_relaxed);
+
+    for (int v = 0; v < maxVoices; ++v)
+    {
+        if ((mask & (1u << v)) != 0 && level[static_cast<size_t> (v)] < silenceLevel)
+        {
+            mask &= ~(1u << v);
+            level[static_cast<size_t> (v)] = 0.0f;
+            phaseInc[static_cast<size_t> (v)] = 0.0f;
+        }
+    }
+
+    activeMask.store (mask, std::memory_order_relaxed);
+}
+
+void SimpleSynthProcessor::noteOn (int note, float velocity)
+{
+    // Find an idle voice (or steal the quietest)
+    uint32_t mask = activeMask.load (std::memory_order_relaxed);
+    int best = -1;
+    float lowestLevel = 999.0f;
+
+    for (int v = 0; v < maxVoices; ++v)
+    {
+        if ((mask & (1u << v)) == 0)
+        {
+            best = v;
+            break;
+        }
+        if (level[static_cast<size_t> (v)] < lowestLevel)
+        {
+            lowestLevel = level[static_cast<size_t> (v)];
+            best = v;
+        }
+    }
+
+    if (best < 0)
+        return;
+
+    auto idx = static_cast<size_t> (best);
+    double freq = 440.0 * std::pow (2.0, (note - 69) / 12.0);
+
+    noteNumber[idx] = note;
+    phase[idx]      = 0.0f;
+    phaseInc[idx]   = static_cast<float> (std::min (freq / currentSampleRate, 0.5));
+    level[idx]      = velocity * 0.3f;
+
+    activeMask.store (mask | (1u << best), std::memory_order_relaxed);
+}
+
+void SimpleSynthProcessor::noteOff (int note)
+{
+    uint32_t mask = activeMask.load (std::memory_order_relaxed);
+
+    for (int v = 0; v < maxVoices; ++v)
+    {
+        if ((mask & (1u << v)) != 0 && noteNumber[static_cast<size_t> (v)] == note)
+            level[static_cast<size_t> (v)] *= releaseFactor; // fast decay on release
+    }
+}
+
+void SimpleSynthProcessor::allNotesOff()
+{
+    phase.fill (0.0f);
+    phaseInc.fill (0.0f);
+    level.fill (0.0f);
+    noteNumber.fill (-1);
+    activeMask.store (0, std::memory_order_relaxed);
+}
+
+} // namespace dc
@@ -2,22 +2,42 @@
 #include "dc/engine/AudioNode.h"
 #include "dc/engine/MidiBlock.h"
 #include "dc/audio/AudioBlock.h"
-#include "dc/midi/MidiMessage.h"
-#include "dc/foundation/types.h"
 #include <array>
-#include <cmath>
+#include <atomic>
+#include <cstdint>
 
 namespace dc
 {
 
 /**
- * Minimal polyphonic sine-wave synthesizer for testing MIDI -> audio pipeline.
- * Accepts MIDI, generates audio. Used as default instrument on MIDI tracks
- * when no VST/AU plugin is loaded.
+ * Lightweight polyphonic synthesizer used as the default instrument on MIDI
+ * tracks when no VST/AU plugin is loaded.
+ *
+ * Voices are stored struct-of-arrays and rendered laneWidth voices at a time
+ * with compiler vector extensions (8 lanes with AVX, 4 with SSE/NEON).
+ * Oscillators are band-limited (polynomial sine, PolyBLEP saw/square), and
+ * note events start at their sample offset within the block.
  */
 class SimpleSynthProcessor : public AudioNode
 {
 public:
+    enum class Waveform
+    {
+        sine,
+        saw,
+        square
+    };
+
+    static constexpr int maxVoices = 32;
+
+#if defined (__AVX__)
+    static constexpr int laneWidth = 8;
+#else
+    static constexpr int laneWidth = 4;
+#endif
+
+    static constexpr int numVoiceGroups = maxVoices / laneWidth;
+
     SimpleSynthProcessor() = default;
 
     std::string getName() const override { return "SimpleSynth"; }
@@ -26,123 +46,36 @@ public:
     bool acceptsMidi() const override  { return true; }
     bool producesMidi() const override { return false; }
 
-    void prepare (double sampleRate, int /*maxBlockSize*/) override
-    {
-        currentSampleRate = sampleRate;
-        for (auto& v : voices)
-            v = {};
-    }
-
+    void prepare (double sampleRate, int maxBlockSize) override;
     void release() override {}
+    void process (AudioBlock& audio, MidiBlock& midi, int numSamples) override;
 
-    void process (AudioBlock& audio, MidiBlock& midi, int numSamples) override
-    {
-        audio.clear();
-
-        // Read MIDI directly from the MidiBlock parameter (no bridge conversion)
-        for (auto it = midi.begin(); it != midi.end(); ++it)
-        {
-            auto event = *it;
-            const auto& msg = event.message;
-
-            if (msg.isNoteOn())
-                noteOn (msg.getNoteNumber(), msg.getVelocity(), event.sampleOffset);
-            else if (msg.isNoteOff())
-                noteOff (msg.getNoteNumber(), event.sampleOffset);
-            else if (msg.isController() && (msg.getControllerNumber() == 123 || msg.getControllerNumber() == 120))
-                allNotesOff();
-        }
-
-        auto* left  = audio.getChannel (0);
-        auto* right = audio.getNumChannels() > 1 ? audio.getChannel (1) : nullptr;
-
-        for (int s = 0; s < numSamples; ++s)
-        {
-            float out = 0.0f;
-
-            for (auto& v : voices)
-            {
-                if (! v.active)
-                    continue;
-
-                out += std::sin (static_cast<float> (v.phase)) * v.level;
-                v.phase += v.phaseIncrement;
-
-                // Simple envelope decay
-                v.level *= 0.99995f;
-                if (v.level < 0.0001f)
-                    v.active = false;
-            }
-
-            // Soft-clip to prevent blowups
-            out = std::tanh (out * 0.5f);
-
-            left[s] = out;
-            if (right != nullptr)
-                right[s] = out;
-        }
-    }
+    void setWaveform (Waveform w) { waveform.store (w); }
+    Waveform getWaveform() const  { return waveform.load(); }
+
+    /// Number of currently sounding voices (approximate when read off the audio thread)
+    int getNumActiveVoices() const;
 
 private:
-    static constexpr int maxVoices = 32;
+    static_assert (maxVoices % laneWidth == 0, "voice count must fill whole SIMD lanes");
 
-    struct Voice
-    {
-        bool   active         = false;
-        int    noteNumber     = -1;
-        double phase          = 0.0;
-        double phaseIncrement = 0.0;
-        float  level          = 0.0f;
-    };
+    // Struct-of-arrays voice bank. Inactive voices keep level and phaseInc
+    // at zero so whole lanes can be rendered without per-voice branches.
+    alignas (32) std::array<float, maxVoices> phase {};
+    alignas (32) std::array<float, maxVoices> phaseInc {};
+    alignas (32) std::array<float, maxVoices> level {};
+    std::array<int, maxVoices> noteNumber {};
+    std::atomic<uint32_t> activeMask { 0 };
 
-    std::array<Voice, maxVoices> voices {};
+    std::atomic<Waveform> waveform { Waveform::sine };
     double currentSampleRate = 44100.0;
 
-    void noteOn (int noteNumber, float velocity, int /*sampleOffset*/)
-    {
-        // Find free voice (or steal quietest)
-        Voice* best = nullptr;
-        float lowestLevel = 999.0f;
-
-        for (auto& v : voices)
-        {
-            if (! v.active)
-            {
-                best = &v;
-                break;
-            }
-            if (v.level < lowestLevel)
-            {
-                lowestLevel = v.level;
-                best = &v;
-            }
-        }
-
-        if (best != nullptr)
-        {
-            double freq = 440.0 * std::pow (2.0, (noteNumber - 69) / 12.0);
-            best->active         = true;
-            best->noteNumber     = noteNumber;
-            best->phase          = 0.0;
-            best->phaseIncrement = 2.0 * dc::pi<double> * freq / currentSampleRate;
-            best->level          = velocity * 0.3f;
-        }
-    }
-
-    void noteOff (int noteNumber, int /*sampleOffset*/)
-    {
-        for (auto& v : voices)
-        {
-            if (v.active && v.noteNumber == noteNumber)
-                v.level *= 0.1f; // fast decay on release
-        }
-    }
-
-    void allNotesOff()
-    {
-        for (auto& v : voices)
-            v.active = false;
-    }
+    void renderVoices (float* out, int startSample, int endSample);
+    void retireSilentVoices();
+
+    void noteOn (int noteNumber, float velocity);
+    void noteOff (int noteNumber);
+    void allNotesOff();
 
     SimpleSynthProcessor (const SimpleSynthProcessor&) = delete;
     SimpleSynthProcessor& operator= (const SimpleSynthProcessor&) = delete;
@@ -1,5 +1,8 @@
 #include "TrackProcessor.h"
+#include "ClipPrefetcher.h"
 #include "dc/audio/AudioBlock.h"
+#include "dc/audio/AudioFileReader.h"
+#include "dc/audio/DiskIOScheduler.h"
 #include "dc/foundation/types.h"
 #include <cmath>
 #include <algorithm>
@@ -7,94 +10,660 @@
 namespace dc
 {
 
+namespace
+{
+
+/// dst[i] += src[i] * (g0 + i * dg). A straight-line loop over contiguous
+/// floats that the compiler turns into SIMD multiply-adds.
+void addWithRamp (float* dst, const float* src, int numSamples, float g0, float dg)
+{
+    for (int i = 0; i < numSamples; ++i)
+        dst[i] += src[i] * (g0 + dg * static_cast<float> (i));
+}
+
+void addUnity (float* dst, const float* src, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+        dst[i] += src[i];
+}
+
+} // anonymous namespace
+
 TrackProcessor::TrackProcessor (TransportController& transport)
     : transportController (transport)
 {
+    prerollPoints.reserve (std::tuple_size<JumpTargets>::value + 1);
+    ClipPrefetcher::getInstance().addProcessor (this);
 }
 
 TrackProcessor::~TrackProcessor()
 {
-    if (diskStreamer)
+    ClipPrefetcher::getInstance().removeProcessor (this);
+
+    for (int i = 0; i < getNumVoices(); ++i)
+    {
+        auto& v = *voices[static_cast<size_t> (i)];
+        if (v.streamer)
+            v.streamer->stop();
+        v.streamer.reset();
+        v.sample.reset();
+    }
+}
+
+void TrackProcessor::setClips (std::vector<Clip> newClips)
+{
+    {
+        std::lock_guard<std::mutex> lock (clipsMutex);  // not on audio thread
+        loadedFile.clear();
+    }
+
+    applyClips (std::move (newClips));
+}
+
+void TrackProcessor::applyClips (std::vector<Clip> newClips)
+{
+    // Fade lengths that overlap are scaled back so they meet, and each
+    // clip plays no further than its length
+    int64_t longest = 0;
+    for (auto& c : newClips)
+    {
+        c.length = std::max<int64_t> (c.length, 0);
+        c.fadeInLength = std::clamp<int64_t> (c.fadeInLength, 0, c.length);
+        c.fadeOutLength = std::clamp<int64_t> (c.fadeOutLength, 0, c.length);
+
+        if (c.fadeInLength + c.fadeOutLength > c.length)
+        {
+            auto total = c.fadeInLength + c.fadeOutLength;
+            c.fadeInLength = c.length * c.fadeInLength / total;
+            c.fadeOutLength = c.length - c.fadeInLength;
+        }
+
+        longest = std::max (longest, c.length);
+    }
+
+    newClips.erase (std::remove_if (newClips.begin(), newClips.end(),
+                                    [] (const Clip& c) { return c.length <= 0; }),
+                    newClips.end());
+
+    std::stable_sort (newClips.begin(), newClips.end(),
+                      [] (const Clip& a, const Clip& b) { return a.startPosition < b.startPosition; });
+
     {
-        diskStreamer->stop();
-        diskStreamer.reset();
+        std::lock_guard<std::mutex> lock (clipsMutex);  // not on audio thread
+        clips = std::move (newClips);
+        maxClipLength = longest;
+        sizedForLookahead = -1;
+
+        // Drop voices whose clip no longer exists; unchanged clips keep
+        // streaming without a gap
+        for (int i = 0; i < getNumVoices(); ++i)
+        {
+            auto& v = *voices[static_cast<size_t> (i)];
+            if (v.state.load (std::memory_order_acquire) != Voice::ready)
+                continue;
+
+            if (std::find (clips.begin(), clips.end(), v.clip) == clips.end())
+                v.cancelled.store (true, std::memory_order_release);
+        }
     }
+
+    ClipPrefetcher::getInstance().wake();
 }
 
 bool TrackProcessor::loadFile (const std::filesystem::path& file)
 {
     clearFile();
 
-    diskStreamer = std::make_unique<dc::DiskStreamer>();
+    auto reader = AudioFileReader::open (file);
+    if (reader == nullptr)
+        return false;
+
+    fileLength.store (reader->getLengthInSamples());
 
-    if (! diskStreamer->open (file))
+    std::vector<Clip> fileClips;
     {
-        diskStreamer.reset();
-        return false;
+        std::lock_guard<std::mutex> lock (clipsMutex);  // not on audio thread
+        loadedFile = file;
+        loadedFileRate = reader->getSampleRate();
+
+        if (outputSampleRate.load() > 0.0)
+            fileClips.push_back (makeFileClip());
     }
 
-    diskStreamer->start();
-    lastSeekPosition = -1;
+    applyClips (std::move (fileClips));
     return true;
 }
 
+TrackProcessor::Clip TrackProcessor::makeFileClip() const
+{
+    // Clip length is on the timeline, at the graph rate
+    Clip clip;
+    clip.sourceFile = loadedFile;
+    clip.length = static_cast<int64_t> (std::ceil (static_cast<double> (fileLength.load())
+                                                   * outputSampleRate.load() / loadedFileRate));
+    return clip;
+}
+
 void TrackProcessor::clearFile()
 {
-    if (diskStreamer)
+    fileLength.store (0);
+    setClips ({});
+}
+
+void TrackProcessor::prepare (double sampleRate, int maxBlockSize)
+{
+    if (sampleRate <= 0.0)
+        sampleRate = 44100.0;
+    outputSampleRate.store (sampleRate);
+    lookaheadSamples.store (static_cast<int64_t> (lookaheadSeconds * sampleRate));
+    parkWindowSamples.store (static_cast<int64_t> (parkWindowSeconds * sampleRate));
+
+    for (auto& ch : scratchData)
+        ch.assign (static_cast<size_t> (std::max (maxBlockSize, 1)), 0.0f);
+
+    lastBlockEnd = -1;
+
+    // A file loaded before the rate was known is placed now
+    std::vector<Clip> fileClips;
+    bool hasFile = false;
     {
-        diskStreamer->stop();
-        diskStreamer.reset();
+        std::lock_guard<std::mutex> lock (clipsMutex);  // not on audio thread
+        hasFile = ! loadedFile.empty();
+        if (hasFile)
+            fileClips.push_back (makeFileClip());
     }
 
-    lastSeekPosition = -1;
+    if (hasFile)
+        applyClips (std::move (fileClips));
+    else
+        ClipPrefetcher::getInstance().wake();   // the look-ahead may have changed
 }
 
-void TrackProcessor::prepare (double /*sampleRate*/, int /*maxBlockSize*/)
+void TrackProcessor::release()
 {
-    // DiskStreamer manages its own background thread — nothing to prepare
+    // Voices are torn down by the prefetcher; just stop using them
+    for (int i = 0; i < getNumVoices(); ++i)
+    {
+        auto& v = *voices[static_cast<size_t> (i)];
+        if (v.state.load (std::memory_order_acquire) == Voice::ready)
+            retireVoice (v);
+    }
+
+    ClipPrefetcher::getInstance().wake();
 }
 
-void TrackProcessor::release()
+void TrackProcessor::retireVoice (Voice& v)
 {
-    if (diskStreamer)
-        diskStreamer->stop();
+    v.state.store (Voice::finished, std::memory_order_release);
 }
 
 void TrackProcessor::process (AudioBlock& audio, MidiBlock& /*midi*/, int numSamples)
 {
-    if (muted.load() || diskStreamer == nullptr)
+    int64_t posInSamples = transportController.getPositionInSamples();
+    int64_t lookahead = lookaheadSamples.load (std::memory_order_relaxed);
+    bool wakePrefetcher = posInSamples != lastBlockEnd;
+
+    // Retire voices that are cancelled or no longer near the playhead
+    // (this also runs while stopped so a moved cursor frees them).
+    // Parked voices wait at their jump target.
+    int poolSize = getNumVoices();
+    for (int i = 0; i < poolSize; ++i)
+    {
+        auto& v = *voices[static_cast<size_t> (i)];
+        if (v.state.load (std::memory_order_acquire) != Voice::ready)
+            continue;
+
+        bool farFromPlayhead = v.clip.getEndPosition() <= posInSamples
+                            || v.clip.startPosition >= posInSamples + 2 * lookahead;
+
+        if (v.cancelled.load (std::memory_order_acquire)
+            || (farFromPlayhead && ! v.parked.load (std::memory_order_relaxed)))
+        {
+            retireVoice (v);
+            wakePrefetcher = true;
+        }
+    }
+
+    audio.clear();
+
+    if (muted.load() || ! transportController.isPlaying())
     {
-        audio.clear();
+        lastBlockEnd = -1;
+        prefetchPosition.store (posInSamples, std::memory_order_relaxed);
+        if (wakePrefetcher)
+            ClipPrefetcher::getInstance().wake();
         return;
     }
 
-    // Seek if transport position changed
-    int64_t posInSamples = transportController.getPositionInSamples();
+    // Mix in chunks no larger than the scratch buffers
+    int chunkSize = static_cast<int> (scratchData[0].size());
+    if (chunkSize == 0)
+        return;
 
-    if (! transportController.isPlaying())
+    for (int offset = 0; offset < numSamples; offset += chunkSize)
     {
-        audio.clear();
-        lastSeekPosition = -1;
+        int n = std::min (chunkSize, numSamples - offset);
+
+        float* chunkChannels[2];
+        int numChannels = std::min (audio.getNumChannels(), 2);
+        for (int ch = 0; ch < numChannels; ++ch)
+            chunkChannels[ch] = audio.getChannel (ch) + offset;
+        AudioBlock chunk (chunkChannels, numChannels, n);
+
+        for (int i = 0; i < poolSize; ++i)
+        {
+            auto& v = *voices[static_cast<size_t> (i)];
+            if (v.state.load (std::memory_order_acquire) != Voice::ready)
+                continue;
+
+            if (! renderVoice (v, chunk, posInSamples + offset, n)
+                && ! v.parked.load (std::memory_order_relaxed))
+            {
+                retireVoice (v);
+                wakePrefetcher = true;
+            }
+        }
+    }
+
+    lastBlockEnd = posInSamples + numSamples;
+    prefetchPosition.store (lastBlockEnd, std::memory_order_relaxed);
+
+    if (wakePrefetcher)
+        ClipPrefetcher::getInstance().wake();
+}
+
+bool TrackProcessor::renderVoice (Voice& v, AudioBlock& audio, int64_t blockStart, int numSamples)
+{
+    const auto& clip = v.clip;
+    int64_t clipEnd = clip.getEndPosition();
+    int64_t blockEnd = blockStart + numSamples;
+
+    int64_t from = std::max (blockStart, clip.startPosition);
+    int64_t to = std::min (blockEnd, clipEnd);
+
+    if (from >= to)
+        return blockStart < clipEnd;   // not started yet, or already past
+
+    int n = static_cast<int> (to - from);
+    int dstOffset = static_cast<int> (from - blockStart);
+    int64_t sourcePosition = clip.sourceOffset + (from - clip.startPosition);
+
+    float* scratchChannels[2] = { scratchData[0].data(), scratchData[1].data() };
+    AudioBlock scratch (scratchChannels, 2, n);
+
+    if (v.sample != nullptr)
+    {
+        // Whole file in memory: any position is a plain copy
+        v.sample->read (scratch, sourcePosition, n);
+    }
+    else
+    {
+        // Reposition the stream after a jump (scrub, loop wrap)
+        if (from != v.nextTimelinePosition)
+            v.streamer->seek (sourcePosition);
+
+        int got = v.streamer->read (scratch, n);
+        if (got < n)
+            underruns.fetch_add (1, std::memory_order_relaxed);
+    }
+
+    v.nextTimelinePosition = to;
+
+    // Gain envelope: fade-in ramp, unity body, fade-out ramp. Each
+    // region is mixed with a single linear ramp.
+    int64_t fadeInEnd = clip.startPosition + clip.fadeInLength;
+    int64_t fadeOutStart = clipEnd - clip.fadeOutLength;
+
+    int64_t t = from;
+    while (t < to)
+    {
+        int64_t regionEnd;
+        float g0 = 1.0f;
+        float dg = 0.0f;
+
+        if (t < fadeInEnd)
+        {
+            regionEnd = std::min (to, fadeInEnd);
+            float inv = 1.0f / static_cast<float> (clip.fadeInLength);
+            g0 = static_cast<float> (t - clip.startPosition) * inv;
+            dg = inv;
+        }
+        else if (t < fadeOutStart)
+        {
+            regionEnd = std::min (to, fadeOutStart);
+        }
+        else
+        {
+            regionEnd = to;
+            float inv = 1.0f / static_cast<float> (clip.fadeOutLength);
+            g0 = static_cast<float> (clipEnd - t) * inv;
+            dg = -inv;
+        }
+
+        int src = static_cast<int> (t - from);
+        int len = static_cast<int> (regionEnd - t);
+
+        for (int ch = 0; ch < audio.getNumChannels(); ++ch)
+        {
+            float* dst = audio.getChannel (ch) + dstOffset + src;
+            const float* s = scratchChannels[ch] + src;
+
+            if (dg == 0.0f)
+                addUnity (dst, s, len);
+            else
+                addWithRamp (dst, s, len, g0, dg);
+        }
+
+        t = regionEnd;
+    }
+
+    return to < clipEnd;
+}
+
+void TrackProcessor::prefetchClips()
+{
+    // Tear down voices the audio thread has handed back
+    for (int i = 0; i < getNumVoices(); ++i)
+    {
+        auto& v = *voices[static_cast<size_t> (i)];
+        if (v.state.load (std::memory_order_acquire) != Voice::finished)
+            continue;
+
+        if (v.streamer)
+            v.streamer->stop();
+        v.streamer.reset();
+        v.sample.reset();
+        v.cancelled.store (false, std::memory_order_relaxed);
+        v.parked.store (false, std::memory_order_relaxed);
+        v.state.store (Voice::idle, std::memory_order_release);
+    }
+
+    if (muted.load() || outputSampleRate.load() <= 0.0)
+        return;   // muted, or not prepared yet
+
+    // Where the next block starts (the transport position lags by one
+    // block while playing, which would reopen clips that just ended)
+    int64_t pos = prefetchPosition.load (std::memory_order_relaxed);
+    if (pos < 0)
+        pos = transportController.getPositionInSamples();
+    int64_t windowEnd = pos + lookaheadSamples.load (std::memory_order_relaxed);
+    int64_t parkWindow = parkWindowSamples.load (std::memory_order_relaxed);
+    auto targets = getJumpTargets();
+
+    pendingOpens.clear();
+
+    {
+        std::lock_guard<std::mutex> lock (clipsMutex);  // not on audio thread
+        reserveVoices();
+
+        // A mapped file cut short on disk would fault on the audio thread:
+        // drop such voices before their next block and reopen the clips below
+        auto now = std::chrono::steady_clock::now();
+        bool checkTruncation = now >= nextTruncationCheck;
+        if (checkTruncation)
+            nextTruncationCheck = now + truncationCheckInterval;
+
+        // Park voices at jump targets and keep their pre-roll on the targets
+        int numParked = 0;
+        for (int i = 0; i < getNumVoices(); ++i)
+        {
+            auto& v = *voices[static_cast<size_t> (i)];
+            if (v.state.load (std::memory_order_acquire) != Voice::ready)
+                continue;
+
+            if (checkTruncation && v.sample != nullptr && v.sample->isTruncated())
+            {
+                v.cancelled.store (true, std::memory_order_release);
+                continue;
+            }
+
+            bool park = numParked < maxParkedVoices && isNearJumpTarget (v.clip, targets);
+            numParked += park ? 1 : 0;
+            v.parked.store (park, std::memory_order_relaxed);
+            updatePreroll (v, targets);
+        }
+
+        // The playhead first, then whatever is left for the jump targets
+        if (claimVoices (pos, windowEnd, targets, false))
+            for (auto t : targets)
+                if (t >= 0 && ! claimVoices (t, t + parkWindow, targets, true))
+                    break;
+    }
+
+    if (pendingOpens.empty())
         return;
+
+    // Opening streams and loading samples may take a while; do it without
+    // clipsMutex so setClips() isn't held up, then publish under it
+    double sampleRate = outputSampleRate.load (std::memory_order_relaxed);
+    auto quality = resamplerQuality.load (std::memory_order_relaxed);
+    for (auto& open : pendingOpens)
+        openClip (open, sampleRate, quality);
+
+    {
+        std::lock_guard<std::mutex> lock (clipsMutex);  // not on audio thread
+        publishOpenedVoices (targets);
     }
 
-    // Seek on position mismatch (e.g. user scrub, loop, etc.)
-    if (lastSeekPosition < 0 || posInSamples != lastSeekPosition)
-        diskStreamer->seek (posInSamples);
+    pendingOpens.clear();
+}
 
-    // Read from DiskStreamer directly into the AudioBlock
-    audio.clear();
-    diskStreamer->read (audio, numSamples);
+void TrackProcessor::reserveVoices()
+{
+    int64_t lookahead = lookaheadSamples.load (std::memory_order_relaxed);
+    if (lookahead == sizedForLookahead)
+        return;
+
+    sizedForLookahead = lookahead;
+
+    // A voice stays open until its clip ends or starts two look-aheads
+    // past the playhead, so that span bounds the unparked voices
+    int needed = std::min (getMaxClipsWithin (2 * lookahead) + maxParkedVoices, maxVoices);
+
+    int n = getNumVoices();
+    for (int i = n; i < needed; ++i)
+        voices[static_cast<size_t> (i)] = std::make_unique<Voice>();
+
+    if (needed > n)
+        numVoices.store (needed, std::memory_order_release);
+}
+
+int TrackProcessor::getMaxClipsWithin (int64_t span) const
+{
+    // A clip overlaps [p, p + span) for p in (start - span, end): sweep
+    // those intervals and keep the deepest overlap. Ends sort before
+    // starts at the same position since the intervals are open.
+    std::vector<std::pair<int64_t, int>> edges;
+    edges.reserve (clips.size() * 2);
+    for (const auto& c : clips)
+    {
+        edges.emplace_back (c.startPosition - span, 1);
+        edges.emplace_back (c.getEndPosition(), -1);
+    }
+    std::sort (edges.begin(), edges.end());
+
+    int depth = 0;
+    int deepest = 0;
+    for (const auto& e : edges)
+    {
+        depth += e.second;
+        deepest = std::max (deepest, depth);
+    }
+    return deepest;
+}
+
+TrackProcessor::JumpTargets TrackProcessor::getJumpTargets() const
+{
+    JumpTargets targets { -1, -1 };
+
+    if (transportController.isLooping())
+        targets[0] = transportController.getLoopStartInSamples();
+    targets[1] = transportController.getEditCursorInSamples();
+
+    if (targets[1] == targets[0])
+        targets[1] = -1;
+
+    return targets;
+}
+
+bool TrackProcessor::isNearJumpTarget (const Clip& clip, const JumpTargets& targets) const
+{
+    int64_t parkWindow = parkWindowSamples.load (std::memory_order_relaxed);
 
-    lastSeekPosition = posInSamples + numSamples;
+    for (auto t : targets)
+        if (t >= 0 && clip.getEndPosition() > t && clip.startPosition < t + parkWindow)
+            return true;
+
+    return false;
+}
+
+void TrackProcessor::updatePreroll (Voice& v, const JumpTargets& targets)
+{
+    if (v.streamer == nullptr)
+        return;   // cached samples are in memory already
+
+    if (v.prerollTargets == targets)
+        return;
+
+    v.prerollTargets = targets;
+
+    prerollPoints.clear();
+    prerollPoints.push_back (v.clip.sourceOffset);
+
+    for (auto t : targets)
+        if (t > v.clip.startPosition && t < v.clip.getEndPosition())
+            prerollPoints.push_back (v.clip.sourceOffset + (t - v.clip.startPosition));
+
+    v.streamer->setPrerollPoints (prerollPoints);
+}
+
+bool TrackProcessor::claimVoices (int64_t windowStart, int64_t windowEnd, const JumpTargets& targets,
+                                  bool parkedOnly)
+{
+    // Clips are sorted by start, so anything overlapping windowStart
+    // starts no earlier than windowStart - maxClipLength
+    auto it = std::lower_bound (clips.begin(), clips.end(), windowStart - maxClipLength,
+                                [] (const Clip& c, int64_t p) { return c.startPosition < p; });
+
+    for (; it != clips.end() && it->startPosition < windowEnd; ++it)
+    {
+        const auto& clip = *it;
+        if (clip.getEndPosition() <= windowStart)
+            continue;
+
+        bool alreadyStreaming = false;
+        Voice* freeVoice = nullptr;
+        int numParked = 0;
+
+        for (int i = 0; i < getNumVoices(); ++i)
+        {
+            auto& v = *voices[static_cast<size_t> (i)];
+            int state = v.state.load (std::memory_order_acquire);
+            bool live = (state == Voice::ready && ! v.cancelled.load (std::memory_order_relaxed))
+                     || (state == Voice::idle && v.opening);
+
+            if (live && v.clip == clip)
+                alreadyStreaming = true;
+            else if (state == Voice::idle && ! v.opening && freeVoice == nullptr)
+                freeVoice = &v;
+
+            if (live && v.parked.load (std::memory_order_relaxed))
+                ++numParked;
+        }
+
+        if (alreadyStreaming)
+            continue;
+        if (freeVoice == nullptr)
+            return false;   // over maxVoices; later clips get a voice as these finish
+
+        // Voices opened for a jump target only make sense parked
+        bool park = numParked < maxParkedVoices && isNearJumpTarget (clip, targets);
+        if (parkedOnly && ! park)
+            continue;
+
+        int64_t startAt = std::max (windowStart, clip.startPosition);
+        freeVoice->clip = clip;
+        freeVoice->nextTimelinePosition = startAt;
+        freeVoice->parked.store (park, std::memory_order_relaxed);
+        freeVoice->opening = true;
+
+        PendingOpen open;
+        open.voice = freeVoice;
+        open.clip = clip;
+        open.startAt = startAt;
+        pendingOpens.push_back (std::move (open));
+    }
+
+    return true;
+}
+
+void TrackProcessor::openClip (PendingOpen& open, double sampleRate, Resampler::Quality quality)
+{
+    const auto& clip = open.clip;
+
+    // Short files are shared in memory across clips and tracks,
+    // already at the graph rate
+    if ((open.sample = SampleCache::getInstance().acquire (clip.sourceFile, sampleRate)))
+        return;
+
+    // Short clips fit entirely in a ring of their own length
+    int bufferSize = DiskStreamer::autoBufferSize;
+    if (clip.length < DiskIOScheduler::getInstance().getRecommendedBufferFrames (sampleRate))
+        bufferSize = static_cast<int> (clip.length);
+
+    // Files at another rate are converted to the graph rate on the
+    // I/O thread
+    auto streamer = std::make_unique<dc::DiskStreamer> (bufferSize);
+    streamer->setOutputSampleRate (sampleRate, quality);
+    if (! streamer->open (clip.sourceFile))
+        return;
+
+    streamer->seek (clip.sourceOffset + (open.startAt - clip.startPosition));
+    streamer->start();
+    open.streamer = std::move (streamer);
+}
+
+void TrackProcessor::publishOpenedVoices (const JumpTargets& targets)
+{
+    for (auto& open : pendingOpens)
+    {
+        auto& v = *open.voice;
+        v.opening = false;
+
+        // The playlist may have dropped the clip while its file was opening
+        auto it = std::lower_bound (clips.begin(), clips.end(), open.clip.startPosition,
+                                    [] (const Clip& c, int64_t p) { return c.startPosition < p; });
+        bool stillListed = false;
+        for (; it != clips.end() && it->startPosition == open.clip.startPosition && ! stillListed; ++it)
+            stillListed = *it == open.clip;
+
+        if (! stillListed || (open.sample == nullptr && open.streamer == nullptr))
+        {
+            v.parked.store (false, std::memory_order_relaxed);
+            continue;   // the streamer, if any, stops as pendingOpens is cleared
+        }
+
+        v.sample = std::move (open.sample);
+        v.streamer = std::move (open.streamer);
+        v.prerollTargets = { noPrerollTargets, noPrerollTargets };
+        if (v.streamer != nullptr)
+            updatePreroll (v, targets);
+        v.state.store (Voice::ready, std::memory_order_release);
+    }
 }
 
 int64_t TrackProcessor::getFileLengthInSamples() const
 {
-    if (diskStreamer)
-        return diskStreamer->getLengthInSamples();
+    return fileLength.load();
+}
 
-    return 0;
+int TrackProcessor::getNumStreamingClips() const
+{
+    int n = 0;
+    for (int i = 0; i < getNumVoices(); ++i)
+        if (voices[static_cast<size_t> (i)]->state.load (std::memory_order_acquire) == Voice::ready)
+            ++n;
+    return n;
 }
 
 } // namespace dc
@@ -3,19 +3,66 @@
 #include "dc/engine/MidiBlock.h"
 #include "TransportController.h"
 #include "dc/audio/DiskStreamer.h"
+#include "dc/audio/SampleCache.h"
+#include <array>
+#include <chrono>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <atomic>
+#include <vector>
 
 namespace dc
 {
 
+/// Plays a track's audio clips from disk.
+///
+/// The clip list is owned by the message/prefetch side. A pool of voices,
+/// grown to the densest stretch of the playlist, is filled by
+/// ClipPrefetcher for clips that are playing or start within the
+/// look-ahead window. Short files play straight from the shared
+/// SampleCache; longer ones get a DiskStreamer each. The audio thread only
+/// mixes ready voices, so gaps between clips cost nothing and no file is
+/// opened or seeked on a clip boundary.
+///
+/// Clips at the loop start and the edit cursor keep a parked voice even
+/// when the playhead is elsewhere, and every streaming voice pre-rolls its
+/// clip start and any of those jump targets inside the clip, so a loop
+/// wrap or a jump to them plays from memory at once.
 class TrackProcessor : public AudioNode
 {
 public:
+    /// One audio clip on the timeline (all positions in samples).
+    struct Clip
+    {
+        std::filesystem::path sourceFile;
+        int64_t startPosition = 0;    // timeline position of the first frame
+        int64_t length = 0;           // timeline length
+        int64_t sourceOffset = 0;     // frame in the file played at startPosition (trimStart)
+        int64_t fadeInLength = 0;
+        int64_t fadeOutLength = 0;
+
+        int64_t getEndPosition() const { return startPosition + length; }
+
+        bool operator== (const Clip& other) const
+        {
+            return startPosition == other.startPosition && length == other.length
+                && sourceOffset == other.sourceOffset && fadeInLength == other.fadeInLength
+                && fadeOutLength == other.fadeOutLength && sourceFile == other.sourceFile;
+        }
+        bool operator!= (const Clip& other) const { return ! (*this == other); }
+    };
+
     TrackProcessor (TransportController& transport);
     ~TrackProcessor() override;
 
+    /// Replace the playlist. Safe while playing: voices for clips that are
+    /// unchanged keep streaming, others are dropped at the next block.
+    void setClips (std::vector<Clip> clips);
+
+    /// Single-clip playlist: the whole file at timeline position 0. The
+    /// clip's timeline length depends on the graph rate, so before the
+    /// first prepare() it is only recorded and placed by prepare().
     bool loadFile (const std::filesystem::path& file);
     void clearFile();
 
@@ -40,21 +87,163 @@ public:
 
     int64_t getFileLengthInSamples() const;
 
+    /// Conversion quality for clips whose file rate differs from the
+    /// graph rate. Applies to streams opened after the call.
+    void setResamplerQuality (Resampler::Quality q) { resamplerQuality.store (q); }
+    Resampler::Quality getResamplerQuality() const  { return resamplerQuality.load(); }
+
+    /// Number of clips currently holding an open stream or cached sample.
+    int getNumStreamingClips() const;
+
+    /// Total DiskStreamer underruns across this track's voices.
+    uint64_t getUnderrunCount() const { return underruns.load (std::memory_order_relaxed); }
+
+    /// How far ahead of the playhead clip streams are opened.
+    static constexpr double lookaheadSeconds = 2.0;
+
+    /// Upper bound on clips streaming at once (playing + upcoming). The
+    /// pool grows to the most clips any stretch of the playlist keeps
+    /// open, plus the parked ones, up to this many.
+    static constexpr int maxVoices = 256;
+
+    /// Clips starting this soon after a jump target are parked there.
+    /// Later ones are opened by the prefetcher after the jump in time.
+    static constexpr double parkWindowSeconds = 0.05;
+
+    /// Voices that may be parked at jump targets at once.
+    static constexpr int maxParkedVoices = 4;
+
     // Metering
     float getPeakLevelLeft() const  { return peakLeft.load(); }
     float getPeakLevelRight() const { return peakRight.load(); }
 
 private:
+    friend class ClipPrefetcher;
+
+    struct Voice
+    {
+        enum State { idle, ready, finished };
+
+        // idle: owned by the prefetcher; ready: owned by the audio thread;
+        // finished: handed back to the prefetcher for teardown
+        std::atomic<int> state { idle };
+        std::atomic<bool> cancelled { false };
+        std::atomic<bool> parked { false };     // at a jump target: kept while far from the playhead
+
+        Clip clip;
+        std::shared_ptr<const CachedSample> sample;       // short files
+        std::unique_ptr<dc::DiskStreamer> streamer;       // everything else
+        int64_t nextTimelinePosition = 0;
+        bool opening = false;     // idle, claimed by the prefetcher while its file opens
+
+        // Jump targets the stream's pre-roll was last pointed at; prefetcher only
+        std::array<int64_t, 2> prerollTargets { noPrerollTargets, noPrerollTargets };
+    };
+
+    static constexpr int64_t noPrerollTargets = -2;   // not a target, unlike -1 (none)
+
+    /// A voice claimed for a clip, opened without clipsMutex held.
+    struct PendingOpen
+    {
+        Voice* voice = nullptr;
+        Clip clip;
+        int64_t startAt = 0;
+        std::shared_ptr<const CachedSample> sample;
+        std::unique_ptr<dc::DiskStreamer> streamer;
+    };
+
+    /// Open voices for upcoming clips and reclaim finished ones.
+    /// Called on the ClipPrefetcher thread.
+    void prefetchClips();
+
+    /// Replace the playlist without forgetting a file from loadFile().
+    void applyClips (std::vector<Clip> clips);
+
+    /// The single clip for loadedFile at the current graph rate.
+    Clip makeFileClip() const;
+
+    /// Grow the pool to what the playlist needs at the current look-ahead.
+    /// Requires clipsMutex held; called on the ClipPrefetcher thread.
+    void reserveVoices();
+
+    /// Most clips that overlap any span of the given length.
+    int getMaxClipsWithin (int64_t span) const;
+
+    int getNumVoices() const { return numVoices.load (std::memory_order_acquire); }
+
+    /// Positions playback is likely to jump to: the loop start (when
+    /// looping) and the edit cursor; -1 for none.
+    using JumpTargets = std::array<int64_t, 2>;
+    JumpTargets getJumpTargets() const;
+
+    /// True if the clip plays within the park window of a target.
+    bool isNearJumpTarget (const Clip& clip, const JumpTargets& targets) const;
+
+    /// Point a voice's stream pre-roll at its clip start and targets inside
+    /// it. Does nothing while the targets stay the same.
+    void updatePreroll (Voice& v, const JumpTargets& targets);
+
+    /// Claim a voice for each clip overlapping [windowStart, windowEnd),
+    /// to be positioned at windowStart (or the clip start), and queue it in
+    /// pendingOpens. With parkedOnly, only clips that can be parked at a
+    /// target are claimed. Requires clipsMutex held. Returns false once the
+    /// voice pool is exhausted.
+    bool claimVoices (int64_t windowStart, int64_t windowEnd, const JumpTargets& targets,
+                      bool parkedOnly);
+
+    /// Load the clip's sample or open its stream. No lock needed.
+    static void openClip (PendingOpen& open, double sampleRate, Resampler::Quality quality);
+
+    /// Hand opened voices to the audio thread, dropping any whose clip has
+    /// left the playlist meanwhile. Requires clipsMutex held.
+    void publishOpenedVoices (const JumpTargets& targets);
+
+    /// Mix one voice's overlap with [blockStart, blockStart + numSamples).
+    /// Returns false once the clip has played out.
+    bool renderVoice (Voice& v, AudioBlock& audio, int64_t blockStart, int numSamples);
+
+    void retireVoice (Voice& v);
+
     TransportController& transportController;
-    std::unique_ptr<dc::DiskStreamer> diskStreamer;
+
+    std::mutex clipsMutex;            // guards clips, maxClipLength and the loaded file
+    std::vector<Clip> clips;          // sorted by startPosition
+    int64_t maxClipLength = 0;
+    int64_t sizedForLookahead = -1;   // look-ahead the pool was last sized for; -1 after a clip change
+    std::filesystem::path loadedFile;
+    double loadedFileRate = 0.0;
+    std::atomic<int64_t> fileLength { 0 };
+
+    // Grow-only: slots below numVoices are allocated and never move, so
+    // the audio thread can walk them while the prefetcher adds more
+    std::array<std::unique_ptr<Voice>, maxVoices> voices;
+    std::atomic<int> numVoices { 0 };
+    std::vector<PendingOpen> pendingOpens;    // prefetcher thread only
+    std::vector<int64_t> prerollPoints;       // prefetcher thread only
+
+    // Mapped samples are checked for truncation (a stat() each) this often,
+    // not on every prefetch pass
+    static constexpr auto truncationCheckInterval = std::chrono::milliseconds (250);
+    std::chrono::steady_clock::time_point nextTruncationCheck;   // prefetcher thread only
+
+    // Scratch for one voice's block, per channel
+    std::vector<float> scratchData[2];
+
+    // Zero until prepare(): nothing is opened before the graph rate is known
+    std::atomic<double> outputSampleRate { 0.0 };
+    std::atomic<Resampler::Quality> resamplerQuality { Resampler::Quality::standard };
+    std::atomic<int64_t> lookaheadSamples { 0 };
+    std::atomic<int64_t> parkWindowSamples { 0 };
 
     std::atomic<float> gain { 1.0f };
     std::atomic<float> pan { 0.0f };
     std::atomic<bool> muted { false };
     std::atomic<float> peakLeft { 0.0f };
     std::atomic<float> peakRight { 0.0f };
+    std::atomic<uint64_t> underruns { 0 };
 
-    int64_t lastSeekPosition = -1;
+    int64_t lastBlockEnd = -1;
+    std::atomic<int64_t> prefetchPosition { -1 };
 
     TrackProcessor (const TrackProcessor&) = delete;
     TrackProcessor& operator= (const TrackProcessor&) = delete;
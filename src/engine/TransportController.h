@@ -52,6 +52,10 @@ public:
     int64_t getLoopEndInSamples() const { return loopEndInSamples.load(); }
     void setLoopEndInSamples (int64_t pos) { loopEndInSamples.store (pos); }
 
+    // Edit cursor (a likely jump target; playback pre-rolls audio there)
+    int64_t getEditCursorInSamples() const { return editCursorInSamples.load(); }
+    void setEditCursorInSamples (int64_t pos) { editCursorInSamples.store (pos); }
+
     // Record arm
     bool isRecordArmed() const { return recordArmed.load(); }
     void setRecordArmed (bool armed) { recordArmed.store (armed); }
@@ -70,6 +74,8 @@ private:
     std::atomic<int64_t> loopStartInSamples { 0 };
     std::atomic<int64_t> loopEndInSamples { INT64_MAX };
 
+    std::atomic<int64_t> editCursorInSamples { 0 };
+
     // Record state
     std::atomic<bool> recordArmed { false };
 
@@ -7,6 +7,9 @@ namespace gfx
 
 Node::~Node()
 {
+    if (resourceOwner)
+        resourceOwner->releaseNode (*this);
+
     removeAllChildren();
 
     if (parent)
@@ -25,8 +28,9 @@ void Node::addChild (Node* child)
         child->parent->removeChild (child);
 
     child->parent = this;
+    child->clearDamage();
     children.push_back (child);
-    invalidate();
+    invalidateRect (child->localAreaToParent (Rect (0, 0, child->getWidth(), child->getHeight())));
 }
 
 void Node::removeChild (Node* child)
@@ -34,9 +38,10 @@ void Node::removeChild (Node* child)
     auto it = std::find (children.begin(), children.end(), child);
     if (it != children.end())
     {
+        auto area = child->localAreaToParent (Rect (0, 0, child->getWidth(), child->getHeight()));
         (*it)->parent = nullptr;
         children.erase (it);
-        invalidate();
+        invalidateRect (area);
     }
 }
 
@@ -59,16 +64,77 @@ void Node::setBounds (const Rect& newBounds)
 {
     if (bounds != newBounds)
     {
+        // Uncover where it was
+        if (parent)
+            parent->invalidateRect (localAreaToParent (Rect (0, 0, bounds.width, bounds.height)));
+
         bounds = newBounds;
         invalidateCache();
     }
 }
 
 void Node::invalidate()
+{
+    invalidateRect (Rect (0, 0, bounds.width, bounds.height));
+}
+
+void Node::invalidateRect (const Rect& localArea)
 {
     dirty = true;
+
+    // Painting clips every node to its bounds
+    auto area = localArea.intersection (Rect (0, 0, bounds.width, bounds.height));
+
     if (parent)
-        parent->invalidate();
+        parent->invalidateRect (area.isEmpty() ? Rect() : localAreaToParent (area));
+    else if (!area.isEmpty())
+        addDamage (area);
+}
+
+void Node::addDamage (const Rect& area)
+{
+    for (auto& d : damage)
+    {
+        if (d.intersects (area))
+        {
+            d = d.united (area);
+            return;
+        }
+    }
+
+    damage.push_back (area);
+
+    if (damage.size() > maxDamageRects)
+    {
+        Rect all;
+        for (const auto& d : damage)
+            all = all.united (d);
+        damage.assign (1, all);
+    }
+}
+
+Rect Node::localAreaToParent (const Rect& area) const
+{
+    if (transform.isIdentity())
+        return area.translated (bounds.x, bounds.y);
+
+    // The renderer applies the transform inside the bounds offset
+    Point corners[] = { transform.apply ({ area.x, area.y }),
+                        transform.apply ({ area.right(), area.y }),
+                        transform.apply ({ area.x, area.bottom() }),
+                        transform.apply ({ area.right(), area.bottom() }) };
+
+    float minX = corners[0].x, maxX = corners[0].x;
+    float minY = corners[0].y, maxY = corners[0].y;
+    for (const auto& c : corners)
+    {
+        minX = std::min (minX, c.x);
+        maxX = std::max (maxX, c.x);
+        minY = std::min (minY, c.y);
+        maxY = std::max (maxY, c.y);
+    }
+
+    return Rect (minX + bounds.x, minY + bounds.y, maxX - minX, maxY - minY);
 }
 
 bool Node::hitTest (Point localPoint) const
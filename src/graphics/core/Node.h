@@ -1,7 +1,6 @@
 #pragma once
 
 #include "Types.h"
-#include "include/core/SkSurface.h"
 #include <vector>
 #include <algorithm>
 
@@ -11,6 +10,19 @@ namespace gfx
 {
 
 class Canvas;
+class Node;
+
+// Something that holds resources for a node, such as the renderer's
+// TextureCache, and is told when the node is destroyed so it can let
+// them go
+class NodeResourceOwner
+{
+public:
+    virtual void releaseNode (Node& node) = 0;
+
+protected:
+    ~NodeResourceOwner() = default;
+};
 
 class Node
 {
@@ -41,7 +53,7 @@ public:
 
     // ─── Transform & visibility ──────────────────────────
 
-    void setTransform (const Transform2D& t) { transform = t; invalidate(); }
+    void setTransform (const Transform2D& t) { invalidate(); transform = t; invalidate(); }
     const Transform2D& getTransform() const { return transform; }
 
     void setOpacity (float o) { opacity = o; invalidate(); }
@@ -52,18 +64,31 @@ public:
 
     // ─── Dirty tracking ──────────────────────────────────
 
+    // Marks this node for repainting and damages the area it covers, as
+    // clipped by its ancestors. Damage collects at the root of the tree, in
+    // the root's coordinates, as a few rectangles.
     void invalidate();
+    void invalidateRect (const Rect& localArea);
     bool isDirty() const { return dirty; }
     void clearDirty() { dirty = false; }
 
-    // ─── Texture cache ───────────────────────────────────
+    bool hasDamage() const { return !damage.empty(); }
+    const std::vector<Rect>& getDamage() const { return damage; }
+    void clearDamage() { damage.clear(); }
+
+    // Beyond this many separate rectangles, damage collapses into one
+    static constexpr size_t maxDamageRects = 8;
 
-    bool hasTextureCache() const { return cachedSurface != nullptr; }
-    sk_sp<SkSurface> getCachedSurface() const { return cachedSurface; }
-    void setCachedSurface (sk_sp<SkSurface> surface) { cachedSurface = std::move (surface); }
-    void invalidateCache() { cachedSurface.reset(); invalidate(); }
+    // ─── Texture cache ───────────────────────────────────
 
+    // Paint this subtree once into a surface held by the renderer's
+    // TextureCache, and composite that until it is invalidated
     bool useTextureCache = false;
+    void invalidateCache() { invalidate(); }
+
+    // Set by whatever holds resources for this node; released on destruction
+    void setResourceOwner (NodeResourceOwner* owner) { resourceOwner = owner; }
+    NodeResourceOwner* getResourceOwner() const { return resourceOwner; }
 
     // ─── Painting ────────────────────────────────────────
 
@@ -85,6 +110,9 @@ public:
     Point localToGlobal (Point p) const;
     Point globalToLocal (Point p) const;
 
+    // Bounding box of a local area in the parent's coordinates, as painted
+    Rect localAreaToParent (const Rect& area) const;
+
 protected:
     Rect bounds;
     Transform2D transform;
@@ -96,7 +124,11 @@ protected:
     Node* parent = nullptr;
     std::vector<Node*> children;
 
-    sk_sp<SkSurface> cachedSurface;
+private:
+    void addDamage (const Rect& area);
+
+    std::vector<Rect> damage;
+    NodeResourceOwner* resourceOwner = nullptr;
 };
 
 } // namespace gfx
@@ -1,4 +1,5 @@
 #include "Canvas.h"
+#include "TextBlobCache.h"
 #include "include/core/SkImage.h"
 #include "include/effects/SkGradientShader.h"
 
@@ -140,40 +141,48 @@ void Canvas::fillRectWithHorizontalGradient (const Rect& r, Color left, Color ri
 
 void Canvas::drawText (const std::string& text, float x, float y, const SkFont& font, Color c)
 {
+    auto& shaped = TextBlobCache::getInstance().get (text, font);
+    if (! shaped.blob)
+        return;
+
     SkPaint paint;
     paint.setColor (toSkColor (c));
     paint.setAntiAlias (true);
-    canvas->drawSimpleText (text.c_str(), text.size(), SkTextEncoding::kUTF8, x, y, font, paint);
+    canvas->drawTextBlob (shaped.blob, x, y, paint);
 }
 
 void Canvas::drawTextCentred (const std::string& text, const Rect& r, const SkFont& font, Color c)
 {
+    auto& shaped = TextBlobCache::getInstance().get (text, font);
+    if (! shaped.blob)
+        return;
+
     SkPaint paint;
     paint.setColor (toSkColor (c));
     paint.setAntiAlias (true);
 
-    SkRect textBounds;
-    font.measureText (text.c_str(), text.size(), SkTextEncoding::kUTF8, &textBounds);
-
+    const auto& textBounds = shaped.bounds;
     float x = r.x + (r.width - textBounds.width()) * 0.5f - textBounds.fLeft;
     float y = r.y + (r.height - textBounds.height()) * 0.5f - textBounds.fTop;
 
-    canvas->drawSimpleText (text.c_str(), text.size(), SkTextEncoding::kUTF8, x, y, font, paint);
+    canvas->drawTextBlob (shaped.blob, x, y, paint);
 }
 
 void Canvas::drawTextRight (const std::string& text, const Rect& r, const SkFont& font, Color c)
 {
+    auto& shaped = TextBlobCache::getInstance().get (text, font);
+    if (! shaped.blob)
+        return;
+
     SkPaint paint;
     paint.setColor (toSkColor (c));
     paint.setAntiAlias (true);
 
-    SkRect textBounds;
-    font.measureText (text.c_str(), text.size(), SkTextEncoding::kUTF8, &textBounds);
-
+    const auto& textBounds = shaped.bounds;
     float x = r.right() - textBounds.width() - textBounds.fLeft - 4.0f;
     float y = r.y + (r.height - textBounds.height()) * 0.5f - textBounds.fTop;
 
-    canvas->drawSimpleText (text.c_str(), text.size(), SkTextEncoding::kUTF8, x, y, font, paint);
+    canvas->drawTextBlob (shaped.blob, x, y, paint);
 }
 
 // ─── Waveform ────────────────────────────────────────────────
@@ -0,0 +1,294 @@
+#include "FrameProfiler.h"
+#include "dc/foundation/file_utils.h"
+#include "dc/foundation/string_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+namespace dc
+{
+namespace gfx
+{
+
+namespace
+{
+double msSince (FrameProfiler::Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli> (FrameProfiler::Clock::now() - start).count();
+}
+
+std::string demangle (const char* name)
+{
+#if defined(__GNUG__)
+    int status = 0;
+    char* demangled = abi::__cxa_demangle (name, nullptr, nullptr, &status);
+    if (status == 0 && demangled != nullptr)
+    {
+        std::string result (demangled);
+        std::free (demangled);
+        return result;
+    }
+#endif
+    return name;
+}
+} // namespace
+
+const char* FrameProfiler::getPhaseName (Phase phase)
+{
+    switch (phase)
+    {
+        case Animation: return "animation";
+        case Acquire:   return "acquire";
+        case Layout:    return "layout";
+        case Paint:     return "paint";
+        case Composite: return "composite";
+        case Overlay:   return "overlay";
+        case Submit:    return "submit";
+        default:        return "?";
+    }
+}
+
+FrameProfiler::FrameProfiler()
+{
+    history.resize (defaultHistorySize);
+}
+
+void FrameProfiler::setHistorySize (int size)
+{
+    history.assign (static_cast<size_t> (std::max (1, size)), Frame());
+    nextFrame = 0;
+    numFrames = 0;
+}
+
+void FrameProfiler::clear()
+{
+    nextFrame = 0;
+    numFrames = 0;
+}
+
+// ─── Recording ───────────────────────────────────────────────
+
+void FrameProfiler::beginFrame()
+{
+    inFrame = isEnabled();
+    if (! inFrame)
+        return;
+
+    frameStart = Clock::now();
+    current = Frame();
+    std::fill (classMs.begin(), classMs.end(), 0.0f);
+}
+
+void FrameProfiler::cancelFrame()
+{
+    inFrame = false;
+}
+
+void FrameProfiler::endFrame (int64_t frameNumber, int paintedNodes, int64_t paintedPixels)
+{
+    if (! inFrame)
+        return;
+
+    inFrame = false;
+    current.frameNumber = frameNumber;
+    current.totalMs = msSince (frameStart);
+    current.paintedNodes = paintedNodes;
+    current.paintedPixels = paintedPixels;
+
+    // Keep the slowest classes of this frame
+    std::vector<int> painted;
+    for (int i = 0; i < static_cast<int> (classMs.size()); ++i)
+        if (classMs[static_cast<size_t> (i)] > 0.0f)
+            painted.push_back (i);
+
+    current.numWidgets = std::min (static_cast<int> (painted.size()), maxWidgetsPerFrame);
+    std::partial_sort (painted.begin(), painted.begin() + current.numWidgets, painted.end(),
+                       [this] (int a, int b) { return classMs[static_cast<size_t> (a)] > classMs[static_cast<size_t> (b)]; });
+
+    for (int i = 0; i < current.numWidgets; ++i)
+    {
+        int cls = painted[static_cast<size_t> (i)];
+        current.widgets[static_cast<size_t> (i)] = { cls, classMs[static_cast<size_t> (cls)] };
+    }
+
+    history[static_cast<size_t> (nextFrame)] = current;
+    nextFrame = (nextFrame + 1) % static_cast<int> (history.size());
+    numFrames = std::min (numFrames + 1, static_cast<int> (history.size()));
+}
+
+void FrameProfiler::addPhaseTime (Phase phase, Clock::time_point start)
+{
+    if (inFrame)
+        current.phaseMs[static_cast<size_t> (phase)] += msSince (start);
+}
+
+void FrameProfiler::addPaintTime (const std::type_info& widgetType, Clock::time_point start)
+{
+    if (! inFrame)
+        return;
+
+    float ms = static_cast<float> (msSince (start));
+    classMs[static_cast<size_t> (classIndexFor (widgetType))] += ms;
+}
+
+int FrameProfiler::classIndexFor (const std::type_info& widgetType)
+{
+    auto [it, inserted] = classIndices.try_emplace (std::type_index (widgetType),
+                                                    static_cast<int> (classNames.size()));
+    if (inserted)
+    {
+        classNames.push_back (demangle (widgetType.name()));
+        classMs.push_back (0.0f);
+    }
+
+    return it->second;
+}
+
+// ─── Queries ─────────────────────────────────────────────────
+
+const FrameProfiler::Frame& FrameProfiler::getFrame (int index) const
+{
+    int size = static_cast<int> (history.size());
+    int oldest = (nextFrame - numFrames + size) % size;
+    return history[static_cast<size_t> ((oldest + index) % size)];
+}
+
+FrameProfiler::Stats FrameProfiler::computeStats (std::vector<double>& values) const
+{
+    Stats stats;
+    stats.frames = static_cast<int> (values.size());
+    if (values.empty())
+        return stats;
+
+    std::sort (values.begin(), values.end());
+
+    // Nearest-rank percentiles
+    auto percentile = [&values] (double p)
+    {
+        auto rank = static_cast<size_t> (std::ceil (p * static_cast<double> (values.size())));
+        return values[std::clamp<size_t> (rank, 1, values.size()) - 1];
+    };
+
+    double sum = 0.0;
+    for (double v : values)
+    {
+        sum += v;
+        if (v > frameBudgetMs)
+            ++stats.overBudget;
+    }
+
+    stats.meanMs = sum / static_cast<double> (values.size());
+    stats.p50Ms = percentile (0.50);
+    stats.p90Ms = percentile (0.90);
+    stats.p99Ms = percentile (0.99);
+    stats.maxMs = values.back();
+    return stats;
+}
+
+FrameProfiler::Stats FrameProfiler::getStats() const
+{
+    std::vector<double> values;
+    values.reserve (static_cast<size_t> (numFrames));
+    for (int i = 0; i < numFrames; ++i)
+        values.push_back (getFrame (i).totalMs);
+    return computeStats (values);
+}
+
+FrameProfiler::Stats FrameProfiler::getPhaseStats (Phase phase) const
+{
+    std::vector<double> values;
+    values.reserve (static_cast<size_t> (numFrames));
+    for (int i = 0; i < numFrames; ++i)
+        values.push_back (getFrame (i).phaseMs[static_cast<size_t> (phase)]);
+    return computeStats (values);
+}
+
+// ─── Report ──────────────────────────────────────────────────
+
+std::string FrameProfiler::formatReport() const
+{
+    auto line = [] (const char* label, const Stats& s)
+    {
+        return dc::format ("  %-10s mean %7.2f  p50 %7.2f  p90 %7.2f  p99 %7.2f  max %7.2f ms\n",
+                           label, s.meanMs, s.p50Ms, s.p90Ms, s.p99Ms, s.maxMs);
+    };
+
+    auto total = getStats();
+    std::string report = dc::format ("Frame profile: %d painted frames, %d over the %.1f ms budget\n\n",
+                                     total.frames, total.overBudget, frameBudgetMs);
+
+    report += line ("total", total);
+    for (int p = 0; p < numPhases; ++p)
+        report += line (getPhaseName (static_cast<Phase> (p)), getPhaseStats (static_cast<Phase> (p)));
+
+    // Paint time by widget class, from each frame's slowest classes
+    struct ClassTotals
+    {
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+        int frames = 0;
+    };
+
+    std::map<int, ClassTotals> byClass;
+    for (int i = 0; i < numFrames; ++i)
+    {
+        const auto& frame = getFrame (i);
+        for (int w = 0; w < frame.numWidgets; ++w)
+        {
+            const auto& wt = frame.widgets[static_cast<size_t> (w)];
+            auto& totals = byClass[wt.widgetClass];
+            totals.totalMs += wt.ms;
+            totals.maxMs = std::max (totals.maxMs, static_cast<double> (wt.ms));
+            ++totals.frames;
+        }
+    }
+
+    std::vector<std::pair<int, ClassTotals>> classes (byClass.begin(), byClass.end());
+    std::sort (classes.begin(), classes.end(),
+               [] (const auto& a, const auto& b) { return a.second.totalMs > b.second.totalMs; });
+
+    report += "\nPaint time by widget (own paint, excluding children):\n";
+    for (const auto& [cls, totals] : classes)
+        report += dc::format ("  %9.2f ms total  %7.2f ms max  %5d frames  %s\n",
+                              totals.totalMs, totals.maxMs, totals.frames,
+                              getWidgetClassName (cls).c_str());
+
+    report += "\nFrames over budget:\n";
+    for (int i = 0; i < numFrames; ++i)
+    {
+        const auto& frame = getFrame (i);
+        if (frame.totalMs <= frameBudgetMs)
+            continue;
+
+        report += dc::format ("  #%lld  %.2f ms  %d nodes  %lld px\n   ",
+                              static_cast<long long> (frame.frameNumber), frame.totalMs,
+                              frame.paintedNodes, static_cast<long long> (frame.paintedPixels));
+
+        for (int p = 0; p < numPhases; ++p)
+            report += dc::format (" %s %.2f", getPhaseName (static_cast<Phase> (p)),
+                                  frame.phaseMs[static_cast<size_t> (p)]);
+        report += "\n";
+
+        for (int w = 0; w < frame.numWidgets; ++w)
+        {
+            const auto& wt = frame.widgets[static_cast<size_t> (w)];
+            report += dc::format ("    %7.2f ms  %s\n", static_cast<double> (wt.ms),
+                                  getWidgetClassName (wt.widgetClass).c_str());
+        }
+    }
+
+    return report;
+}
+
+bool FrameProfiler::dumpToFile (const std::filesystem::path& file) const
+{
+    return dc::writeStringToFile (file, formatReport());
+}
+
+} // namespace gfx
+} // namespace dc
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace dc
+{
+namespace gfx
+{
+
+// Where the Renderer's frame time goes, kept for the last frames painted.
+//
+// The renderer times each phase of a frame with ScopedPhase and each
+// node's own paint() and paintOverChildren() with ScopedPaint. Paint time
+// is grouped by widget class, excluding children, and each frame keeps
+// its most expensive classes so a slow frame can be traced to the widget
+// that caused it. Frames skipped for lack of damage aren't recorded.
+//
+// Timing costs two clock reads per painted node, so nothing is recorded
+// unless the overlay is showing, a capture is running or setEnabled is on.
+class FrameProfiler
+{
+public:
+    enum Phase
+    {
+        Animation,  // animation ticks
+        Acquire,    // waiting for a swapchain image
+        Layout,
+        Paint,
+        Composite,  // copying the persistent frame to the window
+        Overlay,    // the profiler's own graph
+        Submit,     // flush and present
+        numPhases
+    };
+
+    static const char* getPhaseName (Phase phase);
+
+    static constexpr int defaultHistorySize = 600;     // 10 s at 60 Hz
+    static constexpr int maxWidgetsPerFrame = 8;
+    static constexpr double frameBudgetMs = 1000.0 / 60.0;
+
+    struct WidgetTime
+    {
+        int widgetClass = -1;   // index into getWidgetClassName
+        float ms = 0.0f;
+    };
+
+    struct Frame
+    {
+        int64_t frameNumber = 0;
+        double totalMs = 0.0;
+        std::array<double, numPhases> phaseMs {};
+        int paintedNodes = 0;
+        int64_t paintedPixels = 0;
+        std::array<WidgetTime, maxWidgetsPerFrame> widgets {};    // slowest first
+        int numWidgets = 0;
+    };
+
+    struct Stats
+    {
+        int frames = 0;
+        double meanMs = 0.0;
+        double p50Ms = 0.0;
+        double p90Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+        int overBudget = 0;     // frames over frameBudgetMs
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    class ScopedPhase
+    {
+    public:
+        ScopedPhase (FrameProfiler& p, Phase ph)
+            : profiler (p), phase (ph), start (p.isEnabled() ? Clock::now() : Clock::time_point()) {}
+        ~ScopedPhase() { if (profiler.isEnabled()) profiler.addPhaseTime (phase, start); }
+
+    private:
+        FrameProfiler& profiler;
+        Phase phase;
+        Clock::time_point start;
+    };
+
+    class ScopedPaint
+    {
+    public:
+        ScopedPaint (FrameProfiler& p, const std::type_info& widgetType)
+            : profiler (p), type (widgetType), start (p.isEnabled() ? Clock::now() : Clock::time_point()) {}
+        ~ScopedPaint() { if (profiler.isEnabled()) profiler.addPaintTime (type, start); }
+
+    private:
+        FrameProfiler& profiler;
+        const std::type_info& type;
+        Clock::time_point start;
+    };
+
+    FrameProfiler();
+
+    void setEnabled (bool shouldBeEnabled) { enabled = shouldBeEnabled; }
+    bool isEnabled() const { return enabled || overlayVisible || capturing; }
+
+    void setOverlayVisible (bool visible) { overlayVisible = visible; }
+    bool isOverlayVisible() const { return overlayVisible; }
+
+    // Records frames for a later dumpToFile while the overlay is hidden
+    void setCapturing (bool shouldCapture) { capturing = shouldCapture; }
+    bool isCapturing() const { return capturing; }
+
+    void setHistorySize (int numFrames);
+    int getHistorySize() const { return static_cast<int> (history.size()); }
+
+    // Frame boundaries, called by the renderer. cancelFrame drops a frame
+    // that turned out to have nothing to paint.
+    void beginFrame();
+    void cancelFrame();
+    void endFrame (int64_t frameNumber, int paintedNodes, int64_t paintedPixels);
+
+    void addPhaseTime (Phase phase, Clock::time_point start);
+    void addPaintTime (const std::type_info& widgetType, Clock::time_point start);
+
+    // Recorded frames, oldest first (index 0) to newest
+    int getNumFrames() const { return numFrames; }
+    const Frame& getFrame (int index) const;
+
+    Stats getStats() const;
+    Stats getPhaseStats (Phase phase) const;
+
+    const std::string& getWidgetClassName (int widgetClass) const { return classNames[static_cast<size_t> (widgetClass)]; }
+
+    // Stats, the slowest widget classes and every frame over budget, as text
+    std::string formatReport() const;
+    bool dumpToFile (const std::filesystem::path& file) const;
+
+    void clear();
+
+private:
+    int classIndexFor (const std::type_info& widgetType);
+    Stats computeStats (std::vector<double>& values) const;
+
+    bool enabled = false;
+    bool overlayVisible = false;
+    bool capturing = false;
+
+    std::vector<Frame> history;     // ring buffer
+    int nextFrame = 0;
+    int numFrames = 0;
+
+    // Frame being recorded
+    bool inFrame = false;
+    Clock::time_point frameStart;
+    Frame current;
+    std::vector<float> classMs;     // by class index, this frame
+
+    std::unordered_map<std::type_index, int> classIndices;
+    std::vector<std::string> classNames;
+};
+
+} // namespace gfx
+} // namespace dc
@@ -1,6 +1,11 @@
 #include "Renderer.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkImage.h"
+#include "graphics/theme/FontManager.h"
+#include "graphics/theme/Theme.h"
 #include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <algorithm>
 
 namespace dc
@@ -9,7 +14,7 @@ namespace gfx
 {
 
 Renderer::Renderer (GpuBackend& b)
-    : backend (b)
+    : backend (b), textureCache (b)
 {
 }
 
@@ -21,47 +26,127 @@ void Renderer::renderFrame (Widget& rootWidget)
     double timestampMs = std::chrono::duration<double, std::milli> (
         std::chrono::high_resolution_clock::now().time_since_epoch()).count();
 
+    profiler.beginFrame();
+
     // Phase 1: Animation tick (always runs — may mark widgets dirty)
-    animationTick (timestampMs);
+    {
+        FrameProfiler::ScopedPhase phase (profiler, FrameProfiler::Animation);
+        animationTick (timestampMs);
+    }
 
-    // Phase 2: Check if we can skip this frame entirely
-    // If nothing is dirty, no animations are active, and we don't need a forced paint,
-    // skip the expensive GPU work.
-    if (!forcePaint && !isTreeDirty (rootWidget) && !hasActiveAnimations())
+    // Phase 2: Skip the frame entirely when nothing was damaged.
+    // Animating widgets repaint what they change, so they damage too.
+    lastFrameSkipped = !forcePaint && !rootWidget.hasDamage();
+    if (lastFrameSkipped)
     {
         skippedFrames++;
+        profiler.cancelFrame();
         return;
     }
 
-    forcePaint = false;
+    sk_sp<SkSurface> surface;
+    {
+        FrameProfiler::ScopedPhase phase (profiler, FrameProfiler::Acquire);
+        surface = backend.beginFrame();
+    }
 
-    auto surface = backend.beginFrame();
     if (!surface)
-        return;
+    {
+        profiler.cancelFrame();
+        return;     // damage stays pending for the next frame
+    }
 
-    SkCanvas* skCanvas = surface->getCanvas();
     float scale = backend.getScale();
 
-    // Scale for HiDPI — MTKView.drawableSize is in physical pixels,
-    // but our widget coordinates are in logical points.
-    skCanvas->save();
-    skCanvas->scale (scale, scale);
+    if (!frameSurface || frameSurface->width() != surface->width()
+                      || frameSurface->height() != surface->height())
+    {
+        frameSurface = backend.createOffscreenSurface (surface->width(), surface->height());
+        forcePaint = true;
+    }
+
+    // Without a persistent copy, everything is painted straight to the window
+    SkCanvas* skCanvas = frameSurface ? frameSurface->getCanvas() : surface->getCanvas();
+    if (!frameSurface)
+        forcePaint = true;
+
+    Rect window (0, 0, static_cast<float> (surface->width()) / scale,
+                 static_cast<float> (surface->height()) / scale);
+
+    // Damage is in the root's coordinates
+    std::vector<Rect> regions;
+    if (forcePaint)
+        regions.push_back (window);
+    else
+        for (const auto& d : rootWidget.getDamage())
+            regions.push_back (d.translated (rootWidget.getX(), rootWidget.getY()));
+
+    rootWidget.clearDamage();
+    forcePaint = false;
 
     // Phase 3: Layout pass (top-down)
-    layoutPass (rootWidget);
+    {
+        FrameProfiler::ScopedPhase phase (profiler, FrameProfiler::Layout);
+        layoutPass (rootWidget);
+    }
 
-    // Phase 4: Paint pass (depth-first)
+    // Phase 4: Paint pass (depth-first), once per damaged region; nodes
+    // outside it are skipped
     Canvas canvas (skCanvas);
-    paintPass (canvas, rootWidget, 1.0f);
+    lastPaintedPixels = 0;
+    lastPaintedNodes = 0;
 
-    skCanvas->restore();
+    {
+        FrameProfiler::ScopedPhase phase (profiler, FrameProfiler::Paint);
+
+        for (const auto& region : regions)
+        {
+            auto area = region.intersection (window);
+            if (area.isEmpty())
+                continue;
 
-    backend.endFrame (surface);
+            // Scale for HiDPI — the drawable is in physical pixels,
+            // but our widget coordinates are in logical points.
+            skCanvas->save();
+            skCanvas->scale (scale, scale);
+            canvas.clipRect (area);
+
+            paintPass (canvas, rootWidget, 1.0f);
+
+            skCanvas->restore();
+            lastPaintedPixels += static_cast<int64_t> (area.width * scale) * static_cast<int64_t> (area.height * scale);
+        }
+    }
+
+    if (frameSurface)
+    {
+        FrameProfiler::ScopedPhase phase (profiler, FrameProfiler::Composite);
+        auto image = frameSurface->makeImageSnapshot();
+        surface->getCanvas()->drawImage (image, 0, 0);
+    }
+
+    // Drawn on the window only, so it never lands in the persistent frame
+    if (profiler.isOverlayVisible())
+    {
+        FrameProfiler::ScopedPhase phase (profiler, FrameProfiler::Overlay);
+        Canvas windowCanvas (surface->getCanvas());
+        windowCanvas.save();
+        windowCanvas.scale (scale, scale);
+        paintProfilerOverlay (windowCanvas, window);
+        windowCanvas.restore();
+    }
+
+    {
+        FrameProfiler::ScopedPhase phase (profiler, FrameProfiler::Submit);
+        backend.endFrame (surface);
+    }
 
     // Track frame time
     auto endTime = std::chrono::high_resolution_clock::now();
     lastFrameTimeMs = std::chrono::duration<double, std::milli> (endTime - startTime).count();
     frameCount++;
+
+    profiler.endFrame (frameCount, lastPaintedNodes, lastPaintedPixels);
 }
 
 void Renderer::addAnimatingWidget (Widget* w)
@@ -117,93 +202,155 @@ void Renderer::paintPass (Canvas& canvas, Node& node, float parentOpacity)
         canvas.getSkCanvas()->concat (m);
     }
 
-    // Use texture cache if available and clean — skip entire subtree
-    if (node.useTextureCache && !node.isDirty() && node.hasTextureCache())
+    // Entirely outside the damaged region and the parent's clip
+    if (canvas.getSkCanvas()->quickReject (SkRect::MakeWH (bounds.width, bounds.height)))
     {
-        paintCached (canvas, node, effectiveOpacity);
+        canvas.restore();
+        return;
     }
-    else
+
+    // Cached subtree: painted once into its surface, then composited
+    if (node.useTextureCache && paintCached (canvas, node))
     {
-        // Clip to local bounds
-        canvas.clipRect (Rect (0, 0, bounds.width, bounds.height));
+        canvas.restore();
+        return;
+    }
 
-        // Paint this node
+    // Clip to local bounds
+    canvas.clipRect (Rect (0, 0, bounds.width, bounds.height));
+
+    // Paint this node
+    {
+        FrameProfiler::ScopedPaint timer (profiler, typeid (node));
         node.paint (canvas);
+    }
+    lastPaintedNodes++;
 
-        // Paint children
-        for (auto* child : node.getChildren())
-            paintPass (canvas, *child, effectiveOpacity);
+    // Paint children
+    for (auto* child : node.getChildren())
+        paintPass (canvas, *child, effectiveOpacity);
 
-        // Paint overlay
+    // Paint overlay
+    {
+        FrameProfiler::ScopedPaint timer (profiler, typeid (node));
         node.paintOverChildren (canvas);
-
-        // Update texture cache if enabled
-        if (node.useTextureCache)
-        {
-            int w = static_cast<int> (bounds.width * backend.getScale());
-            int h = static_cast<int> (bounds.height * backend.getScale());
-            if (w > 0 && h > 0)
-            {
-                auto offscreen = backend.createOffscreenSurface (w, h);
-                if (offscreen)
-                {
-                    SkCanvas* offCanvas = offscreen->getCanvas();
-                    offCanvas->scale (backend.getScale(), backend.getScale());
-                    Canvas offCanvasWrapper (offCanvas);
-                    node.paint (offCanvasWrapper);
-                    for (auto* child : node.getChildren())
-                        paintPass (offCanvasWrapper, *child, 1.0f);
-                    node.paintOverChildren (offCanvasWrapper);
-                    node.setCachedSurface (offscreen);
-                }
-            }
-        }
-
-        node.clearDirty();
     }
 
+    node.clearDirty();
+
     canvas.restore();
 }
 
-void Renderer::paintCached (Canvas& canvas, Node& node, float parentOpacity)
+bool Renderer::paintCached (Canvas& canvas, Node& node)
 {
-    auto surface = node.getCachedSurface();
-    if (surface)
+    float scale = backend.getScale();
+    const Rect& bounds = node.getBounds();
+    int w = static_cast<int> (std::ceil (bounds.width * scale));
+    int h = static_cast<int> (std::ceil (bounds.height * scale));
+
+    auto surface = node.isDirty() ? nullptr : textureCache.find (node, w, h);
+    if (!surface)
     {
-        auto image = surface->makeImageSnapshot();
-        if (image)
+        surface = textureCache.acquire (node, w, h);
+        if (!surface)
+            return false;   // too large to cache: paint it directly
+
+        SkCanvas* offCanvas = surface->getCanvas();
+        offCanvas->save();
+        offCanvas->scale (scale, scale);
+
+        Canvas offCanvasWrapper (offCanvas);
+        offCanvasWrapper.clipRect (Rect (0, 0, bounds.width, bounds.height));
+        {
+            FrameProfiler::ScopedPaint timer (profiler, typeid (node));
+            node.paint (offCanvasWrapper);
+        }
+        lastPaintedNodes++;
+        for (auto* child : node.getChildren())
+            paintPass (offCanvasWrapper, *child, 1.0f);
         {
-            float invScale = 1.0f / backend.getScale();
-            canvas.getSkCanvas()->save();
-            canvas.getSkCanvas()->scale (invScale, invScale);
-            canvas.drawImage (image, 0, 0);
-            canvas.getSkCanvas()->restore();
+            FrameProfiler::ScopedPaint timer (profiler, typeid (node));
+            node.paintOverChildren (offCanvasWrapper);
         }
+
+        offCanvas->restore();
+        node.clearDirty();
     }
+
+    auto image = surface->makeImageSnapshot();
+    if (!image)
+        return false;
+
+    // Surfaces come in size classes: only the top-left corner is this node
+    canvas.getSkCanvas()->drawImageRect (image, SkRect::MakeIWH (w, h),
+                                         SkRect::MakeWH (bounds.width, bounds.height),
+                                         SkSamplingOptions(), nullptr,
+                                         SkCanvas::kStrict_SrcRectConstraint);
+    return true;
 }
 
-bool Renderer::isTreeDirty (const Node& node) const
+void Renderer::paintProfilerOverlay (Canvas& canvas, const Rect& window)
 {
-    if (node.isDirty())
-        return true;
+    auto& theme = Theme::getDefault();
+    auto& font = FontManager::getInstance().getSmallFont();
 
-    for (auto* child : node.getChildren())
+    const float margin = 8.0f;
+    const float padding = 6.0f;
+    const float barWidth = 2.0f;
+    Rect box (window.width - 300.0f - margin, margin, 300.0f, 110.0f);
+
+    canvas.fillRoundedRect (box, 4.0f, theme.panelBackground.withAlpha ((uint8_t) 220));
+
+    // Frame times, newest on the right; the top of the graph is two frame budgets
+    Rect graph (box.x + padding, box.y + padding, box.width - padding * 2.0f, 60.0f);
+    double graphMs = FrameProfiler::frameBudgetMs * 2.0;
+    int numBars = std::min (profiler.getNumFrames(), static_cast<int> (graph.width / barWidth));
+
+    for (int i = 0; i < numBars; ++i)
     {
-        if (isTreeDirty (*child))
-            return true;
+        const auto& frame = profiler.getFrame (profiler.getNumFrames() - numBars + i);
+        float h = static_cast<float> (std::min (frame.totalMs / graphMs, 1.0)) * graph.height;
+
+        Color c = frame.totalMs <= FrameProfiler::frameBudgetMs ? theme.meterGreen
+                : frame.totalMs < graphMs                      ? theme.meterYellow
+                                                               : theme.meterRed;
+
+        float x = graph.right() - static_cast<float> (numBars - i) * barWidth;
+        canvas.fillRect (Rect (x, graph.bottom() - h, barWidth - 0.5f, h), c);
     }
 
-    return false;
-}
+    float budgetY = graph.bottom() - graph.height * 0.5f;
+    canvas.drawLine (graph.x, budgetY, graph.right(), budgetY, theme.dimText);
 
-bool Renderer::hasActiveAnimations() const
-{
-    for (auto* w : animatingWidgets)
+    // The text changes a few times a second, not every frame, so it stays
+    // readable and doesn't fill the text blob cache with one-off strings
+    if (profilerTextFrame < 0 || frameCount - profilerTextFrame >= profilerTextInterval)
     {
-        if (w->isAnimating())
-            return true;
+        profilerTextFrame = frameCount;
+
+        auto stats = profiler.getStats();
+        char line[160];
+        std::snprintf (line, sizeof (line), "p50 %.1f  p99 %.1f  max %.1f ms  (%d over)",
+                       stats.p50Ms, stats.p99Ms, stats.maxMs, stats.overBudget);
+        profilerStatsText = line;
+        profilerWidgetText.clear();
+
+        if (profiler.getNumFrames() > 0)
+        {
+            const auto& last = profiler.getFrame (profiler.getNumFrames() - 1);
+            if (last.numWidgets > 0)
+            {
+                const auto& slowest = last.widgets[0];
+                std::snprintf (line, sizeof (line), "%.1f ms  %s", static_cast<double> (slowest.ms),
+                               profiler.getWidgetClassName (slowest.widgetClass).c_str());
+                profilerWidgetText = line;
+            }
+        }
     }
-    return false;
+
+    canvas.drawText (profilerStatsText, graph.x, graph.bottom() + 16.0f, font, theme.defaultText);
+    if (! profilerWidgetText.empty())
+        canvas.drawText (profilerWidgetText, graph.x, graph.bottom() + 32.0f, font, theme.dimText);
 }
 
 } // namespace gfx
@@ -3,7 +3,11 @@
 #include "graphics/core/Node.h"
 #include "graphics/core/Widget.h"
 #include "Canvas.h"
+#include "FrameProfiler.h"
 #include "GpuBackend.h"
+#include "TextureCache.h"
+#include <cstdint>
+#include <string>
 #include <vector>
 
 namespace dc
@@ -24,12 +28,26 @@ public:
     void removeAnimatingWidget (Widget* w);
 
     GpuBackend& getBackend() { return backend; }
+    TextureCache& getTextureCache() { return textureCache; }
+
+    // Per-phase and per-widget timings of painted frames, with an optional
+    // graph drawn over the top-right corner of the window
+    FrameProfiler& getProfiler() { return profiler; }
 
     // Frame stats
     double getLastFrameTimeMs() const { return lastFrameTimeMs; }
     int getFrameCount() const { return frameCount; }
     int getSkippedFrames() const { return skippedFrames; }
 
+    // True when the last renderFrame found nothing damaged; the main loop
+    // stops its frame timer and waits for events while frames are skipped
+    bool wasLastFrameSkipped() const { return lastFrameSkipped; }
+
+    // Repaint cost of the last painted frame: device pixels inside the
+    // damaged regions, and nodes whose paint() ran
+    int64_t getLastPaintedPixels() const { return lastPaintedPixels; }
+    int getLastPaintedNodes() const { return lastPaintedNodes; }
+
     // Performance: force next frame to render (e.g., after resize)
     void forceNextFrame() { forcePaint = true; }
 
@@ -37,16 +55,31 @@ private:
     void animationTick (double timestampMs);
     void layoutPass (Widget& widget);
     void paintPass (Canvas& canvas, Node& node, float parentOpacity);
-    void paintCached (Canvas& canvas, Node& node, float parentOpacity);
-    bool isTreeDirty (const Node& node) const;
-    bool hasActiveAnimations() const;
+    bool paintCached (Canvas& canvas, Node& node);
+    void paintProfilerOverlay (Canvas& canvas, const Rect& window);
 
     GpuBackend& backend;
+    TextureCache textureCache;
+    FrameProfiler profiler;
+
+    // Overlay text, refreshed every profilerTextInterval painted frames
+    static constexpr int profilerTextInterval = 15;
+    std::string profilerStatsText;
+    std::string profilerWidgetText;
+    int profilerTextFrame = -1;
     std::vector<Widget*> animatingWidgets;
     double lastFrameTimeMs = 0.0;
     int frameCount = 0;
     int skippedFrames = 0;
+    bool lastFrameSkipped = false;
+    int64_t lastPaintedPixels = 0;
+    int lastPaintedNodes = 0;
     bool forcePaint = true;  // Always paint first frame
+
+    // Persistent copy of the window: swapchain images don't keep their
+    // contents between frames, so damaged regions are repainted here and
+    // the whole of it presented
+    sk_sp<SkSurface> frameSurface;
 };
 
 } // namespace gfx
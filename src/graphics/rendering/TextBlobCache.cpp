@@ -0,0 +1,90 @@
+#include "TextBlobCache.h"
+#include "include/core/SkTypeface.h"
+#include <algorithm>
+#include <functional>
+
+namespace dc
+{
+namespace gfx
+{
+
+size_t TextBlobCache::KeyHash::operator() (const Key& k) const
+{
+    // Equal keys need equal hashes only; operator== compares every font
+    // setting
+    size_t h = std::hash<std::string>() (k.text);
+
+    auto mix = [&h] (size_t v) { h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2); };
+    mix (k.font.getTypeface() != nullptr ? k.font.getTypeface()->uniqueID() : 0);
+    mix (std::hash<float>() (k.font.getSize()));
+    mix (std::hash<float>() (k.font.getScaleX()));
+    mix (static_cast<size_t> (k.font.getEdging()));
+    return h;
+}
+
+TextBlobCache& TextBlobCache::getInstance()
+{
+    static TextBlobCache instance;
+    return instance;
+}
+
+const TextBlobCache::Entry& TextBlobCache::get (const std::string& text, const SkFont& font)
+{
+    Key key { text, font };
+
+    auto it = entries.find (key);
+    if (it != entries.end())
+    {
+        ++hits;
+        lru.splice (lru.begin(), lru, it->second.lruPosition);
+        return it->second.entry;
+    }
+
+    ++misses;
+
+    Entry entry;
+    if (! text.empty())
+    {
+        entry.blob = SkTextBlob::MakeFromText (text.data(), text.size(), font, SkTextEncoding::kUTF8);
+        entry.advance = font.measureText (text.data(), text.size(), SkTextEncoding::kUTF8, &entry.bounds);
+    }
+
+    auto [pos, inserted] = entries.emplace (std::move (key), Slot { std::move (entry), {} });
+    lru.push_front (&pos->first);
+    pos->second.lruPosition = lru.begin();
+
+    // The new entry is most recent, so it survives eviction
+    evictToBudget();
+    return pos->second.entry;
+}
+
+void TextBlobCache::clear()
+{
+    entries.clear();
+    lru.clear();
+}
+
+void TextBlobCache::setMaxEntries (size_t newMaxEntries)
+{
+    maxEntries = std::max<size_t> (1, newMaxEntries);
+    evictToBudget();
+}
+
+double TextBlobCache::getHitRate() const
+{
+    auto lookups = hits + misses;
+    return lookups > 0 ? static_cast<double> (hits) / static_cast<double> (lookups) : 0.0;
+}
+
+void TextBlobCache::evictToBudget()
+{
+    while (entries.size() > maxEntries)
+    {
+        const Key* oldest = lru.back();
+        lru.pop_back();
+        entries.erase (entries.find (*oldest));
+    }
+}
+
+} // namespace gfx
+} // namespace dc
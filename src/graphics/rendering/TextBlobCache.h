@@ -0,0 +1,85 @@
+#pragma once
+
+#include "include/core/SkFont.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkTextBlob.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace dc
+{
+namespace gfx
+{
+
+// Shaped text shared by every Canvas, keyed by string and font.
+//
+// Labels, meter readouts and ruler numbers are drawn with the same
+// strings frame after frame; caching their text blobs and measured
+// bounds means a repaint draws glyph runs instead of converting UTF-8 to
+// glyphs and measuring again. Least recently used entries are dropped
+// beyond the entry budget. Used from the message thread only.
+class TextBlobCache
+{
+public:
+    static TextBlobCache& getInstance();
+
+    static constexpr size_t defaultMaxEntries = 4096;
+
+    struct Entry
+    {
+        sk_sp<SkTextBlob> blob;     // nullptr for empty text
+        SkRect bounds = SkRect::MakeEmpty();
+        float advance = 0.0f;
+    };
+
+    // The shaped text, built and measured on a miss. Valid until the
+    // next call, which may evict it
+    const Entry& get (const std::string& text, const SkFont& font);
+
+    void clear();
+
+    void setMaxEntries (size_t maxEntries);
+    size_t getMaxEntries() const { return maxEntries; }
+
+    // Stats
+    int getNumEntries() const { return static_cast<int> (entries.size()); }
+    int64_t getHits() const { return hits; }
+    int64_t getMisses() const { return misses; }
+    double getHitRate() const;
+    void resetStats() { hits = 0; misses = 0; }
+
+private:
+    struct Key
+    {
+        std::string text;
+        SkFont font;
+
+        bool operator== (const Key& o) const { return text == o.text && font == o.font; }
+    };
+
+    struct KeyHash
+    {
+        size_t operator() (const Key& k) const;
+    };
+
+    struct Slot
+    {
+        Entry entry;
+        std::list<const Key*>::iterator lruPosition;
+    };
+
+    void evictToBudget();
+
+    std::unordered_map<Key, Slot, KeyHash> entries;
+    std::list<const Key*> lru;      // most recent first; points at map keys
+
+    size_t maxEntries = defaultMaxEntries;
+    int64_t hits = 0;
+    int64_t misses = 0;
+};
+
+} // namespace gfx
+} // namespace dc
@@ -1,4 +1,5 @@
 #include "TextureCache.h"
+#include "include/core/SkCanvas.h"
 
 namespace dc
 {
@@ -10,22 +11,21 @@ TextureCache::TextureCache (GpuBackend& b)
 {
 }
 
+TextureCache::~TextureCache()
+{
+    clear();
+}
+
 void TextureCache::enableCaching (Node& node)
 {
     node.useTextureCache = true;
+    node.invalidateCache();
 }
 
 void TextureCache::disableCaching (Node& node)
 {
     node.useTextureCache = false;
-    if (node.hasTextureCache())
-    {
-        int w = static_cast<int> (node.getBounds().width * backend.getScale());
-        int h = static_cast<int> (node.getBounds().height * backend.getScale());
-        memoryUsageBytes -= static_cast<size_t> (w * h * 4);
-        cachedCount--;
-    }
-    node.setCachedSurface (nullptr);
+    release (node);
 }
 
 void TextureCache::invalidate (Node& node)
@@ -33,38 +33,157 @@ void TextureCache::invalidate (Node& node)
     node.invalidateCache();
 }
 
-sk_sp<SkSurface> TextureCache::getOrCreateSurface (Node& node)
+TextureCache::SizeClass TextureCache::sizeClassFor (int widthPx, int heightPx)
 {
-    if (node.hasTextureCache() && !node.isDirty())
-        return node.getCachedSurface();
+    auto roundUp = [] (int v) { return (v + sizeClassStep - 1) / sizeClassStep * sizeClassStep; };
+    return { roundUp (widthPx), roundUp (heightPx) };
+}
 
-    int w = static_cast<int> (node.getBounds().width * backend.getScale());
-    int h = static_cast<int> (node.getBounds().height * backend.getScale());
+sk_sp<SkSurface> TextureCache::find (Node& node, int widthPx, int heightPx)
+{
+    auto it = entries.find (&node);
+    if (it == entries.end() || it->second.widthPx != widthPx || it->second.heightPx != heightPx)
+        return nullptr;
+
+    hits++;
+    lru.splice (lru.begin(), lru, it->second.lruPosition);
+    return it->second.surface;
+}
 
-    if (w <= 0 || h <= 0)
+sk_sp<SkSurface> TextureCache::acquire (Node& node, int widthPx, int heightPx)
+{
+    if (widthPx <= 0 || heightPx <= 0 || widthPx > maxSurfaceDimension || heightPx > maxSurfaceDimension)
+    {
+        release (node);
         return nullptr;
+    }
+
+    misses++;
+    auto sizeClass = sizeClassFor (widthPx, heightPx);
 
-    // Track old surface memory
-    if (node.hasTextureCache())
+    auto it = entries.find (&node);
+    if (it != entries.end() && it->second.sizeClass != sizeClass)
     {
-        memoryUsageBytes -= static_cast<size_t> (w * h * 4);
-        cachedCount--;
+        release (node);
+        it = entries.end();
     }
 
-    auto surface = backend.createOffscreenSurface (w, h);
-    if (surface)
+    if (it == entries.end())
+    {
+        auto surface = takeSurface (sizeClass);
+        if (!surface)
+            return nullptr;
+
+        lru.push_front (&node);
+        node.setResourceOwner (this);
+        Entry entry;
+        entry.surface = std::move (surface);
+        entry.sizeClass = sizeClass;
+        entry.lruPosition = lru.begin();
+        it = entries.emplace (&node, std::move (entry)).first;
+    }
+    else
+    {
+        lru.splice (lru.begin(), lru, it->second.lruPosition);
+    }
+
+    it->second.widthPx = widthPx;
+    it->second.heightPx = heightPx;
+
+    auto surface = it->second.surface;
+    surface->getCanvas()->clear (SK_ColorTRANSPARENT);
+
+    evictToBudget (&node);
+    return surface;
+}
+
+void TextureCache::release (Node& node)
+{
+    auto it = entries.find (&node);
+    if (it == entries.end())
+        return;
+
+    returnSurface (it->second.sizeClass, std::move (it->second.surface));
+    removeEntry (it);
+
+    evictToBudget (nullptr);
+}
+
+void TextureCache::removeEntry (std::unordered_map<Node*, Entry>::iterator it)
+{
+    it->first->setResourceOwner (nullptr);
+    lru.erase (it->second.lruPosition);
+    entries.erase (it);
+}
+
+sk_sp<SkSurface> TextureCache::takeSurface (SizeClass c)
+{
+    auto free = pool.find (c);
+    if (free != pool.end() && !free->second.empty())
     {
-        node.setCachedSurface (surface);
-        memoryUsageBytes += static_cast<size_t> (w * h * 4);
-        cachedCount++;
+        auto surface = std::move (free->second.back());
+        free->second.pop_back();
+        return surface;     // its bytes are already counted
     }
 
+    auto surface = backend.createOffscreenSurface (c.first, c.second);
+    if (surface)
+        memoryUsageBytes += bytesOf (c);
+
     return surface;
 }
 
+void TextureCache::returnSurface (SizeClass c, sk_sp<SkSurface> surface)
+{
+    if (surface)
+        pool[c].push_back (std::move (surface));
+}
+
+void TextureCache::evictToBudget (const Node* keep)
+{
+    // Idle surfaces first
+    for (auto it = pool.begin(); it != pool.end() && memoryUsageBytes > memoryBudget;)
+    {
+        while (!it->second.empty() && memoryUsageBytes > memoryBudget)
+        {
+            it->second.pop_back();
+            memoryUsageBytes -= bytesOf (it->first);
+        }
+
+        it = it->second.empty() ? pool.erase (it) : std::next (it);
+    }
+
+    // Then the least recently drawn nodes, which repaint when next shown
+    while (memoryUsageBytes > memoryBudget && !lru.empty() && lru.back() != keep)
+    {
+        auto it = entries.find (lru.back());
+        memoryUsageBytes -= bytesOf (it->second.sizeClass);
+        removeEntry (it);
+    }
+}
+
+void TextureCache::setMemoryBudget (size_t bytes)
+{
+    memoryBudget = bytes;
+    evictToBudget (nullptr);
+}
+
+int TextureCache::getPooledCount() const
+{
+    size_t count = 0;
+    for (const auto& [sizeClass, surfaces] : pool)
+        count += surfaces.size();
+    return static_cast<int> (count);
+}
+
 void TextureCache::clear()
 {
-    cachedCount = 0;
+    for (auto& [node, entry] : entries)
+        node->setResourceOwner (nullptr);
+
+    entries.clear();
+    lru.clear();
+    pool.clear();
     memoryUsageBytes = 0;
 }
 
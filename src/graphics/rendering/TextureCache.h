@@ -2,16 +2,40 @@
 
 #include "graphics/core/Node.h"
 #include "GpuBackend.h"
+#include "include/core/SkSurface.h"
+#include <cstdint>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace dc
 {
 namespace gfx
 {
 
-class TextureCache
+// Offscreen surfaces holding the painted subtrees of nodes with
+// useTextureCache set, owned by the Renderer.
+//
+// Surfaces are allocated in size classes and recycled: a node that
+// resizes, or is dropped from the cache, returns its surface to a free
+// pool for the next node of that class. Entries and pooled surfaces
+// together stay within the memory budget; pooled surfaces go first, then
+// the least recently used entries.
+//
+// Each node with an entry has the cache as its resource owner, so a node
+// destroyed while scrolled out of view returns its surface to the pool
+// rather than holding it until the LRU gets to it.
+class TextureCache : public NodeResourceOwner
 {
 public:
     explicit TextureCache (GpuBackend& backend);
+    ~TextureCache();
+
+    static constexpr int sizeClassStep = 64;            // device pixels
+    static constexpr int maxSurfaceDimension = 4096;    // larger nodes paint directly
+    static constexpr size_t defaultMemoryBudgetBytes = 128u * 1024u * 1024u;
 
     // Enable caching for a node
     void enableCaching (Node& node);
@@ -22,20 +46,63 @@ public:
     // Invalidate a specific node's cache (forces re-render next frame)
     void invalidate (Node& node);
 
-    // Get or create cached surface for a node
-    sk_sp<SkSurface> getOrCreateSurface (Node& node);
+    // The node's surface if it holds a painting of widthPx x heightPx;
+    // counted as a hit
+    sk_sp<SkSurface> find (Node& node, int widthPx, int heightPx);
+
+    // A cleared surface of at least widthPx x heightPx for the node to be
+    // painted into; counted as a miss. nullptr if it is too large to cache
+    sk_sp<SkSurface> acquire (Node& node, int widthPx, int heightPx);
+
+    // Return a node's surface to the pool
+    void release (Node& node);
+
+    // Called as a node with an entry is destroyed
+    void releaseNode (Node& node) override { release (node); }
 
     // Release all cached surfaces
     void clear();
 
+    void setMemoryBudget (size_t bytes);
+    size_t getMemoryBudget() const { return memoryBudget; }
+
     // Stats
-    int getCachedCount() const { return cachedCount; }
+    int getCachedCount() const { return static_cast<int> (entries.size()); }
+    int getPooledCount() const;
     size_t getMemoryUsageBytes() const { return memoryUsageBytes; }
+    int64_t getHits() const { return hits; }
+    int64_t getMisses() const { return misses; }
+    void resetStats() { hits = 0; misses = 0; }
 
 private:
+    using SizeClass = std::pair<int, int>;
+
+    struct Entry
+    {
+        sk_sp<SkSurface> surface;
+        SizeClass sizeClass;
+        int widthPx = 0;
+        int heightPx = 0;
+        std::list<Node*>::iterator lruPosition;
+    };
+
+    static SizeClass sizeClassFor (int widthPx, int heightPx);
+    static size_t bytesOf (SizeClass c) { return static_cast<size_t> (c.first) * static_cast<size_t> (c.second) * 4; }
+
+    sk_sp<SkSurface> takeSurface (SizeClass c);
+    void returnSurface (SizeClass c, sk_sp<SkSurface> surface);
+    void evictToBudget (const Node* keep);
+    void removeEntry (std::unordered_map<Node*, Entry>::iterator it);
+
     GpuBackend& backend;
-    int cachedCount = 0;
-    size_t memoryUsageBytes = 0;
+    std::unordered_map<Node*, Entry> entries;
+    std::list<Node*> lru;     // most recent first
+    std::map<SizeClass, std::vector<sk_sp<SkSurface>>> pool;
+
+    size_t memoryBudget = defaultMemoryBudgetBytes;
+    size_t memoryUsageBytes = 0;    // entries and pooled surfaces
+    int64_t hits = 0;
+    int64_t misses = 0;
 };
 
 } // namespace gfx
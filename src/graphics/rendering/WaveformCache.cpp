@@ -1,8 +1,6 @@
 #include "WaveformCache.h"
-#include "dc/audio/AudioFileReader.h"
-#include <cmath>
+#include "dc/audio/PeakStore.h"
 #include <algorithm>
-#include <vector>
 
 namespace dc
 {
@@ -19,117 +17,168 @@ WaveformCache::~WaveformCache()
 
 void WaveformCache::loadFromFile (const std::filesystem::path& audioFile)
 {
-    auto reader = dc::AudioFileReader::open (audioFile);
-    if (!reader)
+    auto file = dc::PeakStore::getInstance().acquire (audioFile);
+    if (!file)
         return;
 
-    int64_t numSamples = reader->getLengthInSamples();
-    cachedSampleRate = reader->getSampleRate();
-    int numChannels = reader->getNumChannels();
+    std::lock_guard<std::mutex> lock (lodMutex);
+    livePeaks.reset();
+    peaks = std::move (file);
+    totalSamples = peaks->getLengthInFrames();
+    cachedSampleRate = peaks->getSampleRate();
+    loaded.store (true);
+}
 
-    int64_t samplesToRead = std::min (numSamples, static_cast<int64_t> (10000000));
+void WaveformCache::loadInBackground (const std::filesystem::path& audioFile)
+{
+    auto file = dc::PeakStore::getInstance().request (audioFile);
+    if (!file)
+        return;
 
-    // Read interleaved data
-    std::vector<float> interleaved (static_cast<size_t> (samplesToRead * numChannels));
-    int64_t framesRead = reader->read (interleaved.data(), 0, samplesToRead);
+    std::lock_guard<std::mutex> lock (lodMutex);
+    livePeaks.reset();
+    peaks = std::move (file);
+    totalSamples = peaks->getLengthInFrames();
+    cachedSampleRate = peaks->getSampleRate();
+    loaded.store (true);
+}
 
-    // Extract channel 0 by stepping every numChannels samples
-    std::vector<float> mono (static_cast<size_t> (framesRead));
-    for (int64_t i = 0; i < framesRead; ++i)
-        mono[static_cast<size_t> (i)] = interleaved[static_cast<size_t> (i * numChannels)];
+void WaveformCache::loadFromLivePeaks (std::shared_ptr<dc::LivePeaks> live)
+{
+    if (!live)
+        return;
 
-    buildLODs (mono.data(), framesRead);
+    std::lock_guard<std::mutex> lock (lodMutex);
+    peaks.reset();
+    cachedSampleRate = live->getSampleRate();
+    livePeaks = std::move (live);
+    loaded.store (true);
 }
 
 void WaveformCache::loadFromBuffer (const float* samples, int64_t numSamples, double sampleRate)
 {
-    cachedSampleRate = sampleRate;
-    if (samples != nullptr && numSamples > 0)
-        buildLODs (samples, numSamples);
-}
+    if (samples == nullptr || numSamples <= 0)
+        return;
 
-void WaveformCache::buildLODs (const float* samples, int64_t numSamples)
-{
     std::lock_guard<std::mutex> lock (lodMutex);
 
+    peaks.reset();
+    livePeaks.reset();
+    cachedSampleRate = sampleRate;
     totalSamples = numSamples;
 
-    for (int lod = 0; lod < numLODs; ++lod)
+    for (auto& level : bufferLevels)
+        level.clear();
+
+    dc::PeakAccumulator accumulator (1, [this] (int level, int, int64_t, MinMaxPair minMax, float)
     {
-        int spb = lodSamplesPerBucket[static_cast<size_t> (lod)];
-        int64_t numBuckets = (numSamples + spb - 1) / spb;
+        bufferLevels[static_cast<size_t> (level)].push_back (minMax);
+    });
 
-        lods[static_cast<size_t> (lod)].samplesPerBucket = spb;
-        lods[static_cast<size_t> (lod)].data.resize (static_cast<size_t> (numBuckets));
+    accumulator.add (samples, numSamples);
+    accumulator.finish();
 
-        for (int64_t b = 0; b < numBuckets; ++b)
-        {
-            int64_t start = b * spb;
-            int64_t end = std::min (start + spb, numSamples);
+    loaded.store (true);
+}
 
-            float minVal = 0.0f;
-            float maxVal = 0.0f;
+bool WaveformCache::isComplete() const
+{
+    std::lock_guard<std::mutex> lock (lodMutex);
+    if (livePeaks)
+        return livePeaks->isComplete();
+    return loaded.load() && (!peaks || peaks->isComplete());
+}
 
-            for (int64_t s = start; s < end; ++s)
-            {
-                float v = samples[s];
-                minVal = std::min (minVal, v);
-                maxVal = std::max (maxVal, v);
-            }
+int64_t WaveformCache::getTotalSamples() const
+{
+    std::lock_guard<std::mutex> lock (lodMutex);
+    if (livePeaks)
+        return livePeaks->getFramesDone();
+    return totalSamples;
+}
+
+int WaveformCache::getNumChannels() const
+{
+    std::lock_guard<std::mutex> lock (lodMutex);
+    if (peaks)
+        return peaks->getNumChannels();
+    if (livePeaks)
+        return livePeaks->getNumChannels();
+    return loaded.load() ? 1 : 0;
+}
 
-            lods[static_cast<size_t> (lod)].data[static_cast<size_t> (b)] = { minVal, maxVal };
-        }
+WaveformCache::LODData WaveformCache::lodFor (int lodIndex, int channel) const
+{
+    LODData lod;
+    lod.samplesPerBucket = dc::PeakFile::samplesPerBucket (lodIndex);
+
+    if (peaks)
+    {
+        channel = std::clamp (channel, 0, peaks->getNumChannels() - 1);
+        lod.data = peaks->getMinMax (lodIndex, channel);
+        lod.size = peaks->getNumBucketsReady (lodIndex);
+    }
+    else if (livePeaks)
+    {
+        // Count first: the arrays it is read from hold at least that many
+        channel = std::clamp (channel, 0, livePeaks->getNumChannels() - 1);
+        lod.size = livePeaks->getNumBucketsReady (lodIndex, channel);
+        lod.data = livePeaks->getMinMax (lodIndex, channel);
+    }
+    else
+    {
+        const auto& level = bufferLevels[static_cast<size_t> (lodIndex)];
+        lod.data = level.data();
+        lod.size = static_cast<int64_t> (level.size());
     }
 
-    loaded.store (true);
+    return lod;
 }
 
-const WaveformCache::LODData* WaveformCache::getLOD (double pixelsPerSecond, double sampleRate) const
+const WaveformCache::LODData* WaveformCache::getLOD (double pixelsPerSecond, double sampleRate, int channel) const
 {
     if (!loaded.load())
         return nullptr;
 
-    // Calculate samples per pixel at current zoom
-    double samplesPerPixel = sampleRate / pixelsPerSecond;
+    // Coarsest level whose buckets are no wider than a pixel
+    int bestLOD = dc::PeakFile::levelFor (sampleRate / pixelsPerSecond);
 
-    // Find the best LOD (the one with samplesPerBucket closest to but <= samplesPerPixel)
-    int bestLOD = 0;
-    for (int i = numLODs - 1; i >= 0; --i)
-    {
-        if (lodSamplesPerBucket[static_cast<size_t> (i)] <= samplesPerPixel)
-        {
-            bestLOD = i;
-            break;
-        }
-    }
+    std::lock_guard<std::mutex> lock (lodMutex);
+    auto& lod = lods[static_cast<size_t> (bestLOD)];
+    lod = lodFor (bestLOD, channel);
+    return &lod;
+}
 
-    return &lods[static_cast<size_t> (bestLOD)];
+WaveformCache::LODData WaveformCache::getLODForResolution (double samplesPerPixel, int channel) const
+{
+    if (!loaded.load())
+        return {};
+
+    std::lock_guard<std::mutex> lock (lodMutex);
+    return lodFor (dc::PeakFile::levelFor (samplesPerPixel), channel);
 }
 
 std::vector<WaveformCache::MinMaxPair> WaveformCache::getRegion (
-    int lodIndex, int64_t startSample, int64_t numSamples) const
+    int lodIndex, int64_t startSample, int64_t numSamples, int channel) const
 {
     std::lock_guard<std::mutex> lock (lodMutex);
 
-    if (lodIndex < 0 || lodIndex >= numLODs)
+    if (lodIndex < 0 || lodIndex >= numLODs || !loaded.load())
         return {};
 
-    const auto& lod = lods[static_cast<size_t> (lodIndex)];
-    int spb = lod.samplesPerBucket;
+    auto lod = lodFor (lodIndex, channel);
+    auto spb = lod.samplesPerBucket;
 
     int64_t startBucket = startSample / spb;
     int64_t endBucket = (startSample + numSamples + spb - 1) / spb;
-    int64_t numBuckets = static_cast<int64_t> (lod.data.size());
 
-    startBucket = std::clamp (startBucket, (int64_t) 0, numBuckets);
-    endBucket = std::clamp (endBucket, (int64_t) 0, numBuckets);
+    startBucket = std::clamp (startBucket, (int64_t) 0, lod.size);
+    endBucket = std::clamp (endBucket, (int64_t) 0, lod.size);
 
-    if (startBucket >= endBucket)
+    if (startBucket >= endBucket || lod.data == nullptr)
         return {};
 
-    return std::vector<MinMaxPair> (
-        lod.data.begin() + startBucket,
-        lod.data.begin() + endBucket);
+    return std::vector<MinMaxPair> (lod.data + startBucket, lod.data + endBucket);
 }
 
 } // namespace gfx
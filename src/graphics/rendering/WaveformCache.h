@@ -1,8 +1,11 @@
 #pragma once
 
+#include "dc/audio/LivePeaks.h"
+#include "dc/audio/PeakFile.h"
 #include <filesystem>
 #include <vector>
 #include <array>
+#include <memory>
 #include <mutex>
 #include <atomic>
 #include <cstdint>
@@ -12,51 +15,75 @@ namespace dc
 namespace gfx
 {
 
+// Waveform peaks for display, at PeakFile::numLevels resolutions.
+// Backed by a memory-mapped peak file (see dc::PeakStore), by the live
+// peaks of a take being recorded, or by peaks computed in memory for
+// audio that has no file.
 class WaveformCache
 {
 public:
-    struct MinMaxPair
-    {
-        float minVal = 0.0f;
-        float maxVal = 0.0f;
-    };
+    using MinMaxPair = dc::PeakFile::MinMax;
 
-    // LOD levels: samples per pixel bucket
-    static constexpr int numLODs = 4;
-    static constexpr std::array<int, numLODs> lodSamplesPerBucket = { 256, 1024, 4096, 16384 };
+    static constexpr int numLODs = dc::PeakFile::numLevels;
 
     struct LODData
     {
-        std::vector<MinMaxPair> data;
-        int samplesPerBucket = 0;
+        const MinMaxPair* data = nullptr;
+        int64_t size = 0;               // buckets ready to draw
+        int64_t samplesPerBucket = 0;
     };
 
     WaveformCache();
     ~WaveformCache();
 
-    // Load from audio file (uses dc::AudioFileReader)
+    // Map the file's peak file, scanning the file first if it has none
     void loadFromFile (const std::filesystem::path& audioFile);
 
-    // Load from existing raw sample buffer (channel 0, mono)
+    // Map whatever peaks the file has and build the rest in the background;
+    // isComplete() turns true once they are all there
+    void loadInBackground (const std::filesystem::path& audioFile);
+
+    // Draw a take while it is recorded; grows with it, and is complete
+    // when the take ends
+    void loadFromLivePeaks (std::shared_ptr<dc::LivePeaks> live);
+
+    // Load from existing raw sample buffer (mono)
     void loadFromBuffer (const float* samples, int64_t numSamples, double sampleRate);
 
     // Get the best LOD for current zoom level
-    const LODData* getLOD (double pixelsPerSecond, double sampleRate) const;
+    const LODData* getLOD (double pixelsPerSecond, double sampleRate, int channel = 0) const;
+
+    // Same, by value and safe from any thread; the data stays valid while
+    // the cache lives
+    LODData getLODForResolution (double samplesPerPixel, int channel = 0) const;
 
     // Get data for a specific region
-    std::vector<MinMaxPair> getRegion (int lodIndex, int64_t startSample, int64_t numSamples) const;
+    std::vector<MinMaxPair> getRegion (int lodIndex, int64_t startSample, int64_t numSamples, int channel = 0) const;
 
     bool isLoaded() const { return loaded.load(); }
-    int64_t getTotalSamples() const { return totalSamples; }
+    bool isComplete() const;
+
+    // A background load has been queued and not finished yet
+    bool isPending() const { return pending.load(); }
+
+    int64_t getTotalSamples() const;
+    int getNumChannels() const;
 
 private:
-    void buildLODs (const float* samples, int64_t numSamples);
+    LODData lodFor (int lodIndex, int channel) const;
 
-    std::array<LODData, numLODs> lods;
+    std::shared_ptr<dc::PeakFile> peaks;
+    std::shared_ptr<dc::LivePeaks> livePeaks;
+    std::array<std::vector<MinMaxPair>, numLODs> bufferLevels;
+
+    mutable std::array<LODData, numLODs> lods;
     int64_t totalSamples = 0;
     double cachedSampleRate = 44100.0;
     std::atomic<bool> loaded { false };
+    std::atomic<bool> pending { false };
     mutable std::mutex lodMutex;
+
+    friend class WaveformRegistry;
 };
 
 } // namespace gfx
@@ -0,0 +1,122 @@
+#include "WaveformRegistry.h"
+#include "dc/audio/PeakStore.h"
+#include <condition_variable>
+
+namespace dc
+{
+namespace gfx
+{
+
+WaveformRegistry& WaveformRegistry::getInstance()
+{
+    static WaveformRegistry instance;
+    return instance;
+}
+
+WaveformRegistry::WaveformRegistry()
+{
+    // Loads go through the PeakStore; make sure it outlives our workers
+    dc::PeakStore::getInstance();
+
+    for (int i = 0; i < numLoaders; ++i)
+        loaders.push_back (std::make_unique<dc::WorkerThread> ("WaveformLoader"));
+}
+
+WaveformRegistry::~WaveformRegistry()
+{
+    for (auto& loader : loaders)
+        loader->stop();
+}
+
+std::filesystem::path WaveformRegistry::keyFor (const std::filesystem::path& audioFile)
+{
+    // Purely lexical, so a lookup costs no file system access
+    if (audioFile.is_absolute())
+        return audioFile.lexically_normal();
+
+    std::error_code ec;
+    return std::filesystem::absolute (audioFile, ec).lexically_normal();
+}
+
+std::shared_ptr<WaveformCache> WaveformRegistry::get (const std::filesystem::path& audioFile)
+{
+    if (audioFile.empty())
+        return std::make_shared<WaveformCache>();
+
+    auto key = keyFor (audioFile);
+    std::lock_guard<std::mutex> lock (mutex);
+
+    auto it = entries.find (key);
+    if (it != entries.end())
+    {
+        if (auto existing = it->second.lock())
+            return existing;
+    }
+
+    // Forget files nobody shows any more
+    for (auto e = entries.begin(); e != entries.end();)
+        e = e->second.expired() ? entries.erase (e) : std::next (e);
+
+    auto cache = std::make_shared<WaveformCache>();
+    cache->pending.store (true);
+    entries[key] = cache;
+
+    std::weak_ptr<WaveformCache> weak = cache;
+    pendingLoads.fetch_add (1);
+    loaders[nextLoader++ % loaders.size()]->submit ([this, weak, key]
+    {
+        // Skip loads for clips that are gone already
+        if (auto target = weak.lock())
+        {
+            target->loadInBackground (key);
+            target->pending.store (false);
+        }
+
+        pendingLoads.fetch_sub (1);
+    });
+
+    return cache;
+}
+
+void WaveformRegistry::add (const std::filesystem::path& audioFile, std::shared_ptr<WaveformCache> peaks)
+{
+    if (audioFile.empty() || peaks == nullptr || !peaks->isLoaded())
+        return;
+
+    std::lock_guard<std::mutex> lock (mutex);
+    entries[keyFor (audioFile)] = peaks;
+}
+
+int WaveformRegistry::getNumEntries() const
+{
+    std::lock_guard<std::mutex> lock (mutex);
+
+    int n = 0;
+    for (auto& [key, entry] : entries)
+        if (!entry.expired())
+            ++n;
+    return n;
+}
+
+void WaveformRegistry::waitForLoads()
+{
+    std::mutex doneMutex;
+    std::condition_variable doneCv;
+    size_t remaining = loaders.size();
+
+    for (auto& loader : loaders)
+    {
+        loader->submit ([&]
+        {
+            std::lock_guard<std::mutex> lock (doneMutex);
+            --remaining;
+            doneCv.notify_all();
+        });
+    }
+
+    std::unique_lock<std::mutex> lock (doneMutex);
+    doneCv.wait (lock, [&] { return remaining == 0; });
+}
+
+} // namespace gfx
+} // namespace dc
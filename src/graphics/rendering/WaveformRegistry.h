@@ -0,0 +1,63 @@
+#pragma once
+
+#include "WaveformCache.h"
+#include "dc/foundation/worker_thread.h"
+#include <atomic>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dc
+{
+namespace gfx
+{
+
+// Process-wide registry of waveform peaks, one WaveformCache per audio file.
+//
+// Every clip showing a file shares its cache, and the cache lives as long
+// as any of them holds it. get() never touches the disk: a file nobody
+// holds yet gets an empty cache that is loaded on a background worker and
+// becomes isLoaded() when its peaks are mapped, so views can be rebuilt
+// on every resize or zoom for free.
+class WaveformRegistry
+{
+public:
+    static WaveformRegistry& getInstance();
+
+    WaveformRegistry();
+    ~WaveformRegistry();
+
+    // Shared peaks of audioFile, loading in the background if needed
+    std::shared_ptr<WaveformCache> get (const std::filesystem::path& audioFile);
+
+    // Share peaks loaded elsewhere (e.g. during import) under audioFile
+    void add (const std::filesystem::path& audioFile, std::shared_ptr<WaveformCache> peaks);
+
+    // Files whose peaks are currently held by someone
+    int getNumEntries() const;
+
+    // Block until every load queued so far has finished
+    void waitForLoads();
+
+    // True while loads are queued or running
+    bool hasPendingLoads() const { return pendingLoads.load() > 0; }
+
+private:
+    static std::filesystem::path keyFor (const std::filesystem::path& audioFile);
+
+    static constexpr int numLoaders = 2;
+
+    mutable std::mutex mutex;
+    std::map<std::filesystem::path, std::weak_ptr<WaveformCache>> entries;
+    std::vector<std::unique_ptr<dc::WorkerThread>> loaders;
+    size_t nextLoader = 0;
+    std::atomic<int> pendingLoads { 0 };
+
+    WaveformRegistry (const WaveformRegistry&) = delete;
+    WaveformRegistry& operator= (const WaveformRegistry&) = delete;
+};
+
+} // namespace gfx
+} // namespace dc
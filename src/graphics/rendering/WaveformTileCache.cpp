@@ -0,0 +1,237 @@
+#include "WaveformTileCache.h"
+#include "Canvas.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkSurface.h"
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+namespace dc
+{
+namespace gfx
+{
+
+bool WaveformTileCache::Key::operator< (const Key& o) const
+{
+    return std::tie (source, channel, samplesPerPixel, index, widthPx, heightPx, argb)
+         < std::tie (o.source, o.channel, o.samplesPerPixel, o.index, o.widthPx, o.heightPx, o.argb);
+}
+
+WaveformTileCache& WaveformTileCache::getInstance()
+{
+    static WaveformTileCache instance;
+    return instance;
+}
+
+WaveformTileCache::WaveformTileCache()
+{
+    for (int i = 0; i < numWorkers; ++i)
+        workers.push_back (std::make_unique<dc::WorkerThread> ("WaveformTiles"));
+}
+
+WaveformTileCache::~WaveformTileCache()
+{
+    for (auto& worker : workers)
+        worker->stop();
+}
+
+WaveformTileCache::Tile WaveformTileCache::getTile (const std::shared_ptr<WaveformCache>& source, int channel,
+                                                    double samplesPerPixel, int64_t index, float height,
+                                                    float scale, Color colour)
+{
+    if (!source || !source->isLoaded() || samplesPerPixel <= 0.0 || index < 0)
+        return {};
+
+    Key key { source.get(), channel, samplesPerPixel, index,
+              static_cast<int> (std::ceil (tileWidth * scale)),
+              static_cast<int> (std::ceil (height * scale)),
+              colour.toARGB() };
+
+    if (key.widthPx <= 0 || key.heightPx <= 0)
+        return {};
+
+    std::lock_guard<std::mutex> lock (mutex);
+
+    auto it = entries.find (key);
+    if (it != entries.end() && it->second.source.lock() != source)
+    {
+        // A cache freed and another allocated at the same address
+        if (it->second.image)
+            memoryUsage -= bytesOf (key);
+        lru.erase (it->second.lruPosition);
+        entries.erase (it);
+        it = entries.end();
+    }
+
+    if (it == entries.end())
+    {
+        lru.push_front (key);
+        Entry entry;
+        entry.source = source;
+        entry.lruPosition = lru.begin();
+        it = entries.emplace (key, std::move (entry)).first;
+    }
+    else
+    {
+        lru.splice (lru.begin(), lru, it->second.lruPosition);
+    }
+
+    auto& entry = it->second;
+
+    // Missing, drawn from peaks that have grown since, or drawn before the
+    // peaks were finished (their last buckets can change without adding any)
+    bool stale = !entry.complete
+                 && (source->isComplete()
+                     || source->getLODForResolution (samplesPerPixel / scale, channel).size > entry.bucketsUsed);
+
+    if (stale && !entry.building)
+    {
+        entry.building = true;
+        pendingTiles.fetch_add (1);
+
+        std::weak_ptr<WaveformCache> weak = source;
+        workers[nextWorker++ % workers.size()]->submit ([this, key, weak, scale]
+        {
+            int64_t bucketsUsed = -1;
+            bool complete = false;
+            sk_sp<SkImage> image;
+
+            if (auto target = weak.lock())
+                image = rasterize (*target, key, scale, bucketsUsed, complete);
+
+            finish (key, std::move (image), bucketsUsed, complete);
+            pendingTiles.fetch_sub (1);
+        });
+    }
+
+    return { entry.image, entry.complete };
+}
+
+sk_sp<SkImage> WaveformTileCache::rasterize (const WaveformCache& source, const Key& key, float scale,
+                                             int64_t& bucketsUsed, bool& complete)
+{
+    // Completion first: peaks that finish after the LOD is read would
+    // otherwise mark a tile complete that lacks the last buckets
+    bool sourceComplete = source.isComplete();
+
+    double devicePixelSamples = key.samplesPerPixel / static_cast<double> (scale);
+    auto lod = source.getLODForResolution (devicePixelSamples, key.channel);
+    if (lod.samplesPerBucket <= 0)
+        return nullptr;
+    double tileStart = static_cast<double> (key.index) * tileWidth * key.samplesPerPixel;
+    double tileEnd = tileStart + tileWidth * key.samplesPerPixel;
+
+    bucketsUsed = lod.size;
+    complete = sourceComplete
+               || static_cast<double> (lod.size * lod.samplesPerBucket) >= tileEnd;
+
+    auto surface = SkSurfaces::Raster (SkImageInfo::MakeN32Premul (key.widthPx, key.heightPx));
+    if (!surface)
+        return nullptr;
+
+    surface->getCanvas()->clear (SK_ColorTRANSPARENT);
+
+    std::vector<Canvas::WaveformSample> columns (static_cast<size_t> (key.widthPx));
+    auto spb = lod.samplesPerBucket;
+
+    for (int px = 0; px < key.widthPx; ++px)
+    {
+        auto sampleStart = static_cast<int64_t> (tileStart + px * devicePixelSamples);
+        auto sampleEnd = static_cast<int64_t> (tileStart + (px + 1) * devicePixelSamples);
+
+        float minVal = 0.0f;
+        float maxVal = 0.0f;
+
+        for (int64_t b = sampleStart / spb; b <= sampleEnd / spb && b < lod.size; ++b)
+        {
+            minVal = std::min (minVal, lod.data[b].min);
+            maxVal = std::max (maxVal, lod.data[b].max);
+        }
+
+        columns[static_cast<size_t> (px)] = { minVal, maxVal };
+    }
+
+    Canvas canvas (surface->getCanvas());
+    canvas.drawWaveform (Rect (0, 0, static_cast<float> (key.widthPx), static_cast<float> (key.heightPx)),
+                         columns, Color::fromARGB (key.argb));
+
+    return surface->makeImageSnapshot();
+}
+
+void WaveformTileCache::finish (const Key& key, sk_sp<SkImage> image, int64_t bucketsUsed, bool complete)
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+
+        auto it = entries.find (key);
+        if (it == entries.end())
+            return;     // evicted or cleared meanwhile
+
+        auto& entry = it->second;
+        entry.building = false;
+
+        if (!image)
+        {
+            // Its waveform is gone
+            if (entry.image)
+                memoryUsage -= bytesOf (key);
+            lru.erase (entry.lruPosition);
+            entries.erase (it);
+            return;
+        }
+
+        if (!entry.image)
+            memoryUsage += bytesOf (key);
+
+        entry.image = std::move (image);
+        entry.bucketsUsed = bucketsUsed;
+        entry.complete = complete;
+
+        evictToBudget();
+    }
+
+    generation.fetch_add (1);
+}
+
+void WaveformTileCache::evictToBudget()
+{
+    while (memoryUsage > memoryBudget && lru.size() > 1)
+    {
+        auto it = entries.find (lru.back());
+        if (it->second.image)
+            memoryUsage -= bytesOf (it->first);
+        entries.erase (it);
+        lru.pop_back();
+    }
+}
+
+void WaveformTileCache::setMemoryBudget (size_t bytes)
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    memoryBudget = bytes;
+    evictToBudget();
+}
+
+size_t WaveformTileCache::getMemoryUsageBytes() const
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    return memoryUsage;
+}
+
+int WaveformTileCache::getNumTiles() const
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    return static_cast<int> (entries.size());
+}
+
+void WaveformTileCache::clear()
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    entries.clear();
+    lru.clear();
+    memoryUsage = 0;
+}
+
+} // namespace gfx
+} // namespace dc
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "WaveformCache.h"
+#include "graphics/core/Types.h"
+#include "dc/foundation/worker_thread.h"
+#include "include/core/SkImage.h"
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dc
+{
+namespace gfx
+{
+
+// Rasterized waveform tiles, shared by every WaveformWidget.
+//
+// A waveform at a given zoom (samples per pixel) is cut into tiles of
+// tileWidth pixels, counted from the start of the file. Tiles are drawn
+// into raster images on background workers and kept across frames, so a
+// repaint composites images instead of tessellating paths, and scrolling
+// only rasterizes the tiles it newly exposes. Tiles of peaks that are
+// still growing are redrawn as more of them become ready.
+//
+// Least recently used tiles are dropped beyond the memory budget.
+class WaveformTileCache
+{
+public:
+    static WaveformTileCache& getInstance();
+
+    WaveformTileCache();
+    ~WaveformTileCache();
+
+    static constexpr int tileWidth = 256;
+    static constexpr size_t defaultMemoryBudgetBytes = 64u * 1024u * 1024u;
+
+    struct Tile
+    {
+        sk_sp<SkImage> image;       // nullptr until first rasterized
+        bool current = false;       // final, and drawn from all peaks it covers
+    };
+
+    // Tile index of a waveform at samplesPerPixel, height and scale in
+    // logical pixels and device pixels per logical pixel. Queues it for
+    // rasterizing if it is missing or out of date.
+    Tile getTile (const std::shared_ptr<WaveformCache>& source, int channel, double samplesPerPixel,
+                  int64_t index, float height, float scale, Color colour);
+
+    // Bumped whenever a tile is rasterized; widgets waiting for tiles
+    // repaint when it changes
+    uint64_t getGeneration() const { return generation.load(); }
+
+    // True while tiles are queued or being rasterized
+    bool hasPendingTiles() const { return pendingTiles.load() > 0; }
+
+    void setMemoryBudget (size_t bytes);
+    size_t getMemoryUsageBytes() const;
+    int getNumTiles() const;
+
+    void clear();
+
+private:
+    struct Key
+    {
+        const WaveformCache* source;
+        int channel;
+        double samplesPerPixel;
+        int64_t index;
+        int widthPx;
+        int heightPx;
+        uint32_t argb;
+
+        bool operator< (const Key& o) const;
+    };
+
+    struct Entry
+    {
+        std::weak_ptr<WaveformCache> source;
+        sk_sp<SkImage> image;
+        int64_t bucketsUsed = -1;   // ready buckets when rasterized
+        bool complete = false;
+        bool building = false;
+        std::list<Key>::iterator lruPosition;
+    };
+
+    static sk_sp<SkImage> rasterize (const WaveformCache& source, const Key& key, float scale,
+                                     int64_t& bucketsUsed, bool& complete);
+
+    void finish (const Key& key, sk_sp<SkImage> image, int64_t bucketsUsed, bool complete);
+
+    // Require mutex held
+    void evictToBudget();
+    static size_t bytesOf (const Key& key) { return static_cast<size_t> (key.widthPx) * static_cast<size_t> (key.heightPx) * 4; }
+
+    static constexpr int numWorkers = 2;
+
+    mutable std::mutex mutex;
+    std::map<Key, Entry> entries;
+    std::list<Key> lru;             // most recent first
+    size_t memoryBudget = defaultMemoryBudgetBytes;
+    size_t memoryUsage = 0;
+
+    std::vector<std::unique_ptr<dc::WorkerThread>> workers;
+    size_t nextWorker = 0;
+    std::atomic<uint64_t> generation { 0 };
+    std::atomic<int> pendingTiles { 0 };
+
+    WaveformTileCache (const WaveformTileCache&) = delete;
+    WaveformTileCache& operator= (const WaveformTileCache&) = delete;
+};
+
+} // namespace gfx
+} // namespace dc
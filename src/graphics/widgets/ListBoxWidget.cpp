@@ -2,6 +2,7 @@
 #include "graphics/rendering/Canvas.h"
 #include "graphics/theme/FontManager.h"
 #include <algorithm>
+#include <cmath>
 
 namespace dc
 {
@@ -17,13 +18,18 @@ void ListBoxWidget::paint (Canvas& canvas)
     auto& theme = Theme::getDefault();
     canvas.fillRect (Rect (0, 0, getWidth(), getHeight()), theme.panelBackground);
 
-    int start = getVisibleRowStart();
-    int count = getVisibleRowCount();
+    int numRows = model->getNumRows();
+    double viewBottom = scrollOffset + getHeight();
 
-    for (int i = start; i < start + count && i < static_cast<int> (items.size()); ++i)
+    for (int i = getRowAt (scrollOffset); i < numRows; ++i)
     {
-        float y = static_cast<float> (i) * rowHeight - scrollOffset;
-        Rect rowRect (0, y, getWidth(), rowHeight);
+        double top = getRowTop (i);
+        if (top >= viewBottom)
+            break;
+
+        float y = static_cast<float> (top - scrollOffset);
+        float h = static_cast<float> (getRowTop (i + 1) - top);
+        Rect rowRect (0, y, getWidth(), h);
 
         bool isSelected = (i == selectedIndex);
 
@@ -37,29 +43,43 @@ void ListBoxWidget::paint (Canvas& canvas)
         else
         {
             Color textColor = isSelected ? theme.brightText : theme.defaultText;
-            canvas.drawText (items[static_cast<size_t> (i)],
-                             8.0f, y + rowHeight * 0.5f + 4.0f,
+            canvas.drawText (model->getRowText (i),
+                             8.0f, y + h * 0.5f + 4.0f,
                              FontManager::getInstance().getDefaultFont(),
                              textColor);
         }
 
         // Separator line
-        canvas.drawLine (0, y + rowHeight, getWidth(), y + rowHeight,
+        canvas.drawLine (0, y + h, getWidth(), y + h,
                          theme.outlineColor.withAlpha ((uint8_t) 60));
     }
 }
 
+void ListBoxWidget::animationTick (double)
+{
+    // Ease towards the wheel's scroll target
+    scrollOffset += (scrollTarget - scrollOffset) * 0.35;
+
+    if (std::abs (scrollTarget - scrollOffset) < 0.5)
+    {
+        scrollOffset = scrollTarget;
+        setAnimating (false);
+    }
+
+    repaint();
+}
+
 void ListBoxWidget::mouseDown (const MouseEvent& e)
 {
-    int index = static_cast<int> ((e.y + scrollOffset) / rowHeight);
-    if (index >= 0 && index < static_cast<int> (items.size()))
+    int index = getRowAt (e.y + scrollOffset);
+    if (index >= 0 && index < model->getNumRows())
         setSelectedIndex (index);
 }
 
 void ListBoxWidget::mouseDoubleClick (const MouseEvent& e)
 {
-    int index = static_cast<int> ((e.y + scrollOffset) / rowHeight);
-    if (index >= 0 && index < static_cast<int> (items.size()))
+    int index = getRowAt (e.y + scrollOffset);
+    if (index >= 0 && index < model->getNumRows())
     {
         setSelectedIndex (index);
 
@@ -70,21 +90,48 @@ void ListBoxWidget::mouseDoubleClick (const MouseEvent& e)
 
 bool ListBoxWidget::mouseWheel (const WheelEvent& e)
 {
-    float delta = e.deltaY * (e.isPixelDelta ? 1.0f : 40.0f);
-    float maxScroll = std::max (0.0f, static_cast<float> (items.size()) * rowHeight - getHeight());
-    scrollOffset = std::clamp (scrollOffset - delta, 0.0f, maxScroll);
+    double delta = e.deltaY * (e.isPixelDelta ? 1.0 : 40.0);
+    scrollTarget = std::clamp (scrollTarget - delta, 0.0, getMaxScroll());
+
+    // Trackpads already deliver smooth pixel deltas; wheel notches glide
+    if (e.isPixelDelta)
+        scrollOffset = scrollTarget;
+    else
+        setAnimating (true);
+
     repaint();
     return true;
 }
 
-void ListBoxWidget::setItems (const std::vector<std::string>& newItems)
+void ListBoxWidget::setModel (Model* newModel)
+{
+    model = newModel != nullptr ? newModel : &itemModel;
+    modelChanged();
+}
+
+void ListBoxWidget::modelChanged()
 {
-    items = newItems;
-    scrollOffset = 0.0f;
+    rowOffsetsDirty = true;
+    scrollOffset = 0.0;
+    scrollTarget = 0.0;
     selectedIndex = -1;
+    setAnimating (false);
     repaint();
 }
 
+void ListBoxWidget::rowHeightsChanged()
+{
+    rowOffsetsDirty = true;
+    scrollOffset = scrollTarget = std::min (scrollTarget, getMaxScroll());
+    repaint();
+}
+
+void ListBoxWidget::setItems (const std::vector<std::string>& newItems)
+{
+    itemModel.items = newItems;
+    setModel (nullptr);
+}
+
 void ListBoxWidget::setSelectedIndex (int index)
 {
     if (index != selectedIndex)
@@ -99,29 +146,75 @@ void ListBoxWidget::setSelectedIndex (int index)
 
 void ListBoxWidget::scrollToEnsureIndexVisible (int index)
 {
-    if (index < 0 || index >= static_cast<int> (items.size()))
+    if (index < 0 || index >= model->getNumRows())
         return;
 
-    float rowTop = index * rowHeight;
-    float rowBottom = rowTop + rowHeight;
-    float maxScroll = std::max (0.0f, static_cast<float> (items.size()) * rowHeight - getHeight());
+    double rowTop = getRowTop (index);
+    double rowBottom = getRowTop (index + 1);
+    double target = scrollTarget;
 
-    if (rowTop < scrollOffset)
-        scrollOffset = rowTop;
-    else if (rowBottom > scrollOffset + getHeight())
-        scrollOffset = rowBottom - getHeight();
+    if (rowTop < target)
+        target = rowTop;
+    else if (rowBottom > target + getHeight())
+        target = rowBottom - getHeight();
 
-    scrollOffset = std::clamp (scrollOffset, 0.0f, maxScroll);
+    // Keyboard moves jump straight there so held keys don't lag behind
+    scrollOffset = scrollTarget = std::clamp (target, 0.0, getMaxScroll());
+    setAnimating (false);
 }
 
-int ListBoxWidget::getVisibleRowStart() const
+void ListBoxWidget::updateRowOffsets() const
 {
-    return std::max (0, static_cast<int> (scrollOffset / rowHeight));
+    if (! rowOffsetsDirty)
+        return;
+
+    rowOffsetsDirty = false;
+    rowOffsets.clear();
+
+    if (! model->hasVariableRowHeights())
+        return;
+
+    int numRows = model->getNumRows();
+    rowOffsets.resize (static_cast<size_t> (numRows) + 1);
+    rowOffsets[0] = 0.0;
+
+    for (int i = 0; i < numRows; ++i)
+        rowOffsets[static_cast<size_t> (i) + 1] = rowOffsets[static_cast<size_t> (i)] + model->getRowHeight (i);
 }
 
-int ListBoxWidget::getVisibleRowCount() const
+double ListBoxWidget::getRowTop (int row) const
 {
-    return static_cast<int> (getHeight() / rowHeight) + 2;
+    updateRowOffsets();
+
+    if (rowOffsets.empty())
+        return static_cast<double> (row) * rowHeight;
+
+    row = std::clamp (row, 0, static_cast<int> (rowOffsets.size()) - 1);
+    return rowOffsets[static_cast<size_t> (row)];
+}
+
+double ListBoxWidget::getContentHeight() const
+{
+    return getRowTop (model->getNumRows());
+}
+
+double ListBoxWidget::getMaxScroll() const
+{
+    return std::max (0.0, getContentHeight() - getHeight());
+}
+
+int ListBoxWidget::getRowAt (double y) const
+{
+    if (y < 0.0)
+        return -1;
+
+    updateRowOffsets();
+
+    if (rowOffsets.empty())
+        return static_cast<int> (y / rowHeight);
+
+    auto it = std::upper_bound (rowOffsets.begin(), rowOffsets.end(), y);
+    return static_cast<int> (it - rowOffsets.begin()) - 1;
 }
 
 } // namespace gfx
@@ -14,24 +14,47 @@ namespace gfx
 class ListBoxWidget : public Widget
 {
 public:
+    // Row source for the list. Rows are only asked for while they are on
+    // screen, so a model can front any number of rows without the list
+    // holding a copy of them.
+    class Model
+    {
+    public:
+        virtual ~Model() = default;
+
+        virtual int getNumRows() const = 0;
+        virtual std::string getRowText (int row) const = 0;
+
+        // Override both to give rows their own heights; otherwise every
+        // row is the list's row height
+        virtual bool hasVariableRowHeights() const { return false; }
+        virtual float getRowHeight (int row) const { return 0.0f; }
+    };
+
     ListBoxWidget();
 
     void paint (Canvas& canvas) override;
+    void animationTick (double timestampMs) override;
 
     void mouseDown (const MouseEvent& e) override;
     void mouseDoubleClick (const MouseEvent& e) override;
     bool mouseWheel (const WheelEvent& e) override;
 
-    // Data model
+    // Data model. setModel takes a non-owning pointer (nullptr falls back
+    // to the list's own items); call modelChanged after its rows change.
+    void setModel (Model* model);
+    void modelChanged();
+    void rowHeightsChanged();
+
     void setItems (const std::vector<std::string>& items);
-    int getNumItems() const { return static_cast<int> (items.size()); }
+    int getNumItems() const { return model->getNumRows(); }
 
     // Selection
     void setSelectedIndex (int index);
     int getSelectedIndex() const { return selectedIndex; }
 
     // Configuration
-    void setRowHeight (float h) { rowHeight = h; repaint(); }
+    void setRowHeight (float h) { rowHeight = h; rowHeightsChanged(); }
     float getRowHeight() const { return rowHeight; }
 
     // Callbacks
@@ -42,14 +65,34 @@ public:
     std::function<void (Canvas&, int, const Rect&, bool)> customRowPaint;
 
 private:
-    int getVisibleRowStart() const;
-    int getVisibleRowCount() const;
+    class ItemModel : public Model
+    {
+    public:
+        int getNumRows() const override { return static_cast<int> (items.size()); }
+        std::string getRowText (int row) const override { return items[static_cast<size_t> (row)]; }
+
+        std::vector<std::string> items;
+    };
+
+    double getRowTop (int row) const;
+    double getContentHeight() const;
+    double getMaxScroll() const;
+    int getRowAt (double y) const;
+    void updateRowOffsets() const;
     void scrollToEnsureIndexVisible (int index);
 
-    std::vector<std::string> items;
+    ItemModel itemModel;
+    Model* model = &itemModel;
     int selectedIndex = -1;
     float rowHeight = 24.0f;
-    float scrollOffset = 0.0f;
+
+    // Offsets are doubles so rows stay pixel-exact 100k rows down
+    double scrollOffset = 0.0;
+    double scrollTarget = 0.0;
+
+    // Prefix sums of row heights, only kept for variable-height models
+    mutable std::vector<double> rowOffsets;
+    mutable bool rowOffsetsDirty = true;
 };
 
 } // namespace gfx
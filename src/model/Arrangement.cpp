@@ -1,5 +1,6 @@
 #include "Arrangement.h"
 #include "utils/UndoSystem.h"
+#include <algorithm>
 
 namespace dc
 {
@@ -19,6 +20,31 @@ Track Arrangement::getTrack (int index) const
     return Track (project.getTrack (index));
 }
 
+std::shared_ptr<const ClipIndex> Arrangement::getClipIndex (int trackIndex) const
+{
+    auto trackState = project.getTrack (trackIndex);
+    if (! trackState.isValid())
+        return nullptr;
+
+    clipIndexes.resize (static_cast<size_t> (project.getNumTracks()));
+    auto& slot = clipIndexes[static_cast<size_t> (trackIndex)];
+
+    if (slot == nullptr || slot->getTrackState() != trackState)
+    {
+        // Tracks were added, removed or moved since: reuse its index if
+        // it is held for another slot, otherwise build one
+        auto it = std::find_if (clipIndexes.begin(), clipIndexes.end(),
+                                [&] (const auto& index) { return index != nullptr && index->getTrackState() == trackState; });
+
+        if (it != clipIndexes.end())
+            std::swap (slot, *it);
+        else
+            slot = std::make_shared<ClipIndex> (trackState);
+    }
+
+    return slot;
+}
+
 Track Arrangement::addTrack (const std::string& name)
 {
     auto trackState = project.addTrack (name);
@@ -1,6 +1,9 @@
 #pragma once
 #include "Project.h"
 #include "Track.h"
+#include "ClipIndex.h"
+#include <memory>
+#include <vector>
 
 namespace dc
 {
@@ -13,6 +16,10 @@ public:
     int getNumTracks() const;
     Track getTrack (int index) const;
 
+    // Interval index of a track's clips, kept in step with its clips.
+    // Follows the track if tracks are reordered; nullptr if out of range.
+    std::shared_ptr<const ClipIndex> getClipIndex (int trackIndex) const;
+
     Track addTrack (const std::string& name);
     void removeTrack (int index);
     void moveTrack (int fromIndex, int toIndex);
@@ -31,6 +38,7 @@ public:
 private:
     Project& project;
     int selectedTrackIndex = -1;
+    mutable std::vector<std::shared_ptr<ClipIndex>> clipIndexes;   // by track index
 };
 
 } // namespace dc
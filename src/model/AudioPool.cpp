@@ -0,0 +1,373 @@
+#include "AudioPool.h"
+#include "Project.h"
+#include "dc/foundation/sha256.h"
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <unordered_set>
+
+namespace dc
+{
+
+namespace
+{
+
+bool isHash (const std::string& s)
+{
+    return s.size() == 64
+        && std::all_of (s.begin(), s.end(), [] (char c)
+                        { return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'); });
+}
+
+template <typename Fn>
+void forEachAudioClip (const PropertyTree& projectState, Fn&& fn)
+{
+    auto tracks = projectState.getChildWithType (IDs::TRACKS);
+    for (int t = 0; t < tracks.getNumChildren(); ++t)
+    {
+        auto track = tracks.getChild (t);
+        for (int c = 0; c < track.getNumChildren(); ++c)
+        {
+            auto clip = track.getChild (c);
+            if (clip.getType() == IDs::AUDIO_CLIP)
+                fn (clip);
+        }
+    }
+}
+
+} // namespace
+
+void AudioPool::setDirectory (const std::filesystem::path& dir)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+
+    if (dir != directory_)
+        knownFiles_.clear();
+
+    directory_ = dir;
+}
+
+std::filesystem::path AudioPool::getDirectory() const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return directory_;
+}
+
+std::filesystem::path AudioPool::entryPath (const std::string& hash, const std::filesystem::path& original) const
+{
+    auto ext = original.extension().string();
+    std::transform (ext.begin(), ext.end(), ext.begin(),
+                    [] (unsigned char c) { return static_cast<char> (std::tolower (c)); });
+
+    return directory_ / hash.substr (0, 2) / (hash + ext);
+}
+
+std::string AudioPool::import (const std::filesystem::path& file, ImportMode mode)
+{
+    std::error_code ec;
+    auto size = std::filesystem::file_size (file, ec);
+    if (ec)
+        return {};
+    auto modified = std::filesystem::last_write_time (file, ec);
+    if (ec)
+        return {};
+
+    auto key = std::filesystem::weakly_canonical (file, ec).string();
+
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        if (directory_.empty())
+            return {};
+
+        // Pool files are immutable and named by their hash
+        if (isInPool (file) && isHash (file.stem().string()))
+            return file.stem().string();
+
+        auto known = knownFiles_.find (key);
+        if (known != knownFiles_.end() && known->second.size == size
+            && known->second.modificationTime == modified
+            && ! findEntry (known->second.hash).empty())
+        {
+            if (mode == ImportMode::move)
+                std::filesystem::remove (file, ec);
+            return known->second.hash;
+        }
+    }
+
+    // Hash outside the lock; imports of different files run in parallel
+    auto hash = sha256HexOfFile (file);
+    if (hash.empty())
+        return {};
+
+    std::filesystem::path dir, dest, tmp;
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        if (directory_.empty())
+            return {};
+
+        if (findEntry (hash).empty())
+        {
+            dir = directory_;
+            dest = entryPath (hash, file);
+            tmp = dest;
+            tmp += "." + std::to_string (nextTempId_++) + ".tmp";
+            pendingFiles_.insert (tmp.string());
+        }
+        else if (mode == ImportMode::copy)
+        {
+            knownFiles_[key] = { size, modified, hash };
+        }
+    }
+
+    if (dest.empty())
+    {
+        // Already pooled
+        if (mode == ImportMode::move)
+            std::filesystem::remove (file, ec);
+        return hash;
+    }
+
+    // Store under a temporary name of our own, outside the lock, so a long
+    // copy holds up neither other imports nor lookups, and a partial file
+    // is never mistaken for a complete entry
+    std::filesystem::create_directories (tmp.parent_path(), ec);
+
+    bool movedOriginal = false;
+    if (mode == ImportMode::move)
+    {
+        ec.clear();
+        std::filesystem::rename (file, tmp, ec);
+        movedOriginal = ! ec;
+    }
+
+    bool stored = movedOriginal;
+    if (! stored)
+    {
+        ec.clear();
+        std::filesystem::copy_file (file, tmp, std::filesystem::copy_options::overwrite_existing, ec);
+        stored = ! ec;
+    }
+
+    if (stored)
+        std::filesystem::permissions (tmp,
+                                      std::filesystem::perms::owner_read
+                                          | std::filesystem::perms::group_read
+                                          | std::filesystem::perms::others_read,
+                                      ec);
+
+    // Publish, unless another import of the same content got there first
+    bool pooled = false;
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        pendingFiles_.erase (tmp.string());
+
+        if (stored && directory_ == dir)
+        {
+            if (findEntry (hash).empty())
+            {
+                ec.clear();
+                std::filesystem::rename (tmp, dest, ec);
+                pooled = ! ec;
+            }
+            else
+            {
+                pooled = true;
+                std::filesystem::remove (tmp, ec);
+            }
+        }
+
+        if (pooled && mode == ImportMode::copy)
+            knownFiles_[key] = { size, modified, hash };
+    }
+
+    if (! pooled)
+    {
+        // Give a moved original back rather than lose it
+        if (movedOriginal)
+            std::filesystem::rename (tmp, file, ec);
+        else
+            std::filesystem::remove (tmp, ec);
+        return {};
+    }
+
+    if (mode == ImportMode::move && ! movedOriginal)
+        std::filesystem::remove (file, ec);
+
+    return hash;
+}
+
+std::filesystem::path AudioPool::getFile (const std::string& hash) const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return findEntry (hash);
+}
+
+std::filesystem::path AudioPool::findEntry (const std::string& hash) const
+{
+    if (directory_.empty() || ! isHash (hash))
+        return {};
+
+    std::error_code ec;
+    for (auto& entry : std::filesystem::directory_iterator (directory_ / hash.substr (0, 2), ec))
+    {
+        auto& path = entry.path();
+        if (path.stem() == hash && path.extension() != ".tmp")
+            return path;
+    }
+
+    return {};
+}
+
+bool AudioPool::isPoolFile (const std::filesystem::path& file) const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return isInPool (file);
+}
+
+bool AudioPool::isInPool (const std::filesystem::path& file) const
+{
+    if (directory_.empty())
+        return false;
+
+    auto rel = file.lexically_normal().lexically_relative (directory_.lexically_normal());
+    return ! rel.empty() && *rel.begin() != "..";
+}
+
+std::vector<std::string> AudioPool::getEntries() const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+
+    std::vector<std::string> hashes;
+    std::error_code ec;
+    for (auto& entry : std::filesystem::recursive_directory_iterator (directory_, ec))
+    {
+        auto stem = entry.path().stem().string();
+        if (entry.is_regular_file() && isHash (stem) && entry.path().extension() != ".tmp")
+            hashes.push_back (stem);
+    }
+
+    std::sort (hashes.begin(), hashes.end());
+    return hashes;
+}
+
+std::vector<std::filesystem::path> AudioPool::getUnpooledSources (const PropertyTree& projectState) const
+{
+    std::vector<std::filesystem::path> sources;
+    forEachAudioClip (projectState, [&] (PropertyTree& clip)
+    {
+        std::filesystem::path source (clip.getProperty (IDs::sourceFile).getStringOr (""));
+        if (! source.empty() && ! isPoolFile (source)
+            && std::find (sources.begin(), sources.end(), source) == sources.end())
+            sources.push_back (source);
+    });
+
+    return sources;
+}
+
+int AudioPool::adoptClips (PropertyTree& projectState, UndoManager* um)
+{
+    int repointed = 0;
+    for (auto& source : getUnpooledSources (projectState))
+    {
+        auto hash = import (source);
+        if (! hash.empty())
+            repointed += repointClips (projectState, source, hash, getFile (hash), um);
+    }
+
+    return repointed;
+}
+
+int AudioPool::repointClips (PropertyTree& projectState, const std::filesystem::path& oldFile,
+                             const std::string& hash, const std::filesystem::path& poolFile,
+                             UndoManager* um)
+{
+    int repointed = 0;
+    forEachAudioClip (projectState, [&] (PropertyTree& clip)
+    {
+        if (std::filesystem::path (clip.getProperty (IDs::sourceFile).getStringOr ("")) == oldFile)
+        {
+            clip.setProperty (IDs::sourceFile, Variant (poolFile.string()), um);
+            clip.setProperty (IDs::poolEntry, Variant (hash), um);
+            ++repointed;
+        }
+    });
+
+    return repointed;
+}
+
+AudioPool::CollectResult AudioPool::collectGarbage (const PropertyTree& projectState)
+{
+    return collectGarbage (std::vector<PropertyTree> { projectState });
+}
+
+AudioPool::CollectResult AudioPool::collectGarbage (const std::vector<PropertyTree>& projectStates)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+
+    std::unordered_set<std::string> referenced;
+    for (auto& projectState : projectStates)
+    {
+        forEachAudioClip (projectState, [&] (PropertyTree& clip)
+        {
+            auto hash = clip.getProperty (IDs::poolEntry).getStringOr ("");
+            if (hash.empty())
+            {
+                // Clips written before poolEntry existed only name their
+                // file; a file stem is only an entry hash inside the pool
+                std::filesystem::path source (clip.getProperty (IDs::sourceFile).getStringOr (""));
+                if (isInPool (source) && isHash (source.stem().string()))
+                    hash = source.stem().string();
+            }
+            if (! hash.empty())
+                referenced.insert (hash);
+        });
+    }
+
+    CollectResult result;
+    if (directory_.empty())
+        return result;
+
+    std::vector<std::filesystem::path> doomed;
+    std::error_code ec;
+    for (auto& entry : std::filesystem::recursive_directory_iterator (directory_, ec))
+    {
+        if (! entry.is_regular_file())
+            continue;
+
+        auto& path = entry.path();
+        if (pendingFiles_.count (path.string()) > 0)
+            continue;
+
+        bool leftover = path.extension() == ".tmp";
+        if (leftover || (isHash (path.stem().string()) && referenced.count (path.stem().string()) == 0))
+            doomed.push_back (path);
+    }
+
+    for (auto& path : doomed)
+    {
+        std::error_code sizeError;
+        auto size = std::filesystem::file_size (path, sizeError);
+        if (std::filesystem::remove (path, ec))
+        {
+            if (path.extension() != ".tmp")
+                ++result.entriesRemoved;
+            if (! sizeError)
+                result.bytesFreed += static_cast<int64_t> (size);
+        }
+    }
+
+    // Shard directories left empty
+    std::vector<std::filesystem::path> shards;
+    for (auto& shard : std::filesystem::directory_iterator (directory_, ec))
+        if (shard.is_directory())
+            shards.push_back (shard.path());
+
+    for (auto& shard : shards)
+        if (std::filesystem::is_empty (shard, ec))
+            std::filesystem::remove (shard, ec);
+
+    knownFiles_.clear();
+    return result;
+}
+
+} // namespace dc
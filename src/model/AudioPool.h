@@ -0,0 +1,119 @@
+#pragma once
+#include "dc/model/PropertyTree.h"
+#include "dc/model/UndoManager.h"
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace dc
+{
+
+/** Session media stored by content hash.
+
+    Every audio file a session uses lives once under
+    <session>/media/<first two hex digits>/<sha256><extension>, so duplicate
+    imports, bounces and freezes of the same audio share one copy. Audio
+    clips reference an entry by hash (IDs::poolEntry) and keep the entry's
+    path in IDs::sourceFile for playback.
+
+    Pool files are never modified once written, which is what lets playback
+    share one open handle per entry and lets git store each take once.
+
+    import() may be called from a background thread; the other members
+    belong to the message thread. */
+class AudioPool
+{
+public:
+    AudioPool() = default;
+
+    /** Pool root, normally <session>/media. Empty = no pool (the session
+        has not been saved yet); import() then fails. */
+    void setDirectory (const std::filesystem::path& dir);
+    std::filesystem::path getDirectory() const;
+
+    enum class ImportMode
+    {
+        copy,   // leave the original where it is
+        move    // the original is a session by-product (bounce, conversion)
+    };
+
+    /** Add a file to the pool and return its hash, or an empty string on
+        failure. A file whose content is already pooled costs one hash pass
+        and no copy; an unchanged file imported before costs a stat. */
+    std::string import (const std::filesystem::path& file, ImportMode mode = ImportMode::copy);
+
+    /** Path of an entry, or an empty path if it isn't in the pool. */
+    std::filesystem::path getFile (const std::string& hash) const;
+
+    bool contains (const std::string& hash) const { return ! getFile (hash).empty(); }
+
+    /** True if file lies inside the pool directory. */
+    bool isPoolFile (const std::filesystem::path& file) const;
+
+    /** Hashes of every entry on disk. */
+    std::vector<std::string> getEntries() const;
+
+    /** Distinct source files of audio clips that don't reference an entry
+        of this pool, i.e. what adoptClips() would import. */
+    std::vector<std::filesystem::path> getUnpooledSources (const PropertyTree& projectState) const;
+
+    /** Import the source of every audio clip that doesn't reference an entry
+        of this pool and repoint the clip at it. Hashes and copies on the
+        calling thread; the app adopts through AudioImporter instead, which
+        does the same per file on its workers. Returns the clips repointed. */
+    int adoptClips (PropertyTree& projectState, UndoManager* um = nullptr);
+
+    /** Point clips referencing oldFile at a pool entry instead. */
+    static int repointClips (PropertyTree& projectState, const std::filesystem::path& oldFile,
+                             const std::string& hash, const std::filesystem::path& poolFile,
+                             UndoManager* um = nullptr);
+
+    struct CollectResult
+    {
+        int entriesRemoved = 0;
+        int64_t bytesFreed = 0;
+    };
+
+    /** Delete entries no audio clip in projectState references, along with
+        leftovers of interrupted imports. Destructive: other revisions or
+        backups of the session may still use the entries, and undo history
+        can bring a removed clip back, so only run it when the user asks. */
+    CollectResult collectGarbage (const PropertyTree& projectState);
+
+    /** As above, keeping entries any of projectStates references. */
+    CollectResult collectGarbage (const std::vector<PropertyTree>& projectStates);
+
+    static constexpr const char* directoryName = "media";
+
+private:
+    // Unlocked versions; require mutex_ held
+    std::filesystem::path findEntry (const std::string& hash) const;
+    bool isInPool (const std::filesystem::path& file) const;
+
+    std::filesystem::path entryPath (const std::string& hash, const std::filesystem::path& original) const;
+
+    // Files imported before, so re-importing an unchanged file skips hashing
+    struct KnownFile
+    {
+        uintmax_t size = 0;
+        std::filesystem::file_time_type modificationTime;
+        std::string hash;
+    };
+
+    mutable std::mutex mutex_;
+    std::filesystem::path directory_;
+    std::unordered_map<std::string, KnownFile> knownFiles_;
+
+    // Temporary files of imports in progress, which collectGarbage leaves be
+    std::unordered_set<std::string> pendingFiles_;
+    uint64_t nextTempId_ = 0;
+
+    AudioPool (const AudioPool&) = delete;
+    AudioPool& operator= (const AudioPool&) = delete;
+};
+
+} // namespace dc
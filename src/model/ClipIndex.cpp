@@ -0,0 +1,250 @@
+#include "ClipIndex.h"
+#include <algorithm>
+#include <limits>
+
+namespace dc
+{
+
+ClipIndex::ClipIndex (const PropertyTree& state)
+    : trackState (state)
+{
+    if (trackState.isValid())
+        trackState.addListener (this);
+}
+
+ClipIndex::~ClipIndex()
+{
+    if (trackState.isValid())
+        trackState.removeListener (this);
+}
+
+int ClipIndex::getNumClips() const
+{
+    update();
+    return static_cast<int> (clips.size());
+}
+
+PropertyTree ClipIndex::getClip (int index) const
+{
+    update();
+    if (index < 0 || index >= static_cast<int> (clips.size()))
+        return {};
+    return clips[static_cast<size_t> (index)];
+}
+
+int64_t ClipIndex::getClipStart (int index) const
+{
+    update();
+    if (index < 0 || index >= static_cast<int> (spans.size()))
+        return 0;
+    return spans[static_cast<size_t> (index)].start;
+}
+
+int64_t ClipIndex::getClipEnd (int index) const
+{
+    update();
+    if (index < 0 || index >= static_cast<int> (spans.size()))
+        return 0;
+    return spans[static_cast<size_t> (index)].end;
+}
+
+void ClipIndex::findOverlapping (int64_t start, int64_t end, std::vector<int>& result) const
+{
+    update();
+    result.clear();
+    if (start < end)
+        collect (0, byStart.size(), start, end, result);
+}
+
+void ClipIndex::collect (size_t lo, size_t hi, int64_t start, int64_t end, std::vector<int>& result) const
+{
+    // byStart read as a balanced tree: the middle of each range is its
+    // root, and subtreeEnd prunes ranges that all end before start
+    if (lo >= hi)
+        return;
+
+    size_t mid = lo + (hi - lo) / 2;
+    if (subtreeEnd[mid] <= start)
+        return;
+
+    collect (lo, mid, start, end, result);
+
+    const auto& span = byStart[mid];
+    if (span.start >= end)
+        return;
+
+    if (span.end > start)
+        result.push_back (span.clip);
+
+    collect (mid + 1, hi, start, end, result);
+}
+
+int ClipIndex::getClipAt (int64_t position) const
+{
+    std::vector<int> hits;
+    findOverlapping (position, position + 1, hits);
+
+    if (hits.empty())
+        return -1;
+    return *std::min_element (hits.begin(), hits.end());
+}
+
+int ClipIndex::getNextClip (int64_t position) const
+{
+    update();
+    auto it = std::upper_bound (byStart.begin(), byStart.end(), position,
+                                [] (int64_t pos, const Span& s) { return pos < s.start; });
+    return it != byStart.end() ? it->clip : -1;
+}
+
+int ClipIndex::getPreviousClip (int64_t position) const
+{
+    update();
+    auto it = std::lower_bound (byStart.begin(), byStart.end(), position,
+                                [] (const Span& s, int64_t pos) { return s.start < pos; });
+    if (it == byStart.begin())
+        return -1;
+
+    // Of clips sharing that start, the lowest-numbered
+    auto start = std::prev (it)->start;
+    it = std::lower_bound (byStart.begin(), it, start,
+                           [] (const Span& s, int64_t pos) { return s.start < pos; });
+    return it->clip;
+}
+
+bool ClipIndex::getNextEdge (int64_t position, int64_t& edge) const
+{
+    update();
+    auto it = std::upper_bound (edges.begin(), edges.end(), position);
+    if (it == edges.end())
+        return false;
+
+    edge = *it;
+    return true;
+}
+
+bool ClipIndex::getPreviousEdge (int64_t position, int64_t& edge) const
+{
+    update();
+    auto it = std::lower_bound (edges.begin(), edges.end(), position);
+    if (it == edges.begin())
+        return false;
+
+    edge = *std::prev (it);
+    return true;
+}
+
+bool ClipIndex::getNextEnd (int64_t position, int64_t& end) const
+{
+    update();
+    auto it = std::upper_bound (ends.begin(), ends.end(), position);
+    if (it == ends.end())
+        return false;
+
+    end = *it;
+    return true;
+}
+
+int64_t ClipIndex::getEndPosition() const
+{
+    update();
+    return ends.empty() ? 0 : std::max<int64_t> (0, ends.back());
+}
+
+void ClipIndex::update() const
+{
+    if (! dirty)
+        return;
+
+    dirty = false;
+    clips.clear();
+    spans.clear();
+
+    if (trackState.isValid())
+    {
+        for (int i = 0; i < trackState.getNumChildren(); ++i)
+        {
+            auto child = trackState.getChild (i);
+            if (child.getType() != IDs::AUDIO_CLIP && child.getType() != IDs::MIDI_CLIP)
+                continue;
+
+            int64_t start = child.getProperty (IDs::startPosition).getIntOr (0);
+            int64_t length = child.getProperty (IDs::length).getIntOr (0);
+
+            spans.push_back ({ start, start + length, static_cast<int> (clips.size()) });
+            clips.push_back (child);
+        }
+    }
+
+    byStart = spans;
+    std::sort (byStart.begin(), byStart.end(), [] (const Span& a, const Span& b)
+    {
+        return a.start != b.start ? a.start < b.start : a.clip < b.clip;
+    });
+
+    subtreeEnd.assign (byStart.size(), 0);
+
+    struct Builder
+    {
+        const std::vector<Span>& spans;
+        std::vector<int64_t>& subtreeEnd;
+
+        int64_t build (size_t lo, size_t hi)
+        {
+            if (lo >= hi)
+                return std::numeric_limits<int64_t>::min();
+
+            size_t mid = lo + (hi - lo) / 2;
+            subtreeEnd[mid] = std::max ({ spans[mid].end, build (lo, mid), build (mid + 1, hi) });
+            return subtreeEnd[mid];
+        }
+    };
+
+    Builder { byStart, subtreeEnd }.build (0, byStart.size());
+
+    ends.clear();
+    edges.clear();
+    for (auto& s : spans)
+    {
+        ends.push_back (s.end);
+        edges.push_back (s.start);
+        edges.push_back (s.end);
+    }
+
+    std::sort (ends.begin(), ends.end());
+    std::sort (edges.begin(), edges.end());
+    edges.erase (std::unique (edges.begin(), edges.end()), edges.end());
+}
+
+bool ClipIndex::isClip (const PropertyTree& tree) const
+{
+    return (tree.getType() == IDs::AUDIO_CLIP || tree.getType() == IDs::MIDI_CLIP)
+        && tree.getParent() == trackState;
+}
+
+void ClipIndex::propertyChanged (PropertyTree& tree, PropertyId property)
+{
+    // Clip contents (notes, fades, ...) don't move it
+    if ((property == IDs::startPosition || property == IDs::length) && isClip (tree))
+        dirty = true;
+}
+
+void ClipIndex::childAdded (PropertyTree& parent, PropertyTree&)
+{
+    if (parent == trackState)
+        dirty = true;
+}
+
+void ClipIndex::childRemoved (PropertyTree& parent, PropertyTree&, int)
+{
+    if (parent == trackState)
+        dirty = true;
+}
+
+void ClipIndex::childOrderChanged (PropertyTree& parent, int, int)
+{
+    if (parent == trackState)
+        dirty = true;
+}
+
+} // namespace dc
@@ -0,0 +1,76 @@
+#pragma once
+#include "Project.h"
+#include <cstdint>
+#include <vector>
+
+namespace dc
+{
+
+// Interval index over one track's clips by timeline sample range.
+//
+// Clips are numbered as Track::getClip numbers them. The index listens to
+// the track and re-sorts on the first query after a clip is added, removed
+// or moved; queries are then O(log n + k) for k results, which keeps
+// culling, hit-testing and motions fast on tracks with thousands of clips.
+class ClipIndex : private PropertyTree::Listener
+{
+public:
+    explicit ClipIndex (const PropertyTree& trackState);
+    ~ClipIndex() override;
+
+    const PropertyTree& getTrackState() const { return trackState; }
+
+    int getNumClips() const;
+    PropertyTree getClip (int index) const;
+    int64_t getClipStart (int index) const;
+    int64_t getClipEnd (int index) const;
+
+    // Clips overlapping [start, end), ordered by start position
+    void findOverlapping (int64_t start, int64_t end, std::vector<int>& result) const;
+
+    // Lowest-numbered clip containing position, or -1
+    int getClipAt (int64_t position) const;
+
+    // First clip starting after position / last starting before it, or -1
+    int getNextClip (int64_t position) const;
+    int getPreviousClip (int64_t position) const;
+
+    // Nearest clip start or end after / before position; returns false
+    // if there is none
+    bool getNextEdge (int64_t position, int64_t& edge) const;
+    bool getPreviousEdge (int64_t position, int64_t& edge) const;
+    bool getNextEnd (int64_t position, int64_t& end) const;
+
+    // End of the last clip, or 0 for an empty track
+    int64_t getEndPosition() const;
+
+private:
+    struct Span
+    {
+        int64_t start;
+        int64_t end;
+        int clip;
+    };
+
+    void update() const;
+    void collect (size_t lo, size_t hi, int64_t start, int64_t end, std::vector<int>& result) const;
+    bool isClip (const PropertyTree& tree) const;
+
+    // PropertyTree::Listener
+    void propertyChanged (PropertyTree&, PropertyId) override;
+    void childAdded (PropertyTree&, PropertyTree&) override;
+    void childRemoved (PropertyTree&, PropertyTree&, int) override;
+    void childOrderChanged (PropertyTree&, int, int) override;
+
+    PropertyTree trackState;
+
+    mutable bool dirty = true;
+    mutable std::vector<PropertyTree> clips;    // by clip number
+    mutable std::vector<Span> spans;            // by clip number
+    mutable std::vector<Span> byStart;          // sorted by start
+    mutable std::vector<int64_t> subtreeEnd;    // latest end in each implicit subtree of byStart
+    mutable std::vector<int64_t> edges;         // starts and ends, sorted and unique
+    mutable std::vector<int64_t> ends;          // sorted
+};
+
+} // namespace dc
@@ -2,6 +2,9 @@
 #include "dc/foundation/assert.h"
 #include "dc/foundation/base64.h"
 #include "dc/midi/MidiMessage.h"
+#include "dc/model/UndoAction.h"
+#include "dc/model/UndoManager.h"
+#include <memory>
 
 namespace dc
 {
@@ -18,6 +21,46 @@ namespace
     const dc::PropertyId ccNumberPropId ("ccNumber");
     const dc::PropertyId beatPropId ("beat");
     const dc::PropertyId valuePropId ("value");
+
+    void writeNotes (PropertyTree& clipState, const std::vector<int>& indices, const NoteArray& notes)
+    {
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            auto child = clipState.getChild (indices[i]);
+            child.setPropertySilently (noteNumberPropId, Variant (static_cast<int> (notes.noteNumbers[i])));
+            child.setPropertySilently (startBeatPropId, Variant (notes.startBeats[i]));
+            child.setPropertySilently (lengthBeatsPropId, Variant (notes.lengthBeats[i]));
+            child.setPropertySilently (velocityPropId, Variant (static_cast<int> (notes.velocities[i])));
+        }
+    }
+
+    // One undo step for a whole bulk edit: the touched child indices plus
+    // the note arrays before and after. Undo/redo rewrite the NOTE children
+    // silently, then re-collapse so listeners see one midiData change.
+    class NoteEditAction : public UndoAction
+    {
+    public:
+        NoteEditAction (PropertyTree clip, std::vector<int> indices, NoteArray before, NoteArray after)
+            : clipState (std::move (clip)), indices (std::move (indices)),
+              before (std::move (before)), after (std::move (after))
+        {
+        }
+
+        void undo() override { apply (before); }
+        void redo() override { apply (after); }
+        std::string getDescription() const override { return "Edit Notes"; }
+
+        void apply (const NoteArray& notes)
+        {
+            writeNotes (clipState, indices, notes);
+            MidiClip (clipState).collapseChildrenToMidiData (nullptr);
+        }
+
+    private:
+        PropertyTree clipState;
+        std::vector<int> indices;
+        NoteArray before, after;
+    };
 }
 
 MidiClip::MidiClip (const PropertyTree& s)
@@ -120,7 +163,8 @@ void MidiClip::expandNotesToChildren()
 
 void MidiClip::collapseChildrenToMidiData (UndoManager* um)
 {
-    MidiSequence seq;
+    std::vector<TimedMidiEvent> events;
+    events.reserve (static_cast<size_t> (state.getNumChildren()) * 2);
 
     for (int i = 0; i < state.getNumChildren(); ++i)
     {
@@ -134,11 +178,8 @@ void MidiClip::collapseChildrenToMidiData (UndoManager* um)
             int vel = static_cast<int> (child.getProperty (velocityPropId).getIntOr (100));
 
             float velocity = static_cast<float> (vel) / 127.0f;
-            auto noteOn = dc::MidiMessage::noteOn (1, noteNum, velocity);
-            seq.addEvent (noteOn, startBeat);
-
-            auto noteOff = dc::MidiMessage::noteOff (1, noteNum);
-            seq.addEvent (noteOff, startBeat + lengthBeats);
+            events.push_back ({ startBeat, dc::MidiMessage::noteOn (1, noteNum, velocity), -1 });
+            events.push_back ({ startBeat + lengthBeats, dc::MidiMessage::noteOff (1, noteNum), -1 });
         }
         else if (child.getType() == ccPointTypeId)
         {
@@ -146,11 +187,12 @@ void MidiClip::collapseChildrenToMidiData (UndoManager* um)
             auto beat = child.getProperty (beatPropId).getDoubleOr (0.0);
             int value = static_cast<int> (child.getProperty (valuePropId).getIntOr (0));
 
-            auto ccMsg = dc::MidiMessage::controllerEvent (1, ccNum, value);
-            seq.addEvent (ccMsg, beat);
+            events.push_back ({ beat, dc::MidiMessage::controllerEvent (1, ccNum, value), -1 });
         }
     }
 
+    MidiSequence seq;
+    seq.addEvents (std::move (events));
     seq.updateMatchedPairs();
     setMidiSequence (seq, um);
 }
@@ -178,4 +220,36 @@ void MidiClip::removeNote (int childIndex, UndoManager* um)
     }
 }
 
+NoteArray MidiClip::getNotes (const std::vector<int>& childIndices) const
+{
+    NoteArray notes;
+    notes.reserve (childIndices.size());
+
+    for (int idx : childIndices)
+    {
+        auto child = state.getChild (idx);
+        notes.add (static_cast<int> (child.getProperty (noteNumberPropId).getIntOr (60)),
+                   child.getProperty (startBeatPropId).getDoubleOr (0.0),
+                   child.getProperty (lengthBeatsPropId).getDoubleOr (0.25),
+                   static_cast<int> (child.getProperty (velocityPropId).getIntOr (100)));
+    }
+
+    return notes;
+}
+
+void MidiClip::applyNoteEdits (const std::vector<int>& childIndices, const NoteArray& edited,
+                               UndoManager* um)
+{
+    dc_assert (childIndices.size() == edited.size());
+
+    if (childIndices.empty())
+        return;
+
+    auto action = std::make_unique<NoteEditAction> (state, childIndices, getNotes (childIndices), edited);
+    action->redo();
+
+    if (um != nullptr)
+        um->addAction (std::move (action));
+}
+
 } // namespace dc
@@ -1,6 +1,8 @@
 #pragma once
 #include "Project.h"
 #include "dc/midi/MidiSequence.h"
+#include "dc/midi/NoteEdits.h"
+#include <vector>
 
 namespace dc
 {
@@ -32,6 +34,14 @@ public:
                           int velocity, UndoManager* um = nullptr);
     void removeNote (int childIndex, UndoManager* um = nullptr);
 
+    // Bulk note editing: gather NOTE children into a NoteArray, run the
+    // dc::NoteEdits kernels on it, then apply the result. applyNoteEdits()
+    // records one undo action holding only the before/after arrays and
+    // publishes a single midiData change instead of one per property.
+    NoteArray getNotes (const std::vector<int>& childIndices) const;
+    void applyNoteEdits (const std::vector<int>& childIndices, const NoteArray& edited,
+                         UndoManager* um = nullptr);
+
     PropertyTree& getState() { return state; }
 
 private:
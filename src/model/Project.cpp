@@ -46,6 +46,13 @@ bool Project::loadFromFile (const std::filesystem::path& /*file*/)
 }
 
 PropertyTree Project::addTrack (const std::string& trackName)
+{
+    auto track = createTrackState (trackName);
+    state.getChildWithType (IDs::TRACKS).addChild (track, -1, &undoSystem.getUndoManager());
+    return track;
+}
+
+PropertyTree Project::createTrackState (const std::string& trackName)
 {
     PropertyTree track (IDs::TRACK);
     track.setProperty (IDs::name, Variant (trackName), nullptr);
@@ -55,8 +62,6 @@ PropertyTree Project::addTrack (const std::string& trackName)
     track.setProperty (IDs::solo, Variant (false), nullptr);
     track.setProperty (IDs::armed, Variant (false), nullptr);
     track.setProperty (IDs::colour, Variant (dc::randomInt (0, 0x7FFFFFFF)), nullptr);
-
-    state.getChildWithType (IDs::TRACKS).addChild (track, -1, &undoSystem.getUndoManager());
     return track;
 }
 
@@ -6,6 +6,7 @@
 #include <filesystem>
 #include "utils/UndoSystem.h"
 #include "Clipboard.h"
+#include "AudioPool.h"
 
 namespace dc
 {
@@ -27,6 +28,7 @@ namespace IDs
     DECLARE_ID (solo)
     DECLARE_ID (armed)
     DECLARE_ID (sourceFile)
+    DECLARE_ID (poolEntry)        // content hash of the clip's AudioPool entry
     DECLARE_ID (startPosition)    // in samples
     DECLARE_ID (length)           // in samples
     DECLARE_ID (trimStart)        // in samples
@@ -104,6 +106,10 @@ public:
 
     // Track management
     PropertyTree addTrack (const std::string& name);
+
+    // Build a detached TRACK node with default properties. Fill it in
+    // (clips, plugins) before attaching so listeners see one childAdded.
+    static PropertyTree createTrackState (const std::string& name);
     void removeTrack (int index);
     int getNumTracks() const;
     PropertyTree getTrack (int index) const;
@@ -116,6 +122,9 @@ public:
 
     Clipboard& getClipboard() { return clipboard; }
 
+    // Content-addressed media of the session (see AudioPool)
+    AudioPool& getAudioPool() { return audioPool; }
+
     // Master bus state (persistent, holds volume + plugin chain)
     PropertyTree getMasterBusState();
 
@@ -140,6 +149,7 @@ private:
     PropertyTree state;
     UndoSystem undoSystem;
     Clipboard clipboard;
+    AudioPool audioPool;
 
     void createDefaultState();
 
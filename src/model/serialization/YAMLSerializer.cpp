@@ -105,6 +105,10 @@ YAML::Node YAMLSerializer::emitAudioClip (const PropertyTree& clipState, const s
     std::filesystem::path sourceFile (clipState.getProperty (IDs::sourceFile, Variant ("")).toString());
     clip["source_file"] = makeRelativePath (sourceFile, sessionDir);
 
+    auto poolEntry = clipState.getProperty (IDs::poolEntry, Variant ("")).toString();
+    if (! poolEntry.empty())
+        clip["pool_entry"] = poolEntry;
+
     clip["start_position"] = clipState.getProperty (IDs::startPosition, Variant (0)).toInt();
     clip["length"] = clipState.getProperty (IDs::length, Variant (0)).toInt();
     clip["trim_start"] = clipState.getProperty (IDs::trimStart, Variant (0)).toInt();
@@ -285,6 +289,9 @@ PropertyTree YAMLSerializer::parseAudioClip (const YAML::Node& node, const std::
         clip.setProperty (IDs::sourceFile, Variant (resolved.string()));
     }
 
+    if (node["pool_entry"])
+        clip.setProperty (IDs::poolEntry, Variant (node["pool_entry"].as<std::string>()));
+
     if (node["start_position"])
         clip.setProperty (IDs::startPosition, Variant (node["start_position"].as<int64_t>()));
     if (node["length"])
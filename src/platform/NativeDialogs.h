@@ -17,6 +17,11 @@ public:
                                const std::vector<std::string>& fileTypes,
                                std::function<void (const std::string&)> callback);
 
+    // File open panel allowing several files; empty list if cancelled
+    static void showOpenPanelMultiple (const std::string& title,
+                                       const std::vector<std::string>& fileTypes,
+                                       std::function<void (const std::vector<std::string>&)> callback);
+
     // File save panel
     static void showSavePanel (const std::string& title,
                                const std::string& defaultName,
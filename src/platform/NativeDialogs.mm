@@ -44,6 +44,38 @@ void NativeDialogs::showOpenPanel (const std::string& title,
     }
 }
 
+void NativeDialogs::showOpenPanelMultiple (const std::string& title,
+                                            const std::vector<std::string>& fileTypes,
+                                            std::function<void (const std::vector<std::string>&)> callback)
+{
+    @autoreleasepool
+    {
+        NSOpenPanel* panel = [NSOpenPanel openPanel];
+        [panel setTitle:[NSString stringWithUTF8String:title.c_str()]];
+        [panel setAllowsMultipleSelection:YES];
+        [panel setCanChooseFiles:YES];
+        [panel setCanChooseDirectories:NO];
+
+        if (! fileTypes.empty())
+        {
+            NSMutableArray* types = [NSMutableArray array];
+            for (const auto& type : fileTypes)
+                [types addObject:[NSString stringWithUTF8String:type.c_str()]];
+            [panel setAllowedFileTypes:types];
+        }
+
+        [panel beginWithCompletionHandler:^(NSModalResponse result)
+        {
+            std::vector<std::string> paths;
+            if (result == NSModalResponseOK)
+                for (NSURL* url in panel.URLs)
+                    paths.push_back ([[url path] UTF8String]);
+
+            if (callback) callback (paths);
+        }];
+    }
+}
+
 void NativeDialogs::showSavePanel (const std::string& title,
                                     const std::string& defaultName,
                                     std::function<void (const std::string&)> callback)
@@ -84,6 +84,19 @@ void GlfwWindow::pollEvents()
     glfwPollEvents();
 }
 
+void GlfwWindow::waitEvents (double timeoutSeconds)
+{
+    if (timeoutSeconds > 0.0)
+        glfwWaitEventsTimeout (timeoutSeconds);
+    else
+        glfwPollEvents();
+}
+
+void GlfwWindow::postEmptyEvent()
+{
+    glfwPostEmptyEvent();
+}
+
 bool GlfwWindow::shouldClose() const
 {
     return glfwWindowShouldClose (window);
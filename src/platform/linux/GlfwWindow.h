@@ -31,6 +31,13 @@ public:
     void pollEvents();
     bool shouldClose() const;
 
+    /** Block until an event arrives, postEmptyEvent() is called or the
+        timeout (seconds) passes. */
+    void waitEvents (double timeoutSeconds);
+
+    /** Wake a waitEvents() call. Safe to call from any thread. */
+    static void postEmptyEvent();
+
     /** Load a PNG file and set it as the X11 window icon.
         On Wayland this is a no-op (the .desktop file provides the icon). */
     void setWindowIcon (const std::string& pngPath);
@@ -7,8 +7,13 @@
 #include <pluginterfaces/base/funknown.h>
 
 #include <algorithm>
+#include <cerrno>
 #include <chrono>
 #include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
 #include <vector>
 
 namespace dc
@@ -25,6 +30,30 @@ LinuxRunLoop& LinuxRunLoop::instance()
     return inst;
 }
 
+LinuxRunLoop::LinuxRunLoop()
+{
+    epollFd_ = epoll_create1 (EPOLL_CLOEXEC);
+    timerFd_ = timerfd_create (CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    wakeFd_ = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    for (int fd : { timerFd_, wakeFd_ })
+    {
+        struct epoll_event ev {};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl (epollFd_, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+LinuxRunLoop::~LinuxRunLoop()
+{
+    stopWatching();
+
+    for (int fd : { epollFd_, timerFd_, wakeFd_ })
+        if (fd >= 0)
+            ::close (fd);
+}
+
 // ─── IRunLoop: Event handlers ────────────────────────────────────────────────
 
 tresult PLUGIN_API LinuxRunLoop::registerEventHandler (IEventHandler* handler, FileDescriptor fd)
@@ -35,6 +64,12 @@ tresult PLUGIN_API LinuxRunLoop::registerEventHandler (IEventHandler* handler, F
     if (eventHandlers_.find (fd) != eventHandlers_.end())
         return kInvalidArgument;
 
+    struct epoll_event ev {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (epoll_ctl (epollFd_, EPOLL_CTL_ADD, fd, &ev) != 0)
+        return kResultFalse;
+
     eventHandlers_[fd] = handler;
     dc_log ("[RunLoop] registerEventHandler fd=%d handler=%p", fd, static_cast<void*> (handler));
     return kResultOk;
@@ -48,6 +83,9 @@ tresult PLUGIN_API LinuxRunLoop::unregisterEventHandler (IEventHandler* handler)
         {
             dc_log ("[RunLoop] unregisterEventHandler fd=%d handler=%p",
                      it->first, static_cast<void*> (handler));
+
+            // Fails harmlessly if the plugin already closed the fd
+            epoll_ctl (epollFd_, EPOLL_CTL_DEL, it->first, nullptr);
             eventHandlers_.erase (it);
             return kResultOk;
         }
@@ -72,6 +110,7 @@ tresult PLUGIN_API LinuxRunLoop::registerTimer (ITimerHandler* handler, TimerInt
     entry.nextFire = std::chrono::steady_clock::now() + entry.intervalMs;
 
     timers_.push_back (entry);
+    armTimerFd();
     dc_log ("[RunLoop] registerTimer handler=%p interval=%lums",
              static_cast<void*> (handler), static_cast<unsigned long> (milliseconds));
     return kResultOk;
@@ -87,9 +126,33 @@ tresult PLUGIN_API LinuxRunLoop::unregisterTimer (ITimerHandler* handler)
 
     dc_log ("[RunLoop] unregisterTimer handler=%p", static_cast<void*> (handler));
     timers_.erase (it);
+    armTimerFd();
     return kResultOk;
 }
 
+void LinuxRunLoop::armTimerFd()
+{
+    // A zero it_value disarms the timer
+    struct itimerspec spec {};
+
+    if (! timers_.empty())
+    {
+        auto next = std::min_element (timers_.begin(), timers_.end(),
+                                      [] (const TimerEntry& a, const TimerEntry& b)
+                                      { return a.nextFire < b.nextFire; })->nextFire;
+
+        // steady_clock is CLOCK_MONOTONIC on Linux
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds> (next.time_since_epoch()).count();
+        spec.it_value.tv_sec = static_cast<time_t> (ns / 1000000000);
+        spec.it_value.tv_nsec = static_cast<long> (ns % 1000000000);
+
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0)
+            spec.it_value.tv_nsec = 1;
+    }
+
+    timerfd_settime (timerFd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
 // ─── FUnknown ────────────────────────────────────────────────────────────────
 
 tresult PLUGIN_API LinuxRunLoop::queryInterface (const TUID iid, void** obj)
@@ -121,42 +184,30 @@ uint32 PLUGIN_API LinuxRunLoop::release()
     return count;
 }
 
-// ─── Poll (called from main loop each frame) ────────────────────────────────
+// ─── Poll (called from main loop each iteration) ────────────────────────────
 
 void LinuxRunLoop::poll()
 {
-    // --- File descriptor polling ---
-    if (! eventHandlers_.empty())
+    // --- File descriptor dispatch ---
+    struct epoll_event events[32];
+    int ready = epoll_wait (epollFd_, events, 32, 0);
+
+    for (int i = 0; i < ready; ++i)
     {
-        // Copy keys before dispatching — callbacks may unregister handlers
-        std::vector<FileDescriptor> fds;
-        fds.reserve (eventHandlers_.size());
-        for (const auto& pair : eventHandlers_)
-            fds.push_back (pair.first);
-
-        std::vector<struct pollfd> pfds;
-        pfds.reserve (fds.size());
-        for (auto fd : fds)
-        {
-            struct pollfd pfd {};
-            pfd.fd = fd;
-            pfd.events = POLLIN;
-            pfds.push_back (pfd);
-        }
+        int fd = events[i].data.fd;
 
-        int ret = ::poll (pfds.data(), pfds.size(), 0);
-        if (ret > 0)
+        if (fd == wakeFd_ || fd == timerFd_)
         {
-            for (size_t i = 0; i < pfds.size(); ++i)
-            {
-                if (pfds[i].revents & (POLLIN | POLLERR | POLLHUP))
-                {
-                    auto it = eventHandlers_.find (fds[i]);
-                    if (it != eventHandlers_.end())
-                        it->second->onFDIsSet (fds[i]);
-                }
-            }
+            // Drain the counter; timers are checked below either way
+            uint64_t count;
+            while (::read (fd, &count, sizeof (count)) > 0) {}
+            continue;
         }
+
+        // Look up per event — callbacks may unregister handlers
+        auto it = eventHandlers_.find (fd);
+        if (it != eventHandlers_.end())
+            it->second->onFDIsSet (fd);
     }
 
     // --- Timer firing ---
@@ -184,6 +235,83 @@ void LinuxRunLoop::poll()
                 }
             }
         }
+
+        armTimerFd();
+    }
+
+    // Let the watcher look for the next wake
+    {
+        std::lock_guard<std::mutex> lock (watchMutex_);
+        ++dispatchCount_;
+    }
+    dispatched_.notify_one();
+}
+
+// ─── Waking the main thread ─────────────────────────────────────────────────
+
+void LinuxRunLoop::wake()
+{
+    uint64_t one = 1;
+    [[maybe_unused]] auto written = ::write (wakeFd_, &one, sizeof (one));
+}
+
+void LinuxRunLoop::startWatching (std::function<void()> wakeMainThread)
+{
+    if (watcher_.joinable() || ! wakeMainThread)
+        return;
+
+    stopping_ = false;
+    watcher_ = std::thread ([this, wakeMainThread = std::move (wakeMainThread)]()
+    {
+        watch (wakeMainThread);
+    });
+}
+
+void LinuxRunLoop::stopWatching()
+{
+    if (! watcher_.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock (watchMutex_);
+        stopping_ = true;
+    }
+
+    wake();
+    dispatched_.notify_one();
+    watcher_.join();
+}
+
+void LinuxRunLoop::watch (std::function<void()> wakeMainThread)
+{
+    for (;;)
+    {
+        uint64_t seen;
+        {
+            std::lock_guard<std::mutex> lock (watchMutex_);
+            if (stopping_)
+                return;
+            seen = dispatchCount_;
+        }
+
+        // An epoll fd is readable while any fd in its set is ready
+        struct pollfd pfd {};
+        pfd.fd = epollFd_;
+        pfd.events = POLLIN;
+
+        if (::poll (&pfd, 1, -1) < 0 && errno != EINTR)
+            return;
+
+        std::unique_lock<std::mutex> lock (watchMutex_);
+        if (stopping_)
+            return;
+
+        lock.unlock();
+        wakeMainThread();
+        lock.lock();
+
+        // Level-triggered fds stay ready until the main thread handles them
+        dispatched_.wait (lock, [&] { return stopping_ || dispatchCount_ != seen; });
     }
 }
 
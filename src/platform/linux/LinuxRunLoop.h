@@ -7,6 +7,11 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -31,12 +36,24 @@ public:
     Steinberg::uint32 PLUGIN_API addRef() override;
     Steinberg::uint32 PLUGIN_API release() override;
 
-    /// Called from the main loop each frame to dispatch pending fd events and timers
+    /// Called from the main loop each iteration to dispatch ready fd events
+    /// and due timers. Never blocks.
     void poll();
 
+    /// Wake the main thread out of its event wait. Safe from any thread.
+    void wake();
+
+    /// Start a thread that waits on the plugin fds, the timer deadline and
+    /// wake(), and calls wakeMainThread when any of them needs the main
+    /// thread. This lets the main loop block in its own event wait (e.g.
+    /// glfwWaitEventsTimeout with glfwPostEmptyEvent as wakeMainThread).
+    /// After a wake the watcher waits for poll() before watching again.
+    void startWatching (std::function<void()> wakeMainThread);
+    void stopWatching();
+
 private:
-    LinuxRunLoop() = default;
-    ~LinuxRunLoop() = default;
+    LinuxRunLoop();
+    ~LinuxRunLoop();
 
     LinuxRunLoop (const LinuxRunLoop&) = delete;
     LinuxRunLoop& operator= (const LinuxRunLoop&) = delete;
@@ -55,6 +72,21 @@ private:
 
     std::vector<TimerEntry> timers_;
 
+    void armTimerFd();
+    void watch (std::function<void()> wakeMainThread);
+
+    // Plugin fds, timerFd_ and wakeFd_ all feed one epoll set, so a single
+    // readable fd tells the watcher there is work
+    int epollFd_ = -1;
+    int timerFd_ = -1;   // armed for the earliest timer
+    int wakeFd_ = -1;    // eventfd written by wake()
+
+    std::thread watcher_;
+    std::mutex watchMutex_;
+    std::condition_variable dispatched_;
+    uint64_t dispatchCount_ = 0;
+    bool stopping_ = false;
+
     std::atomic<Steinberg::uint32> refCount_ {1};
 };
 
@@ -75,6 +75,32 @@ void NativeDialogs::showOpenPanel (const std::string& title,
         callback (path);
 }
 
+void NativeDialogs::showOpenPanelMultiple (const std::string& title,
+                                           const std::vector<std::string>& fileTypes,
+                                           std::function<void (const std::vector<std::string>&)> callback)
+{
+    std::ostringstream cmd;
+    cmd << "zenity --file-selection --multiple --separator='\n'"
+        << " --title='" << shellEscape (title) << "'";
+
+    if (!fileTypes.empty())
+    {
+        cmd << " --file-filter='Supported files |";
+        for (const auto& ext : fileTypes)
+            cmd << " *." << ext;
+        cmd << "'";
+    }
+
+    std::vector<std::string> paths;
+    std::istringstream output (exec (cmd.str()));
+    for (std::string line; std::getline (output, line); )
+        if (!line.empty())
+            paths.push_back (line);
+
+    if (callback)
+        callback (paths);
+}
+
 void NativeDialogs::showSavePanel (const std::string& title,
                                    const std::string& defaultName,
                                    std::function<void (const std::string&)> callback)
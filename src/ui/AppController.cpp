@@ -3,14 +3,20 @@
 #include "engine/PluginProcessorNode.h"
 #include "dc/plugins/PluginDescription.h"
 #include "graphics/rendering/Canvas.h"
+#include "graphics/rendering/WaveformRegistry.h"
+#include "graphics/rendering/WaveformTileCache.h"
 #include "model/Track.h"
 #include "model/MixerState.h"
 #include "model/AudioClip.h"
 #include "model/MidiClip.h"
 #include "model/StepSequencer.h"
+#include "model/serialization/SessionReader.h"
 #include "platform/NativeDialogs.h"
 #include "plugins/PluginEditorBridge.h"
+#include "dc/audio/AudioFileReader.h"
+#include "dc/audio/PeakStore.h"
 #include "utils/UndoSystem.h"
+#include "utils/MidiFileUtils.h"
 #include "dc/foundation/assert.h"
 #include "dc/foundation/file_utils.h"
 #include "dc/foundation/string_utils.h"
@@ -35,6 +41,8 @@ AppController::~AppController()
 {
     audioEngine.stopStream();   // Stop audio thread before any cleanup
 
+    audioImporter.reset();
+
     if (vimEngine)
     {
         vimEngine->removeListener (this);
@@ -1160,11 +1168,31 @@ void AppController::registerAllActions()
         [this]() { loadSession(); }, {}
     });
 
+    actionRegistry.registerAction ({
+        "file.clean_up_media", "Clean Up Unused Media", "File", "",
+        [this]() { cleanUpUnusedMedia(); }, {}
+    });
+
     actionRegistry.registerAction ({
         "file.import_audio", "Import Audio", "File", "",
         [this]() { openFile(); }, {}
     });
 
+    actionRegistry.registerAction ({
+        "file.import_audio_converted", "Import Audio (Convert to Session Rate)", "File", "",
+        [this]() { openFile (true); }, {}
+    });
+
+    actionRegistry.registerAction ({
+        "file.import_midi", "Import MIDI File", "File", "",
+        [this]() { importMidiFile(); }, {}
+    });
+
+    actionRegistry.registerAction ({
+        "file.export_midi", "Export MIDI File", "File", "",
+        [this]() { exportMidiFile(); }, {}
+    });
+
     actionRegistry.registerAction ({
         "file.audio_settings", "Audio Settings", "File", "",
         [this]() { showAudioSettings(); }, {}
@@ -1240,6 +1268,46 @@ void AppController::registerAllActions()
         [this]() { toggleBrowser(); }, {}
     });
 
+    actionRegistry.registerAction ({
+        "view.toggle_frame_profiler", "Toggle Frame Profiler", "View", "",
+        [this]()
+        {
+            if (renderer == nullptr)
+                return;
+
+            auto& profiler = renderer->getProfiler();
+            profiler.setOverlayVisible (! profiler.isOverlayVisible());
+            renderer->forceNextFrame();
+        }, {}
+    });
+
+    actionRegistry.registerAction ({
+        "view.capture_frame_profile", "Start/Stop Frame Profile Capture", "View", "",
+        [this]()
+        {
+            if (renderer == nullptr)
+                return;
+
+            // The first run starts recording; the second writes the report
+            auto& profiler = renderer->getProfiler();
+            if (! profiler.isCapturing())
+            {
+                profiler.clear();
+                profiler.setCapturing (true);
+                dc_log ("[FrameProfiler] capturing");
+                return;
+            }
+
+            profiler.setCapturing (false);
+
+            auto path = dc::getUserAppDataDirectory() / "frame-profile.txt";
+            if (profiler.dumpToFile (path))
+                dc_log ("[FrameProfiler] wrote %s", path.string().c_str());
+            else
+                dc_log ("[FrameProfiler] failed to write %s", path.string().c_str());
+        }, {}
+    });
+
     // ─── Sequencer ───────────────────────────────────────────
     actionRegistry.registerAction ({
         "seq.move_left", "Sequencer Move Left", "Sequencer", "h",
@@ -1398,6 +1466,24 @@ void AppController::registerAllActions()
         { VimContext::PianoRoll }
     });
 
+    actionRegistry.registerAction ({
+        "pr.velocity_up", "Increase Velocity", "Piano Roll", "",
+        [this]() { if (pianoRollWidget) pianoRollWidget->scaleVelocitySelected (1.1); },
+        { VimContext::PianoRoll }
+    });
+
+    actionRegistry.registerAction ({
+        "pr.velocity_down", "Decrease Velocity", "Piano Roll", "",
+        [this]() { if (pianoRollWidget) pianoRollWidget->scaleVelocitySelected (0.9); },
+        { VimContext::PianoRoll }
+    });
+
+    actionRegistry.registerAction ({
+        "pr.legato", "Legato Notes", "Piano Roll", "",
+        [this]() { if (pianoRollWidget) pianoRollWidget->legatoSelected(); },
+        { VimContext::PianoRoll }
+    });
+
     actionRegistry.registerAction ({
         "pr.zoom_in", "Zoom In", "Piano Roll", "zi",
         [this]() { if (pianoRollWidget) pianoRollWidget->zoomHorizontal (1.25f); },
@@ -1515,18 +1601,6 @@ void AppController::rebuildAudioGraph()
             auto processor = std::make_unique<TrackProcessor> (transportController);
             auto* processorPtr = processor.get();
 
-            // Load the first audio clip's file (skip MIDI clips)
-            for (int c = 0; c < track.getNumClips(); ++c)
-            {
-                auto clipState = track.getClip (c);
-                if (clipState.getType() == IDs::AUDIO_CLIP)
-                {
-                    AudioClip clip (clipState);
-                    processorPtr->loadFile (clip.getSourceFile());
-                    break;
-                }
-            }
-
             // Keep muted on TrackProcessor for disk I/O efficiency
             processorPtr->setMuted (track.isMuted());
 
@@ -1534,6 +1608,8 @@ void AppController::rebuildAudioGraph()
             trackProcessors.push_back (processorPtr);
             midiClipProcessors.push_back (nullptr);
             trackNodes.push_back (nodeId);
+
+            syncAudioClipsFromModel (i);
         }
 
         // Instantiate plugin chain from model
@@ -1728,6 +1804,44 @@ void AppController::syncSequencerFromModel()
     sequencerProcessor->updatePatternSnapshot (snapshot);
 }
 
+void AppController::syncAudioClipsFromModel (int trackIndex)
+{
+    if (trackIndex < 0 || trackIndex >= static_cast<int> (trackProcessors.size()))
+        return;
+
+    auto* processor = trackProcessors[static_cast<size_t> (trackIndex)];
+    if (processor == nullptr)
+        return;
+
+    Track track (project.getTrack (trackIndex));
+    std::vector<TrackProcessor::Clip> playlist;
+
+    for (int c = 0; c < track.getNumClips(); ++c)
+    {
+        auto clipState = track.getClip (c);
+        if (clipState.getType() != IDs::AUDIO_CLIP)
+            continue;
+
+        AudioClip clip (clipState);
+        TrackProcessor::Clip entry;
+        entry.sourceFile = clip.getSourceFile();
+        entry.startPosition = clip.getStartPosition();
+        entry.sourceOffset = clip.getTrimStart();
+        entry.length = clip.getLength();
+        entry.fadeInLength = clip.getFadeInLength();
+        entry.fadeOutLength = clip.getFadeOutLength();
+
+        // trimEnd bounds the source region; never play past it
+        int64_t trimEnd = clip.getTrimEnd();
+        if (trimEnd > entry.sourceOffset)
+            entry.length = std::min (entry.length, trimEnd - entry.sourceOffset);
+
+        playlist.push_back (std::move (entry));
+    }
+
+    processor->setClips (std::move (playlist));
+}
+
 void AppController::syncMidiClipFromModel (int trackIndex)
 {
     if (trackIndex < 0 || trackIndex >= static_cast<int> (midiClipProcessors.size()))
@@ -2107,20 +2221,61 @@ void AppController::saveSession()
                 return;
 
             std::filesystem::path dir (path);
-            if (project.saveSessionToDirectory (path))
+
+            // Media the session uses moves into (or is shared with) the
+            // session's pool before the clips referencing it are written.
+            // Hashing and copying happen on the importer's workers
+            auto& pool = project.getAudioPool();
+            pool.setDirectory (dir / AudioPool::directoryName);
+            PeakStore::getInstance().setDirectory (dir / PeakStore::directoryName);
+
+            auto sources = pool.getUnpooledSources (project.getState());
+            auto generation = ++saveGeneration;
+            pendingAdoptions = static_cast<int> (sources.size());
+
+            if (sources.empty())
             {
-                currentSessionDirectory = dir;
-                recentProjects.addProject (dir.string());
-                refreshRecentProjectActions();
+                writeSession (dir);
+                return;
             }
-            else
+
+            AudioImporter::Options options;
+            options.scanPeaks = false;
+
+            for (auto& source : sources)
             {
-                platform::NativeDialogs::showAlert ("Save Error",
-                    "Failed to save session to:\n" + path);
+                audioImporter->import (source, options, [this, dir, generation] (const AudioImporter::Result& result)
+                {
+                    if (generation != saveGeneration)
+                        return;
+
+                    // Sources that can't be pooled stay where they are
+                    if (result.ok && ! result.poolEntry.empty())
+                        AudioPool::repointClips (project.getState(), result.source,
+                                                 result.poolEntry, result.file);
+
+                    if (--pendingAdoptions == 0)
+                        writeSession (dir);
+                });
             }
         });
 }
 
+void AppController::writeSession (const std::filesystem::path& dir)
+{
+    if (project.saveSessionToDirectory (dir))
+    {
+        currentSessionDirectory = dir;
+        recentProjects.addProject (dir.string());
+        refreshRecentProjectActions();
+    }
+    else
+    {
+        platform::NativeDialogs::showAlert ("Save Error",
+            "Failed to save session to:\n" + dir.string());
+    }
+}
+
 void AppController::loadSession()
 {
     platform::NativeDialogs::showOpenPanel ("Load Session", {},
@@ -2152,6 +2307,28 @@ void AppController::loadSessionFromDirectory (const std::filesystem::path& dir)
     if (project.loadSessionFromDirectory (dir.string()))
     {
         currentSessionDirectory = dir;
+
+        // A save still adopting media belongs to the replaced session
+        ++saveGeneration;
+        pendingAdoptions = 0;
+
+        project.getAudioPool().setDirectory (dir / AudioPool::directoryName);
+
+        // Scan any media without current peak files in the background, so
+        // clips draw from mapped peaks instead of reading their audio
+        PeakStore::getInstance().setDirectory (dir / PeakStore::directoryName);
+        auto tracks = project.getState().getChildWithType (IDs::TRACKS);
+        for (int t = 0; t < tracks.getNumChildren(); ++t)
+        {
+            auto track = tracks.getChild (t);
+            for (int c = 0; c < track.getNumChildren(); ++c)
+            {
+                auto clip = track.getChild (c);
+                if (clip.getType() == IDs::AUDIO_CLIP)
+                    PeakStore::getInstance().request (clip.getProperty (IDs::sourceFile).getStringOr (""));
+            }
+        }
+
         project.getState().addListener (this);
         project.getState().getChildWithType (IDs::TRACKS).addListener (this);
         auto newSeq = project.getState().getChildWithType (IDs::STEP_SEQUENCER);
@@ -2187,36 +2364,125 @@ void AppController::loadSessionFromDirectory (const std::filesystem::path& dir)
     }
 }
 
-void AppController::openFile()
+void AppController::cleanUpUnusedMedia()
+{
+    if (currentSessionDirectory.empty())
+    {
+        platform::NativeDialogs::showAlert ("Clean Up Unused Media",
+            "Save the session first; only a saved session has a media pool.");
+        return;
+    }
+
+    if (! platform::NativeDialogs::showConfirmation ("Clean Up Unused Media",
+            "Delete media in this session's pool that neither the open session nor its "
+            "saved copy uses?\n\nUndo history will be cleared. Other revisions or backups "
+            "of the session that use the deleted media will no longer find it."))
+        return;
+
+    // The saved copy can still use media the open session has dropped
+    std::vector<PropertyTree> states { project.getState() };
+    auto saved = SessionReader::readSession (currentSessionDirectory);
+    if (saved.isValid())
+        states.push_back (saved);
+
+    project.getUndoManager().clearHistory();
+    auto result = project.getAudioPool().collectGarbage (states);
+
+    platform::NativeDialogs::showAlert ("Clean Up Unused Media",
+        "Deleted " + std::to_string (result.entriesRemoved) + " unused media files ("
+        + std::to_string (result.bytesFreed / (1024 * 1024)) + " MB).");
+}
+
+void AppController::openFile (bool convertToSessionRate)
 {
-    platform::NativeDialogs::showOpenPanel ("Select an audio file...",
+    platform::NativeDialogs::showOpenPanelMultiple ("Select audio files...",
         { "wav", "aiff", "mp3", "flac", "ogg" },
-        [this] (const std::string& path)
+        [this, convertToSessionRate] (const std::vector<std::string>& paths)
         {
-            if (path.empty())
-                return;
-            std::filesystem::path file (path);
-            if (std::filesystem::exists (file) && std::filesystem::is_regular_file (file))
-                addTrackFromFile (file);
+            std::vector<std::filesystem::path> files;
+            for (auto& path : paths)
+            {
+                std::filesystem::path file (path);
+                if (std::filesystem::exists (file) && std::filesystem::is_regular_file (file))
+                    files.push_back (file);
+            }
+            importAudioFiles (files, convertToSessionRate);
         });
 }
 
-void AppController::addTrackFromFile (const std::filesystem::path& file)
+void AppController::addTrackFromFile (const std::filesystem::path& file, bool convertToSessionRate)
 {
-    auto trackName = file.stem().string();
-    auto trackState = project.addTrack (trackName);
+    importAudioFiles ({ file }, convertToSessionRate);
+}
+
+void AppController::importAudioFiles (const std::vector<std::filesystem::path>& files, bool convertToSessionRate)
+{
+    if (files.empty())
+        return;
 
-    auto tempProcessor = std::make_unique<TrackProcessor> (transportController);
-    if (tempProcessor->loadFile (file))
+    AudioImporter::Options options;
+    if (convertToSessionRate)
+        options.targetSampleRate = project.getSampleRate();
+    if (! currentSessionDirectory.empty())
+        options.workDirectory = currentSessionDirectory / "audio";
+
+    // Each file gets a placeholder track at once; its clip is added when
+    // the pipeline has decoded, pooled and scanned the file
+    deferGraphRebuild = true;
+    for (auto& file : files)
     {
-        auto length = tempProcessor->getFileLengthInSamples();
-        Track track (trackState);
-        track.addAudioClip (file.string(), 0, length);
+        auto trackState = project.addTrack (file.stem().string());
+        audioImporter->import (file, options, [this, trackState] (const AudioImporter::Result& result)
+        {
+            finishAudioImport (trackState, result);
+        });
     }
+    deferGraphRebuild = false;
 
     rebuildAudioGraph();
 }
 
+void AppController::finishAudioImport (PropertyTree trackState, const AudioImporter::Result& result)
+{
+    auto tracks = project.getState().getChildWithType (IDs::TRACKS);
+    int trackIndex = tracks.indexOf (trackState);
+
+    if (result.ok && trackIndex >= 0)
+    {
+        // Lanes showing the file share the peaks scanned during import
+        gfx::WaveformRegistry::getInstance().add (result.file, result.peaks);
+
+        // Timeline positions are at the session rate; files at another
+        // rate are converted while streaming
+        double sessionRate = project.getSampleRate();
+        auto length = static_cast<int64_t> (std::ceil (static_cast<double> (result.lengthInSamples)
+                                                       * sessionRate / result.sampleRate));
+
+        Track track (trackState);
+        auto clip = track.addAudioClip (result.file.string(), 0, length);
+        if (! result.poolEntry.empty())
+            clip.setProperty (IDs::poolEntry, Variant (result.poolEntry), nullptr);
+    }
+    else if (! result.ok)
+    {
+        if (trackIndex >= 0 && Track (trackState).getNumClips() == 0)
+            project.removeTrack (trackIndex);
+
+        importErrors.push_back (result.source.filename().string() + ": " + result.error);
+    }
+
+    // One alert for the whole batch
+    if (! audioImporter->getProgress().isActive() && ! importErrors.empty())
+    {
+        std::string message = "Some files could not be imported:\n";
+        for (auto& error : importErrors)
+            message += "\n" + error;
+        importErrors.clear();
+
+        platform::NativeDialogs::showAlert ("Import Error", message);
+    }
+}
+
 void AppController::addMidiTrack (const std::string& name)
 {
     auto trackState = project.addTrack (name);
@@ -2237,6 +2503,59 @@ void AppController::addMidiTrack (const std::string& name)
     rebuildAudioGraph();
 }
 
+void AppController::importMidiFile()
+{
+    platform::NativeDialogs::showOpenPanel ("Select a MIDI file...",
+        { "mid", "midi", "smf" },
+        [this] (const std::string& path)
+        {
+            if (path.empty())
+                return;
+            std::filesystem::path file (path);
+            if (std::filesystem::is_regular_file (file))
+                importMidiFileFromPath (file);
+        });
+}
+
+void AppController::importMidiFileFromPath (const std::filesystem::path& file)
+{
+    auto midiFile = MidiFile::read (file);
+    if (midiFile == nullptr)
+    {
+        platform::NativeDialogs::showAlert ("Import Error",
+            "Not a valid MIDI file:\n" + file.string());
+        return;
+    }
+
+    // Each imported track is attached fully built; rebuild the graph once
+    deferGraphRebuild = true;
+    int added = MidiFileUtils::importIntoProject (*midiFile, project, file.stem().string());
+    deferGraphRebuild = false;
+
+    if (added > 0)
+    {
+        arrangement.selectTrack (project.getNumTracks() - added);
+        vimContext.setSelectedClipIndex (0);
+    }
+
+    rebuildAudioGraph();
+}
+
+void AppController::exportMidiFile()
+{
+    platform::NativeDialogs::showSavePanel ("Export MIDI File", "Untitled.mid",
+        [this] (const std::string& path)
+        {
+            if (path.empty())
+                return;
+
+            auto midiFile = MidiFileUtils::createFromProject (project);
+            if (! midiFile.write (path))
+                platform::NativeDialogs::showAlert ("Export Error",
+                    "Failed to write MIDI file:\n" + path);
+        });
+}
+
 void AppController::showAudioSettings()
 {
     auto deviceName = audioEngine.getCurrentDeviceName();
@@ -2343,6 +2662,19 @@ void AppController::propertyChanged (PropertyTree& tree, PropertyId property)
         transportController.setLoopEndInSamples (project.getCycleEnd());
     }
 
+    // Audio clip moved, trimmed or faded
+    if (tree.getType() == IDs::AUDIO_CLIP)
+    {
+        auto trackState = tree.getParent();
+        if (trackState.getType() == IDs::TRACK)
+        {
+            auto tracksNode = project.getState().getChildWithType (IDs::TRACKS);
+            int trackIndex = tracksNode.indexOf (trackState);
+            if (trackIndex >= 0)
+                syncAudioClipsFromModel (trackIndex);
+        }
+    }
+
     // MIDI clip property changed (e.g. midiData, startPosition, length)
     if (tree.getType() == IDs::MIDI_CLIP)
     {
@@ -2367,7 +2699,7 @@ void AppController::propertyChanged (PropertyTree& tree, PropertyId property)
 
 void AppController::childAdded (PropertyTree& parent, PropertyTree& child)
 {
-    if (parent.getType() == IDs::TRACKS)
+    if (parent.getType() == IDs::TRACKS && ! deferGraphRebuild)
         rebuildAudioGraph();
 
     // MIDI clip added to a track
@@ -2379,6 +2711,15 @@ void AppController::childAdded (PropertyTree& parent, PropertyTree& child)
             syncMidiClipFromModel (trackIndex);
     }
 
+    // Audio clip added to a track
+    if (parent.getType() == IDs::TRACK && child.getType() == IDs::AUDIO_CLIP)
+    {
+        auto tracksNode = project.getState().getChildWithType (IDs::TRACKS);
+        int trackIndex = tracksNode.indexOf (parent);
+        if (trackIndex >= 0)
+            syncAudioClipsFromModel (trackIndex);
+    }
+
     if (parent.getType() == IDs::STEP_SEQUENCER || parent.getType() == IDs::STEP_PATTERN
         || parent.getType() == IDs::STEP_ROW)
         syncSequencerFromModel();
@@ -2398,6 +2739,15 @@ void AppController::childRemoved (PropertyTree& parent, PropertyTree& child, int
             syncMidiClipFromModel (trackIndex);
     }
 
+    // Audio clip removed from a track
+    if (parent.getType() == IDs::TRACK && child.getType() == IDs::AUDIO_CLIP)
+    {
+        auto tracksNode = project.getState().getChildWithType (IDs::TRACKS);
+        int trackIndex = tracksNode.indexOf (parent);
+        if (trackIndex >= 0)
+            syncAudioClipsFromModel (trackIndex);
+    }
+
     if (parent.getType() == IDs::STEP_SEQUENCER || parent.getType() == IDs::STEP_PATTERN
         || parent.getType() == IDs::STEP_ROW)
         syncSequencerFromModel();
@@ -2475,10 +2825,30 @@ void AppController::vimContextChanged()
     }
 }
 
+bool AppController::needsFrameTimer() const
+{
+    return transportController.isPlaying()
+        || (browserWidget && browserWidget->isScanInProgress())
+        || (audioImporter && audioImporter->getProgress().isActive())
+        || waveformsPending();
+}
+
+bool AppController::waveformsPending()
+{
+    // Waveform widgets poll for peaks and tiles in their animation tick,
+    // which only runs when the loop wakes
+    return gfx::WaveformRegistry::getInstance().hasPendingLoads()
+        || gfx::WaveformTileCache::getInstance().hasPendingTiles()
+        || PeakStore::getInstance().isBuilding();
+}
+
 void AppController::tick()
 {
     messageQueue.processAll();
 
+    // Track processors keep audio pre-rolled at the grid cursor
+    transportController.setEditCursorInSamples (vimContext.getGridCursorPosition());
+
     // Poll browser scan progress (async scan updates atomics from background thread)
     if (browserWidget)
         browserWidget->tick();
@@ -2487,6 +2857,18 @@ void AppController::tick()
     if (transportBar)
         transportBar->getCpuMeter().setCpuLoad (audioEngine.getCpuLoad());
 
+    // Background audio import progress
+    if (transportBar && audioImporter)
+    {
+        auto progress = audioImporter->getProgress();
+        if (progress.isActive())
+            transportBar->setImportProgress (progress.fraction,
+                std::string (pendingAdoptions > 0 ? "Saving: pooling " : "Importing ") + std::to_string (progress.finished + 1) + "/" + std::to_string (progress.total)
+                    + (progress.currentFile.empty() ? "" : " " + progress.currentFile));
+        else
+            transportBar->clearImportProgress();
+    }
+
     if (! mixerWidget)
         return;
 
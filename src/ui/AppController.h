@@ -36,6 +36,8 @@
 #include "ui/pluginview/PluginViewWidget.h"
 #include "model/RecentProjects.h"
 #include "dc/foundation/message_queue.h"
+#include "utils/AudioImporter.h"
+#include <atomic>
 #include <filesystem>
 #include <vector>
 
@@ -63,6 +65,15 @@ public:
     // Called by the platform render loop to push meter levels and process messages
     void tick();
 
+    // True while state the UI shows changes without any event to announce
+    // it (playback, a plugin scan, an audio import, waveforms loading), so
+    // the render loop has to keep ticking at frame rate instead of waiting
+    // for events
+    bool needsFrameTimer() const;
+
+    // Posting here must wake the render loop when it is waiting for events
+    dc::MessageQueue& getMessageQueue() { return messageQueue; }
+
     // Access for wiring
     gfx::Renderer* getRenderer() { return renderer; }
     void setRenderer (gfx::Renderer* r);
@@ -122,6 +133,7 @@ private:
     void syncTrackProcessorsFromModel();
     void syncSequencerFromModel();
     void syncMidiClipFromModel (int trackIndex);
+    void syncAudioClipsFromModel (int trackIndex);
 
     void connectTrackPluginChain (int trackIndex);
     void disconnectTrackPluginChain (int trackIndex);
@@ -131,9 +143,17 @@ private:
     // Session management
     void saveSession();
     void loadSession();
-    void openFile();
-    void addTrackFromFile (const std::filesystem::path& file);
+    void cleanUpUnusedMedia();
+    static bool waveformsPending();
+    void writeSession (const std::filesystem::path& dir);
+    void openFile (bool convertToSessionRate = false);
+    void addTrackFromFile (const std::filesystem::path& file, bool convertToSessionRate = false);
+    void importAudioFiles (const std::vector<std::filesystem::path>& files, bool convertToSessionRate = false);
+    void finishAudioImport (PropertyTree trackState, const AudioImporter::Result& result);
     void addMidiTrack (const std::string& name);
+    void importMidiFile();
+    void importMidiFileFromPath (const std::filesystem::path& file);
+    void exportMidiFile();
     void showAudioSettings();
 
     // Panel visibility
@@ -180,6 +200,16 @@ private:
 
     std::filesystem::path currentSessionDirectory;
 
+    // Background decode, conversion, pooling and peak scanning of imported audio
+    std::unique_ptr<AudioImporter> audioImporter = std::make_unique<AudioImporter> (project.getAudioPool(), messageQueue);
+    std::vector<std::string> importErrors;
+
+    // A save adopts unpooled clip sources on the importer's workers and
+    // writes the session when the last one lands; loading or saving again
+    // bumps the generation, which drops the older save
+    uint64_t saveGeneration = 0;
+    int pendingAdoptions = 0;
+
     // ─── UI widgets ──────────────────────────────────────
     std::unique_ptr<TransportBarWidget> transportBar;
     std::unique_ptr<VimStatusBarWidget> vimStatusBar;
@@ -194,6 +224,9 @@ private:
 
     bool browserVisible = false;
 
+    // Set while a bulk model edit adds many tracks; the graph is rebuilt once at the end
+    bool deferGraphRebuild = false;
+
     // Resizer bar position: fraction of center area occupied by top (arrangement)
     float splitRatio = 0.65f;
 
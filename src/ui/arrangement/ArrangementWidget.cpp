@@ -2,6 +2,7 @@
 #include "graphics/rendering/Canvas.h"
 #include "graphics/theme/Theme.h"
 #include "model/Track.h"
+#include <algorithm>
 
 namespace dc
 {
@@ -53,11 +54,7 @@ void ArrangementWidget::paintOverChildren (gfx::Canvas& canvas)
     double sr = transportController.getSampleRate();
     if (sr <= 0.0) return;
 
-    int64_t posInSamples = transportController.getPositionInSamples();
-    double posInSeconds = static_cast<double> (posInSamples) / sr;
-
-    float cursorX = static_cast<float> (posInSeconds * pixelsPerSecond)
-                  + theme.headerWidth - scrollView.getScrollOffsetX();
+    float cursorX = getPlayheadX();
 
     if (cursorX >= theme.headerWidth && cursorX <= getWidth())
     {
@@ -107,7 +104,15 @@ void ArrangementWidget::resized()
     timeRuler.setBounds (0, 0, w, rulerHeight);
     scrollView.setBounds (0, rulerHeight, w, h - rulerHeight);
 
-    float contentWidth = std::max (w, 10000.0f);
+    // Wide enough to scroll a viewport past the last clip
+    int64_t endPosition = 0;
+    for (int i = 0; i < arrangement.getNumTracks(); ++i)
+        endPosition = std::max (endPosition, arrangement.getClipIndex (i)->getEndPosition());
+
+    double sr = transportController.getSampleRate();
+    float endX = sr > 0.0 ? static_cast<float> (static_cast<double> (endPosition) / sr * pixelsPerSecond) : 0.0f;
+
+    float contentWidth = std::max ({ w, 10000.0f, endX + gfx::Theme::getDefault().headerWidth + w });
     float contentHeight = static_cast<float> (trackLanes.size()) * trackHeight;
     scrollView.setContentSize (contentWidth, contentHeight);
 
@@ -116,9 +121,28 @@ void ArrangementWidget::resized()
         trackLanes[i]->setBounds (0, static_cast<float> (i) * trackHeight,
                                    contentWidth, trackHeight);
     }
+
+    updateVisibleClips();
 }
 
-void ArrangementWidget::animationTick (double /*timestampMs*/)
+void ArrangementWidget::updateVisibleClips()
+{
+    float left = scrollView.getScrollOffsetX();
+    float right = left + scrollView.getWidth();
+    float top = scrollView.getScrollOffsetY();
+    float bottom = top + scrollView.getHeight();
+
+    for (auto& lane : trackLanes)
+    {
+        auto b = lane->getBounds();
+        if (b.bottom() > top && b.y < bottom)
+            lane->setVisibleRange (left, right);
+        else
+            lane->setVisibleRange (0.0f, 0.0f);
+    }
+}
+
+void ArrangementWidget::animationTick (double timestampMs)
 {
     // Deferred rebuild — coalesces multiple PropertyTree changes into a single rebuild
     if (needsRebuild)
@@ -130,8 +154,46 @@ void ArrangementWidget::animationTick (double /*timestampMs*/)
     // Sync scroll offset to time ruler
     timeRuler.setScrollOffset (static_cast<double> (scrollView.getScrollOffsetX()));
 
-    // Repaint for playhead animation
-    repaint();
+    // Make clip views for whatever scrolled into view
+    updateVisibleClips();
+
+    for (auto& lane : trackLanes)
+        lane->animationTick (timestampMs);
+
+    // Playhead animation: repaint only the columns it left and entered,
+    // unless the cycle overlay changed too
+    float cursorX = getPlayheadX();
+    bool looping = transportController.isLooping();
+    int64_t loopStart = transportController.getLoopStartInSamples();
+    int64_t loopEnd = transportController.getLoopEndInSamples();
+
+    if (looping != lastLooping || loopStart != lastLoopStart || loopEnd != lastLoopEnd)
+    {
+        repaint();
+    }
+    else if (cursorX != lastPlayheadX)
+    {
+        invalidateRect (gfx::Rect (lastPlayheadX - playheadDamageWidth * 0.5f, rulerHeight,
+                                   playheadDamageWidth, getHeight() - rulerHeight));
+        invalidateRect (gfx::Rect (cursorX - playheadDamageWidth * 0.5f, rulerHeight,
+                                   playheadDamageWidth, getHeight() - rulerHeight));
+    }
+
+    lastPlayheadX = cursorX;
+    lastLooping = looping;
+    lastLoopStart = loopStart;
+    lastLoopEnd = loopEnd;
+}
+
+float ArrangementWidget::getPlayheadX() const
+{
+    double sr = transportController.getSampleRate();
+    if (sr <= 0.0) return -1.0f;
+
+    double posInSeconds = static_cast<double> (transportController.getPositionInSamples()) / sr;
+
+    return static_cast<float> (posInSeconds * pixelsPerSecond)
+         + gfx::Theme::getDefault().headerWidth - scrollView.getScrollOffsetX();
 }
 
 void ArrangementWidget::rebuildTrackLanes()
@@ -146,7 +208,7 @@ void ArrangementWidget::rebuildTrackLanes()
     for (int i = 0; i < project.getNumTracks(); ++i)
     {
         auto trackState = project.getTrack (i);
-        auto lane = std::make_unique<TrackLaneWidget> (trackState);
+        auto lane = std::make_unique<TrackLaneWidget> (trackState, arrangement.getClipIndex (i));
         lane->setPixelsPerSecond (pixelsPerSecond);
         lane->setSampleRate (sr);
         lane->setTempo (tempoMap.getTempo());
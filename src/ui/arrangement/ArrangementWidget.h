@@ -47,6 +47,8 @@ public:
 
 private:
     void updateSelectionVisuals();
+    void updateVisibleClips();
+    float getPlayheadX() const;
 
     Project& project;
     TransportController& transportController;
@@ -64,7 +66,15 @@ private:
     double pixelsPerSecond = 100.0;
     bool activeContext = true;
     bool needsRebuild = false;
+
+    // What paintOverChildren last showed, to damage only what moved
+    float lastPlayheadX = -1.0f;
+    bool lastLooping = false;
+    int64_t lastLoopStart = -1;
+    int64_t lastLoopEnd = -1;
+
     static constexpr float rulerHeight = 30.0f;
+    static constexpr float playheadDamageWidth = 4.0f;  // 2px line, antialiased
     static constexpr float trackHeight = 100.0f;
 };
 
@@ -11,6 +11,8 @@ namespace ui
 MidiClipWidget::MidiClipWidget (const PropertyTree& state)
     : clipState (state)
 {
+    // Decoding and drawing the notes is costly; they rarely change
+    useTextureCache = true;
     clipState.addListener (this);
 }
 
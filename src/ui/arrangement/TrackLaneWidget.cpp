@@ -1,8 +1,11 @@
 #include "TrackLaneWidget.h"
 #include "graphics/rendering/Canvas.h"
+#include "graphics/rendering/WaveformRegistry.h"
 #include "graphics/theme/FontManager.h"
 #include "model/Track.h"
 #include "model/Project.h"
+#include <algorithm>
+#include <cmath>
 #include <filesystem>
 #include <string>
 
@@ -11,8 +14,8 @@ namespace dc
 namespace ui
 {
 
-TrackLaneWidget::TrackLaneWidget (const PropertyTree& state)
-    : trackState (state)
+TrackLaneWidget::TrackLaneWidget (const PropertyTree& state, std::shared_ptr<const ClipIndex> index)
+    : trackState (state), clipIndex (std::move (index))
 {
 }
 
@@ -111,26 +114,18 @@ void TrackLaneWidget::paintOverChildren (gfx::Canvas& canvas)
         else
         {
             // Linewise or fallback: highlight all clips on track
-            auto drawClipHighlight = [&] (gfx::Widget* clip)
+            auto drawClipHighlight = [&] (int clip)
             {
-                Rect clipBounds = clip->getBounds();
+                Rect clipBounds = getClipBounds (clip);
                 canvas.fillRoundedRect (clipBounds.reduced (-2.0f), 3.0f,
                                         highlightColor.withAlpha ((uint8_t) 64));
                 canvas.strokeRect (clipBounds, highlightColor, 2.0f);
             };
 
-            if (visualLinewise)
-            {
-                for (auto& cv : clipViews)
-                    drawClipHighlight (cv.get());
-            }
-            else
-            {
-                int start = std::max (0, visualStartClip);
-                int end   = std::min (static_cast<int> (clipViews.size()) - 1, visualEndClip);
-                for (int i = start; i <= end; ++i)
-                    drawClipHighlight (clipViews[static_cast<size_t> (i)].get());
-            }
+            // Only those near the viewport can show
+            for (int clip : materializedClips)
+                if (visualLinewise || (clip >= visualStartClip && clip <= visualEndClip))
+                    drawClipHighlight (clip);
         }
     }
 
@@ -149,11 +144,10 @@ void TrackLaneWidget::paintOverChildren (gfx::Canvas& canvas)
     }
 
     // Clip-under-cursor indicator (green border around clip containing cursor)
-    if (selected && selectedClipIndex >= 0 && selectedClipIndex < static_cast<int> (clipViews.size())
-        && ! inVisualSelection)
+    if (selected && clipIndex != nullptr && selectedClipIndex >= 0
+        && selectedClipIndex < clipIndex->getNumClips() && ! inVisualSelection)
     {
-        auto* clip = clipViews[static_cast<size_t> (selectedClipIndex)].get();
-        Rect clipBounds = clip->getBounds();
+        Rect clipBounds = getClipBounds (selectedClipIndex);
 
         canvas.fillRoundedRect (clipBounds.reduced (-2.0f), 3.0f,
                                 theme.selection.withAlpha ((uint8_t) 64));
@@ -163,7 +157,36 @@ void TrackLaneWidget::paintOverChildren (gfx::Canvas& canvas)
 
 void TrackLaneWidget::resized()
 {
-    rebuildClipViews();
+    updateClipViews (true);
+}
+
+void TrackLaneWidget::animationTick (double timestampMs)
+{
+    // The renderer only ticks top-level widgets; pass it on to clips
+    // whose waveforms are still loading or rasterizing
+    for (auto& [clip, cv] : clipViews)
+        if (cv->isAnimating())
+            cv->animationTick (timestampMs);
+}
+
+void TrackLaneWidget::setVisibleRange (float left, float right)
+{
+    visibleLeft = left;
+    visibleRight = right;
+
+    // Scrolled out of view: drop its views
+    if (right <= left)
+    {
+        if (! clipViews.empty())
+            updateClipViews (false);
+        return;
+    }
+
+    // Still covered by the views already made
+    if (left >= materializedLeft && right <= materializedRight)
+        return;
+
+    updateClipViews (false);
 }
 
 void TrackLaneWidget::setPixelsPerSecond (double pps)
@@ -208,6 +231,7 @@ void TrackLaneWidget::setSelectedClipIndex (int idx)
 void TrackLaneWidget::setVisualSelection (const VimContext::VisualSelection& sel, int trackIndex)
 {
     bool wasInVisual = inVisualSelection;
+    int lastClip = clipIndex != nullptr ? clipIndex->getNumClips() - 1 : -1;
 
     if (sel.active)
     {
@@ -226,7 +250,7 @@ void TrackLaneWidget::setVisualSelection (const VimContext::VisualSelection& sel
             else if (trackIndex > minTrack && trackIndex < maxTrack)
             {
                 visualStartClip = 0;
-                visualEndClip   = static_cast<int> (clipViews.size()) - 1;
+                visualEndClip   = lastClip;
             }
             else
             {
@@ -237,7 +261,7 @@ void TrackLaneWidget::setVisualSelection (const VimContext::VisualSelection& sel
                 if (trackIndex == minTrack)
                 {
                     visualStartClip = anchorClip;
-                    visualEndClip   = static_cast<int> (clipViews.size()) - 1;
+                    visualEndClip   = lastClip;
                 }
                 else
                 {
@@ -249,7 +273,7 @@ void TrackLaneWidget::setVisualSelection (const VimContext::VisualSelection& sel
         else
         {
             visualStartClip = 0;
-            visualEndClip   = static_cast<int> (clipViews.size()) - 1;
+            visualEndClip   = lastClip;
         }
     }
     else
@@ -290,30 +314,73 @@ void TrackLaneWidget::setGridVisualSelection (int64_t startPos, int64_t endPos,
     repaint();
 }
 
-void TrackLaneWidget::rebuildClipViews()
+gfx::Rect TrackLaneWidget::getClipBounds (int clip) const
 {
-    // Remove existing
-    for (auto& cv : clipViews)
-        removeChild (cv.get());
-    clipViews.clear();
-    waveformCaches.clear();
+    auto start = static_cast<double> (clipIndex->getClipStart (clip));
+    auto length = static_cast<double> (clipIndex->getClipEnd (clip)) - start;
 
-    float h = getHeight();
+    float x = static_cast<float> ((start / sampleRate) * pixelsPerSecond) + headerWidth;
+    float w = static_cast<float> ((length / sampleRate) * pixelsPerSecond);
+    return gfx::Rect (x, 0, w, getHeight());
+}
 
-    for (int i = 0; i < trackState.getNumChildren(); ++i)
+void TrackLaneWidget::updateClipViews (bool rebuild)
+{
+    // Hold on to replaced views until the new ones have taken their peaks,
+    // so a rebuild reuses them instead of loading them again
+    std::map<int, std::unique_ptr<gfx::Widget>> previous;
+    if (rebuild)
     {
-        auto child = trackState.getChild (i);
-        bool isAudio = child.getType() == IDs::AUDIO_CLIP;
-        bool isMidi  = child.getType() == IDs::MIDI_CLIP;
+        for (auto& [clip, cv] : clipViews)
+            removeChild (cv.get());
+        previous.swap (clipViews);
+    }
+
+    materializedClips.clear();
+    materializedLeft = materializedRight = 0.0f;
 
-        if (! isAudio && ! isMidi)
+    if (clipIndex != nullptr && sampleRate > 0.0 && pixelsPerSecond > 0.0 && visibleRight > visibleLeft)
+    {
+        float margin = (visibleRight - visibleLeft) * materializeMargin;
+        materializedLeft = visibleLeft - margin;
+        materializedRight = visibleRight + margin;
+
+        auto toSamples = [this] (float x)
+        {
+            return static_cast<int64_t> (std::floor ((x - headerWidth) / pixelsPerSecond * sampleRate));
+        };
+
+        clipIndex->findOverlapping (toSamples (materializedLeft), toSamples (materializedRight) + 1,
+                                    materializedClips);
+    }
+
+    std::vector<int> wanted (materializedClips);
+    std::sort (wanted.begin(), wanted.end());
+
+    // Drop views that scrolled out of range
+    for (auto it = clipViews.begin(); it != clipViews.end();)
+    {
+        if (std::binary_search (wanted.begin(), wanted.end(), it->first))
+        {
+            ++it;
             continue;
+        }
 
-        int64_t startPos = child.getProperty (IDs::startPosition).getIntOr (0);
-        int64_t clipLength = child.getProperty (IDs::length).getIntOr (0);
+        removeChild (it->second.get());
+        it = clipViews.erase (it);
+    }
+
+    float h = getHeight();
 
-        float x = static_cast<float> ((static_cast<double> (startPos) / sampleRate) * pixelsPerSecond) + headerWidth;
-        float w = static_cast<float> ((static_cast<double> (clipLength) / sampleRate) * pixelsPerSecond);
+    for (int clip : materializedClips)
+    {
+        if (clipViews.count (clip) > 0)
+            continue;
+
+        auto child = clipIndex->getClip (clip);
+        bool isAudio = child.getType() == IDs::AUDIO_CLIP;
+
+        int64_t clipLength = child.getProperty (IDs::length).getIntOr (0);
 
         std::unique_ptr<gfx::Widget> widget;
 
@@ -321,22 +388,15 @@ void TrackLaneWidget::rebuildClipViews()
 
         if (isAudio)
         {
-            // Create waveform cache and load audio data
-            auto cache = std::make_unique<gfx::WaveformCache>();
+            // Shared with every clip of the same file; loads in the background
             std::string sourceFilePath = child.getProperty (IDs::sourceFile).getStringOr ("");
-            if (! sourceFilePath.empty())
-            {
-                std::filesystem::path sourceFile (sourceFilePath);
-                if (std::filesystem::exists (sourceFile) && std::filesystem::is_regular_file (sourceFile))
-                    cache->loadFromFile (sourceFile);
-            }
+            auto cache = gfx::WaveformRegistry::getInstance().get (std::filesystem::path (sourceFilePath));
 
             auto waveformWidget = std::make_unique<WaveformWidget>();
-            waveformWidget->setWaveformCache (cache.get());
+            waveformWidget->setWaveformCache (cache);
             waveformWidget->setPixelsPerSecond (pixelsPerSecond);
             waveformWidget->setSampleRate (sampleRate);
             waveformWidget->setTrimStartSamples (trimStart);
-            waveformCaches.push_back (std::move (cache));
             widget = std::move (waveformWidget);
         }
         else
@@ -355,9 +415,10 @@ void TrackLaneWidget::rebuildClipViews()
             widget = std::move (midiWidget);
         }
 
-        widget->setBounds (x, 0, w, h);
+        auto bounds = getClipBounds (clip);
+        widget->setBounds (bounds.x, 0, bounds.width, h);
         addChild (widget.get());
-        clipViews.push_back (std::move (widget));
+        clipViews[clip] = std::move (widget);
     }
 }
 
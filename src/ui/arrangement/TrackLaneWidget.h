@@ -5,7 +5,9 @@
 #include "graphics/rendering/WaveformCache.h"
 #include "WaveformWidget.h"
 #include "MidiClipWidget.h"
+#include "model/ClipIndex.h"
 #include "vim/VimContext.h"
+#include <map>
 #include <vector>
 #include <memory>
 
@@ -14,14 +16,17 @@ namespace dc
 namespace ui
 {
 
+// One track's row in the arrangement. Clip widgets exist only for clips
+// near the visible part of the lane, found through the track's ClipIndex.
 class TrackLaneWidget : public gfx::Widget
 {
 public:
-    explicit TrackLaneWidget (const PropertyTree& trackState);
+    TrackLaneWidget (const PropertyTree& trackState, std::shared_ptr<const ClipIndex> clipIndex);
 
     void paint (gfx::Canvas& canvas) override;
     void paintOverChildren (gfx::Canvas& canvas) override;
     void resized() override;
+    void animationTick (double timestampMs) override;
 
     void setPixelsPerSecond (double pps);
     void setSampleRate (double sr);
@@ -33,13 +38,19 @@ public:
     void setGridUnitInSamples (int64_t unit);
     void setGridVisualSelection (int64_t startPos, int64_t endPos, bool active);
 
+    // Visible part of the lane, in its own x coordinates; an empty range
+    // when it is scrolled out of view
+    void setVisibleRange (float left, float right);
+
     bool isSelected() const { return selected; }
     const PropertyTree& getTrackState() const { return trackState; }
 
 private:
-    void rebuildClipViews();
+    void updateClipViews (bool rebuild);
+    gfx::Rect getClipBounds (int clip) const;
 
     PropertyTree trackState;
+    std::shared_ptr<const ClipIndex> clipIndex;
     double pixelsPerSecond = 100.0;
     double sampleRate = 44100.0;
     double tempo = 120.0;
@@ -58,8 +69,17 @@ private:
 
     static constexpr float headerWidth = 150.0f;
 
-    std::vector<std::unique_ptr<gfx::WaveformCache>> waveformCaches;
-    std::vector<std::unique_ptr<gfx::Widget>> clipViews;
+    // Clip views are made for the visible range widened by this many
+    // viewport widths either side, and remade once it scrolls out of it
+    static constexpr float materializeMargin = 0.5f;
+
+    float visibleLeft = 0.0f;
+    float visibleRight = 0.0f;
+    float materializedLeft = 0.0f;
+    float materializedRight = 0.0f;
+
+    std::vector<int> materializedClips;     // ordered by start
+    std::map<int, std::unique_ptr<gfx::Widget>> clipViews;  // by clip index
 };
 
 } // namespace ui
@@ -1,6 +1,9 @@
 #include "WaveformWidget.h"
 #include "graphics/rendering/Canvas.h"
+#include "graphics/rendering/WaveformTileCache.h"
 #include "graphics/theme/Theme.h"
+#include "include/core/SkCanvas.h"
+#include <cmath>
 
 namespace dc
 {
@@ -9,60 +12,97 @@ namespace ui
 
 WaveformWidget::WaveformWidget()
 {
-    useTextureCache = true;
 }
 
 void WaveformWidget::paint (gfx::Canvas& canvas)
 {
     using namespace gfx;
     auto& theme = Theme::getDefault();
+    auto& tiles = WaveformTileCache::getInstance();
 
     Rect r (0, 0, getWidth(), getHeight());
 
     // Background
     canvas.fillRect (r, Color::fromARGB (0xff222238));
 
-    if (!waveformCache || !waveformCache->isLoaded())
-        return;
+    waitingForTiles = false;
 
-    // Get appropriate LOD data
-    const auto* lod = waveformCache->getLOD (pixelsPerSecond, sampleRate);
-    if (!lod || lod->data.empty())
+    if (!waveformCache || !waveformCache->isLoaded() || getWidth() <= 0.0f)
         return;
 
-    // Build sample array for canvas drawWaveform
-    int numPixels = static_cast<int> (getWidth());
-    std::vector<Canvas::WaveformSample> samples (static_cast<size_t> (numPixels));
-
-    int64_t totalSamples = waveformCache->getTotalSamples();
-    int64_t visibleSamples = totalSamples - trimStartSamples;
+    int64_t visibleSamples = waveformCache->getTotalSamples() - trimStartSamples;
     if (visibleSamples <= 0) return;
-    double samplesPerPixel = static_cast<double> (visibleSamples) / static_cast<double> (numPixels);
-    int spb = lod->samplesPerBucket;
+    double samplesPerPixel = static_cast<double> (visibleSamples) / static_cast<double> (getWidth());
+
+    // Tiles are counted from the start of the file; the trim shifts them left
+    double offset = static_cast<double> (trimStartSamples) / samplesPerPixel;
+
+    auto* sk = canvas.getSkCanvas();
+    float scale = sk->getTotalMatrix().getScaleX();
+    if (scale <= 0.0f) scale = 1.0f;
+
+    // Only the tiles under the dirty area
+    auto clip = sk->getLocalClipBounds();
+    double left = std::max (0.0, static_cast<double> (clip.left())) + offset;
+    double right = std::min (static_cast<double> (getWidth()), static_cast<double> (clip.right())) + offset;
+    if (right <= left) return;
+
+    constexpr int tileWidth = WaveformTileCache::tileWidth;
+    auto first = static_cast<int64_t> (std::floor (left / tileWidth));
+    auto last = static_cast<int64_t> (std::ceil (right / tileWidth)) - 1;
 
-    for (int px = 0; px < numPixels; ++px)
+    canvas.save();
+    canvas.clipRect (r);
+
+    for (int64_t t = first; t <= last; ++t)
     {
-        int64_t sampleStart = trimStartSamples + static_cast<int64_t> (px * samplesPerPixel);
-        int64_t sampleEnd = trimStartSamples + static_cast<int64_t> ((px + 1) * samplesPerPixel);
-        int bucketStart = static_cast<int> (sampleStart / spb);
-        int bucketEnd = static_cast<int> (sampleEnd / spb);
+        auto tile = tiles.getTile (waveformCache, 0, samplesPerPixel, t, getHeight(), scale, theme.waveformFill);
 
-        float minVal = 0.0f;
-        float maxVal = 0.0f;
+        if (!tile.current)
+            waitingForTiles = true;
 
-        for (int b = bucketStart; b <= bucketEnd && b < static_cast<int> (lod->data.size()); ++b)
+        if (tile.image)
         {
-            if (b >= 0)
-            {
-                minVal = std::min (minVal, lod->data[static_cast<size_t> (b)].minVal);
-                maxVal = std::max (maxVal, lod->data[static_cast<size_t> (b)].maxVal);
-            }
+            float x = static_cast<float> (static_cast<double> (t * tileWidth) - offset);
+            canvas.drawImageScaled (tile.image, Rect (x, 0, static_cast<float> (tileWidth), getHeight()));
         }
+    }
+
+    canvas.restore();
 
-        samples[static_cast<size_t> (px)] = { minVal, maxVal };
+    if (waitingForTiles)
+    {
+        generationDrawn = tiles.getGeneration();
+        setAnimating (true);
     }
+}
+
+void WaveformWidget::animationTick (double /*timestampMs*/)
+{
+    if (!waveformCache)
+    {
+        setAnimating (false);
+        return;
+    }
+
+    // Peaks still loading or being built: redraw as they fill in. Failed
+    // loads count as finished.
+    bool complete = waveformCache->isComplete()
+                    || (!waveformCache->isPending() && !waveformCache->isLoaded());
+    int64_t ready = waveformCache->getLODForResolution (sampleRate / pixelsPerSecond).size;
+
+    if (ready != bucketsDrawn)
+    {
+        bucketsDrawn = ready;
+        repaint();
+    }
+
+    // Tiles rasterized since the last paint
+    if (waitingForTiles && gfx::WaveformTileCache::getInstance().getGeneration() != generationDrawn)
+        repaint();
 
-    canvas.drawWaveform (r, samples, theme.waveformFill);
+    if (complete && !waitingForTiles)
+        setAnimating (false);
 }
 
 } // namespace ui
@@ -2,29 +2,42 @@
 
 #include "graphics/core/Widget.h"
 #include "graphics/rendering/WaveformCache.h"
+#include <memory>
 
 namespace dc
 {
 namespace ui
 {
 
+// Draws a clip's waveform from rasterized tiles shared through
+// gfx::WaveformTileCache, repainting as tiles and peaks become ready.
 class WaveformWidget : public gfx::Widget
 {
 public:
     WaveformWidget();
 
     void paint (gfx::Canvas& canvas) override;
+    void animationTick (double timestampMs) override;
 
-    void setWaveformCache (gfx::WaveformCache* cache) { waveformCache = cache; repaint(); }
+    void setWaveformCache (std::shared_ptr<gfx::WaveformCache> cache)
+    {
+        waveformCache = std::move (cache);
+        bucketsDrawn = -1;
+        setAnimating (waveformCache != nullptr && !waveformCache->isComplete());
+        repaint();
+    }
     void setPixelsPerSecond (double pps) { pixelsPerSecond = pps; repaint(); }
     void setSampleRate (double sr) { sampleRate = sr; repaint(); }
     void setTrimStartSamples (int64_t samples) { trimStartSamples = samples; repaint(); }
 
 private:
-    gfx::WaveformCache* waveformCache = nullptr;
+    std::shared_ptr<gfx::WaveformCache> waveformCache;
     double pixelsPerSecond = 100.0;
     double sampleRate = 44100.0;
     int64_t trimStartSamples = 0;
+    int64_t bucketsDrawn = -1;
+    bool waitingForTiles = false;
+    uint64_t generationDrawn = 0;
 };
 
 } // namespace ui
@@ -1,5 +1,6 @@
 #include "BrowserWidget.h"
 #include "graphics/rendering/Canvas.h"
+#include "graphics/rendering/TextBlobCache.h"
 #include "graphics/theme/Theme.h"
 #include "graphics/theme/FontManager.h"
 #include "include/core/SkFont.h"
@@ -34,9 +35,10 @@ BrowserWidget::BrowserWidget (PluginManager& pm)
     pluginList.onDoubleClick = [this] (int index)
     {
         if (index >= 0 && index < static_cast<int> (displayedPlugins.size()) && onPluginSelected)
-            onPluginSelected (displayedPlugins[index]);
+            onPluginSelected (getDisplayedPlugin (index));
     };
 
+    pluginList.setModel (this);
     refreshPluginList();
 }
 
@@ -74,9 +76,8 @@ void BrowserWidget::paint (gfx::Canvas& canvas)
     // Cursor (only when search is active)
     if (searchActive)
     {
-        SkScalar textWidth = 0.0f;
-        if (! searchBuffer.empty())
-            textWidth = font.measureText (searchBuffer.data(), searchBuffer.size(), SkTextEncoding::kUTF8);
+        // Measured when the text was drawn above
+        float textWidth = gfx::TextBlobCache::getInstance().get (searchBuffer, font).advance;
 
         float cursorX = textX + textWidth;
         canvas.drawLine (cursorX, searchY + 6.0f, cursorX, searchY + searchFieldHeight - 6.0f,
@@ -136,42 +137,86 @@ void BrowserWidget::clearSearchFilter()
     repaint();
 }
 
-void BrowserWidget::filterPlugins()
+namespace
+{
+std::string toLower (std::string s)
+{
+    std::transform (s.begin(), s.end(), s.begin(),
+                    [] (unsigned char c) { return static_cast<char> (std::tolower (c)); });
+    return s;
+}
+} // namespace
+
+void BrowserWidget::rebuildSearchKeys()
 {
-    displayedPlugins.clear();
     auto& knownPlugins = pluginManager.getKnownPlugins();
 
-    std::vector<std::string> names;
+    searchKeys.clear();
+    searchKeys.reserve (knownPlugins.size());
 
+    // The newline can't appear in a query, so a match never spans both fields
     for (const auto& type : knownPlugins)
+        searchKeys.push_back (toLower (type.name) + '\n' + toLower (type.manufacturer));
+
+    filterValid = false;
+}
+
+void BrowserWidget::filterPlugins()
+{
+    if (searchKeys.size() != pluginManager.getKnownPlugins().size())
+        rebuildSearchKeys();
+
+    std::string queryLower = toLower (searchBuffer);
+    int numKnown = static_cast<int> (searchKeys.size());
+
+    // A query containing the previous one can only match a subset of its
+    // results, so typing narrows the current list instead of rescanning
+    bool narrowing = filterValid && queryLower.find (filteredQuery) != std::string::npos;
+
+    if (! narrowing)
     {
-        if (! searchBuffer.empty())
-        {
-            std::string nameLower = type.name;
-            std::transform (nameLower.begin(), nameLower.end(), nameLower.begin(),
-                            [] (unsigned char c) { return static_cast<char> (std::tolower (c)); });
-            std::string mfgLower = type.manufacturer;
-            std::transform (mfgLower.begin(), mfgLower.end(), mfgLower.begin(),
-                            [] (unsigned char c) { return static_cast<char> (std::tolower (c)); });
-            std::string queryLower = searchBuffer;
-            std::transform (queryLower.begin(), queryLower.end(), queryLower.begin(),
-                            [] (unsigned char c) { return static_cast<char> (std::tolower (c)); });
-
-            if (nameLower.find (queryLower) == std::string::npos
-                && mfgLower.find (queryLower) == std::string::npos)
-                continue;
-        }
+        displayedPlugins.resize (static_cast<size_t> (numKnown));
+        for (int i = 0; i < numKnown; ++i)
+            displayedPlugins[static_cast<size_t> (i)] = i;
+    }
 
-        displayedPlugins.push_back (type);
-        names.push_back (type.name + " (" + type.manufacturer + ")");
+    if (! queryLower.empty() && ! (narrowing && queryLower == filteredQuery))
+    {
+        displayedPlugins.erase (
+            std::remove_if (displayedPlugins.begin(), displayedPlugins.end(),
+                            [&] (int i)
+                            {
+                                return searchKeys[static_cast<size_t> (i)].find (queryLower) == std::string::npos;
+                            }),
+            displayedPlugins.end());
     }
 
-    pluginList.setItems (names);
+    filteredQuery = queryLower;
+    filterValid = true;
+    pluginList.modelChanged();
+}
+
+const dc::PluginDescription& BrowserWidget::getDisplayedPlugin (int row) const
+{
+    auto index = displayedPlugins[static_cast<size_t> (row)];
+    return pluginManager.getKnownPlugins()[static_cast<size_t> (index)];
+}
+
+int BrowserWidget::getNumRows() const
+{
+    return static_cast<int> (displayedPlugins.size());
+}
+
+std::string BrowserWidget::getRowText (int row) const
+{
+    const auto& type = getDisplayedPlugin (row);
+    return type.name + " (" + type.manufacturer + ")";
 }
 
 void BrowserWidget::refreshPluginList()
 {
     searchBuffer.clear();
+    rebuildSearchKeys();
     filterPlugins();
 }
 
@@ -214,7 +259,7 @@ void BrowserWidget::confirmSelection()
 {
     int idx = pluginList.getSelectedIndex();
     if (idx >= 0 && idx < static_cast<int> (displayedPlugins.size()) && onPluginSelected)
-        onPluginSelected (displayedPlugins[idx]);
+        onPluginSelected (getDisplayedPlugin (idx));
 }
 
 void BrowserWidget::startAsyncScan()
@@ -253,6 +298,10 @@ void BrowserWidget::startAsyncScan()
 
 void BrowserWidget::tick()
 {
+    // Not registered with the renderer, so drive the list's smooth scroll
+    if (pluginList.isAnimating())
+        pluginList.animationTick (0.0);
+
     if (scanInProgress_ && scanResultReady_)
     {
         scanInProgress_ = false;
@@ -17,7 +17,8 @@ namespace dc
 namespace ui
 {
 
-class BrowserWidget : public gfx::Widget
+class BrowserWidget : public gfx::Widget,
+                      private gfx::ListBoxWidget::Model
 {
 public:
     explicit BrowserWidget (PluginManager& pluginManager);
@@ -57,13 +58,26 @@ public:
 
 private:
     void filterPlugins();
+    void rebuildSearchKeys();
+    const dc::PluginDescription& getDisplayedPlugin (int row) const;
+
+    // gfx::ListBoxWidget::Model
+    int getNumRows() const override;
+    std::string getRowText (int row) const override;
 
     PluginManager& pluginManager;
     gfx::ButtonWidget scanButton;
     gfx::ProgressBarWidget progressBar;
     gfx::LabelWidget scanStatusLabel { "", gfx::LabelWidget::Centre };
     gfx::ListBoxWidget pluginList;
-    std::vector<dc::PluginDescription> displayedPlugins;
+
+    // Filtering narrows an index list over the known plugins instead of
+    // copying them; searchKeys holds each plugin's lower-cased name and
+    // manufacturer so a keystroke doesn't re-lower the whole list
+    std::vector<int> displayedPlugins;
+    std::vector<std::string> searchKeys;
+    std::string filteredQuery;
+    bool filterValid = false;
     std::string searchBuffer;
     bool searchActive = false;
     float searchFieldY_ = 36.0f;
@@ -21,7 +21,7 @@ public:
 
     void setClipState (const PropertyTree& state) { clipState = state; repaint(); }
     void setPixelsPerBeat (float ppb) { pixelsPerBeat = ppb; repaint(); }
-    void setScrollOffset (float offset) { scrollOffset = offset; repaint(); }
+    void setScrollOffset (float offset) { if (offset != scrollOffset) { scrollOffset = offset; repaint(); } }
     void setCCNumber (int cc) { ccNumber = cc; repaint(); }
     int getCCNumber() const { return ccNumber; }
 
@@ -1,6 +1,9 @@
 #include "NoteGridWidget.h"
 #include "graphics/rendering/Canvas.h"
 #include "graphics/theme/Theme.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
 
 namespace dc
 {
@@ -63,6 +66,120 @@ void NoteGridWidget::paint (gfx::Canvas& canvas)
         else
             canvas.fillRect (Rect (x, 0, 0.5f, h), Color::fromARGB (0xff282840));
     }
+
+    paintNotes (canvas);
+}
+
+void NoteGridWidget::setNoteRange (double beatOffset, double clipLengthBeats)
+{
+    noteBeatOffset = beatOffset;
+    noteRangeBeats = clipLengthBeats;
+    repaint();
+}
+
+gfx::Rect NoteGridWidget::getNoteBounds (const NoteIndex::Note& note) const
+{
+    // Clamped to the start of the visible clip region
+    double start = note.startBeat - noteBeatOffset;
+    double length = note.lengthBeats;
+    if (start < 0.0)
+    {
+        length += start;
+        start = 0.0;
+    }
+
+    return gfx::Rect (beatsToX (start), noteToY (note.noteNumber),
+                      static_cast<float> (length * pixelsPerBeat), rowHeight - 1.0f);
+}
+
+void NoteGridWidget::notesInRect (const gfx::Rect& r, std::vector<const NoteIndex::Note*>& result) const
+{
+    result.clear();
+    if (noteIndex == nullptr || r.width <= 0.0f || r.height <= 0.0f)
+        return;
+
+    double startBeat = std::max (0.0, xToBeats (r.x));
+    double endBeat = std::min (noteRangeBeats, xToBeats (r.right()));
+    if (endBeat <= startBeat)
+        return;
+
+    int highNote = std::clamp (yToNote (r.y), 0, 127);
+    int lowNote = std::clamp (yToNote (r.bottom()), 0, 127);
+
+    noteIndex->query (startBeat + noteBeatOffset, endBeat + noteBeatOffset, lowNote, highNote, result);
+
+    // Rows are whole pitches; drop notes whose bar the rect only grazes
+    result.erase (std::remove_if (result.begin(), result.end(), [&] (const NoteIndex::Note* n)
+    {
+        return ! getNoteBounds (*n).intersects (r);
+    }), result.end());
+}
+
+const NoteIndex::Note* NoteGridWidget::noteAtPoint (float x, float y) const
+{
+    if (noteIndex == nullptr)
+        return nullptr;
+
+    double beat = xToBeats (x);
+    if (beat < 0.0 || beat >= noteRangeBeats)
+        return nullptr;
+
+    int note = yToNote (y);
+    if (note < 0 || note > 127 || y - noteToY (note) >= rowHeight - 1.0f)
+        return nullptr;
+
+    return noteIndex->noteAt (note, beat + noteBeatOffset);
+}
+
+void NoteGridWidget::paintNotes (gfx::Canvas& canvas)
+{
+    using namespace gfx;
+
+    if (noteIndex == nullptr || noteIndex->empty())
+        return;
+
+    auto clip = canvas.getSkCanvas()->getLocalClipBounds();
+    Rect area (clip.left(), clip.top(), clip.right() - clip.left(), clip.bottom() - clip.top());
+    notesInRect (area.intersection (Rect (0, 0, getWidth(), getHeight())), visibleNotes);
+
+    if (visibleNotes.empty())
+        return;
+
+    // One path per velocity colour, so thousands of notes are a few draws
+    std::map<int, SkPath> bodies;
+    std::map<int, SkPath> handles;
+    SkPath selection;
+
+    for (auto* note : visibleNotes)
+    {
+        auto b = getNoteBounds (*note);
+        auto r = SkRect::MakeXYWH (b.x, b.y, b.width, b.height);
+        int velocity = std::clamp (note->velocity, 0, 127);
+
+        bodies[velocity].addRRect (SkRRect::MakeRectXY (r, 2.0f, 2.0f));
+        handles[velocity].addRect (SkRect::MakeXYWH (b.right() - 3.0f, b.y, 3.0f, b.height));
+
+        if (isNoteSelected && isNoteSelected (note->id))
+            selection.addRect (r);
+    }
+
+    // Color based on velocity
+    auto noteColour = [] (int velocity)
+    {
+        float velNorm = static_cast<float> (velocity) / 127.0f;
+        return Color (static_cast<uint8_t> (74 + velNorm * 100),
+                      static_cast<uint8_t> (158 - velNorm * 50),
+                      255);
+    };
+
+    for (auto& [velocity, path] : bodies)
+        canvas.fillPath (path, noteColour (velocity));
+
+    for (auto& [velocity, path] : handles)
+        canvas.fillPath (path, noteColour (velocity).withAlpha ((uint8_t) 180));
+
+    if (! selection.isEmpty())
+        canvas.strokePath (selection, Theme::getDefault().brightText, 2.0f);
 }
 
 void NoteGridWidget::paintOverChildren (gfx::Canvas& canvas)
@@ -86,6 +203,26 @@ void NoteGridWidget::mouseDown (const gfx::MouseEvent& e)
     int note = yToNote (e.y);
     double beat = xToBeats (e.x);
 
+    if (toolMode != EraseTool)
+    {
+        if (auto* hit = noteAtPoint (e.x, e.y))
+        {
+            pressedNote = *hit;
+            pressX = e.x;
+            pressY = e.y;
+
+            // Right edge = resize
+            if (e.x > getNoteBounds (pressedNote).right() - resizeHandleWidth)
+                resizingNote = true;
+            else
+                draggingNote = true;
+
+            if (onNoteClicked)
+                onNoteClicked (pressedNote.id, e.shift);
+            return;
+        }
+    }
+
     if (toolMode == DrawTool)
     {
         if (onDrawNote)
@@ -112,7 +249,17 @@ void NoteGridWidget::mouseDown (const gfx::MouseEvent& e)
 
 void NoteGridWidget::mouseDrag (const gfx::MouseEvent& e)
 {
-    if (isRubberBanding)
+    if (resizingNote)
+    {
+        if (onNoteResize)
+            onNoteResize (pressedNote, e.x - getNoteBounds (pressedNote).x);
+    }
+    else if (draggingNote)
+    {
+        if (onNoteDrag)
+            onNoteDrag (pressedNote, e.x - pressX, e.y - pressY);
+    }
+    else if (isRubberBanding)
     {
         rbEndX = e.x;
         rbEndY = e.y;
@@ -122,6 +269,9 @@ void NoteGridWidget::mouseDrag (const gfx::MouseEvent& e)
 
 void NoteGridWidget::mouseUp (const gfx::MouseEvent& e)
 {
+    draggingNote = false;
+    resizingNote = false;
+
     if (isRubberBanding)
     {
         isRubberBanding = false;
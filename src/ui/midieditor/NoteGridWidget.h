@@ -1,13 +1,18 @@
 #pragma once
 
 #include "graphics/core/Widget.h"
+#include "dc/midi/NoteIndex.h"
 #include <functional>
+#include <vector>
 
 namespace dc
 {
 namespace ui
 {
 
+// The piano roll's grid and notes. Notes are not widgets: they are drawn
+// straight from a NoteIndex, only those under the dirty area, and mouse
+// hits are answered by querying the same index.
 class NoteGridWidget : public gfx::Widget
 {
 public:
@@ -25,6 +30,22 @@ public:
     std::function<void (float, float, float, float)> onRubberBandSelect; // startX, startY, endX, endY
     std::function<void()> onEmptyClick; // click on empty area in select mode
 
+    // Note callbacks; ids are NoteIndex ids, notes are as pressed
+    std::function<bool (int noteId)> isNoteSelected;
+    std::function<void (int noteId, bool shift)> onNoteClicked;
+    std::function<void (const NoteIndex::Note&, float dx, float dy)> onNoteDrag;
+    std::function<void (const NoteIndex::Note&, float newWidth)> onNoteResize;
+
+    // Notes to draw, in stored beats. Shown from beatOffset, for
+    // clipLengthBeats; the index must outlive the grid or be reset.
+    void setNoteIndex (const NoteIndex* index) { noteIndex = index; repaint(); }
+    void setNoteRange (double beatOffset, double clipLengthBeats);
+
+    // Hit-testing, in grid coordinates
+    const NoteIndex::Note* noteAtPoint (float x, float y) const;
+    void notesInRect (const gfx::Rect& r, std::vector<const NoteIndex::Note*>& result) const;
+    gfx::Rect getNoteBounds (const NoteIndex::Note& note) const;
+
     // Coordinate helpers
     float beatsToX (double beats) const;
     double xToBeats (float x) const;
@@ -50,6 +71,7 @@ public:
 
 private:
     bool isBlackKey (int note) const;
+    void paintNotes (gfx::Canvas& canvas);
 
     float pixelsPerBeat = 80.0f;
     float rowHeight = 12.0f;
@@ -61,6 +83,18 @@ private:
     bool isRubberBanding = false;
     float rbStartX = 0.0f, rbStartY = 0.0f;
     float rbEndX = 0.0f, rbEndY = 0.0f;
+
+    const NoteIndex* noteIndex = nullptr;
+    double noteBeatOffset = 0.0;
+    double noteRangeBeats = 0.0;
+    std::vector<const NoteIndex::Note*> visibleNotes;  // reused by paint
+
+    // Note being dragged or resized, as it was when pressed
+    NoteIndex::Note pressedNote;
+    bool draggingNote = false;
+    bool resizingNote = false;
+    float pressX = 0.0f, pressY = 0.0f;
+    static constexpr float resizeHandleWidth = 6.0f;
 };
 
 } // namespace ui
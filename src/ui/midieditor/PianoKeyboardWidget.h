@@ -16,7 +16,7 @@ public:
     void paint (gfx::Canvas& canvas) override;
     void mouseDown (const gfx::MouseEvent& e) override;
 
-    void setScrollOffset (float offset) { scrollOffset = offset; repaint(); }
+    void setScrollOffset (float offset) { if (offset != scrollOffset) { scrollOffset = offset; repaint(); } }
     float getRowHeight() const { return rowHeight; }
     void setRowHeight (float rh) { rowHeight = rh; repaint(); }
 
@@ -19,7 +19,7 @@ public:
     void mouseDown (const gfx::MouseEvent& e) override;
 
     void setPixelsPerBeat (float ppb) { pixelsPerBeat = ppb; repaint(); }
-    void setScrollOffset (float offset) { scrollOffset = offset; repaint(); }
+    void setScrollOffset (float offset) { if (offset != scrollOffset) { scrollOffset = offset; repaint(); } }
     void setTimeSigNumerator (int num) { timeSigNumerator = num; repaint(); }
     void setBeatOffset (double offset) { beatOffset = offset; repaint(); }
 
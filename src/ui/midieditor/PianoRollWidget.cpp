@@ -10,6 +10,23 @@ namespace dc
 namespace ui
 {
 
+namespace
+{
+
+const PropertyId midiDataId ("midiData");
+
+// Marks the piano roll's own note edits, whose changes reach the note
+// index through the listener, so their midiData collapse needn't resync it
+struct ScopedNoteEdit
+{
+    explicit ScopedNoteEdit (bool& f) : flag (f) { flag = true; }
+    ~ScopedNoteEdit() { flag = false; }
+
+    bool& flag;
+};
+
+} // namespace
+
 PianoRollWidget::PianoRollWidget (Project& p, TransportController& t)
     : project (p), transportController (t), ruler (t, p), velocityLane (p), ccLane (p)
 {
@@ -48,6 +65,7 @@ PianoRollWidget::PianoRollWidget (Project& p, TransportController& t)
         double defaultLength = 1.0 / gridDivision;
 
         ScopedTransaction txn (project.getUndoSystem(), "Add Note");
+        ScopedNoteEdit edit (editingNotes);
         MidiClip clip (clipState);
         clip.addNote (noteNumber, snappedBeat, defaultLength, 100, &project.getUndoManager());
     };
@@ -60,25 +78,15 @@ PianoRollWidget::PianoRollWidget (Project& p, TransportController& t)
         // Convert display beat back to stored beat
         double storedBeat = beat + trimOffsetBeats;
 
-        // Find note at this position
-        for (int i = 0; i < clipState.getNumChildren(); ++i)
-        {
-            auto child = clipState.getChild (i);
-            if (child.getType() != IDs::NOTE)
-                continue;
-
-            int nn = static_cast<int> (child.getProperty (IDs::noteNumber).getIntOr (60));
-            double sb = child.getProperty (IDs::startBeat).getDoubleOr (0.0);
-            double lb = child.getProperty (IDs::lengthBeats).getDoubleOr (0.25);
+        auto* note = noteIndex.noteAt (noteNumber, storedBeat);
+        int childIndex = note != nullptr ? childIndexOfNote (note->id) : -1;
+        if (childIndex < 0)
+            return;
 
-            if (nn == noteNumber && storedBeat >= sb && storedBeat < sb + lb)
-            {
-                ScopedTransaction txn (project.getUndoSystem(), "Erase Note");
-                MidiClip clip (clipState);
-                clip.removeNote (i, &project.getUndoManager());
-                return;
-            }
-        }
+        ScopedTransaction txn (project.getUndoSystem(), "Erase Note");
+        ScopedNoteEdit edit (editingNotes);
+        MidiClip clip (clipState);
+        clip.removeNote (childIndex, &project.getUndoManager());
     };
 
     noteGrid.onRubberBandSelect = [this] (float x, float y, float w, float h)
@@ -91,6 +99,75 @@ PianoRollWidget::PianoRollWidget (Project& p, TransportController& t)
         deselectAll();
     };
 
+    // Wire note callbacks — selection, move and resize
+    noteGrid.setNoteIndex (&noteIndex);
+
+    noteGrid.isNoteSelected = [this] (int noteId)
+    {
+        return selectedNoteIndices.count (childIndexOfNote (noteId)) > 0;
+    };
+
+    noteGrid.onNoteClicked = [this] (int noteId, bool shiftHeld)
+    {
+        selectNote (childIndexOfNote (noteId), shiftHeld);
+    };
+
+    noteGrid.onNoteDrag = [this] (const NoteIndex::Note& original, float dx, float dy)
+    {
+        int childIndex = childIndexOfNote (original.id);
+        if (childIndex < 0)
+            return;
+
+        auto noteState = clipState.getChild (childIndex);
+
+        project.getUndoSystem().beginCoalescedTransaction ("Move Note");
+        auto& um = project.getUndoManager();
+        ScopedNoteEdit edit (editingNotes);
+
+        // Offsets are from the press, so apply them to the note as it was then
+        double newBeat = original.startBeat + static_cast<double> (dx) / pixelsPerBeat;
+        int newNote = original.noteNumber - static_cast<int> (dy / rowHeight);
+
+        if (snapEnabled)
+            newBeat = snapBeat (newBeat);
+
+        newBeat = std::max (0.0, newBeat);
+        newNote = std::clamp (newNote, 0, 127);
+
+        noteState.setProperty (IDs::startBeat, Variant (newBeat), &um);
+        noteState.setProperty (IDs::noteNumber, Variant (newNote), &um);
+
+        MidiClip clip (clipState);
+        clip.collapseChildrenToMidiData (&um);
+    };
+
+    noteGrid.onNoteResize = [this] (const NoteIndex::Note& original, float newWidth)
+    {
+        int childIndex = childIndexOfNote (original.id);
+        if (childIndex < 0)
+            return;
+
+        auto noteState = clipState.getChild (childIndex);
+
+        project.getUndoSystem().beginCoalescedTransaction ("Resize Note");
+        auto& um = project.getUndoManager();
+        ScopedNoteEdit edit (editingNotes);
+
+        double newLengthBeats = static_cast<double> (newWidth) / pixelsPerBeat;
+        double minLength = 1.0 / (gridDivision * 4); // 1/16 beat minimum
+
+        if (newLengthBeats < minLength)
+            newLengthBeats = minLength;
+
+        if (snapEnabled)
+            newLengthBeats = snapBeat (newLengthBeats);
+
+        noteState.setProperty (IDs::lengthBeats, Variant (newLengthBeats), &um);
+
+        MidiClip clip (clipState);
+        clip.collapseChildrenToMidiData (&um);
+    };
+
     setAnimating (true);
 }
 
@@ -243,7 +320,7 @@ void PianoRollWidget::resized()
     // Sync keyboard scroll with grid scroll
     keyboard.setScrollOffset (scrollView.getScrollOffsetY());
 
-    rebuildNotes();
+    updateNoteRange();
 }
 
 void PianoRollWidget::loadClip (const PropertyTree& state)
@@ -277,128 +354,125 @@ void PianoRollWidget::loadClip (const PropertyTree& state)
         ruler.setBeatOffset (0.0);
     }
 
-    rebuildNotes();
+    rebuildNoteIndex();
+    updateNoteRange();
 }
 
-void PianoRollWidget::rebuildNotes()
-{
-    for (auto& nw : noteWidgets)
-        noteGrid.removeChild (nw.get());
-    noteWidgets.clear();
-
-    if (! clipState.isValid())
-        return;
-
-    // Compute visible beat range from clip length
-    double sr = project.getSampleRate();
-    double tempo = project.getTempo();
-    int64_t clipLength = clipState.getProperty (IDs::length).getIntOr (0);
-    double clipLengthBeats = (sr > 0.0 && tempo > 0.0)
-        ? (static_cast<double> (clipLength) / sr) * tempo / 60.0
-        : 1e12;
+// ── Note index ───────────────────────────────────────────────────────────────
 
-    for (int i = 0; i < clipState.getNumChildren(); ++i)
-    {
-        auto note = clipState.getChild (i);
-        if (note.getType() != IDs::NOTE)
-            continue;
-
-        int noteNum = static_cast<int> (note.getProperty (IDs::noteNumber).getIntOr (60));
-        auto startBeat = note.getProperty (IDs::startBeat).getDoubleOr (0.0) - trimOffsetBeats;
-        auto lengthBeats = note.getProperty (IDs::lengthBeats).getDoubleOr (0.25);
-        int velocity = static_cast<int> (note.getProperty (IDs::velocity).getIntOr (100));
-
-        // Skip notes outside the visible clip region
-        if (startBeat + lengthBeats <= 0.0 || startBeat >= clipLengthBeats)
-            continue;
-
-        // Clamp note to visible region
-        if (startBeat < 0.0)
-        {
-            lengthBeats += startBeat;
-            startBeat = 0.0;
-        }
-
-        float x = noteGrid.beatsToX (startBeat);
-        float y = noteGrid.noteToY (noteNum);
-        float w = static_cast<float> (lengthBeats * pixelsPerBeat);
-
-        auto nw = std::make_unique<NoteWidget>();
-        nw->setNoteNumber (noteNum);
-        nw->setVelocity (velocity);
-        nw->setSelected (selectedNoteIndices.count (i) > 0);
-        nw->setBounds (x, y, w, rowHeight - 1.0f);
-
-        // Wire drag callback — move note
-        int noteIndex = i;
-        nw->onDrag = [this, noteIndex] (float dx, float dy)
-        {
-            if (noteIndex >= clipState.getNumChildren())
-                return;
-
-            auto noteState = clipState.getChild (noteIndex);
-            if (noteState.getType() != IDs::NOTE)
-                return;
+namespace
+{
 
-            project.getUndoSystem().beginCoalescedTransaction ("Move Note");
-            auto& um = project.getUndoManager();
+NoteIndex::Note readNote (int id, const PropertyTree& note)
+{
+    NoteIndex::Note n;
+    n.id = id;
+    n.noteNumber = static_cast<int> (note.getProperty (IDs::noteNumber).getIntOr (60));
+    n.startBeat = note.getProperty (IDs::startBeat).getDoubleOr (0.0);
+    n.lengthBeats = note.getProperty (IDs::lengthBeats).getDoubleOr (0.25);
+    n.velocity = static_cast<int> (note.getProperty (IDs::velocity).getIntOr (100));
+    return n;
+}
 
-            double curBeat = noteState.getProperty (IDs::startBeat).getDoubleOr (0.0);
-            int curNote = static_cast<int> (noteState.getProperty (IDs::noteNumber).getIntOr (60));
+} // namespace
 
-            double newBeat = curBeat + static_cast<double> (dx) / pixelsPerBeat;
-            int newNote = curNote - static_cast<int> (dy / rowHeight);
+void PianoRollWidget::rebuildNoteIndex()
+{
+    noteIndex.clear();
+    noteIdOfChild.clear();
+    childOfNoteId.clear();
 
-            if (snapEnabled)
-                newBeat = snapBeat (newBeat);
+    if (clipState.isValid())
+    {
+        noteIdOfChild.assign (static_cast<size_t> (clipState.getNumChildren()), -1);
+        for (int i = 0; i < clipState.getNumChildren(); ++i)
+            indexNoteChild (i);
+    }
 
-            newBeat = std::max (0.0, newBeat);
-            newNote = std::clamp (newNote, 0, 127);
+    staleChildIndicesFrom = noteIdOfChild.size();
+    noteGrid.repaint();
+}
 
-            noteState.setProperty (IDs::startBeat, Variant (newBeat), &um);
-            noteState.setProperty (IDs::noteNumber, Variant (newNote), &um);
+void PianoRollWidget::indexNoteChild (int childIndex)
+{
+    auto child = clipState.getChild (childIndex);
+    if (child.getType() != IDs::NOTE)
+        return;
 
-            MidiClip clip (clipState);
-            clip.collapseChildrenToMidiData (&um);
-        };
+    auto& id = noteIdOfChild[static_cast<size_t> (childIndex)];
+    if (id < 0)
+    {
+        id = static_cast<int> (childOfNoteId.size());
+        childOfNoteId.push_back (childIndex);
+    }
 
-        // Wire resize callback — change note length
-        nw->onResize = [this, noteIndex] (float newWidth)
-        {
-            if (noteIndex >= clipState.getNumChildren())
-                return;
+    noteIndex.insert (readNote (id, child));
+}
 
-            auto noteState = clipState.getChild (noteIndex);
-            if (noteState.getType() != IDs::NOTE)
-                return;
+void PianoRollWidget::resyncNoteIndex()
+{
+    // NoteEdits write the NOTE children silently, then collapse to midiData;
+    // reindex only the notes that moved
+    if (noteIdOfChild.size() != static_cast<size_t> (clipState.getNumChildren()))
+    {
+        rebuildNoteIndex();
+        return;
+    }
 
-            project.getUndoSystem().beginCoalescedTransaction ("Resize Note");
-            auto& um = project.getUndoManager();
+    for (int i = 0; i < clipState.getNumChildren(); ++i)
+    {
+        int id = noteIdOfChild[static_cast<size_t> (i)];
+        auto child = clipState.getChild (i);
+        if (id < 0 || child.getType() != IDs::NOTE)
+            continue;
 
-            double newLengthBeats = static_cast<double> (newWidth) / pixelsPerBeat;
-            double minLength = 1.0 / (gridDivision * 4); // 1/16 beat minimum
+        auto current = readNote (id, child);
+        auto* indexed = noteIndex.find (id);
+        if (indexed == nullptr
+            || indexed->noteNumber != current.noteNumber
+            || indexed->startBeat != current.startBeat
+            || indexed->lengthBeats != current.lengthBeats
+            || indexed->velocity != current.velocity)
+            noteIndex.insert (current);
+    }
+}
 
-            if (newLengthBeats < minLength)
-                newLengthBeats = minLength;
+void PianoRollWidget::updateNoteRange()
+{
+    double clipLengthBeats = 0.0;
 
-            if (snapEnabled)
-                newLengthBeats = snapBeat (newLengthBeats);
+    if (clipState.isValid())
+    {
+        double sr = project.getSampleRate();
+        double tempo = project.getTempo();
+        int64_t clipLength = clipState.getProperty (IDs::length).getIntOr (0);
+        clipLengthBeats = (sr > 0.0 && tempo > 0.0)
+            ? (static_cast<double> (clipLength) / sr) * tempo / 60.0
+            : 1e12;
+    }
 
-            noteState.setProperty (IDs::lengthBeats, Variant (newLengthBeats), &um);
+    noteGrid.setNoteRange (trimOffsetBeats, clipLengthBeats);
+}
 
-            MidiClip clip (clipState);
-            clip.collapseChildrenToMidiData (&um);
-        };
+int PianoRollWidget::childIndexOfNote (int noteId) const
+{
+    if (noteId < 0 || noteId >= static_cast<int> (childOfNoteId.size()))
+        return -1;
 
-        // Wire click callback — selection
-        nw->onClicked = [this, noteIndex] (bool shiftHeld)
-        {
-            selectNote (noteIndex, shiftHeld);
-        };
+    // Inserts and removals only lower the stale mark; the shifted children
+    // are renumbered together on the next lookup that lands past it
+    int childIndex = childOfNoteId[static_cast<size_t> (noteId)];
+    if (childIndex >= 0 && static_cast<size_t> (childIndex) >= staleChildIndicesFrom)
+    {
+        for (size_t i = staleChildIndicesFrom; i < noteIdOfChild.size(); ++i)
+            if (noteIdOfChild[i] >= 0)
+                childOfNoteId[static_cast<size_t> (noteIdOfChild[i])] = static_cast<int> (i);
 
-        noteGrid.addChild (nw.get());
-        noteWidgets.push_back (std::move (nw));
+        staleChildIndicesFrom = noteIdOfChild.size();
+        childIndex = childOfNoteId[static_cast<size_t> (noteId)];
     }
+
+    return childIndex;
 }
 
 double PianoRollWidget::snapBeat (double beat) const
@@ -446,27 +520,14 @@ void PianoRollWidget::selectNote (int index, bool addToSelection)
             selectedNoteIndices.insert (index);
     }
 
-    // Update visual state
-    int noteIdx = 0;
-    for (int i = 0; i < clipState.getNumChildren(); ++i)
-    {
-        if (clipState.getChild (i).getType() != IDs::NOTE)
-            continue;
-
-        if (noteIdx < static_cast<int> (noteWidgets.size()))
-            noteWidgets[static_cast<size_t> (noteIdx)]->setSelected (
-                selectedNoteIndices.count (i) > 0);
-        ++noteIdx;
-    }
-
+    noteGrid.repaint();
     repaint();
 }
 
 void PianoRollWidget::deselectAll()
 {
     selectedNoteIndices.clear();
-    for (auto& nw : noteWidgets)
-        nw->setSelected (false);
+    noteGrid.repaint();
     repaint();
 }
 
@@ -479,8 +540,7 @@ void PianoRollWidget::selectAll()
             selectedNoteIndices.insert (i);
     }
 
-    for (auto& nw : noteWidgets)
-        nw->setSelected (true);
+    noteGrid.repaint();
     repaint();
 }
 
@@ -488,32 +548,17 @@ void PianoRollWidget::selectNotesInRect (float x, float y, float w, float h)
 {
     selectedNoteIndices.clear();
 
-    int noteIdx = 0;
-    for (int i = 0; i < clipState.getNumChildren(); ++i)
-    {
-        auto child = clipState.getChild (i);
-        if (child.getType() != IDs::NOTE)
-            continue;
-
-        if (noteIdx < static_cast<int> (noteWidgets.size()))
-        {
-            auto& nw = noteWidgets[static_cast<size_t> (noteIdx)];
-            auto nb = nw->getBounds();
+    std::vector<const NoteIndex::Note*> hits;
+    noteGrid.notesInRect (gfx::Rect (x, y, w, h), hits);
 
-            // Check intersection
-            if (nb.x < x + w && nb.x + nb.width > x
-                && nb.y < y + h && nb.y + nb.height > y)
-            {
-                selectedNoteIndices.insert (i);
-                nw->setSelected (true);
-            }
-            else
-            {
-                nw->setSelected (false);
-            }
-        }
-        ++noteIdx;
+    for (auto* note : hits)
+    {
+        int childIndex = childIndexOfNote (note->id);
+        if (childIndex >= 0)
+            selectedNoteIndices.insert (childIndex);
     }
+
+    noteGrid.repaint();
     repaint();
 }
 
@@ -556,6 +601,7 @@ void PianoRollWidget::deleteSelectedNotes (char reg)
 
     ScopedTransaction txn (project.getUndoSystem(), "Delete Notes");
     auto& um = project.getUndoManager();
+    ScopedNoteEdit edit (editingNotes);
 
     // Remove in reverse order to preserve indices
     std::vector<int> sorted (selectedNoteIndices.begin(), selectedNoteIndices.end());
@@ -619,6 +665,7 @@ void PianoRollWidget::pasteNotes (char reg)
 
     ScopedTransaction txn (project.getUndoSystem(), "Paste Notes");
     auto& um = project.getUndoManager();
+    ScopedNoteEdit edit (editingNotes);
 
     // Convert display beat to stored beat (accounting for clip's trim offset)
     double cursorBeat = static_cast<double> (prBeatCol) / gridDivision + trimOffsetBeats;
@@ -644,6 +691,7 @@ void PianoRollWidget::duplicateSelectedNotes()
 
     ScopedTransaction txn (project.getUndoSystem(), "Duplicate Notes");
     auto& um = project.getUndoManager();
+    ScopedNoteEdit edit (editingNotes);
 
     // Find rightmost edge to place duplicates after
     double maxEnd = 0.0;
@@ -681,86 +729,80 @@ void PianoRollWidget::duplicateSelectedNotes()
     clip.collapseChildrenToMidiData (&um);
 }
 
-void PianoRollWidget::transposeSelected (int semitones)
+std::vector<int> PianoRollWidget::getSelectedNoteChildren() const
 {
-    if (selectedNoteIndices.empty() || ! clipState.isValid())
-        return;
-
-    ScopedTransaction txn (project.getUndoSystem(), "Transpose Notes");
-    auto& um = project.getUndoManager();
+    std::vector<int> indices;
+    indices.reserve (selectedNoteIndices.size());
 
     for (int idx : selectedNoteIndices)
-    {
-        if (idx < clipState.getNumChildren())
-        {
-            auto child = clipState.getChild (idx);
-            int noteNum = static_cast<int> (child.getProperty (IDs::noteNumber).getIntOr (60));
-            noteNum = std::clamp (noteNum + semitones, 0, 127);
-            child.setProperty (IDs::noteNumber, Variant (noteNum), &um);
-        }
-    }
+        if (idx < clipState.getNumChildren() && clipState.getChild (idx).getType() == IDs::NOTE)
+            indices.push_back (idx);
 
-    MidiClip clip (clipState);
-    clip.collapseChildrenToMidiData (&um);
+    return indices;
 }
 
-void PianoRollWidget::quantizeSelected (double strength)
+void PianoRollWidget::editSelectedNotes (const std::string& name,
+                                         const std::function<void (NoteArray&)>& edit)
 {
     if (selectedNoteIndices.empty() || ! clipState.isValid())
         return;
 
-    ScopedTransaction txn (project.getUndoSystem(), "Quantize Notes");
-    auto& um = project.getUndoManager();
+    auto indices = getSelectedNoteChildren();
+    if (indices.empty())
+        return;
 
-    double gridSize = 1.0 / static_cast<double> (gridDivision);
+    MidiClip clip (clipState);
+    auto notes = clip.getNotes (indices);
+    edit (notes);
 
-    for (int idx : selectedNoteIndices)
+    ScopedTransaction txn (project.getUndoSystem(), name);
+
+    // The NOTE children are written silently, so reindex just those
     {
-        if (idx < clipState.getNumChildren())
-        {
-            auto child = clipState.getChild (idx);
-            double startBeat = child.getProperty (IDs::startBeat).getDoubleOr (0.0);
-            double quantized = std::round (startBeat / gridSize) * gridSize;
-            double newBeat = startBeat + (quantized - startBeat) * strength;
-            child.setProperty (IDs::startBeat, Variant (newBeat), &um);
-        }
+        ScopedNoteEdit noteEdit (editingNotes);
+        clip.applyNoteEdits (indices, notes, &project.getUndoManager());
     }
 
-    MidiClip clip (clipState);
-    clip.collapseChildrenToMidiData (&um);
+    for (int idx : indices)
+        indexNoteChild (idx);
 }
 
-void PianoRollWidget::humanizeSelected (double timingRange, double velocityRange)
+void PianoRollWidget::transposeSelected (int semitones)
 {
-    if (selectedNoteIndices.empty() || ! clipState.isValid())
-        return;
+    editSelectedNotes ("Transpose Notes",
+        [semitones] (NoteArray& notes) { transposeNotes (notes, semitones); });
+}
 
-    ScopedTransaction txn (project.getUndoSystem(), "Humanize Notes");
-    auto& um = project.getUndoManager();
+void PianoRollWidget::quantizeSelected (double strength, double swing)
+{
+    QuantizeSettings settings;
+    settings.gridBeats = 1.0 / static_cast<double> (gridDivision);
+    settings.strength = strength;
+    settings.swing = swing;
 
-    std::random_device rd;
-    std::mt19937 gen (rd());
-    std::uniform_real_distribution<double> timeDist (-timingRange, timingRange);
-    std::uniform_real_distribution<double> velDist (-velocityRange, velocityRange);
+    editSelectedNotes ("Quantize Notes",
+        [&settings] (NoteArray& notes) { quantizeNotes (notes, settings); });
+}
 
-    for (int idx : selectedNoteIndices)
-    {
-        if (idx < clipState.getNumChildren())
-        {
-            auto child = clipState.getChild (idx);
+void PianoRollWidget::humanizeSelected (double timingRange, double velocityRange)
+{
+    std::random_device rd;
+    uint64_t seed = (static_cast<uint64_t> (rd()) << 32) | rd();
 
-            double startBeat = child.getProperty (IDs::startBeat).getDoubleOr (0.0);
-            startBeat = std::max (0.0, startBeat + timeDist (gen));
-            child.setProperty (IDs::startBeat, Variant (startBeat), &um);
+    editSelectedNotes ("Humanize Notes",
+        [=] (NoteArray& notes) { humanizeNotes (notes, timingRange, velocityRange, seed); });
+}
 
-            int vel = static_cast<int> (child.getProperty (IDs::velocity).getIntOr (100));
-            vel = std::clamp (vel + static_cast<int> (velDist (gen)), 1, 127);
-            child.setProperty (IDs::velocity, Variant (vel), &um);
-        }
-    }
+void PianoRollWidget::scaleVelocitySelected (double factor)
+{
+    editSelectedNotes ("Scale Velocity",
+        [factor] (NoteArray& notes) { scaleNoteVelocities (notes, factor); });
+}
 
-    MidiClip clip (clipState);
-    clip.collapseChildrenToMidiData (&um);
+void PianoRollWidget::legatoSelected()
+{
+    editSelectedNotes ("Legato",
+        [] (NoteArray& notes) { legatoNotes (notes); });
 }
 
 // ── Zoom ─────────────────────────────────────────────────────────────────────
@@ -879,14 +921,28 @@ void PianoRollWidget::animationTick (double)
         double relativeSeconds = relativeSamples / sr;
         double relativeBeat = relativeSeconds * tempo / 60.0;
 
-        playheadBeat = relativeBeat;
+        if (relativeBeat != playheadBeat)
+        {
+            playheadBeat = relativeBeat;
+            repaint();
+        }
+    }
+
+    bool looping = transportController.isLooping();
+    int64_t loopStart = transportController.getLoopStartInSamples();
+    int64_t loopEnd = transportController.getLoopEndInSamples();
+
+    if (looping != lastLooping || loopStart != lastLoopStart || loopEnd != lastLoopEnd)
+    {
+        lastLooping = looping;
+        lastLoopStart = loopStart;
+        lastLoopEnd = loopEnd;
+        repaint();
     }
 
     // Sync keyboard scroll with scrollView
     keyboard.setScrollOffset (scrollView.getScrollOffsetY());
     ruler.setScrollOffset (scrollView.getScrollOffsetX());
-
-    repaint();
 }
 
 void PianoRollWidget::ensureCursorVisible()
@@ -900,19 +956,84 @@ void PianoRollWidget::ensureCursorVisible()
 
 // ── PropertyTree::Listener ───────────────────────────────────────────────────
 
-void PianoRollWidget::propertyChanged (PropertyTree&, PropertyId)
+void PianoRollWidget::propertyChanged (PropertyTree& tree, PropertyId property)
 {
-    rebuildNotes();
+    if (tree == clipState)
+    {
+        // midiData is rewritten after every note edit. Our own have been
+        // indexed already; others (undo, redo, the vim engine, the lanes)
+        // may have written the NOTE children silently
+        if (property == midiDataId && ! editingNotes)
+            resyncNoteIndex();
+
+        updateNoteRange();
+    }
+    else if (tree.getType() == IDs::NOTE && tree.getParent() == clipState)
+    {
+        int childIndex = clipState.indexOf (tree);
+        if (childIndex >= 0 && childIndex < static_cast<int> (noteIdOfChild.size()))
+            indexNoteChild (childIndex);
+    }
+
+    noteGrid.repaint();
 }
 
-void PianoRollWidget::childAdded (PropertyTree&, PropertyTree&)
+void PianoRollWidget::childAdded (PropertyTree& parent, PropertyTree& child)
 {
-    rebuildNotes();
+    if (parent != clipState)
+        return;
+
+    int childIndex = clipState.indexOf (child);
+    if (childIndex < 0 || childIndex > static_cast<int> (noteIdOfChild.size()))
+    {
+        rebuildNoteIndex();
+        return;
+    }
+
+    // Children from here on shift up one
+    staleChildIndicesFrom = std::min (staleChildIndicesFrom, static_cast<size_t> (childIndex));
+
+    std::set<int> shifted;
+    for (int idx : selectedNoteIndices)
+        shifted.insert (idx >= childIndex ? idx + 1 : idx);
+    selectedNoteIndices.swap (shifted);
+
+    noteIdOfChild.insert (noteIdOfChild.begin() + childIndex, -1);
+    indexNoteChild (childIndex);
+
+    noteGrid.repaint();
 }
 
-void PianoRollWidget::childRemoved (PropertyTree&, PropertyTree&, int)
+void PianoRollWidget::childRemoved (PropertyTree& parent, PropertyTree&, int childIndex)
 {
-    rebuildNotes();
+    if (parent != clipState)
+        return;
+
+    if (childIndex < 0 || childIndex >= static_cast<int> (noteIdOfChild.size()))
+    {
+        rebuildNoteIndex();
+        return;
+    }
+
+    int id = noteIdOfChild[static_cast<size_t> (childIndex)];
+    if (id >= 0)
+    {
+        noteIndex.remove (id);
+        childOfNoteId[static_cast<size_t> (id)] = -1;
+    }
+
+    noteIdOfChild.erase (noteIdOfChild.begin() + childIndex);
+
+    // Children after it shift down one
+    staleChildIndicesFrom = std::min (staleChildIndicesFrom, static_cast<size_t> (childIndex));
+
+    std::set<int> shifted;
+    for (int idx : selectedNoteIndices)
+        if (idx != childIndex)
+            shifted.insert (idx > childIndex ? idx - 1 : idx);
+    selectedNoteIndices.swap (shifted);
+
+    noteGrid.repaint();
 }
 
 } // namespace ui
@@ -7,13 +7,15 @@
 #include "PianoRollRulerWidget.h"
 #include "VelocityLaneWidget.h"
 #include "CCLaneWidget.h"
-#include "NoteWidget.h"
 #include "model/Project.h"
 #include "model/MidiClip.h"
 #include "engine/TransportController.h"
+#include "dc/midi/NoteIndex.h"
 #include <vector>
 #include <set>
 #include <memory>
+#include <functional>
+#include <string>
 
 namespace dc
 {
@@ -64,8 +66,10 @@ public:
     void pasteNotes (char reg = '\0');
     void duplicateSelectedNotes();
     void transposeSelected (int semitones);
-    void quantizeSelected (double strength = 1.0);
+    void quantizeSelected (double strength = 1.0, double swing = 0.0);
     void humanizeSelected (double timingRange = 0.1, double velocityRange = 10.0);
+    void scaleVelocitySelected (double factor);
+    void legatoSelected();
 
     // Zoom
     void zoomHorizontal (float factor);
@@ -97,9 +101,19 @@ public:
     bool isCCLaneVisible() const { return ccLaneVisible; }
 
 private:
-    void rebuildNotes();
     void ensureCursorVisible();
 
+    // Note index upkeep: rebuilt on loadClip, then patched per edit
+    void rebuildNoteIndex();
+    void indexNoteChild (int childIndex);
+    void resyncNoteIndex();
+    void updateNoteRange();
+    int childIndexOfNote (int noteId) const;
+
+    // Run a NoteEdits kernel over the selected notes as one undo step
+    std::vector<int> getSelectedNoteChildren() const;
+    void editSelectedNotes (const std::string& name, const std::function<void (NoteArray&)>& edit);
+
     Project& project;
     TransportController& transportController;
 
@@ -110,7 +124,14 @@ private:
     NoteGridWidget noteGrid;
     VelocityLaneWidget velocityLane;
     CCLaneWidget ccLane;
-    std::vector<std::unique_ptr<NoteWidget>> noteWidgets;
+
+    // The clip's NOTE children by pitch and time, in stored beats. Index
+    // ids stay put while child indices shift under inserts and removals.
+    NoteIndex noteIndex;
+    std::vector<int> noteIdOfChild;     // -1 for children that aren't notes
+    mutable std::vector<int> childOfNoteId;     // -1 once removed
+    mutable size_t staleChildIndicesFrom = 0;   // entries at or past this child may be stale
+    bool editingNotes = false;                  // inside one of our own note edits
 
     // Tools
     Tool currentTool = Select;
@@ -133,6 +154,11 @@ private:
     // Playhead
     double playheadBeat = -1.0;
 
+    // Cycle overlay last painted (repaint only when it changes)
+    bool lastLooping = false;
+    int64_t lastLoopStart = -1;
+    int64_t lastLoopEnd = -1;
+
     // Vim cursor
     int prBeatCol = 0;
     int prNoteRow = 60;
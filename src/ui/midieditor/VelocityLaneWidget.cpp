@@ -49,7 +49,7 @@ void VelocityLaneWidget::paint (gfx::Canvas& canvas)
             continue;
         }
 
-        // Color based on velocity (matches NoteWidget)
+        // Color based on velocity (matches NoteGridWidget)
         uint8_t r = static_cast<uint8_t> (74 + velNorm * 100);
         uint8_t g = static_cast<uint8_t> (158 - velNorm * 50);
         uint8_t b = 255;
@@ -22,7 +22,7 @@ public:
 
     void setClipState (const PropertyTree& state) { clipState = state; repaint(); }
     void setPixelsPerBeat (float ppb) { pixelsPerBeat = ppb; repaint(); }
-    void setScrollOffset (float offset) { scrollOffset = offset; repaint(); }
+    void setScrollOffset (float offset) { if (offset != scrollOffset) { scrollOffset = offset; repaint(); } }
     void setSelectedNotes (const std::set<int>* sel) { selectedNotes = sel; repaint(); }
 
 private:
@@ -112,7 +112,7 @@ void MeterWidget::animationTick (double timestampMs)
         peakHoldRight *= 0.95f;
     }
 
-    repaint();
+    repaintIfChanged();
 }
 
 void MeterWidget::setLevel (float leftDb, float rightDb)
@@ -157,7 +157,30 @@ void MeterWidget::setLevel (float leftDb, float rightDb)
         peakHoldRight *= 0.95f;
     }
 
-    repaint();
+    repaintIfChanged();
+}
+
+void MeterWidget::repaintIfChanged()
+{
+    // Settle below what paint() draws so decay ends instead of repainting
+    // every frame, then only repaint for a change of half a pixel or more
+    for (auto* v : { &displayLeft, &displayRight })
+        if (*v < 0.001f) *v = 0.0f;
+    for (auto* v : { &peakHoldLeft, &peakHoldRight })
+        if (*v <= 0.01f) *v = 0.0f;
+
+    float h = std::max (1.0f, getHeight());
+    auto moved = [h] (float a, float b) { return std::abs (a - b) * h >= 0.5f || ((a > 0.0f) != (b > 0.0f)); };
+
+    if (moved (displayLeft, paintedLeft) || moved (displayRight, paintedRight)
+        || moved (peakHoldLeft, paintedPeakLeft) || moved (peakHoldRight, paintedPeakRight))
+    {
+        paintedLeft = displayLeft;
+        paintedRight = displayRight;
+        paintedPeakLeft = peakHoldLeft;
+        paintedPeakRight = peakHoldRight;
+        repaint();
+    }
 }
 
 void MeterWidget::setPeakHold (float lp, float rp)
@@ -21,6 +21,8 @@ public:
     void setPeakHold (float leftPeak, float rightPeak);
 
 private:
+    void repaintIfChanged();
+
     float leftLevel = -60.0f;
     float rightLevel = -60.0f;
     float leftPeak = -60.0f;
@@ -33,6 +35,12 @@ private:
     float peakHoldRight = 0.0f;
     double peakHoldTimerLeft = 0.0;
     double peakHoldTimerRight = 0.0;
+
+    // Display values at the last repaint
+    float paintedLeft = 0.0f;
+    float paintedRight = 0.0f;
+    float paintedPeakLeft = 0.0f;
+    float paintedPeakRight = 0.0f;
 };
 
 } // namespace ui
@@ -1,5 +1,6 @@
 #include "CommandPaletteWidget.h"
 #include "graphics/rendering/Canvas.h"
+#include "graphics/rendering/TextBlobCache.h"
 #include "graphics/theme/Theme.h"
 #include "graphics/theme/FontManager.h"
 #include "include/core/SkFont.h"
@@ -104,9 +105,8 @@ void CommandPaletteWidget::paint (gfx::Canvas& canvas)
 
     // Blinking cursor (always visible when palette is showing)
     {
-        SkScalar textWidth = 0.0f;
-        if (! searchBuffer.empty())
-            textWidth = font.measureText (searchBuffer.data(), searchBuffer.size(), SkTextEncoding::kUTF8);
+        // Measured when the text was drawn above
+        float textWidth = gfx::TextBlobCache::getInstance().get (searchBuffer, font).advance;
 
         float cursorX = searchTextX + textWidth;
         canvas.drawLine (cursorX, paletteY + 10.0f, cursorX, paletteY + searchFieldHeight - 10.0f,
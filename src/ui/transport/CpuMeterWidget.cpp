@@ -3,6 +3,7 @@
 #include "graphics/theme/Theme.h"
 #include "graphics/theme/FontManager.h"
 #include <algorithm>
+#include <cmath>
 #include <cstdio>
 
 namespace dc
@@ -37,7 +38,21 @@ void CpuMeterWidget::animationTick (double timestampMs)
         peakHold *= 0.95f;
     }
 
-    repaint();
+    // Settle below what paint() draws so decay ends instead of repainting
+    // forever, then only repaint for a visible change
+    if (smoothedLoad <= 0.0001f) smoothedLoad = 0.0f;
+    if (peakHold <= 0.005f) peakHold = 0.0f;
+
+    float barW = std::max (1.0f, getWidth() - 62.0f);
+    if (std::abs (smoothedLoad - paintedLoad) * barW >= 0.5f
+        || std::abs (peakHold - paintedPeak) * barW >= 0.5f
+        || static_cast<int> (smoothedLoad * 100.0f + 0.5f) != static_cast<int> (paintedLoad * 100.0f + 0.5f)
+        || (smoothedLoad > 0.0f) != (paintedLoad > 0.0f))
+    {
+        paintedLoad = smoothedLoad;
+        paintedPeak = peakHold;
+        repaint();
+    }
 }
 
 void CpuMeterWidget::paint (gfx::Canvas& canvas)
@@ -23,6 +23,10 @@ private:
     float smoothedLoad = 0.0f;
     float peakHold = 0.0f;
     double peakHoldTimer = 0.0;
+
+    // Values at the last repaint
+    float paintedLoad = 0.0f;
+    float paintedPeak = 0.0f;
 };
 
 } // namespace ui
@@ -48,8 +48,11 @@ TransportBarWidget::TransportBarWidget (TransportController& transport, TempoMap
     addChild (&importButton);
     addChild (&audioSettingsButton);
     addChild (&pluginsButton);
+    addChild (&importProgress);
     addChild (&cpuMeter);
 
+    importProgress.setVisible (false);
+
     auto badge = getBranchBadge();
     if (! badge.empty())
     {
@@ -136,6 +139,13 @@ void TransportBarWidget::resized()
     rightX -= cpuMeterWidth;
     cpuMeter.setBounds (rightX + margin, margin, cpuMeterWidth - 2.0f * margin, bh);
 
+    if (importProgress.isVisible())
+    {
+        float progressWidth = 220.0f;
+        rightX -= progressWidth;
+        importProgress.setBounds (rightX + margin, margin * 2.0f, progressWidth - 2.0f * margin, bh - 2.0f * margin);
+    }
+
     // Branch badge (if on a feature branch) and time display fill the middle
     float timeX = buttonWidth * 2.0f + tempoWidth;
     if (branchLabel.getParent() != nullptr)
@@ -149,6 +159,27 @@ void TransportBarWidget::resized()
     timeDisplay.setBounds (timeX, 0, timeW, h);
 }
 
+void TransportBarWidget::setImportProgress (double fraction, const std::string& status)
+{
+    importProgress.setProgress (fraction);
+    importProgress.setStatusText (status);
+
+    if (! importProgress.isVisible())
+    {
+        importProgress.setVisible (true);
+        resized();
+    }
+}
+
+void TransportBarWidget::clearImportProgress()
+{
+    if (importProgress.isVisible())
+    {
+        importProgress.setVisible (false);
+        resized();
+    }
+}
+
 void TransportBarWidget::animationTick (double /*timestampMs*/)
 {
     auto pos = tempoMap.samplesToBarBeat (transportController.getPositionInSamples(),
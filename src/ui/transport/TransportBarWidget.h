@@ -4,6 +4,7 @@
 #include "graphics/core/Event.h"
 #include "graphics/widgets/ButtonWidget.h"
 #include "graphics/widgets/LabelWidget.h"
+#include "graphics/widgets/ProgressBarWidget.h"
 #include "ui/transport/CpuMeterWidget.h"
 #include "engine/TransportController.h"
 #include "model/TempoMap.h"
@@ -35,6 +36,11 @@ public:
 
     CpuMeterWidget& getCpuMeter() { return cpuMeter; }
 
+    /// Show background import progress next to the CPU meter; hidden
+    /// again by clearImportProgress()
+    void setImportProgress (double fraction, const std::string& status);
+    void clearImportProgress();
+
 private:
     void updateTempoDisplay();
     void commitTempoEdit();
@@ -57,6 +63,7 @@ private:
     gfx::ButtonWidget audioSettingsButton;
     gfx::ButtonWidget pluginsButton;
     gfx::LabelWidget branchLabel;
+    gfx::ProgressBarWidget importProgress;
     CpuMeterWidget cpuMeter;
 };
 
@@ -285,7 +285,21 @@ void VimStatusBarWidget::paint (gfx::Canvas& canvas)
 
 void VimStatusBarWidget::animationTick (double /*timestampMs*/)
 {
-    repaint();
+    // Only the playhead time and the selected track's instrument change
+    // without a VimEngine notification; leave idle frames undamaged
+    auto timeStr = transport.getTimeString();
+
+    std::string instrument;
+    int tIdx = arrangement.getSelectedTrackIndex();
+    if (tIdx >= 0 && tIdx < static_cast<int> (trackInstrumentLabels.size()))
+        instrument = trackInstrumentLabels[static_cast<size_t> (tIdx)];
+
+    if (timeStr != lastTimeString || instrument != lastInstrumentLabel)
+    {
+        lastTimeString = std::move (timeStr);
+        lastInstrumentLabel = std::move (instrument);
+        repaint();
+    }
 }
 
 void VimStatusBarWidget::vimModeChanged (VimEngine::Mode)
@@ -40,6 +40,9 @@ private:
     TransportController& transport;
     const GridSystem& gridSystem;
     const std::vector<std::string>& trackInstrumentLabels;
+
+    std::string lastTimeString;
+    std::string lastInstrumentLabel;
 };
 
 } // namespace ui
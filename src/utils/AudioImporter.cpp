@@ -0,0 +1,294 @@
+#include "AudioImporter.h"
+#include "dc/audio/AudioFileReader.h"
+#include "dc/audio/AudioFileWriter.h"
+#include "dc/audio/Resampler.h"
+#include "dc/foundation/file_utils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace dc
+{
+
+namespace
+{
+
+/** Decode a whole file to 32-bit float WAV at its own rate. */
+bool decodeToWav (AudioFileReader& reader, const std::filesystem::path& dst,
+                  std::atomic<float>& progress, const std::atomic<bool>& cancel)
+{
+    int numChannels = reader.getNumChannels();
+    int64_t length = reader.getLengthInSamples();
+
+    auto writer = AudioFileWriter::create (dst, AudioFileWriter::Format::WAV_32F,
+                                           numChannels, reader.getSampleRate());
+    if (writer == nullptr)
+        return false;
+
+    constexpr int64_t chunkFrames = 65536;
+    std::vector<float> buffer (static_cast<size_t> (chunkFrames * numChannels));
+
+    bool ok = true;
+    for (int64_t pos = 0; pos < length && ok; )
+    {
+        if (cancel.load (std::memory_order_relaxed))
+            ok = false;
+        else
+        {
+            auto got = reader.read (buffer.data(), pos, std::min (chunkFrames, length - pos));
+            ok = got > 0 && writer->write (buffer.data(), got);
+            pos += std::max<int64_t> (got, 0);
+            progress.store (static_cast<float> (pos) / static_cast<float> (length), std::memory_order_relaxed);
+        }
+    }
+
+    writer->close();
+
+    if (! ok)
+    {
+        std::error_code ec;
+        std::filesystem::remove (dst, ec);
+    }
+
+    return ok;
+}
+
+/** dir/name, or dir/stem_<id>.ext if that is taken. */
+std::filesystem::path uniquePath (const std::filesystem::path& dir, const std::string& stem,
+                                  const std::string& ext, uint64_t id)
+{
+    auto path = dir / (stem + ext);
+    if (std::filesystem::exists (path))
+        path = dir / (stem + "_" + std::to_string (id) + ext);
+    return path;
+}
+
+// Share of a file's progress each stage accounts for
+constexpr float convertShare = 0.6f;
+constexpr float poolShare = 0.2f;
+
+} // namespace
+
+AudioImporter::AudioImporter (AudioPool& p, dc::MessageQueue& mq, int numThreads)
+    : pool (p), messageQueue (mq)
+{
+    if (numThreads <= 0)
+        numThreads = std::clamp (static_cast<int> (std::thread::hardware_concurrency()) - 1, 1, 8);
+
+    for (int i = 0; i < numThreads; ++i)
+        threads.emplace_back ([this] { workerLoop(); });
+}
+
+AudioImporter::~AudioImporter()
+{
+    cancelAll();
+
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+
+    for (auto& t : threads)
+        if (t.joinable())
+            t.join();
+}
+
+std::filesystem::path AudioImporter::getDefaultWorkDirectory()
+{
+    return dc::getUserAppDataDirectory() / "imports";
+}
+
+uint64_t AudioImporter::import (const std::filesystem::path& file, const Options& options, Callback onFinished)
+{
+    auto job = std::make_shared<Job>();
+    job->file = file;
+    job->options = options;
+    job->onFinished = std::move (onFinished);
+
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+
+        // A new batch starts once the previous one is fully done
+        if (batchFinished >= batchTotal)
+            batchTotal = batchFinished = 0;
+
+        job->id = nextId++;
+        ++batchTotal;
+        queue.push_back (job);
+    }
+
+    cv.notify_one();
+    return job->id;
+}
+
+void AudioImporter::cancelAll()
+{
+    std::lock_guard<std::mutex> lock (mutex);
+
+    for (auto& job : queue)
+        job->cancel.store (true);
+    for (auto& job : active)
+        job->cancel.store (true);
+}
+
+AudioImporter::Progress AudioImporter::getProgress() const
+{
+    std::lock_guard<std::mutex> lock (mutex);
+
+    Progress p;
+    p.total = batchTotal;
+    p.finished = batchFinished;
+
+    double done = batchFinished;
+    for (auto& job : active)
+        done += std::max (job->progress.load (std::memory_order_relaxed),
+                          convertShare * job->convertProgress.load (std::memory_order_relaxed));
+
+    if (batchTotal > 0)
+        p.fraction = std::clamp (done / batchTotal, 0.0, 1.0);
+
+    if (! active.empty())
+        p.currentFile = active.front()->file.filename().string();
+
+    return p;
+}
+
+void AudioImporter::workerLoop()
+{
+    for (;;)
+    {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock (mutex);
+            cv.wait (lock, [this] { return stopping || ! queue.empty(); });
+
+            if (queue.empty())
+                return;
+
+            job = queue.front();
+            queue.pop_front();
+            active.push_back (job);
+        }
+
+        auto result = process (*job);
+
+        {
+            std::lock_guard<std::mutex> lock (mutex);
+            active.erase (std::find (active.begin(), active.end(), job));
+            ++batchFinished;
+        }
+
+        if (job->onFinished)
+        {
+            messageQueue.post ([callback = std::move (job->onFinished), result = std::move (result)]
+            {
+                callback (result);
+            });
+        }
+    }
+}
+
+AudioImporter::Result AudioImporter::process (Job& job)
+{
+    Result result;
+    result.id = job.id;
+    result.source = job.file;
+
+    auto fail = [&] (const std::string& why)
+    {
+        result.ok = false;
+        result.error = why;
+        return result;
+    };
+
+    if (job.cancel.load())
+        return fail ("Cancelled");
+
+    // Probe
+    auto reader = AudioFileReader::open (job.file);
+    if (reader == nullptr)
+        return fail ("Not a readable audio file");
+
+    double fileRate = reader->getSampleRate();
+    double targetRate = job.options.targetSampleRate;
+    bool resample = targetRate > 0.0 && std::abs (targetRate - fileRate) > 1e-6;
+    bool decode = ! resample && job.options.decodeCompressed && reader->isCompressed();
+
+    // Convert
+    auto playable = job.file;
+    bool byProduct = false;
+
+    if (resample || decode)
+    {
+        auto dir = job.options.workDirectory.empty() ? getDefaultWorkDirectory()
+                                                     : job.options.workDirectory;
+        std::error_code ec;
+        std::filesystem::create_directories (dir, ec);
+
+        auto stem = job.file.stem().string();
+        if (resample)
+            stem += "_" + std::to_string (static_cast<int> (targetRate));
+        auto converted = uniquePath (dir, stem, ".wav", job.id);
+
+        bool ok;
+        if (resample)
+        {
+            reader.reset();
+            ok = Resampler::convertFile (job.file, converted, targetRate, Resampler::Quality::high,
+                                         &job.convertProgress, &job.cancel);
+        }
+        else
+        {
+            ok = decodeToWav (*reader, converted, job.convertProgress, job.cancel);
+            reader.reset();
+        }
+
+        if (! ok)
+            return fail (job.cancel.load() ? "Cancelled" : "Conversion failed");
+
+        playable = converted;
+        byProduct = true;
+    }
+
+    job.progress.store (convertShare);
+
+    // Hash into the pool (copies only content the pool doesn't have)
+    if (! pool.getDirectory().empty())
+    {
+        auto hash = pool.import (playable, byProduct ? AudioPool::ImportMode::move
+                                                     : AudioPool::ImportMode::copy);
+        if (! hash.empty())
+        {
+            result.poolEntry = hash;
+            playable = pool.getFile (hash);
+        }
+    }
+
+    job.progress.store (convertShare + poolShare);
+
+    if (job.cancel.load())
+        return fail ("Cancelled");
+
+    // Peaks and final format of what will actually play
+    auto playReader = AudioFileReader::open (playable);
+    if (playReader == nullptr)
+        return fail ("Imported file could not be reopened");
+
+    result.file = playable;
+    result.sampleRate = playReader->getSampleRate();
+    result.numChannels = playReader->getNumChannels();
+    result.lengthInSamples = playReader->getLengthInSamples();
+    playReader.reset();
+
+    if (job.options.scanPeaks)
+    {
+        result.peaks = std::make_shared<gfx::WaveformCache>();
+        result.peaks->loadFromFile (playable);
+    }
+
+    job.progress.store (1.0f);
+    result.ok = true;
+    return result;
+}
+
+} // namespace dc
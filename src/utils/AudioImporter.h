@@ -0,0 +1,120 @@
+#pragma once
+#include "dc/foundation/message_queue.h"
+#include "graphics/rendering/WaveformCache.h"
+#include "model/AudioPool.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dc
+{
+
+/** Imports audio files on a pool of worker threads.
+
+    Each file is probed, optionally converted (to the session rate, or from
+    a compressed format to float WAV), added to the session's AudioPool and
+    scanned for waveform peaks. Several files are in flight at once, so
+    dropping in a folder of stems costs roughly the slowest file rather than
+    the sum of all of them.
+
+    Results are delivered on the message thread through the MessageQueue,
+    one callback per file, in completion order. */
+class AudioImporter
+{
+public:
+    struct Options
+    {
+        double targetSampleRate = 0.0;          // 0 = keep the file's rate
+        bool decodeCompressed = false;          // FLAC/Ogg/MP3 -> float WAV
+        std::filesystem::path workDirectory;    // converted copies; empty = getDefaultWorkDirectory()
+        bool scanPeaks = true;                  // false when only pooling, e.g. adopting on save
+    };
+
+    struct Result
+    {
+        uint64_t id = 0;
+        std::filesystem::path source;
+        bool ok = false;
+        std::string error;
+
+        std::filesystem::path file;     // what clips should play
+        std::string poolEntry;          // empty when the session has no pool yet
+        double sampleRate = 0.0;        // of file
+        int numChannels = 0;
+        int64_t lengthInSamples = 0;    // of file, at sampleRate
+        std::shared_ptr<gfx::WaveformCache> peaks;   // null unless Options::scanPeaks
+    };
+
+    using Callback = std::function<void (const Result&)>;
+
+    /** Where converted copies go when the session has no directory of its
+        own yet: a folder in the user's app data, never beside the source. */
+    static std::filesystem::path getDefaultWorkDirectory();
+
+    /** numThreads = 0 picks one per core, leaving one for audio and UI. */
+    AudioImporter (AudioPool& pool, dc::MessageQueue& mq, int numThreads = 0);
+    ~AudioImporter();
+
+    /** Queue a file. Returns an id that the Result carries. */
+    uint64_t import (const std::filesystem::path& file, const Options& options, Callback onFinished);
+
+    /** Abort every queued and running file. Each still reports a Result,
+        with ok = false, so callers can clean up placeholders. */
+    void cancelAll();
+
+    struct Progress
+    {
+        int total = 0;                  // files in the current batch
+        int finished = 0;
+        double fraction = 0.0;          // 0..1 over the batch, including partial files
+        std::string currentFile;        // name of a file being worked on
+
+        bool isActive() const { return finished < total; }
+    };
+
+    Progress getProgress() const;
+
+    int getNumThreads() const { return static_cast<int> (threads.size()); }
+
+private:
+    struct Job
+    {
+        uint64_t id = 0;
+        std::filesystem::path file;
+        Options options;
+        Callback onFinished;
+        std::atomic<float> progress { 0.0f };           // whole file, 0..1
+        std::atomic<float> convertProgress { 0.0f };    // conversion stage, 0..1
+        std::atomic<bool> cancel { false };
+    };
+
+    void workerLoop();
+    Result process (Job& job);
+
+    AudioPool& pool;
+    dc::MessageQueue& messageQueue;
+
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::shared_ptr<Job>> queue;
+    std::vector<std::shared_ptr<Job>> active;
+    std::vector<std::thread> threads;
+    bool stopping = false;
+
+    uint64_t nextId = 1;
+    int batchTotal = 0;
+    int batchFinished = 0;
+
+    AudioImporter (const AudioImporter&) = delete;
+    AudioImporter& operator= (const AudioImporter&) = delete;
+};
+
+} // namespace dc
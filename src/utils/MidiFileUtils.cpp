@@ -0,0 +1,101 @@
+#include "MidiFileUtils.h"
+#include "model/Project.h"
+#include "model/Track.h"
+#include "model/MidiClip.h"
+#include "utils/UndoSystem.h"
+#include <algorithm>
+#include <cmath>
+
+namespace dc
+{
+
+int MidiFileUtils::importIntoProject (const MidiFile& file, Project& project,
+                                      const std::string& fallbackName)
+{
+    auto& undo = project.getUndoSystem();
+    auto* um = &undo.getUndoManager();
+    undo.beginTransaction ("Import MIDI");
+
+    if (! file.getTempoChanges().empty())
+        project.setTempo (file.getTempoChanges().front().bpm);
+
+    if (! file.getTimeSignatureChanges().empty())
+    {
+        const auto& ts = file.getTimeSignatureChanges().front();
+        project.setTimeSigNumerator (ts.numerator);
+        project.setTimeSigDenominator (ts.denominator);
+    }
+
+    const double samplesPerBeat = 60.0 / project.getTempo() * project.getSampleRate();
+    const int beatsPerBar = std::max (1, project.getTimeSigNumerator());
+    auto tracksNode = project.getState().getChildWithType (IDs::TRACKS);
+    int added = 0;
+
+    for (int i = 0; i < file.getNumTracks(); ++i)
+    {
+        const auto& smfTrack = file.getTrack (i);
+        if (smfTrack.sequence.getNumEvents() == 0)
+            continue;
+
+        auto name = smfTrack.name.empty()
+            ? fallbackName + " " + std::to_string (added + 1)
+            : smfTrack.name;
+
+        auto trackState = Project::createTrackState (name);
+        Track track (trackState);
+
+        // Round the clip up to a whole bar past the last event
+        double lastBeat = smfTrack.sequence.getEvents().back().timeInBeats;
+        double lengthBeats = (std::floor (lastBeat / beatsPerBar) + 1.0) * beatsPerBar;
+
+        auto clipState = track.addMidiClip (0, static_cast<int64_t> (lengthBeats * samplesPerBeat));
+        MidiClip (clipState).setMidiSequence (smfTrack.sequence);
+
+        tracksNode.addChild (trackState, -1, um);
+        ++added;
+    }
+
+    undo.endTransaction();
+    return added;
+}
+
+MidiFile MidiFileUtils::createFromProject (Project& project)
+{
+    MidiFile file;
+    file.addTempoChange (0.0, project.getTempo());
+    file.addTimeSignatureChange (0.0, project.getTimeSigNumerator(), project.getTimeSigDenominator());
+
+    const double beatsPerSample = project.getTempo() / 60.0 / project.getSampleRate();
+
+    for (int t = 0; t < project.getNumTracks(); ++t)
+    {
+        Track track (project.getTrack (t));
+        std::vector<TimedMidiEvent> events;
+
+        for (int c = 0; c < track.getNumClips(); ++c)
+        {
+            auto clipState = track.getClip (c);
+            if (clipState.getType() != IDs::MIDI_CLIP)
+                continue;
+
+            MidiClip clip (clipState);
+            double offset = static_cast<double> (clip.getStartPosition()) * beatsPerSample;
+
+            auto seq = clip.getMidiSequence();
+            for (const auto& evt : seq.getEvents())
+                events.push_back ({ evt.timeInBeats + offset, evt.message, -1 });
+        }
+
+        if (events.empty())
+            continue;
+
+        MidiFile::Track smfTrack;
+        smfTrack.name = track.getName();
+        smfTrack.sequence.addEvents (std::move (events));
+        file.addTrack (std::move (smfTrack));
+    }
+
+    return file;
+}
+
+} // namespace dc
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "dc/midi/MidiFile.h"
+
+#include <string>
+
+namespace dc
+{
+
+class Project;
+
+class MidiFileUtils
+{
+public:
+    // Append one MIDI track per non-empty SMF track, each holding a single
+    // clip with the whole sequence. Clips are stored as encoded midiData
+    // (no NOTE children) and every track is attached fully built, so the
+    // import is one undo step and one childAdded per track.
+    // The project has a single tempo and time signature: the first tempo
+    // and time-signature events of the file are applied, later changes are
+    // ignored. Returns the number of tracks added.
+    static int importIntoProject (const MidiFile& file, Project& project,
+                                  const std::string& fallbackName);
+
+    // Build a type 1 MIDI file with one track per project track that has
+    // MIDI clips. Clip events are offset by the clip start position.
+    static MidiFile createFromProject (Project& project);
+
+private:
+    MidiFileUtils() = delete;
+};
+
+} // namespace dc
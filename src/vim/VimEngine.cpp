@@ -462,23 +462,8 @@ void VimEngine::updateClipIndexFromGridCursor()
         return;
     }
 
-    Track track = arrangement.getTrack (trackIdx);
-    int64_t cursorPos = context.getGridCursorPosition();
-
-    for (int i = 0; i < track.getNumClips(); ++i)
-    {
-        auto clipState = track.getClip (i);
-        auto start = clipState.getProperty (IDs::startPosition).getIntOr (0);
-        auto length = clipState.getProperty (IDs::length).getIntOr (0);
-
-        if (cursorPos >= start && cursorPos < start + length)
-        {
-            context.setSelectedClipIndex (i);
-            return;
-        }
-    }
-
-    context.setSelectedClipIndex (-1);
+    auto clips = arrangement.getClipIndex (trackIdx);
+    context.setSelectedClipIndex (clips->getClipAt (context.getGridCursorPosition()));
 }
 
 // ── Track jumps ─────────────────────────────────────────────────────────────
@@ -517,17 +502,7 @@ void VimEngine::jumpToSessionEnd()
     int64_t maxEnd = 0;
 
     for (int i = 0; i < arrangement.getNumTracks(); ++i)
-    {
-        Track track = arrangement.getTrack (i);
-
-        for (int c = 0; c < track.getNumClips(); ++c)
-        {
-            auto clipState = track.getClip (c);
-            auto start = clipState.getProperty (IDs::startPosition).getIntOr (0);
-            auto length = clipState.getProperty (IDs::length).getIntOr (0);
-            maxEnd = std::max (maxEnd, start + length);
-        }
-    }
+        maxEnd = std::max (maxEnd, arrangement.getClipIndex (i)->getEndPosition());
 
     transport.setPositionInSamples (maxEnd);
     listeners.call ([](Listener& l) { l.vimContextChanged(); });
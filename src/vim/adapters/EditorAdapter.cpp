@@ -80,23 +80,8 @@ void EditorAdapter::updateClipIndexFromGridCursor()
         return;
     }
 
-    Track track = arrangement.getTrack (trackIdx);
-    int64_t cursorPos = context.getGridCursorPosition();
-
-    for (int i = 0; i < track.getNumClips(); ++i)
-    {
-        auto clipState = track.getClip (i);
-        auto start = clipState.getProperty (IDs::startPosition).getIntOr (0);
-        auto length = clipState.getProperty (IDs::length).getIntOr (0);
-
-        if (cursorPos >= start && cursorPos < start + length)
-        {
-            context.setSelectedClipIndex (i);
-            return;
-        }
-    }
-
-    context.setSelectedClipIndex (-1);
+    auto clips = arrangement.getClipIndex (trackIdx);
+    context.setSelectedClipIndex (clips->getClipAt (context.getGridCursorPosition()));
 }
 
 // ── Track jumps ─────────────────────────────────────────────────────────────
@@ -135,17 +120,7 @@ void EditorAdapter::jumpToSessionEnd()
     int64_t maxEnd = 0;
 
     for (int i = 0; i < arrangement.getNumTracks(); ++i)
-    {
-        Track track = arrangement.getTrack (i);
-
-        for (int c = 0; c < track.getNumClips(); ++c)
-        {
-            auto clipState = track.getClip (c);
-            auto start = clipState.getProperty (IDs::startPosition).getIntOr (0);
-            auto length = clipState.getProperty (IDs::length).getIntOr (0);
-            maxEnd = std::max (maxEnd, start + length);
-        }
-    }
+        maxEnd = std::max (maxEnd, arrangement.getClipIndex (i)->getEndPosition());
 
     transport.setPositionInSamples (maxEnd);
     if (onContextChanged) onContextChanged();
@@ -488,30 +463,6 @@ void EditorAdapter::openFocusedItem()
     }
 }
 
-// ── Clip edge helpers ────────────────────────────────────────────────────────
-
-// Collect all clip start/end positions on a track, sorted ascending
-static std::vector<int64_t> collectClipEdges (const Arrangement& arr, int trackIdx)
-{
-    std::vector<int64_t> edges;
-    if (trackIdx < 0 || trackIdx >= arr.getNumTracks())
-        return edges;
-
-    Track track = arr.getTrack (trackIdx);
-    for (int i = 0; i < track.getNumClips(); ++i)
-    {
-        auto clip = track.getClip (i);
-        auto start = clip.getProperty (IDs::startPosition).getIntOr (0);
-        auto length = clip.getProperty (IDs::length).getIntOr (0);
-        edges.push_back (start);
-        edges.push_back (start + length);
-    }
-
-    std::sort (edges.begin(), edges.end());
-    edges.erase (std::unique (edges.begin(), edges.end()), edges.end());
-    return edges;
-}
-
 // ── Motion resolution ───────────────────────────────────────────────────────
 
 ContextAdapter::MotionRange EditorAdapter::resolveMotion (char32_t key, int count) const
@@ -915,17 +866,8 @@ void EditorAdapter::executeMotion (char32_t key, int count)
             int trackIdx = arrangement.getSelectedTrackIndex();
             int64_t maxEnd = 0;
 
-            if (trackIdx >= 0 && trackIdx < arrangement.getNumTracks())
-            {
-                Track track = arrangement.getTrack (trackIdx);
-                for (int ci = 0; ci < track.getNumClips(); ++ci)
-                {
-                    auto clipState = track.getClip (ci);
-                    auto start = clipState.getProperty (IDs::startPosition).getIntOr (0);
-                    auto length = clipState.getProperty (IDs::length).getIntOr (0);
-                    maxEnd = std::max (maxEnd, start + length);
-                }
-            }
+            if (auto clips = arrangement.getClipIndex (trackIdx))
+                maxEnd = clips->getEndPosition();
 
             if (sr > 0.0 && maxEnd > 0)
             {
@@ -966,16 +908,13 @@ void EditorAdapter::executeMotion (char32_t key, int count)
         {
             double sr = transport.getSampleRate();
             int trackIdx = arrangement.getSelectedTrackIndex();
-            auto edges = collectClipEdges (arrangement, trackIdx);
             int64_t cursorPos = context.getGridCursorPosition();
 
-            for (int n = 0; n < count; ++n)
+            if (auto clips = arrangement.getClipIndex (trackIdx))
             {
-                auto it = std::upper_bound (edges.begin(), edges.end(), cursorPos);
-                if (it != edges.end())
-                    cursorPos = *it;
-                else
-                    break;
+                for (int n = 0; n < count; ++n)
+                    if (! clips->getNextEdge (cursorPos, cursorPos))
+                        break;
             }
 
             if (sr > 0.0)
@@ -990,19 +929,13 @@ void EditorAdapter::executeMotion (char32_t key, int count)
         {
             double sr = transport.getSampleRate();
             int trackIdx = arrangement.getSelectedTrackIndex();
-            auto edges = collectClipEdges (arrangement, trackIdx);
             int64_t cursorPos = context.getGridCursorPosition();
 
-            for (int n = 0; n < count; ++n)
+            if (auto clips = arrangement.getClipIndex (trackIdx))
             {
-                auto it = std::lower_bound (edges.begin(), edges.end(), cursorPos);
-                if (it != edges.begin())
-                {
-                    --it;
-                    cursorPos = *it;
-                }
-                else
-                    break;
+                for (int n = 0; n < count; ++n)
+                    if (! clips->getPreviousEdge (cursorPos, cursorPos))
+                        break;
             }
 
             if (sr > 0.0)
@@ -1019,26 +952,13 @@ void EditorAdapter::executeMotion (char32_t key, int count)
             int trackIdx = arrangement.getSelectedTrackIndex();
             int64_t cursorPos = context.getGridCursorPosition();
 
-            if (trackIdx >= 0 && trackIdx < arrangement.getNumTracks())
+            if (auto clips = arrangement.getClipIndex (trackIdx))
             {
-                Track track = arrangement.getTrack (trackIdx);
-
-                std::vector<int64_t> endEdges;
-                for (int ci = 0; ci < track.getNumClips(); ++ci)
-                {
-                    auto clip = track.getClip (ci);
-                    auto start = clip.getProperty (IDs::startPosition).getIntOr (0);
-                    auto length = clip.getProperty (IDs::length).getIntOr (0);
-                    endEdges.push_back (start + length);
-                }
-                std::sort (endEdges.begin(), endEdges.end());
-
                 for (int n = 0; n < count; ++n)
                 {
-                    auto it = std::upper_bound (endEdges.begin(), endEdges.end(), cursorPos);
-                    if (it != endEdges.end())
+                    int64_t endPos = 0;
+                    if (clips->getNextEnd (cursorPos, endPos))
                     {
-                        int64_t endPos = *it;
                         if (sr > 0.0)
                         {
                             int64_t snapped = gridSystem.snapFloor (endPos - 1, sr);
@@ -1148,21 +1068,14 @@ ContextAdapter::MotionRange EditorAdapter::getVisualRange() const
         int primaryTrack = range.startIndex;
         if (primaryTrack >= 0 && primaryTrack < arrangement.getNumTracks())
         {
-            Track track = arrangement.getTrack (primaryTrack);
-            int firstClip = -1, lastClip = -1;
+            std::vector<int> hits;
+            arrangement.getClipIndex (primaryTrack)->findOverlapping (minPos, maxPos, hits);
 
-            for (int i = 0; i < track.getNumClips(); ++i)
+            int firstClip = -1, lastClip = -1;
+            if (! hits.empty())
             {
-                auto clip = track.getClip (i);
-                auto start = clip.getProperty (IDs::startPosition).getIntOr (0);
-                auto length = clip.getProperty (IDs::length).getIntOr (0);
-
-                if (start < maxPos && start + length > minPos)
-                {
-                    if (firstClip < 0)
-                        firstClip = i;
-                    lastClip = i;
-                }
+                firstClip = *std::min_element (hits.begin(), hits.end());
+                lastClip = *std::max_element (hits.begin(), hits.end());
             }
 
             range.startSecondary = (firstClip >= 0) ? firstClip : 0;
@@ -0,0 +1,401 @@
+// Benchmark: DiskStreamer and ThreadedRecorder capacity
+//
+// Writes synthetic stereo files, then for a growing number of streams
+// plays them the way the audio thread does: fixed blocks pulled at the
+// block rate, with random seeks and loop jumps. Optionally records to
+// several ThreadedRecorders from the same thread at the same time.
+//
+// For each stream count it reports underruns, ring fill percentiles (in
+// seconds of audio), decoded read throughput, process CPU per stream and
+// frames the recorders dropped. Use it to size hardware and to catch
+// regressions in the streaming path.
+//
+// Usage: dc_bench_disk_streamer [options]
+//   --format wav16|wav24|wav32f|flac16|flac24   file format (wav24)
+//   --streams N        largest stream count; runs 1, 2, 4 ... N (32)
+//   --seconds S        playback time per stream count (10)
+//   --file-seconds S   length of each generated file (60)
+//   --rate R           sample rate (48000)
+//   --block B          frames per simulated audio callback (256)
+//   --speed X          pull X times faster than real time (1)
+//   --seek-every S     mean seconds between random seeks per stream (4)
+//   --recorders M      concurrent ThreadedRecorder writers (0)
+//   --io-threads T     DiskIOScheduler threads (2)
+//   --direct           read compressed files without the DecodeCache
+//   --dir PATH         where to write files (a temporary directory)
+
+#include "dc/audio/AudioFileWriter.h"
+#include "dc/audio/DecodeCache.h"
+#include "dc/audio/DiskIOScheduler.h"
+#include "dc/audio/DiskStreamer.h"
+#include "dc/audio/ThreadedRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+namespace
+{
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+constexpr int kChannels = 2;
+
+// Recorders write what a capture would: 24-bit WAV
+constexpr auto kRecordFormat = dc::AudioFileWriter::Format::WAV_24;
+constexpr double kRecordBytesPerSample = 3.0;
+
+struct Options
+{
+    std::string format = "wav24";
+    int maxStreams = 32;
+    double seconds = 10.0;
+    double fileSeconds = 60.0;
+    double sampleRate = 48000.0;
+    int blockSize = 256;
+    double speed = 1.0;
+    double seekEverySeconds = 4.0;
+    int recorders = 0;
+    int ioThreads = dc::DiskIOScheduler::defaultNumThreads;
+    bool direct = false;
+    fs::path directory;
+};
+
+bool parseFormat (const std::string& name, dc::AudioFileWriter::Format& format, std::string& extension)
+{
+    struct { const char* name; dc::AudioFileWriter::Format format; const char* extension; } formats[] = {
+        { "wav16",  dc::AudioFileWriter::Format::WAV_16,  ".wav" },
+        { "wav24",  dc::AudioFileWriter::Format::WAV_24,  ".wav" },
+        { "wav32f", dc::AudioFileWriter::Format::WAV_32F, ".wav" },
+        { "flac16", dc::AudioFileWriter::Format::FLAC_16, ".flac" },
+        { "flac24", dc::AudioFileWriter::Format::FLAC_24, ".flac" },
+    };
+
+    for (auto& f : formats)
+    {
+        if (name == f.name)
+        {
+            format = f.format;
+            extension = f.extension;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseOptions (int argc, char** argv, Options& o)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto next = [&] () -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+
+        if (arg == "--format")            o.format = next();
+        else if (arg == "--streams")      o.maxStreams = std::max (1, std::atoi (next()));
+        else if (arg == "--seconds")      o.seconds = std::atof (next());
+        else if (arg == "--file-seconds") o.fileSeconds = std::atof (next());
+        else if (arg == "--rate")         o.sampleRate = std::atof (next());
+        else if (arg == "--block")        o.blockSize = std::max (16, std::atoi (next()));
+        else if (arg == "--speed")        o.speed = std::max (0.01, std::atof (next()));
+        else if (arg == "--seek-every")   o.seekEverySeconds = std::atof (next());
+        else if (arg == "--recorders")    o.recorders = std::max (0, std::atoi (next()));
+        else if (arg == "--io-threads")   o.ioThreads = std::max (1, std::atoi (next()));
+        else if (arg == "--direct")       o.direct = true;
+        else if (arg == "--dir")          o.directory = next();
+        else
+        {
+            std::fprintf (stderr, "unknown option: %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Band-limited-ish noise: compresses about as badly as real music, so
+/// FLAC decode cost is realistic.
+bool writeSourceFile (const fs::path& file, dc::AudioFileWriter::Format format,
+                      double sampleRate, double seconds, unsigned seed)
+{
+    auto writer = dc::AudioFileWriter::create (file, format, kChannels, sampleRate);
+    if (writer == nullptr)
+        return false;
+
+    std::mt19937 rng (seed);
+    std::uniform_real_distribution<float> dist (-0.5f, 0.5f);
+
+    constexpr int chunk = 65536;
+    std::vector<float> data (static_cast<size_t> (chunk * kChannels));
+    float state[kChannels] = {};
+
+    auto total = static_cast<int64_t> (seconds * sampleRate);
+    for (int64_t done = 0; done < total; done += chunk)
+    {
+        auto n = static_cast<int> (std::min<int64_t> (chunk, total - done));
+        for (int f = 0; f < n; ++f)
+            for (int ch = 0; ch < kChannels; ++ch)
+                data[static_cast<size_t> (f * kChannels + ch)] = state[ch] = 0.7f * state[ch] + dist (rng);
+
+        if (! writer->write (data.data(), n))
+            return false;
+    }
+
+    writer->close();
+    return true;
+}
+
+double processCpuSeconds()
+{
+    return static_cast<double> (std::clock()) / CLOCKS_PER_SEC;
+}
+
+double percentile (std::vector<float>& values, double p)
+{
+    if (values.empty())
+        return 0.0;
+
+    auto index = static_cast<size_t> (p * static_cast<double> (values.size() - 1));
+    std::nth_element (values.begin(), values.begin() + static_cast<std::ptrdiff_t> (index), values.end());
+    return values[index];
+}
+
+struct StreamState
+{
+    std::unique_ptr<dc::DiskStreamer> streamer;
+    int64_t position = 0;
+    int64_t loopStart = 0;
+    int64_t loopEnd = 0;
+};
+
+struct Result
+{
+    int streams = 0;
+    uint64_t underruns = 0;
+    int64_t seeks = 0;
+    double fillP1 = 0.0, fillP50 = 0.0, fillP99 = 0.0;
+    double decodedMBPerSecond = 0.0;
+    double cpuPercentPerStream = 0.0;
+    double lateCallbacksPercent = 0.0;
+    int64_t recorderDropped = 0;
+    double recorderMBPerSecond = 0.0;
+};
+
+Result run (const Options& o, const std::vector<fs::path>& files, int numStreams)
+{
+    Result result;
+    result.streams = numStreams;
+
+    dc::DiskIOScheduler scheduler (o.ioThreads);
+    dc::DecodeCache decodeCache;
+    std::mt19937 rng (static_cast<unsigned> (numStreams));
+
+    std::vector<StreamState> streams (static_cast<size_t> (numStreams));
+    for (int i = 0; i < numStreams; ++i)
+    {
+        auto& s = streams[static_cast<size_t> (i)];
+        s.streamer = std::make_unique<dc::DiskStreamer> (dc::DiskStreamer::autoBufferSize, &scheduler);
+        s.streamer->setDecodeCache (o.direct ? nullptr : &decodeCache);
+        if (! s.streamer->open (files[static_cast<size_t> (i) % files.size()]))
+        {
+            std::fprintf (stderr, "cannot open %s\n", files[0].c_str());
+            std::exit (1);
+        }
+
+        // Each stream loops a few seconds somewhere in its file
+        int64_t length = s.streamer->getLengthInSamples();
+        std::uniform_int_distribution<int64_t> startDist (0, std::max<int64_t> (length / 2, 1));
+        s.loopStart = startDist (rng);
+        s.loopEnd = std::min (length, s.loopStart + static_cast<int64_t> (4.0 * o.sampleRate));
+        s.position = s.loopStart;
+        s.streamer->seek (s.position);
+        s.streamer->start();
+    }
+
+    // Recorders share a temporary directory next to the sources
+    std::vector<std::unique_ptr<dc::ThreadedRecorder>> recorders;
+    for (int i = 0; i < o.recorders; ++i)
+    {
+        auto recorder = std::make_unique<dc::ThreadedRecorder> (static_cast<int> (o.sampleRate));
+        auto path = o.directory / ("record_" + std::to_string (i) + ".wav");
+        if (recorder->start (path, kRecordFormat, kChannels, o.sampleRate))
+            recorders.push_back (std::move (recorder));
+    }
+
+    // Let the rings fill before measuring, as transport start would
+    std::this_thread::sleep_for (std::chrono::milliseconds (500));
+
+    std::vector<float> left (static_cast<size_t> (o.blockSize)), right (static_cast<size_t> (o.blockSize));
+    float* channels[] = { left.data(), right.data() };
+    dc::AudioBlock block (channels, kChannels, o.blockSize);
+
+    std::vector<float> recordLeft (static_cast<size_t> (o.blockSize), 0.25f);
+    std::vector<float> recordRight (static_cast<size_t> (o.blockSize), -0.25f);
+    float* recordChannels[] = { recordLeft.data(), recordRight.data() };
+    dc::AudioBlock recordBlock (recordChannels, kChannels, o.blockSize);
+
+    for (auto& s : streams)
+        s.streamer->resetUnderrunCount();
+
+    auto period = std::chrono::duration<double> (o.blockSize / o.sampleRate / o.speed);
+    auto totalBlocks = static_cast<int64_t> (o.seconds * o.sampleRate / o.blockSize);
+    double seekProbability = o.seekEverySeconds > 0.0
+        ? o.blockSize / (o.seekEverySeconds * o.sampleRate) : 0.0;
+    std::uniform_real_distribution<double> chance (0.0, 1.0);
+
+    std::vector<float> fill;
+    fill.reserve (static_cast<size_t> (totalBlocks / 8 + 1) * streams.size());
+
+    auto samplesBefore = scheduler.getStats().samplesRead;
+    double cpuBefore = processCpuSeconds();
+    auto start = Clock::now();
+    auto deadline = start;
+    int64_t late = 0;
+
+    for (int64_t b = 0; b < totalBlocks; ++b)
+    {
+        for (auto& s : streams)
+        {
+            s.streamer->read (block, o.blockSize);
+            s.position += o.blockSize;
+
+            if (s.position >= s.loopEnd)
+            {
+                s.position = s.loopStart;
+                s.streamer->seek (s.position);
+                ++result.seeks;
+            }
+            else if (chance (rng) < seekProbability)
+            {
+                std::uniform_int_distribution<int64_t> to (0, s.streamer->getLengthInSamples() - o.blockSize);
+                s.position = to (rng);
+                s.streamer->seek (s.position);
+                ++result.seeks;
+            }
+
+            if (b % 8 == 0)
+                fill.push_back (static_cast<float> (s.streamer->getBufferedFrames() / o.sampleRate));
+        }
+
+        for (auto& r : recorders)
+            r->write (recordBlock, o.blockSize);
+
+        deadline += std::chrono::duration_cast<Clock::duration> (period);
+        if (Clock::now() > deadline)
+            ++late;
+        else
+            std::this_thread::sleep_until (deadline);
+    }
+
+    auto elapsed = std::chrono::duration<double> (Clock::now() - start).count();
+    double cpu = processCpuSeconds() - cpuBefore;
+    auto samplesRead = scheduler.getStats().samplesRead - samplesBefore;
+
+    for (auto& s : streams)
+    {
+        result.underruns += s.streamer->getUnderrunCount();
+        s.streamer->stop();
+    }
+
+    for (auto& r : recorders)
+    {
+        r->stop();
+        result.recorderDropped += totalBlocks * o.blockSize - r->getRecordedSampleCount();
+    }
+
+    result.fillP1 = percentile (fill, 0.01);
+    result.fillP50 = percentile (fill, 0.50);
+    result.fillP99 = percentile (fill, 0.99);
+    result.decodedMBPerSecond = static_cast<double> (samplesRead) * sizeof (float) / elapsed / 1.0e6;
+    result.cpuPercentPerStream = 100.0 * cpu / elapsed / numStreams;
+    result.lateCallbacksPercent = 100.0 * static_cast<double> (late) / static_cast<double> (totalBlocks);
+    if (! recorders.empty())
+        result.recorderMBPerSecond = static_cast<double> (recorders.size() * static_cast<size_t> (totalBlocks)
+                                                          * static_cast<size_t> (o.blockSize) * kChannels)
+                                     * kRecordBytesPerSample / elapsed / 1.0e6;
+
+    for (int i = 0; i < o.recorders; ++i)
+    {
+        std::error_code ec;
+        fs::remove (o.directory / ("record_" + std::to_string (i) + ".wav"), ec);
+    }
+
+    return result;
+}
+
+} // anonymous namespace
+
+int main (int argc, char** argv)
+{
+    Options o;
+    if (! parseOptions (argc, argv, o))
+        return 1;
+
+    dc::AudioFileWriter::Format format;
+    std::string extension;
+    if (! parseFormat (o.format, format, extension))
+    {
+        std::fprintf (stderr, "unknown format: %s\n", o.format.c_str());
+        return 1;
+    }
+
+    bool ownDirectory = o.directory.empty();
+    if (ownDirectory)
+        o.directory = fs::temp_directory_path() / ("dc_bench_disk_streamer_" + std::to_string (::getpid()));
+    fs::create_directories (o.directory);
+
+    // One source per stream at the largest count, so no two streams share
+    // a file handle or page cache
+    std::printf ("Writing %d %s files of %.0f s...\n", o.maxStreams, o.format.c_str(), o.fileSeconds);
+    std::vector<fs::path> files;
+    for (int i = 0; i < o.maxStreams; ++i)
+    {
+        auto file = o.directory / ("source_" + std::to_string (i) + extension);
+        if (! writeSourceFile (file, format, o.sampleRate, o.fileSeconds, static_cast<unsigned> (i + 1)))
+        {
+            std::fprintf (stderr, "cannot write %s\n", file.c_str());
+            return 1;
+        }
+        files.push_back (file);
+    }
+
+    std::printf ("DiskStreamer benchmark: %s, %.0f Hz, block %d, %.1fx real time, %d I/O threads%s, "
+                 "%d recorders, %.0f s per run\n",
+                 o.format.c_str(), o.sampleRate, o.blockSize, o.speed, o.ioThreads,
+                 o.direct ? ", no decode cache" : "", o.recorders, o.seconds);
+    std::printf ("%-8s %-10s %-8s %-22s %-12s %-12s %-8s %s\n", "streams", "underruns", "seeks",
+                 "fill p1/p50/p99 (s)", "decoded MB/s", "CPU%/stream", "late%", "rec dropped (MB/s)");
+
+    for (int n = 1; ; n = std::min (n * 2, o.maxStreams))
+    {
+        auto r = run (o, files, n);
+
+        char fillText[32];
+        std::snprintf (fillText, sizeof (fillText), "%.2f/%.2f/%.2f", r.fillP1, r.fillP50, r.fillP99);
+        std::printf ("%-8d %-10llu %-8lld %-22s %-12.1f %-12.2f %-8.2f %lld (%.1f)\n",
+                     r.streams, static_cast<unsigned long long> (r.underruns), static_cast<long long> (r.seeks),
+                     fillText, r.decodedMBPerSecond, r.cpuPercentPerStream, r.lateCallbacksPercent,
+                     static_cast<long long> (r.recorderDropped), r.recorderMBPerSecond);
+        std::fflush (stdout);
+
+        if (n == o.maxStreams)
+            break;
+    }
+
+    if (ownDirectory)
+    {
+        std::error_code ec;
+        fs::remove_all (o.directory, ec);
+    }
+
+    return 0;
+}
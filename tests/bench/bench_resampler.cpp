@@ -0,0 +1,109 @@
+// Benchmark: Resampler throughput
+//
+// Converts stereo noise in 4096-frame chunks for each quality level and
+// common rate pair, and reports output frames per second per channel and
+// how many channels one core can convert in real time.
+//
+// Usage: dc_bench_resampler [seconds-of-audio]
+
+#include "dc/audio/Resampler.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+constexpr int kChunk = 4096;
+constexpr int kChannels = 2;
+
+struct Result
+{
+    double framesPerSecondPerChannel;
+    double channelsPerCore;
+};
+
+Result run (dc::Resampler::Quality quality, double inRate, double outRate, double audioSeconds)
+{
+    dc::Resampler resampler (kChannels, inRate, outRate, quality);
+
+    std::mt19937 rng (1);
+    std::uniform_real_distribution<float> dist (-1.0f, 1.0f);
+
+    std::vector<std::vector<float>> in (kChannels, std::vector<float> (kChunk));
+    for (auto& ch : in)
+        for (auto& s : ch)
+            s = dist (rng);
+
+    int maxOut = static_cast<int> (kChunk / resampler.getRatio()) + resampler.getNumTaps() + 2;
+    std::vector<std::vector<float>> out (kChannels, std::vector<float> (static_cast<size_t> (maxOut)));
+
+    const float* inPtrs[kChannels] = { in[0].data(), in[1].data() };
+    float* outPtrs[kChannels] = { out[0].data(), out[1].data() };
+
+    const auto targetFrames = static_cast<int64_t> (audioSeconds * outRate);
+    int64_t produced = 0;
+    float sink = 0.0f;
+
+    auto start = std::chrono::steady_clock::now();
+
+    while (produced < targetFrames)
+    {
+        int n = resampler.process (inPtrs, kChunk, outPtrs, maxOut);
+        produced += n;
+        sink += out[0][0];
+    }
+
+    auto elapsed = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+
+    if (sink == 12345.0f)
+        std::printf ("\n");  // keep the optimiser from discarding the work
+
+    // One core converted kChannels channels in that time
+    Result r;
+    r.framesPerSecondPerChannel = static_cast<double> (produced) * kChannels / elapsed;
+    r.channelsPerCore = r.framesPerSecondPerChannel / outRate;
+    return r;
+}
+
+} // anonymous namespace
+
+int main (int argc, char** argv)
+{
+    double audioSeconds = argc > 1 ? std::atof (argv[1]) : 20.0;
+
+    std::printf ("Resampler benchmark: %d channels, chunk %d, %.0f s of output audio\n",
+                 kChannels, kChunk, audioSeconds);
+    std::printf ("%-10s %-16s %-8s %-20s %s\n", "quality", "rates", "taps", "Mframes/s/channel", "channels/core");
+
+    struct { const char* name; dc::Resampler::Quality q; } qualities[] = {
+        { "draft",    dc::Resampler::Quality::draft },
+        { "standard", dc::Resampler::Quality::standard },
+        { "high",     dc::Resampler::Quality::high },
+    };
+
+    struct { double in, out; } rates[] = {
+        { 44100.0, 48000.0 },
+        { 48000.0, 44100.0 },
+        { 96000.0, 48000.0 },
+    };
+
+    for (auto& q : qualities)
+    {
+        for (auto& r : rates)
+        {
+            dc::Resampler probe (kChannels, r.in, r.out, q.q);
+            auto result = run (q.q, r.in, r.out, audioSeconds);
+
+            char rateName[32];
+            std::snprintf (rateName, sizeof (rateName), "%.1fk->%.1fk", r.in / 1000.0, r.out / 1000.0);
+            std::printf ("%-10s %-16s %-8d %-20.2f %.0f\n", q.name, rateName, probe.getNumTaps(),
+                         result.framesPerSecondPerChannel / 1.0e6, result.channelsPerCore);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,268 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "utils/AudioImporter.h"
+#include "dc/audio/AudioFileWriter.h"
+#include "dc/audio/PeakStore.h"
+#include "dc/foundation/message_queue.h"
+#include "model/AudioClip.h"
+#include "model/Project.h"
+#include "model/Track.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+struct TempDir
+{
+    fs::path path;
+
+    TempDir()
+    {
+        auto base = fs::temp_directory_path() / "dc_test_import_XXXXXX";
+        auto tmpl = base.string();
+        REQUIRE (mkdtemp (tmpl.data()) != nullptr);
+        path = tmpl;
+
+        // Keep peak files out of the user's app data directory
+        dc::PeakStore::getInstance().setDirectory (path / dc::PeakStore::directoryName);
+    }
+
+    ~TempDir()
+    {
+        dc::PeakStore::getInstance().setDirectory ({});
+        std::error_code ec;
+        fs::remove_all (path, ec);
+    }
+};
+
+fs::path writeSine (const fs::path& file, double sampleRate, int64_t frames, float frequency)
+{
+    auto writer = dc::AudioFileWriter::create (file, dc::AudioFileWriter::Format::WAV_32F, 2, sampleRate);
+    REQUIRE (writer != nullptr);
+
+    std::vector<float> data (static_cast<size_t> (frames * 2));
+    for (int64_t i = 0; i < frames; ++i)
+    {
+        auto v = 0.5f * std::sin (6.2831853f * frequency * static_cast<float> (i) / static_cast<float> (sampleRate));
+        data[static_cast<size_t> (i * 2)] = v;
+        data[static_cast<size_t> (i * 2 + 1)] = v;
+    }
+
+    REQUIRE (writer->write (data.data(), frames));
+    writer->close();
+    return file;
+}
+
+// Deliver results the way AppController::tick() does
+void waitForResults (dc::MessageQueue& mq, const std::vector<dc::AudioImporter::Result>& results, size_t count)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds (30);
+    while (results.size() < count && std::chrono::steady_clock::now() < deadline)
+    {
+        mq.processAll();
+        std::this_thread::sleep_for (std::chrono::milliseconds (2));
+    }
+    REQUIRE (results.size() == count);
+}
+
+} // namespace
+
+TEST_CASE ("AudioImporter imports several files in parallel", "[integration][import]")
+{
+    TempDir tmp;
+    dc::AudioPool pool;
+    pool.setDirectory (tmp.path / "session" / dc::AudioPool::directoryName);
+
+    std::vector<fs::path> files;
+    for (int i = 0; i < 4; ++i)
+        files.push_back (writeSine (tmp.path / ("stem" + std::to_string (i) + ".wav"), 44100.0, 22050,
+                                    220.0f * static_cast<float> (i + 1)));
+    // Same content as stem0 under another name
+    fs::copy_file (files[0], tmp.path / "copy.wav");
+    files.push_back (tmp.path / "copy.wav");
+
+    dc::MessageQueue mq;
+    dc::AudioImporter importer (pool, mq, 3);
+    REQUIRE (importer.getNumThreads() == 3);
+
+    std::vector<dc::AudioImporter::Result> results;
+    for (auto& file : files)
+        importer.import (file, {}, [&] (const dc::AudioImporter::Result& r) { results.push_back (r); });
+
+    CHECK (importer.getProgress().total == 5);
+    waitForResults (mq, results, files.size());
+
+    for (auto& r : results)
+    {
+        INFO (r.source << ": " << r.error);
+        REQUIRE (r.ok);
+        CHECK (pool.isPoolFile (r.file));
+        CHECK (r.file == pool.getFile (r.poolEntry));
+        CHECK (r.lengthInSamples == 22050);
+        CHECK (r.numChannels == 2);
+        REQUIRE (r.peaks != nullptr);
+        CHECK (r.peaks->isLoaded());
+    }
+
+    // Identical content is stored once; originals are left in place
+    CHECK (pool.getEntries().size() == 4);
+    CHECK (fs::exists (files[0]));
+
+    auto progress = importer.getProgress();
+    CHECK_FALSE (progress.isActive());
+    CHECK (progress.finished == 5);
+    CHECK_THAT (progress.fraction, Catch::Matchers::WithinAbs (1.0, 1e-9));
+}
+
+TEST_CASE ("AudioImporter converts to the target rate", "[integration][import]")
+{
+    TempDir tmp;
+    dc::AudioPool pool;
+    pool.setDirectory (tmp.path / "media");
+
+    auto source = writeSine (tmp.path / "take.wav", 44100.0, 44100, 440.0f);
+
+    dc::MessageQueue mq;
+    dc::AudioImporter importer (pool, mq, 2);
+
+    dc::AudioImporter::Options options;
+    options.targetSampleRate = 48000.0;
+    options.workDirectory = tmp.path / "audio";
+
+    std::vector<dc::AudioImporter::Result> results;
+    importer.import (source, options, [&] (const dc::AudioImporter::Result& r) { results.push_back (r); });
+    waitForResults (mq, results, 1);
+
+    auto& r = results[0];
+    REQUIRE (r.ok);
+    CHECK_THAT (r.sampleRate, Catch::Matchers::WithinAbs (48000.0, 1e-6));
+    CHECK (std::abs (r.lengthInSamples - 48000) <= 1);
+    CHECK (pool.isPoolFile (r.file));
+
+    // The converted copy was a by-product and moved into the pool
+    CHECK_FALSE (fs::exists (tmp.path / "audio" / "take_48000.wav"));
+}
+
+TEST_CASE ("AudioImporter reports unreadable files", "[integration][import]")
+{
+    TempDir tmp;
+    dc::AudioPool pool;
+
+    auto bogus = tmp.path / "notes.wav";
+    std::ofstream (bogus) << "not audio";
+
+    dc::MessageQueue mq;
+    dc::AudioImporter importer (pool, mq, 1);
+
+    std::vector<dc::AudioImporter::Result> results;
+    importer.import (bogus, {}, [&] (const dc::AudioImporter::Result& r) { results.push_back (r); });
+    waitForResults (mq, results, 1);
+
+    CHECK_FALSE (results[0].ok);
+    CHECK_FALSE (results[0].error.empty());
+    CHECK (results[0].source == bogus);
+}
+
+TEST_CASE ("AudioImporter without a pool plays the original", "[integration][import]")
+{
+    TempDir tmp;
+    dc::AudioPool pool;     // unsaved session: no directory
+
+    auto source = writeSine (tmp.path / "loop.wav", 44100.0, 4410, 110.0f);
+
+    dc::MessageQueue mq;
+    dc::AudioImporter importer (pool, mq, 1);
+
+    std::vector<dc::AudioImporter::Result> results;
+    importer.import (source, {}, [&] (const dc::AudioImporter::Result& r) { results.push_back (r); });
+    waitForResults (mq, results, 1);
+
+    REQUIRE (results[0].ok);
+    CHECK (results[0].file == source);
+    CHECK (results[0].poolEntry.empty());
+}
+
+TEST_CASE ("AudioImporter without a session converts outside the source folder", "[integration][import]")
+{
+    TempDir tmp;
+    dc::AudioPool pool;     // unsaved session: no directory, no work directory
+
+    // Converted copies land in the app data folder, which follows HOME
+    std::string oldHome = std::getenv ("HOME") != nullptr ? std::getenv ("HOME") : "";
+    setenv ("HOME", (tmp.path / "home").c_str(), 1);
+
+    fs::create_directories (tmp.path / "library");
+    auto source = writeSine (tmp.path / "library" / "hit.wav", 44100.0, 4410, 220.0f);
+
+    dc::MessageQueue mq;
+    dc::AudioImporter importer (pool, mq, 1);
+
+    dc::AudioImporter::Options options;
+    options.targetSampleRate = 48000.0;
+
+    std::vector<dc::AudioImporter::Result> results;
+    importer.import (source, options, [&] (const dc::AudioImporter::Result& r) { results.push_back (r); });
+    waitForResults (mq, results, 1);
+
+    auto workDir = dc::AudioImporter::getDefaultWorkDirectory();
+    setenv ("HOME", oldHome.c_str(), 1);
+
+    REQUIRE (results[0].ok);
+    CHECK (results[0].file.parent_path() == workDir);
+    CHECK (fs::exists (results[0].file));
+
+    // Nothing was written beside the source
+    int entries = 0;
+    for (auto& entry : fs::directory_iterator (tmp.path / "library"))
+        entries += entry.path() != source ? 1 : 0;
+    CHECK (entries == 0);
+}
+
+TEST_CASE ("AudioImporter adopts clip sources for a save", "[integration][import]")
+{
+    TempDir tmp;
+    dc::Project project;
+    auto& pool = project.getAudioPool();
+
+    auto take = writeSine (tmp.path / "take.wav", 44100.0, 4410, 330.0f);
+    for (int t = 0; t < 2; ++t)
+        dc::Track (project.addTrack ("T")).addAudioClip (take, 0, 4410);
+
+    // What AppController::saveSession() does once the pool has a directory
+    pool.setDirectory (tmp.path / "session" / dc::AudioPool::directoryName);
+    auto sources = pool.getUnpooledSources (project.getState());
+    REQUIRE (sources.size() == 1);
+
+    dc::MessageQueue mq;
+    dc::AudioImporter importer (pool, mq, 1);
+
+    dc::AudioImporter::Options options;
+    options.scanPeaks = false;
+
+    std::vector<dc::AudioImporter::Result> results;
+    importer.import (sources[0], options, [&] (const dc::AudioImporter::Result& r)
+    {
+        results.push_back (r);
+        dc::AudioPool::repointClips (project.getState(), r.source, r.poolEntry, r.file);
+    });
+    waitForResults (mq, results, 1);
+
+    REQUIRE (results[0].ok);
+    CHECK (results[0].peaks == nullptr);
+    for (int t = 0; t < 2; ++t)
+    {
+        auto clip = dc::Track (project.getTrack (t)).getClip (0);
+        CHECK (clip.getProperty (dc::IDs::poolEntry).getStringOr ("") == results[0].poolEntry);
+        CHECK (dc::AudioClip (clip).getSourceFile() == pool.getFile (results[0].poolEntry));
+    }
+    CHECK (pool.getUnpooledSources (project.getState()).empty());
+}
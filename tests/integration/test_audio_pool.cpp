@@ -0,0 +1,240 @@
+#include <catch2/catch_test_macros.hpp>
+#include "model/AudioPool.h"
+#include "model/Project.h"
+#include "model/Track.h"
+#include "model/AudioClip.h"
+#include "dc/foundation/file_utils.h"
+#include "dc/foundation/sha256.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+struct TempDir
+{
+    fs::path path;
+
+    TempDir()
+    {
+        auto base = fs::temp_directory_path() / "dc_test_pool_XXXXXX";
+        auto tmpl = base.string();
+        REQUIRE (mkdtemp (tmpl.data()) != nullptr);
+        path = tmpl;
+    }
+
+    ~TempDir()
+    {
+        std::error_code ec;
+        // Pool entries are read-only; the directories are not, so removal works
+        fs::remove_all (path, ec);
+    }
+};
+
+fs::path writeFile (const fs::path& file, const std::string& content)
+{
+    fs::create_directories (file.parent_path());
+    std::ofstream out (file, std::ios::binary);
+    out << content;
+    return file;
+}
+
+} // namespace
+
+TEST_CASE ("AudioPool stores files by content hash", "[integration][pool]")
+{
+    TempDir tmp;
+    auto source = writeFile (tmp.path / "in" / "Kick.WAV", "kick drum bytes");
+
+    dc::AudioPool pool;
+    CHECK (pool.import (source).empty());     // no directory yet
+
+    pool.setDirectory (tmp.path / "session" / dc::AudioPool::directoryName);
+    auto hash = pool.import (source);
+
+    REQUIRE (hash == dc::sha256Hex ("kick drum bytes"));
+    auto entry = pool.getFile (hash);
+    CHECK (entry == pool.getDirectory() / hash.substr (0, 2) / (hash + ".wav"));
+    CHECK (dc::readFileToString (entry) == "kick drum bytes");
+    CHECK (fs::exists (source));
+    CHECK (pool.isPoolFile (entry));
+    CHECK_FALSE (pool.isPoolFile (source));
+
+    // Importing a pool file returns its own entry
+    CHECK (pool.import (entry) == hash);
+}
+
+TEST_CASE ("AudioPool deduplicates identical content", "[integration][pool]")
+{
+    TempDir tmp;
+    dc::AudioPool pool;
+    pool.setDirectory (tmp.path / "media");
+
+    auto a = writeFile (tmp.path / "a.wav", "same audio");
+    auto b = writeFile (tmp.path / "elsewhere" / "b.wav", "same audio");
+    auto c = writeFile (tmp.path / "c.wav", "different audio");
+
+    auto hashA = pool.import (a);
+    auto hashB = pool.import (b);
+    auto hashC = pool.import (c);
+
+    CHECK (hashA == hashB);
+    CHECK (hashA != hashC);
+    CHECK (pool.getEntries().size() == 2);
+
+    // Re-import of an unchanged file is answered without hashing; a
+    // changed file gets a new entry
+    CHECK (pool.import (a) == hashA);
+    writeFile (a, "edited audio");
+    fs::last_write_time (a, fs::last_write_time (a) + std::chrono::seconds (2));
+    auto edited = pool.import (a);
+    CHECK (edited == dc::sha256Hex ("edited audio"));
+    CHECK (pool.getEntries().size() == 3);
+}
+
+TEST_CASE ("AudioPool concurrent imports of the same content publish one entry", "[integration][pool]")
+{
+    TempDir tmp;
+    dc::AudioPool pool;
+    pool.setDirectory (tmp.path / "media");
+
+    const int numThreads = 8;
+    std::vector<std::string> hashes (numThreads);
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        auto file = writeFile (tmp.path / ("take" + std::to_string (i) + ".wav"), std::string (1 << 20, 'x'));
+        auto mode = i % 2 == 0 ? dc::AudioPool::ImportMode::copy : dc::AudioPool::ImportMode::move;
+        threads.emplace_back ([&pool, &hashes, file, mode, i] { hashes[static_cast<size_t> (i)] = pool.import (file, mode); });
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    for (auto& hash : hashes)
+        CHECK (hash == hashes[0]);
+
+    CHECK (pool.getEntries().size() == 1);
+    CHECK (fs::file_size (pool.getFile (hashes[0])) == (1u << 20));
+
+    // Losing imports discard their temporary copies
+    int leftovers = 0;
+    for (auto& entry : fs::recursive_directory_iterator (tmp.path / "media"))
+        if (entry.path().extension() == ".tmp")
+            ++leftovers;
+    CHECK (leftovers == 0);
+}
+
+TEST_CASE ("AudioPool move import consumes by-products", "[integration][pool]")
+{
+    TempDir tmp;
+    dc::AudioPool pool;
+    pool.setDirectory (tmp.path / "media");
+
+    auto bounce = writeFile (tmp.path / "bounce.wav", "bounced mix");
+    auto hash = pool.import (bounce, dc::AudioPool::ImportMode::move);
+    REQUIRE_FALSE (hash.empty());
+    CHECK_FALSE (fs::exists (bounce));
+    CHECK (dc::readFileToString (pool.getFile (hash)) == "bounced mix");
+
+    // A second identical bounce is discarded in favour of the entry
+    auto again = writeFile (tmp.path / "bounce2.wav", "bounced mix");
+    CHECK (pool.import (again, dc::AudioPool::ImportMode::move) == hash);
+    CHECK_FALSE (fs::exists (again));
+    CHECK (pool.getEntries().size() == 1);
+}
+
+TEST_CASE ("AudioPool adopts clips and survives a session round-trip", "[integration][pool]")
+{
+    TempDir tmp;
+    auto source = writeFile (tmp.path / "take.wav", "recorded take");
+
+    dc::Project project;
+    dc::Track first (project.addTrack ("One"));
+    dc::Track second (project.addTrack ("Two"));
+    first.addAudioClip (source, 0, 100);
+    second.addAudioClip (source, 500, 100);
+
+    auto sessionDir = tmp.path / "session";
+    auto& pool = project.getAudioPool();
+    pool.setDirectory (sessionDir / dc::AudioPool::directoryName);
+    CHECK (pool.adoptClips (project.getState()) == 2);
+
+    auto hash = dc::sha256Hex ("recorded take");
+    for (int t = 0; t < 2; ++t)
+    {
+        auto clip = dc::Track (project.getTrack (t)).getClip (0);
+        CHECK (clip.getProperty (dc::IDs::poolEntry).getStringOr ("") == hash);
+        CHECK (dc::AudioClip (clip).getSourceFile() == pool.getFile (hash));
+    }
+
+    // Already-pooled clips are left alone
+    CHECK (pool.adoptClips (project.getState()) == 0);
+
+    REQUIRE (project.saveSessionToDirectory (sessionDir));
+
+    dc::Project loaded;
+    REQUIRE (loaded.loadSessionFromDirectory (sessionDir));
+    auto clip = dc::Track (loaded.getTrack (1)).getClip (0);
+    CHECK (clip.getProperty (dc::IDs::poolEntry).getStringOr ("") == hash);
+    CHECK (fs::equivalent (dc::AudioClip (clip).getSourceFile(), pool.getFile (hash)));
+}
+
+TEST_CASE ("AudioPool collects unreferenced media", "[integration][pool]")
+{
+    TempDir tmp;
+    dc::Project project;
+    auto& pool = project.getAudioPool();
+    pool.setDirectory (tmp.path / "media");
+
+    auto keepHash = pool.import (writeFile (tmp.path / "keep.wav", "kept"));
+    auto dropHash = pool.import (writeFile (tmp.path / "drop.wav", "dropped!"));
+    auto leftover = writeFile (pool.getDirectory() / "ab" / "partial.wav.tmp", "x");
+
+    dc::Track track (project.addTrack ("T"));
+    auto clip = track.addAudioClip (pool.getFile (keepHash), 0, 10);
+    clip.setProperty (dc::IDs::poolEntry, dc::Variant (keepHash), nullptr);
+
+    auto result = pool.collectGarbage (project.getState());
+    CHECK (result.entriesRemoved == 1);
+    CHECK (result.bytesFreed == 8 + 1);   // the entry and the leftover
+    CHECK (pool.contains (keepHash));
+    CHECK_FALSE (pool.contains (dropHash));
+    CHECK_FALSE (fs::exists (leftover));
+    CHECK_FALSE (fs::exists (pool.getDirectory() / dropHash.substr (0, 2)));
+}
+
+TEST_CASE ("AudioPool keeps media any given session references", "[integration][pool]")
+{
+    TempDir tmp;
+    dc::Project open, saved;
+    auto& pool = open.getAudioPool();
+    pool.setDirectory (tmp.path / "media");
+
+    auto openHash = pool.import (writeFile (tmp.path / "open.wav", "open"));
+    auto savedHash = pool.import (writeFile (tmp.path / "saved.wav", "saved"));
+    auto strayHash = pool.import (writeFile (tmp.path / "stray.wav", "stray"));
+
+    dc::Track (open.addTrack ("T")).addAudioClip (pool.getFile (openHash), 0, 10);
+    dc::Track (saved.addTrack ("T")).addAudioClip (pool.getFile (savedHash), 0, 10);
+
+    // A file outside the pool that happens to be named like an entry
+    // doesn't reference it
+    auto lookalike = writeFile (tmp.path / (strayHash + ".wav"), "elsewhere");
+    dc::Track (open.addTrack ("U")).addAudioClip (lookalike, 0, 10);
+
+    auto result = pool.collectGarbage ({ open.getState(), saved.getState() });
+    CHECK (result.entriesRemoved == 1);
+    CHECK (pool.contains (openHash));
+    CHECK (pool.contains (savedHash));
+    CHECK_FALSE (pool.contains (strayHash));
+    CHECK (fs::exists (lookalike));
+}
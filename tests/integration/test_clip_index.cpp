@@ -0,0 +1,136 @@
+#include <catch2/catch_test_macros.hpp>
+#include "model/Project.h"
+#include "model/Track.h"
+#include "model/Arrangement.h"
+#include "model/ClipIndex.h"
+#include <algorithm>
+#include <random>
+
+TEST_CASE ("ClipIndex answers overlap, point and edge queries", "[integration][clip_index]")
+{
+    dc::Project project;
+    dc::Track track (project.addTrack ("Track"));
+
+    track.addMidiClip (1000, 500);     // clip 0: [1000, 1500)
+    track.addMidiClip (0, 200);        // clip 1: [0, 200)
+    track.addMidiClip (1200, 1000);    // clip 2: [1200, 2200)
+
+    dc::ClipIndex index (track.getState());
+    REQUIRE (index.getNumClips() == 3);
+    CHECK (index.getClip (0) == track.getClip (0));
+
+    std::vector<int> hits;
+    index.findOverlapping (100, 1100, hits);
+    CHECK (hits == std::vector<int> { 1, 0 });
+
+    index.findOverlapping (1500, 1600, hits);
+    CHECK (hits == std::vector<int> { 2 });
+
+    index.findOverlapping (200, 1000, hits);
+    CHECK (hits.empty());
+
+    CHECK (index.getClipAt (1300) == 0);
+    CHECK (index.getClipAt (1500) == 2);
+    CHECK (index.getClipAt (600) == -1);
+
+    CHECK (index.getNextClip (0) == 0);
+    CHECK (index.getNextClip (1000) == 2);
+    CHECK (index.getNextClip (1200) == -1);
+    CHECK (index.getPreviousClip (1000) == 1);
+    CHECK (index.getPreviousClip (0) == -1);
+
+    int64_t edge = 0;
+    REQUIRE (index.getNextEdge (200, edge));
+    CHECK (edge == 1000);
+    REQUIRE (index.getPreviousEdge (1200, edge));
+    CHECK (edge == 1000);
+    REQUIRE (index.getNextEnd (1500, edge));
+    CHECK (edge == 2200);
+    CHECK_FALSE (index.getNextEdge (2200, edge));
+
+    CHECK (index.getEndPosition() == 2200);
+}
+
+TEST_CASE ("ClipIndex follows clip edits", "[integration][clip_index]")
+{
+    dc::Project project;
+    dc::Track track (project.addTrack ("Track"));
+    dc::ClipIndex index (track.getState());
+
+    CHECK (index.getNumClips() == 0);
+    CHECK (index.getEndPosition() == 0);
+
+    auto clip = track.addMidiClip (0, 100);
+    CHECK (index.getClipAt (50) == 0);
+
+    clip.setProperty (dc::IDs::startPosition, dc::Variant (int64_t (5000)), nullptr);
+    CHECK (index.getClipAt (50) == -1);
+    CHECK (index.getClipAt (5050) == 0);
+    CHECK (index.getEndPosition() == 5100);
+
+    track.addAudioClip ("a.wav", 0, 300);
+    CHECK (index.getClipAt (50) == 1);
+
+    track.removeClip (0);
+    CHECK (index.getNumClips() == 1);
+    CHECK (index.getClipAt (5050) == -1);
+    CHECK (index.getEndPosition() == 300);
+}
+
+TEST_CASE ("ClipIndex overlap queries match a linear scan", "[integration][clip_index]")
+{
+    dc::Project project;
+    dc::Track track (project.addTrack ("Track"));
+
+    std::mt19937 rng (7);
+    std::uniform_int_distribution<int64_t> startDist (0, 1000000);
+    std::uniform_int_distribution<int64_t> lengthDist (0, 20000);
+
+    for (int i = 0; i < 2000; ++i)
+        track.addMidiClip (startDist (rng), i % 100 == 0 ? 400000 : lengthDist (rng));
+
+    dc::ClipIndex index (track.getState());
+    REQUIRE (index.getNumClips() == 2000);
+
+    std::vector<int> hits;
+    for (int q = 0; q < 200; ++q)
+    {
+        int64_t start = startDist (rng);
+        int64_t end = start + lengthDist (rng) + 1;
+
+        std::vector<int> expected;
+        for (int c = 0; c < index.getNumClips(); ++c)
+            if (index.getClipStart (c) < end && index.getClipEnd (c) > start)
+                expected.push_back (c);
+
+        index.findOverlapping (start, end, hits);
+        std::sort (hits.begin(), hits.end());
+        REQUIRE (hits == expected);
+
+        int at = index.getClipAt (start);
+        int expectedAt = -1;
+        for (int c = 0; c < index.getNumClips() && expectedAt < 0; ++c)
+            if (start >= index.getClipStart (c) && start < index.getClipEnd (c))
+                expectedAt = c;
+        REQUIRE (at == expectedAt);
+    }
+}
+
+TEST_CASE ("Arrangement keeps one clip index per track across reorders", "[integration][clip_index]")
+{
+    dc::Project project;
+    dc::Arrangement arrangement (project);
+
+    auto a = arrangement.addTrack ("A");
+    arrangement.addTrack ("B");
+    a.addMidiClip (0, 100);
+
+    auto indexA = arrangement.getClipIndex (0);
+    REQUIRE (indexA != nullptr);
+    CHECK (indexA->getNumClips() == 1);
+    CHECK (arrangement.getClipIndex (2) == nullptr);
+
+    arrangement.moveTrack (0, 1);
+    CHECK (arrangement.getClipIndex (1) == indexA);
+    CHECK (arrangement.getClipIndex (0)->getNumClips() == 0);
+}
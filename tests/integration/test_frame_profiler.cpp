@@ -0,0 +1,172 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "graphics/rendering/FrameProfiler.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using dc::gfx::FrameProfiler;
+using Catch::Matchers::WithinAbs;
+
+namespace
+{
+
+struct MeterWidget {};
+struct TrackView {};
+
+// A start time the given number of milliseconds ago, so recorded times
+// are known without sleeping
+FrameProfiler::Clock::time_point msAgo (double ms)
+{
+    return FrameProfiler::Clock::now()
+         - std::chrono::duration_cast<FrameProfiler::Clock::duration> (std::chrono::duration<double, std::milli> (ms));
+}
+
+} // namespace
+
+TEST_CASE ("FrameProfiler keeps the most recent frames in order", "[integration][frame_profiler]")
+{
+    FrameProfiler profiler;
+    profiler.setEnabled (true);
+    profiler.setHistorySize (4);
+
+    for (int i = 1; i <= 6; ++i)
+    {
+        profiler.beginFrame();
+        profiler.endFrame (i, i * 10, i * 100);
+    }
+
+    REQUIRE (profiler.getNumFrames() == 4);
+    CHECK (profiler.getFrame (0).frameNumber == 3);
+    CHECK (profiler.getFrame (3).frameNumber == 6);
+    CHECK (profiler.getFrame (3).paintedNodes == 60);
+    CHECK (profiler.getFrame (3).paintedPixels == 600);
+
+    // Cancelled frames and frames recorded while disabled are dropped
+    profiler.beginFrame();
+    profiler.cancelFrame();
+    profiler.endFrame (7, 0, 0);
+
+    profiler.setEnabled (false);
+    profiler.beginFrame();
+    profiler.endFrame (8, 0, 0);
+
+    CHECK (profiler.getFrame (3).frameNumber == 6);
+
+    profiler.clear();
+    CHECK (profiler.getNumFrames() == 0);
+    CHECK (profiler.getStats().frames == 0);
+}
+
+TEST_CASE ("FrameProfiler records only while something uses the numbers", "[integration][frame_profiler]")
+{
+    FrameProfiler profiler;
+    CHECK_FALSE (profiler.isEnabled());
+
+    profiler.beginFrame();
+    profiler.endFrame (1, 1, 0);
+    CHECK (profiler.getNumFrames() == 0);
+
+    profiler.setOverlayVisible (true);
+    profiler.beginFrame();
+    profiler.endFrame (2, 1, 0);
+    CHECK (profiler.getNumFrames() == 1);
+
+    profiler.setOverlayVisible (false);
+    profiler.setCapturing (true);
+    profiler.beginFrame();
+    profiler.endFrame (3, 1, 0);
+    CHECK (profiler.getNumFrames() == 2);
+
+    profiler.setCapturing (false);
+    CHECK_FALSE (profiler.isEnabled());
+}
+
+TEST_CASE ("FrameProfiler reports nearest-rank percentiles per phase", "[integration][frame_profiler]")
+{
+    FrameProfiler profiler;
+    profiler.setEnabled (true);
+
+    for (int i = 1; i <= 100; ++i)
+    {
+        profiler.beginFrame();
+        profiler.addPhaseTime (FrameProfiler::Paint, msAgo (i));
+        profiler.endFrame (i, 1, 1);
+    }
+
+    auto paint = profiler.getPhaseStats (FrameProfiler::Paint);
+    CHECK (paint.frames == 100);
+    CHECK_THAT (paint.p50Ms, WithinAbs (50.0, 1.0));
+    CHECK_THAT (paint.p90Ms, WithinAbs (90.0, 1.0));
+    CHECK_THAT (paint.p99Ms, WithinAbs (99.0, 1.0));
+    CHECK_THAT (paint.maxMs, WithinAbs (100.0, 1.0));
+    CHECK_THAT (paint.meanMs, WithinAbs (50.5, 1.0));
+
+    // The frame total covers the whole frame, not the injected phase time
+    auto total = profiler.getStats();
+    CHECK (total.frames == 100);
+    CHECK (total.p50Ms <= total.p90Ms);
+    CHECK (total.p90Ms <= total.p99Ms);
+    CHECK (total.p99Ms <= total.maxMs);
+
+    CHECK (profiler.getPhaseStats (FrameProfiler::Layout).maxMs == 0.0);
+}
+
+TEST_CASE ("FrameProfiler attributes paint time to widget classes", "[integration][frame_profiler]")
+{
+    FrameProfiler profiler;
+    profiler.setEnabled (true);
+
+    profiler.beginFrame();
+    profiler.addPaintTime (typeid (MeterWidget), msAgo (2.0));
+    profiler.addPaintTime (typeid (TrackView), msAgo (5.0));
+    profiler.addPaintTime (typeid (MeterWidget), msAgo (2.0));
+    profiler.endFrame (1, 3, 0);
+
+    const auto& frame = profiler.getFrame (0);
+    REQUIRE (frame.numWidgets == 2);
+
+    // Slowest first; repeated classes are summed
+    CHECK (profiler.getWidgetClassName (frame.widgets[0].widgetClass).find ("TrackView") != std::string::npos);
+    CHECK (profiler.getWidgetClassName (frame.widgets[1].widgetClass).find ("MeterWidget") != std::string::npos);
+    CHECK_THAT (frame.widgets[1].ms, WithinAbs (4.0, 0.5));
+
+    // Each frame starts its class totals afresh
+    profiler.beginFrame();
+    profiler.addPaintTime (typeid (MeterWidget), msAgo (1.0));
+    profiler.endFrame (2, 1, 0);
+
+    REQUIRE (profiler.getFrame (1).numWidgets == 1);
+    CHECK_THAT (profiler.getFrame (1).widgets[0].ms, WithinAbs (1.0, 0.5));
+}
+
+TEST_CASE ("FrameProfiler report summarises phases and widgets and dumps to a file", "[integration][frame_profiler]")
+{
+    FrameProfiler profiler;
+    profiler.setEnabled (true);
+
+    profiler.beginFrame();
+    profiler.endFrame (1, 1, 0);
+
+    profiler.beginFrame();
+    profiler.addPaintTime (typeid (TrackView), msAgo (30.0));
+    profiler.addPhaseTime (FrameProfiler::Paint, msAgo (30.0));
+    profiler.endFrame (2, 1, 0);
+
+    auto report = profiler.formatReport();
+    CHECK (report.find ("2 painted frames") != std::string::npos);
+    CHECK (report.find ("paint") != std::string::npos);
+    CHECK (report.find ("TrackView") != std::string::npos);
+    CHECK (report.find ("Frames over budget") != std::string::npos);
+
+    auto file = std::filesystem::temp_directory_path() / "dc_test_frame_profile.txt";
+    REQUIRE (profiler.dumpToFile (file));
+
+    std::ifstream in (file);
+    std::stringstream contents;
+    contents << in.rdbuf();
+    CHECK (contents.str() == report);
+
+    std::filesystem::remove (file);
+}
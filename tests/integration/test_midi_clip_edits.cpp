@@ -0,0 +1,89 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "model/Project.h"
+#include "model/Track.h"
+#include "model/MidiClip.h"
+#include "utils/UndoSystem.h"
+
+#include <numeric>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+namespace
+{
+
+struct ChangeCounter : dc::PropertyTree::Listener
+{
+    int propertyChanges = 0;
+    void propertyChanged (dc::PropertyTree&, dc::PropertyId) override { ++propertyChanges; }
+};
+
+dc::PropertyTree makeClipWithNotes (dc::Project& project, int numNotes)
+{
+    dc::Track track (project.addTrack ("Keys"));
+    auto clipState = track.addMidiClip (0, 44100 * 60);
+
+    dc::MidiClip clip (clipState);
+    dc::MidiSequence seq;
+    for (int i = 0; i < numNotes; ++i)
+    {
+        seq.addEvent (dc::MidiMessage::noteOn (1, 48 + i % 24, 0.75f), i * 0.5 + 0.05);
+        seq.addEvent (dc::MidiMessage::noteOff (1, 48 + i % 24), i * 0.5 + 0.3);
+    }
+    clip.setMidiSequence (seq);
+    clip.expandNotesToChildren();
+    return clipState;
+}
+
+} // anonymous namespace
+
+TEST_CASE ("MidiClip applyNoteEdits is one undo step and one notification", "[integration][midi_clip]")
+{
+    dc::Project project;
+    auto clipState = makeClipWithNotes (project, 2000);
+    dc::MidiClip clip (clipState);
+
+    std::vector<int> indices (static_cast<size_t> (clipState.getNumChildren()));
+    std::iota (indices.begin(), indices.end(), 0);
+
+    auto notes = clip.getNotes (indices);
+    REQUIRE (notes.size() == 2000);
+
+    dc::QuantizeSettings settings;
+    settings.gridBeats = 0.5;
+    dc::quantizeNotes (notes, settings);
+    dc::transposeNotes (notes, 12);
+
+    ChangeCounter counter;
+    clipState.addListener (&counter);
+    {
+        dc::ScopedTransaction txn (project.getUndoSystem(), "Quantize Notes");
+        clip.applyNoteEdits (indices, notes, &project.getUndoManager());
+    }
+    clipState.removeListener (&counter);
+
+    // Only the clip's midiData changed from a listener's point of view
+    CHECK (counter.propertyChanges == 1);
+
+    auto seq = clip.getMidiSequence();
+    REQUIRE (seq.getNumEvents() == 4000);
+    REQUIRE_THAT (seq.getEvent (0).timeInBeats, WithinAbs (0.0, 1e-12));
+    CHECK (seq.getEvent (0).message.getNoteNumber() == 60);
+
+    auto firstNote = clipState.getChild (0);
+    REQUIRE_THAT (firstNote.getProperty (dc::IDs::startBeat).getDoubleOr (-1.0), WithinAbs (0.0, 1e-12));
+
+    SECTION ("undo restores notes and midiData in one step")
+    {
+        project.getUndoSystem().undo();
+
+        REQUIRE_THAT (firstNote.getProperty (dc::IDs::startBeat).getDoubleOr (-1.0), WithinAbs (0.05, 1e-12));
+        CHECK (firstNote.getProperty (dc::IDs::noteNumber).getIntOr (0) == 48);
+        REQUIRE_THAT (clip.getMidiSequence().getEvent (0).timeInBeats, WithinAbs (0.05, 1e-12));
+
+        project.getUndoSystem().redo();
+        CHECK (firstNote.getProperty (dc::IDs::noteNumber).getIntOr (0) == 60);
+        REQUIRE_THAT (clip.getMidiSequence().getEvent (0).timeInBeats, WithinAbs (0.0, 1e-12));
+    }
+}
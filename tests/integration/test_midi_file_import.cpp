@@ -0,0 +1,108 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "utils/MidiFileUtils.h"
+#include "utils/UndoSystem.h"
+#include "model/Project.h"
+#include "model/Track.h"
+#include "model/MidiClip.h"
+
+using Catch::Matchers::WithinAbs;
+
+namespace
+{
+
+dc::MidiFile makeTwoTrackFile()
+{
+    dc::MidiFile file;
+    file.addTempoChange (0.0, 96.0);
+    file.addTempoChange (16.0, 140.0);
+    file.addTimeSignatureChange (0.0, 6, 8);
+
+    for (int t = 0; t < 2; ++t)
+    {
+        dc::MidiFile::Track track;
+        track.name = t == 0 ? "Bass" : "";
+        for (int i = 0; i < 8; ++i)
+        {
+            track.sequence.addEvent (dc::MidiMessage::noteOn (1, 40 + i, 0.7f), i * 1.0);
+            track.sequence.addEvent (dc::MidiMessage::noteOff (1, 40 + i), i * 1.0 + 0.5);
+        }
+        file.addTrack (std::move (track));
+    }
+
+    // Empty conductor-style track is skipped on import
+    file.addTrack ({});
+    return file;
+}
+
+} // anonymous namespace
+
+TEST_CASE ("MidiFileUtils import builds tracks without NOTE children", "[integration][midi_file]")
+{
+    dc::Project project;
+    auto file = makeTwoTrackFile();
+
+    int added = dc::MidiFileUtils::importIntoProject (file, project, "song");
+    REQUIRE (added == 2);
+    REQUIRE (project.getNumTracks() == 2);
+
+    // First tempo / time signature are applied
+    CHECK_THAT (project.getTempo(), WithinAbs (96.0, 1e-9));
+    CHECK (project.getTimeSigNumerator() == 6);
+    CHECK (project.getTimeSigDenominator() == 8);
+
+    dc::Track bass (project.getTrack (0));
+    CHECK (bass.getName() == "Bass");
+    dc::Track unnamed (project.getTrack (1));
+    CHECK (unnamed.getName() == "song 2");
+
+    REQUIRE (bass.getNumClips() == 1);
+    dc::MidiClip clip (bass.getClip (0));
+    CHECK (clip.getState().getNumChildren() == 0);
+    CHECK (clip.getMidiSequence().getNumEvents() == 16);
+
+    // 7.5 beats rounded up to two 6-beat bars at 96 bpm / 44.1 kHz
+    CHECK (clip.getLength() == static_cast<int64_t> (12.0 * 60.0 / 96.0 * 44100.0));
+}
+
+TEST_CASE ("MidiFileUtils import is a single undo step", "[integration][midi_file]")
+{
+    dc::Project project;
+    auto file = makeTwoTrackFile();
+
+    dc::MidiFileUtils::importIntoProject (file, project, "song");
+    REQUIRE (project.getNumTracks() == 2);
+
+    project.getUndoSystem().undo();
+    CHECK (project.getNumTracks() == 0);
+    CHECK_THAT (project.getTempo(), WithinAbs (120.0, 1e-9));
+}
+
+TEST_CASE ("MidiFileUtils export offsets clips by start position", "[integration][midi_file]")
+{
+    dc::Project project;
+    auto trackState = project.addTrack ("Keys");
+    dc::Track track (trackState);
+
+    // Clip starts at beat 4 (120 bpm, 44.1 kHz)
+    auto clipState = track.addMidiClip (4 * 22050, 4 * 22050);
+    dc::MidiSequence seq;
+    seq.addEvent (dc::MidiMessage::noteOn (2, 60, 1.0f), 0.0);
+    seq.addEvent (dc::MidiMessage::noteOff (2, 60), 1.0);
+    dc::MidiClip (clipState).setMidiSequence (seq);
+
+    project.addTrack ("Audio only");
+
+    auto file = dc::MidiFileUtils::createFromProject (project);
+    REQUIRE (file.getNumTracks() == 1);
+    CHECK (file.getTrack (0).name == "Keys");
+    REQUIRE_THAT (file.getTrack (0).sequence.getEvent (0).timeInBeats, WithinAbs (4.0, 1e-9));
+    REQUIRE_THAT (file.getTrack (0).sequence.getEvent (1).timeInBeats, WithinAbs (5.0, 1e-9));
+
+    // And back in through the SMF encoder
+    auto bytes = file.writeToMemory();
+    auto reread = dc::MidiFile::readFromMemory (bytes.data(), bytes.size());
+    REQUIRE (reread != nullptr);
+    CHECK (reread->getTotalNumEvents() == 2);
+    REQUIRE_THAT (reread->getTempoChanges().front().bpm, WithinAbs (120.0, 0.01));
+}
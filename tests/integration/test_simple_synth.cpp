@@ -0,0 +1,160 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "engine/SimpleSynthProcessor.h"
+#include "dc/audio/AudioBlock.h"
+#include "dc/engine/MidiBlock.h"
+#include "dc/midi/MidiMessage.h"
+#include "dc/foundation/types.h"
+
+#include <algorithm>
+#include <cmath>
+
+using Catch::Matchers::WithinAbs;
+
+static constexpr int kBlockSize = 512;
+static constexpr double kSampleRate = 48000.0;
+
+namespace
+{
+
+struct SynthBuffer
+{
+    float data[2][kBlockSize] {};
+    float* channels[2] = { data[0], data[1] };
+    dc::AudioBlock block { channels, 2, kBlockSize };
+};
+
+float peakOf (const float* samples, int start, int end)
+{
+    float peak = 0.0f;
+    for (int i = start; i < end; ++i)
+        peak = std::max (peak, std::abs (samples[i]));
+    return peak;
+}
+
+} // anonymous namespace
+
+// ─── Silence without notes ──────────────────────────────────────────────────
+
+TEST_CASE ("SimpleSynth: no notes produces silence", "[integration][simple_synth]")
+{
+    dc::SimpleSynthProcessor synth;
+    synth.prepare (kSampleRate, kBlockSize);
+
+    SynthBuffer buf;
+    dc::MidiBlock midi;
+    synth.process (buf.block, midi, kBlockSize);
+
+    CHECK (peakOf (buf.data[0], 0, kBlockSize) == 0.0f);
+    CHECK (synth.getNumActiveVoices() == 0);
+}
+
+// ─── Sample-accurate note start ─────────────────────────────────────────────
+
+TEST_CASE ("SimpleSynth: note-on starts at its sample offset", "[integration][simple_synth]")
+{
+    dc::SimpleSynthProcessor synth;
+    synth.prepare (kSampleRate, kBlockSize);
+
+    SynthBuffer buf;
+    dc::MidiBlock midi;
+    midi.addEvent (dc::MidiMessage::noteOn (1, 69, 1.0f), 200);
+    synth.process (buf.block, midi, kBlockSize);
+
+    CHECK (peakOf (buf.data[0], 0, 200) == 0.0f);
+    CHECK (peakOf (buf.data[0], 201, kBlockSize) > 0.05f);
+    CHECK (synth.getNumActiveVoices() == 1);
+
+    // Both channels carry the same signal
+    for (int i = 0; i < kBlockSize; ++i)
+        REQUIRE (buf.data[0][i] == buf.data[1][i]);
+}
+
+// ─── Oscillator pitch ───────────────────────────────────────────────────────
+
+TEST_CASE ("SimpleSynth: A4 renders at 440 Hz", "[integration][simple_synth]")
+{
+    for (auto wave : { dc::SimpleSynthProcessor::Waveform::sine,
+                       dc::SimpleSynthProcessor::Waveform::saw,
+                       dc::SimpleSynthProcessor::Waveform::square })
+    {
+        dc::SimpleSynthProcessor synth;
+        synth.prepare (kSampleRate, kBlockSize);
+        synth.setWaveform (wave);
+
+        // Render 1 second and count upward zero crossings
+        int crossings = 0;
+        float prev = 0.0f;
+        const int numBlocks = static_cast<int> (kSampleRate) / kBlockSize;
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            SynthBuffer buf;
+            dc::MidiBlock midi;
+            if (b == 0)
+                midi.addEvent (dc::MidiMessage::noteOn (1, 69, 1.0f), 0);
+
+            synth.process (buf.block, midi, kBlockSize);
+
+            for (int i = 0; i < kBlockSize; ++i)
+            {
+                float s = buf.data[0][i];
+                if (prev < 0.0f && s >= 0.0f)
+                    ++crossings;
+                prev = s;
+                REQUIRE (std::abs (s) <= 1.0f);
+            }
+        }
+
+        double seconds = numBlocks * kBlockSize / kSampleRate;
+        CHECK_THAT (crossings / seconds, WithinAbs (440.0, 3.0));
+    }
+}
+
+// ─── Sine accuracy ──────────────────────────────────────────────────────────
+
+TEST_CASE ("SimpleSynth: sine voice matches reference sine", "[integration][simple_synth]")
+{
+    dc::SimpleSynthProcessor synth;
+    synth.prepare (kSampleRate, kBlockSize);
+
+    SynthBuffer buf;
+    dc::MidiBlock midi;
+    midi.addEvent (dc::MidiMessage::noteOn (1, 69, 1.0f), 0);
+    synth.process (buf.block, midi, kBlockSize);
+
+    const double inc = 440.0 / kSampleRate;
+    for (int i = 0; i < kBlockSize; ++i)
+    {
+        double level = 0.3 * std::pow (0.99995, i);
+        double expected = std::tanh (0.5 * level * std::sin (2.0 * dc::pi<double> * inc * i));
+        REQUIRE_THAT (buf.data[0][i], WithinAbs (expected, 1e-4));
+    }
+}
+
+// ─── Voice allocation ───────────────────────────────────────────────────────
+
+TEST_CASE ("SimpleSynth: voice stealing caps polyphony", "[integration][simple_synth]")
+{
+    dc::SimpleSynthProcessor synth;
+    synth.prepare (kSampleRate, kBlockSize);
+
+    SynthBuffer buf;
+    dc::MidiBlock midi;
+    for (int n = 0; n < dc::SimpleSynthProcessor::maxVoices + 8; ++n)
+        midi.addEvent (dc::MidiMessage::noteOn (1, 30 + n, 0.5f), n);
+
+    synth.process (buf.block, midi, kBlockSize);
+    CHECK (synth.getNumActiveVoices() == dc::SimpleSynthProcessor::maxVoices);
+
+    SECTION ("all notes off silences the next block")
+    {
+        SynthBuffer next;
+        dc::MidiBlock off;
+        off.addEvent (dc::MidiMessage::allNotesOff (1), 0);
+        synth.process (next.block, off, kBlockSize);
+
+        CHECK (synth.getNumActiveVoices() == 0);
+        CHECK (peakOf (next.data[0], 0, kBlockSize) == 0.0f);
+    }
+}
@@ -0,0 +1,467 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "engine/TransportController.h"
+#include "engine/TrackProcessor.h"
+#include "dc/audio/AudioBlock.h"
+#include "dc/audio/AudioFileWriter.h"
+#include "dc/audio/SampleCache.h"
+#include "dc/engine/MidiBlock.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+namespace fs = std::filesystem;
+
+static constexpr int kBlockSize = 441;
+static constexpr double kSampleRate = 44100.0;
+
+namespace
+{
+
+struct TempDir
+{
+    fs::path path;
+
+    TempDir()
+    {
+        auto tmpl = (fs::temp_directory_path() / "dc_track_playlist_XXXXXX").string();
+        REQUIRE (mkdtemp (tmpl.data()) != nullptr);
+        path = tmpl;
+    }
+
+    ~TempDir()
+    {
+        std::error_code ec;
+        fs::remove_all (path, ec);
+    }
+};
+
+/// Mono WAV where sample i == i / scale, so positions can be read back
+fs::path writeIndexFile (const TempDir& tmp, const std::string& name, int numFrames, float scale)
+{
+    auto path = tmp.path / name;
+    std::vector<float> data (static_cast<size_t> (numFrames));
+    for (int i = 0; i < numFrames; ++i)
+        data[static_cast<size_t> (i)] = static_cast<float> (i) / scale;
+
+    auto writer = dc::AudioFileWriter::create (path, dc::AudioFileWriter::Format::WAV_32F, 1, kSampleRate);
+    writer->write (data.data(), numFrames);
+    writer->close();
+    return path;
+}
+
+/// Drives a TrackProcessor the way the audio callback does and records
+/// the left channel of everything it renders.
+struct Player
+{
+    dc::TransportController transport;
+    dc::TrackProcessor processor { transport };
+    std::vector<float> rendered;
+
+    explicit Player (bool prepared = true)
+    {
+        transport.setSampleRate (kSampleRate);
+        if (prepared)
+            processor.prepare (kSampleRate, kBlockSize);
+    }
+
+    /// Let the prefetcher open the clips around the playhead and fill them
+    void waitForStreams (int expected)
+    {
+        dc::MidiBlock midi;
+        float l[kBlockSize], r[kBlockSize];
+        float* ch[2] = { l, r };
+        dc::AudioBlock block (ch, 2, kBlockSize);
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds (2);
+        while (processor.getNumStreamingClips() < expected && std::chrono::steady_clock::now() < deadline)
+        {
+            processor.process (block, midi, kBlockSize);
+            std::this_thread::sleep_for (std::chrono::milliseconds (2));
+        }
+        std::this_thread::sleep_for (std::chrono::milliseconds (50));
+    }
+
+    /// Play numBlocks blocks, pacing at roughly real time when asked
+    void play (int numBlocks, bool realTime = false)
+    {
+        dc::MidiBlock midi;
+        float l[kBlockSize], r[kBlockSize];
+        float* ch[2] = { l, r };
+        dc::AudioBlock block (ch, 2, kBlockSize);
+
+        transport.play();
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            processor.process (block, midi, kBlockSize);
+            rendered.insert (rendered.end(), l, l + kBlockSize);
+            transport.advancePosition (kBlockSize);
+
+            if (realTime)
+                std::this_thread::sleep_for (std::chrono::microseconds (
+                    static_cast<int> (1.0e6 * kBlockSize / kSampleRate)));
+        }
+    }
+};
+
+} // anonymous namespace
+
+// ─── Placement and trim ─────────────────────────────────────────────────────
+
+TEST_CASE ("Track playlist: clips play at their start position from trimStart", "[integration][playlist]")
+{
+    TempDir tmp;
+    auto file = writeIndexFile (tmp, "a.wav", 20000, 100000.0f);
+
+    Player p;
+    dc::TrackProcessor::Clip clip;
+    clip.sourceFile = file;
+    clip.startPosition = 1000;
+    clip.sourceOffset = 5000;
+    clip.length = 2000;
+    p.processor.setClips ({ clip });
+
+    p.waitForStreams (1);
+    p.play (10);
+
+    // Silence before the clip and after it ends
+    CHECK (p.rendered[999] == 0.0f);
+    CHECK (p.rendered[3000] == 0.0f);
+
+    // Timeline 1000 plays source frame 5000
+    REQUIRE_THAT (p.rendered[1000], WithinAbs (5000.0 / 100000.0, 1e-6));
+    REQUIRE_THAT (p.rendered[2999], WithinAbs (6999.0 / 100000.0, 1e-6));
+    CHECK (p.processor.getUnderrunCount() == 0);
+}
+
+TEST_CASE ("Track playlist: several clips from different files", "[integration][playlist]")
+{
+    TempDir tmp;
+    auto a = writeIndexFile (tmp, "a.wav", 4000, 10000.0f);
+    auto b = writeIndexFile (tmp, "b.wav", 4000, -10000.0f);
+
+    Player p;
+    std::vector<dc::TrackProcessor::Clip> clips (2);
+    clips[0].sourceFile = b;
+    clips[0].startPosition = 3000;
+    clips[0].length = 1000;
+    clips[1].sourceFile = a;
+    clips[1].startPosition = 500;
+    clips[1].length = 1000;
+    clips[1].sourceOffset = 100;
+    p.processor.setClips (clips);
+
+    p.waitForStreams (2);
+    p.play (10);
+
+    REQUIRE_THAT (p.rendered[500], WithinAbs (0.01, 1e-6));
+    REQUIRE_THAT (p.rendered[3000], WithinAbs (0.0, 1e-6));
+    REQUIRE_THAT (p.rendered[3500], WithinAbs (-0.05, 1e-6));
+    CHECK (p.rendered[2000] == 0.0f);
+}
+
+TEST_CASE ("Track playlist: a file loaded before prepare is placed at the graph rate", "[integration][playlist]")
+{
+    TempDir tmp;
+    auto file = writeIndexFile (tmp, "a.wav", 4000, 10000.0f);
+
+    Player p (false);
+    REQUIRE (p.processor.loadFile (file));
+    CHECK (p.processor.getFileLengthInSamples() == 4000);
+
+    // Nothing opens until the rate is known
+    std::this_thread::sleep_for (std::chrono::milliseconds (50));
+    CHECK (p.processor.getNumStreamingClips() == 0);
+
+    // At twice the file rate the clip lasts twice as many samples
+    p.transport.setSampleRate (2.0 * kSampleRate);
+    p.processor.prepare (2.0 * kSampleRate, kBlockSize);
+    p.waitForStreams (1);
+    p.play (20);
+
+    REQUIRE_THAT (p.rendered[4000], WithinAbs (0.2, 1e-3));
+    CHECK (p.rendered[7900] != 0.0f);
+    CHECK (p.rendered[8100] == 0.0f);
+}
+
+// ─── Fades ──────────────────────────────────────────────────────────────────
+
+TEST_CASE ("Track playlist: fades apply linear ramps", "[integration][playlist]")
+{
+    TempDir tmp;
+    auto file = tmp.path / "dc.wav";
+    {
+        std::vector<float> ones (8000, 1.0f);
+        auto writer = dc::AudioFileWriter::create (file, dc::AudioFileWriter::Format::WAV_32F, 1, kSampleRate);
+        writer->write (ones.data(), 8000);
+        writer->close();
+    }
+
+    Player p;
+    dc::TrackProcessor::Clip clip;
+    clip.sourceFile = file;
+    clip.length = 4000;
+    clip.fadeInLength = 1000;
+    clip.fadeOutLength = 2000;
+    p.processor.setClips ({ clip });
+
+    p.waitForStreams (1);
+    p.play (10);
+
+    REQUIRE_THAT (p.rendered[0], WithinAbs (0.0, 1e-6));
+    REQUIRE_THAT (p.rendered[500], WithinAbs (0.5, 1e-5));
+    REQUIRE_THAT (p.rendered[1500], WithinAbs (1.0, 1e-6));
+    REQUIRE_THAT (p.rendered[2000], WithinAbs (1.0, 1e-6));
+    REQUIRE_THAT (p.rendered[3000], WithinAbs (0.5, 1e-5));
+    REQUIRE_THAT (p.rendered[3999], WithinAbs (1.0 / 2000.0, 1e-5));
+    CHECK (p.rendered[4000] == 0.0f);
+}
+
+TEST_CASE ("Track playlist: overlapping fades crossfade", "[integration][playlist]")
+{
+    TempDir tmp;
+    auto file = tmp.path / "dc.wav";
+    {
+        std::vector<float> ones (8000, 1.0f);
+        auto writer = dc::AudioFileWriter::create (file, dc::AudioFileWriter::Format::WAV_32F, 1, kSampleRate);
+        writer->write (ones.data(), 8000);
+        writer->close();
+    }
+
+    Player p;
+    std::vector<dc::TrackProcessor::Clip> clips (2);
+    clips[0].sourceFile = file;
+    clips[0].length = 3000;
+    clips[0].fadeOutLength = 1000;
+    clips[1].sourceFile = file;
+    clips[1].startPosition = 2000;
+    clips[1].length = 3000;
+    clips[1].fadeInLength = 1000;
+    p.processor.setClips (clips);
+
+    p.waitForStreams (2);
+    p.play (12);
+
+    // Linear fades of equal length sum to unity across the overlap
+    for (int i = 1500; i < 4500; i += 125)
+        REQUIRE_THAT (p.rendered[static_cast<size_t> (i)], WithinAbs (1.0, 1e-4));
+}
+
+// ─── Dense playlists ────────────────────────────────────────────────────────
+
+TEST_CASE ("Track playlist: many short clips stream without underruns", "[integration][playlist]")
+{
+    TempDir tmp;
+    auto file = writeIndexFile (tmp, "a.wav", 44100, 44100.0f);
+
+    // 100 clips of 300 frames every 441 frames, each from a different
+    // offset in the file
+    constexpr int kClips = 100;
+    Player p;
+    std::vector<dc::TrackProcessor::Clip> clips;
+    for (int i = 0; i < kClips; ++i)
+    {
+        dc::TrackProcessor::Clip c;
+        c.sourceFile = file;
+        c.startPosition = static_cast<int64_t> (i) * 441;
+        c.sourceOffset = static_cast<int64_t> ((i * 37) % 100) * 400;
+        c.length = 300;
+        clips.push_back (c);
+    }
+    p.processor.setClips (clips);
+
+    p.waitForStreams (kClips);
+    p.play (kClips + 2, true);
+
+    CHECK (p.processor.getUnderrunCount() == 0);
+
+    for (int i = 0; i < kClips; ++i)
+    {
+        auto t = static_cast<size_t> (i) * 441;
+        float expected = static_cast<float> (clips[static_cast<size_t> (i)].sourceOffset) / 44100.0f;
+        REQUIRE_THAT (p.rendered[t], WithinAbs (expected, 1e-6));
+        REQUIRE (p.rendered[t + 350] == 0.0f);
+    }
+}
+
+TEST_CASE ("Track playlist: more clips than fit the old fixed pool all start on time", "[integration][playlist]")
+{
+    TempDir tmp;
+    auto file = writeIndexFile (tmp, "a.wav", 4000, 100000.0f);
+
+    // 40 clips stacked at the same position, each one frame further into
+    // the file: every one needs a voice at once
+    constexpr int kClips = 40;
+    Player p;
+    std::vector<dc::TrackProcessor::Clip> clips (kClips);
+    for (int i = 0; i < kClips; ++i)
+    {
+        clips[static_cast<size_t> (i)].sourceFile = file;
+        clips[static_cast<size_t> (i)].startPosition = 1000;
+        clips[static_cast<size_t> (i)].sourceOffset = i;
+        clips[static_cast<size_t> (i)].length = 300;
+    }
+    p.processor.setClips (clips);
+
+    p.waitForStreams (kClips);
+    CHECK (p.processor.getNumStreamingClips() == kClips);
+    p.play (5);
+
+    // Sum of (100 + i) over the clips
+    REQUIRE_THAT (p.rendered[1100], WithinAbs ((kClips * 100.0 + kClips * (kClips - 1) / 2.0) / 100000.0, 1e-5));
+    CHECK (p.rendered[1350] == 0.0f);
+}
+
+// ─── Sample cache ───────────────────────────────────────────────────────────
+
+TEST_CASE ("Track playlist: cached and streamed clips render identically", "[integration][playlist]")
+{
+    TempDir tmp;
+    auto file = writeIndexFile (tmp, "a.wav", 8000, 10000.0f);
+
+    std::vector<dc::TrackProcessor::Clip> clips (3);
+    for (int i = 0; i < 3; ++i)
+    {
+        clips[static_cast<size_t> (i)].sourceFile = file;
+        clips[static_cast<size_t> (i)].startPosition = 500 + i * 1500;
+        clips[static_cast<size_t> (i)].sourceOffset = 1000 * i;
+        clips[static_cast<size_t> (i)].length = 1000;
+        clips[static_cast<size_t> (i)].fadeInLength = 100;
+    }
+
+    auto& cache = dc::SampleCache::getInstance();
+    auto defaultMaxBytes = cache.getMaxSampleBytes();
+    auto render = [&] (size_t maxBytes)
+    {
+        cache.setMaxSampleBytes (maxBytes);
+        cache.clear();
+
+        Player p;
+        p.processor.setClips (clips);
+        p.waitForStreams (3);
+        p.play (12);
+        return p.rendered;
+    };
+
+    auto streamed = render (0);
+    auto statsBefore = cache.getStats();
+    auto cached = render (defaultMaxBytes);
+    auto statsAfter = cache.getStats();
+    cache.setMaxSampleBytes (defaultMaxBytes);
+
+    // One load, then the other two clips share it
+    CHECK (statsAfter.misses - statsBefore.misses == 1);
+    CHECK (statsAfter.hits - statsBefore.hits >= 2);
+
+    REQUIRE (streamed.size() == cached.size());
+    for (size_t i = 0; i < streamed.size(); ++i)
+        REQUIRE (streamed[i] == cached[i]);
+
+    REQUIRE_THAT (cached[2100], WithinAbs (1100.0 / 10000.0, 1e-6));
+}
+
+// ─── Jumps ──────────────────────────────────────────────────────────────────
+
+namespace
+{
+
+/// Forces clips through DiskStreamer for the lifetime of the object
+struct StreamingOnly
+{
+    size_t saved = dc::SampleCache::getInstance().getMaxSampleBytes();
+    StreamingOnly()  { dc::SampleCache::getInstance().setMaxSampleBytes (0); }
+    ~StreamingOnly() { dc::SampleCache::getInstance().setMaxSampleBytes (saved); }
+};
+
+} // anonymous namespace
+
+TEST_CASE ("Track playlist: loop wraps play from pre-roll without gaps", "[integration][playlist]")
+{
+    TempDir tmp;
+    StreamingOnly streamingOnly;
+    auto file = writeIndexFile (tmp, "long.wav", 200000, 200000.0f);
+
+    Player p;
+    dc::TrackProcessor::Clip clip;
+    clip.sourceFile = file;
+    clip.length = 200000;
+    p.processor.setClips ({ clip });
+
+    constexpr int64_t loopStart = 10000;
+    constexpr int64_t loopEnd = 30000;
+    p.transport.setLoopStartInSamples (loopStart);
+    p.transport.setLoopEndInSamples (loopEnd);
+    p.transport.setLoopEnabled (true);
+    p.transport.setPositionInSamples (loopStart);
+
+    p.waitForStreams (1);
+    std::this_thread::sleep_for (std::chrono::milliseconds (100));
+
+    // Three passes round the loop
+    constexpr int kBlocks = 140;
+    p.play (kBlocks, true);
+
+    CHECK (p.processor.getUnderrunCount() == 0);
+
+    // The transport wraps between blocks; each block plays on from where it starts
+    int64_t pos = loopStart;
+    for (int b = 0; b < kBlocks; ++b)
+    {
+        for (int i = 0; i < kBlockSize; i += 20)
+        {
+            auto idx = static_cast<size_t> (b * kBlockSize + i);
+            REQUIRE_THAT (p.rendered[idx], WithinAbs (static_cast<double> (pos + i) / 200000.0, 1e-6));
+        }
+
+        pos += kBlockSize;
+        if (pos >= loopEnd)
+            pos = loopStart + (pos - loopEnd);
+    }
+}
+
+TEST_CASE ("Track playlist: jump to the edit cursor plays at once", "[integration][playlist]")
+{
+    TempDir tmp;
+    StreamingOnly streamingOnly;
+    auto a = writeIndexFile (tmp, "a.wav", 100000, 100000.0f);
+    auto b = writeIndexFile (tmp, "b.wav", 100000, -100000.0f);
+
+    Player p;
+    std::vector<dc::TrackProcessor::Clip> clips (2);
+    clips[0].sourceFile = a;
+    clips[0].length = 100000;
+    clips[1].sourceFile = b;
+    clips[1].startPosition = 1000000;
+    clips[1].sourceOffset = 2000;
+    clips[1].length = 50000;
+    p.processor.setClips (clips);
+
+    // The clip under the cursor is opened and parked although it is far
+    // from the playhead
+    p.transport.setEditCursorInSamples (1005000);
+    p.waitForStreams (2);
+    CHECK (p.processor.getNumStreamingClips() == 2);
+
+    p.play (20, true);
+    REQUIRE_THAT (p.rendered[100], WithinAbs (0.001, 1e-6));
+
+    // Jump: the very first block after it already has audio
+    p.transport.setPositionInSamples (1005000);
+    p.play (1);
+    REQUIRE_THAT (p.rendered[20 * kBlockSize], WithinAbs (-7000.0 / 100000.0, 1e-6));
+    REQUIRE_THAT (p.rendered[21 * kBlockSize - 1], WithinAbs (-(7000.0 + kBlockSize - 1) / 100000.0, 1e-6));
+
+    // Jump back into the first clip at the cursor position inside it
+    p.transport.setEditCursorInSamples (60000);
+    std::this_thread::sleep_for (std::chrono::milliseconds (200));
+    p.transport.setPositionInSamples (60000);
+    p.play (1);
+    REQUIRE_THAT (p.rendered[21 * kBlockSize], WithinAbs (0.6, 1e-6));
+
+    CHECK (p.processor.getUnderrunCount() == 0);
+}
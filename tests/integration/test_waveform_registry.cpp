@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+#include "graphics/rendering/WaveformRegistry.h"
+#include "dc/audio/AudioFileWriter.h"
+#include "dc/audio/PeakStore.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+struct TempDir
+{
+    fs::path path;
+
+    TempDir()
+    {
+        auto base = fs::temp_directory_path() / "dc_test_waveforms_XXXXXX";
+        auto tmpl = base.string();
+        REQUIRE (mkdtemp (tmpl.data()) != nullptr);
+        path = tmpl;
+
+        dc::PeakStore::getInstance().setDirectory (path / dc::PeakStore::directoryName);
+    }
+
+    ~TempDir()
+    {
+        dc::PeakStore::getInstance().setDirectory ({});
+        std::error_code ec;
+        fs::remove_all (path, ec);
+    }
+};
+
+fs::path writeSine (const fs::path& file, int64_t frames)
+{
+    auto writer = dc::AudioFileWriter::create (file, dc::AudioFileWriter::Format::WAV_32F, 1, 44100.0);
+    REQUIRE (writer != nullptr);
+
+    std::vector<float> data (static_cast<size_t> (frames));
+    for (int64_t i = 0; i < frames; ++i)
+        data[static_cast<size_t> (i)] = 0.5f * std::sin (static_cast<float> (i) * 0.01f);
+
+    writer->write (data.data(), frames);
+    writer->close();
+    return file;
+}
+
+bool waitUntilComplete (const dc::gfx::WaveformCache& cache)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds (10);
+    while (! cache.isComplete())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+        std::this_thread::sleep_for (std::chrono::milliseconds (2));
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE ("WaveformRegistry shares one cache per file and loads it in the background", "[integration][waveform]")
+{
+    TempDir tmp;
+    auto file = writeSine (tmp.path / "a.wav", 100000);
+
+    auto& registry = dc::gfx::WaveformRegistry::getInstance();
+
+    auto first = registry.get (file);
+    REQUIRE (first != nullptr);
+
+    // Same file, spelled differently: same cache
+    auto second = registry.get (tmp.path / "." / "a.wav");
+    CHECK (second == first);
+
+    registry.waitForLoads();
+    CHECK_FALSE (registry.hasPendingLoads());
+    REQUIRE (waitUntilComplete (*first));
+    CHECK_FALSE (first->isPending());
+    CHECK (first->getTotalSamples() == 100000);
+
+    const auto* lod = first->getLOD (100.0, 44100.0);
+    REQUIRE (lod != nullptr);
+    CHECK (lod->size > 0);
+
+    // Dropped once nobody holds it
+    first.reset();
+    second.reset();
+    CHECK (registry.getNumEntries() == 0);
+
+    auto third = registry.get (file);
+    CHECK (registry.getNumEntries() == 1);
+    registry.waitForLoads();
+    CHECK (third->isLoaded());
+}
+
+TEST_CASE ("WaveformRegistry adopts peaks loaded elsewhere", "[integration][waveform]")
+{
+    TempDir tmp;
+    auto file = writeSine (tmp.path / "b.wav", 5000);
+
+    auto peaks = std::make_shared<dc::gfx::WaveformCache>();
+    peaks->loadFromFile (file);
+    REQUIRE (peaks->isLoaded());
+
+    auto& registry = dc::gfx::WaveformRegistry::getInstance();
+    registry.add (file, peaks);
+
+    CHECK (registry.get (file) == peaks);
+}
+
+TEST_CASE ("WaveformRegistry reports unreadable files as not pending", "[integration][waveform]")
+{
+    TempDir tmp;
+
+    auto& registry = dc::gfx::WaveformRegistry::getInstance();
+    auto missing = registry.get (tmp.path / "missing.wav");
+    registry.waitForLoads();
+
+    CHECK_FALSE (missing->isPending());
+    CHECK_FALSE (missing->isLoaded());
+}
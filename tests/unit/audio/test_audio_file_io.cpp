@@ -9,6 +9,7 @@
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <thread>
 #include <vector>
 
 using Catch::Matchers::WithinAbs;
@@ -521,6 +522,84 @@ TEST_CASE("AudioFileReader getFormatName and getBitDepth", "[audio][fileio]")
     }
 }
 
+// ─── Shared handles ─────────────────────────────────────────────
+
+TEST_CASE("AudioFileReader openShared returns one handle per file", "[audio][fileio]")
+{
+    TempDir tmp;
+    auto pathA = tmp.file("a.wav");
+    auto pathB = tmp.file("b.wav");
+    auto sine = generateSine(1000, 44100.0, 440.0);
+
+    for (auto& path : { pathA, pathB })
+    {
+        auto writer = dc::AudioFileWriter::create(path, dc::AudioFileWriter::Format::WAV_32F, 1, 44100.0);
+        REQUIRE(writer != nullptr);
+        REQUIRE(writer->write(sine.data(), 1000));
+        writer->close();
+    }
+
+    auto first = dc::AudioFileReader::openShared(pathA);
+    auto second = dc::AudioFileReader::openShared(tmp.path / "." / "a.wav");
+    auto other = dc::AudioFileReader::openShared(pathB);
+    REQUIRE(first != nullptr);
+    REQUIRE(first == second);
+    REQUIRE(other != first);
+
+    // Once every holder is gone the next open gets a fresh handle
+    std::weak_ptr<dc::AudioFileReader> weak = first;
+    first.reset();
+    second.reset();
+    REQUIRE(weak.expired());
+    REQUIRE(dc::AudioFileReader::openShared(pathA) != nullptr);
+
+    REQUIRE(dc::AudioFileReader::openShared(tmp.file("missing.wav")) == nullptr);
+}
+
+TEST_CASE("AudioFileReader shared handle serves concurrent readers", "[audio][fileio]")
+{
+    TempDir tmp;
+    auto filepath = tmp.file("shared.wav");
+    const int numFrames = 48000;
+
+    std::vector<float> ramp(static_cast<size_t>(numFrames));
+    for (int i = 0; i < numFrames; ++i)
+        ramp[static_cast<size_t>(i)] = static_cast<float>(i) / static_cast<float>(numFrames);
+
+    {
+        auto writer = dc::AudioFileWriter::create(filepath, dc::AudioFileWriter::Format::WAV_32F, 1, 48000.0);
+        REQUIRE(writer != nullptr);
+        REQUIRE(writer->write(ramp.data(), numFrames));
+    }
+
+    auto reader = dc::AudioFileReader::openShared(filepath);
+    REQUIRE(reader != nullptr);
+
+    // Each thread reads its own interleaved positions; seeks must not mix
+    std::vector<int> mismatches(4, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&, t]
+        {
+            std::vector<float> buf(256);
+            for (int pos = t * 256; pos + 256 <= numFrames; pos += 1024)
+            {
+                reader->read(buf.data(), pos, 256);
+                for (int i = 0; i < 256; ++i)
+                    if (buf[static_cast<size_t>(i)] != ramp[static_cast<size_t>(pos + i)])
+                        ++mismatches[static_cast<size_t>(t)];
+            }
+        });
+    }
+
+    for (auto& th : threads)
+        th.join();
+
+    for (int m : mismatches)
+        REQUIRE(m == 0);
+}
+
 // ─── Writer create failure ──────────────────────────────────────
 
 TEST_CASE("AudioFileWriter create with invalid path returns nullptr", "[audio][fileio]")
@@ -0,0 +1,412 @@
+// Unit tests for dc::CaptureEngine
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <dc/audio/CaptureEngine.h>
+#include <dc/audio/AudioFileReader.h>
+#include <dc/audio/AudioBlock.h>
+#include <dc/audio/PeakStore.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+namespace fs = std::filesystem;
+
+// ─── Helpers ────────────────────────────────────────────────────
+
+namespace {
+
+struct TempDir
+{
+    fs::path path;
+
+    TempDir()
+    {
+        auto base = fs::temp_directory_path() / "dc_capture_test_XXXXXX";
+        auto tmpl = base.string();
+        REQUIRE(mkdtemp(tmpl.data()) != nullptr);
+        path = tmpl;
+
+        // Takes store their peak files; keep them out of the user's data
+        dc::PeakStore::getInstance().setDirectory(path / dc::PeakStore::directoryName);
+    }
+
+    ~TempDir()
+    {
+        dc::PeakStore::getInstance().setDirectory({});
+        std::error_code ec;
+        fs::remove_all(path, ec);
+    }
+
+    fs::path file(const std::string& name) const { return path / name; }
+};
+
+/// Multi-channel AudioBlock owning its samples
+struct Block
+{
+    std::vector<std::vector<float>> data;
+    std::vector<float*> channels;
+
+    Block(int numChannels, int numSamples)
+        : data(static_cast<size_t>(numChannels), std::vector<float>(static_cast<size_t>(numSamples), 0.0f))
+    {
+        for (auto& ch : data)
+            channels.push_back(ch.data());
+    }
+
+    dc::AudioBlock block()
+    {
+        return dc::AudioBlock(channels.data(), static_cast<int>(channels.size()),
+                              static_cast<int>(data[0].size()));
+    }
+};
+
+/// Distinct, exactly representable value per input, channel and frame
+float testValue(int input, int channel, int64_t frame)
+{
+    return static_cast<float>((frame + input * 7 + channel * 3) % 1024) / 2048.0f - 0.25f;
+}
+
+std::vector<uint8_t> readBytes(const fs::path& file)
+{
+    std::ifstream in(file, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+uint32_t le32(const std::vector<uint8_t>& b, size_t offset)
+{
+    return static_cast<uint32_t>(b[offset]) | (static_cast<uint32_t>(b[offset + 1]) << 8)
+         | (static_cast<uint32_t>(b[offset + 2]) << 16) | (static_cast<uint32_t>(b[offset + 3]) << 24);
+}
+
+} // anonymous namespace
+
+// ─── Multi-input round trip ─────────────────────────────────────
+
+TEST_CASE("CaptureEngine records several inputs to separate files", "[audio][capture]")
+{
+    TempDir tmp;
+    const double sampleRate = 48000.0;
+    const int blockSize = 256;
+    const int numBlocks = 200;
+    const int totalFrames = blockSize * numBlocks;
+
+    std::vector<dc::CaptureEngine::InputSpec> specs;
+    for (int i = 0; i < 4; ++i)
+        specs.push_back({ tmp.file("in" + std::to_string(i) + ".wav"), i % 2 + 1,
+                          dc::CaptureEngine::SampleFormat::float32 });
+
+    dc::CaptureEngine engine(1.0);
+    REQUIRE(engine.start(specs, sampleRate));
+    REQUIRE(engine.isRecording());
+    REQUIRE(engine.getNumInputs() == 4);
+
+    Block block(2, blockSize);
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        for (int input = 0; input < 4; ++input)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    block.data[static_cast<size_t>(ch)][static_cast<size_t>(i)] =
+                        testValue(input, ch, b * blockSize + i);
+            engine.write(input, block.block(), blockSize);
+        }
+
+        if (b % 16 == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    engine.stop();
+    REQUIRE_FALSE(engine.isRecording());
+
+    for (int input = 0; input < 4; ++input)
+    {
+        int numChannels = input % 2 + 1;
+        REQUIRE(engine.getRecordedFrames(input) == totalFrames);
+
+        auto reader = dc::AudioFileReader::open(specs[static_cast<size_t>(input)].file);
+        REQUIRE(reader != nullptr);
+        REQUIRE(reader->getNumChannels() == numChannels);
+        REQUIRE(reader->getLengthInSamples() == totalFrames);
+        REQUIRE_THAT(reader->getSampleRate(), WithinAbs(sampleRate, 0.1));
+
+        std::vector<float> interleaved(static_cast<size_t>(totalFrames * numChannels));
+        REQUIRE(reader->read(interleaved.data(), 0, totalFrames) == totalFrames);
+
+        bool allMatch = true;
+        for (int f = 0; f < totalFrames && allMatch; ++f)
+            for (int ch = 0; ch < numChannels; ++ch)
+                allMatch = allMatch
+                    && interleaved[static_cast<size_t>(f * numChannels + ch)] == testValue(input, ch, f);
+        REQUIRE(allMatch);
+    }
+
+    REQUIRE(engine.getMetrics().droppedFrames == 0);
+}
+
+// ─── File layout ────────────────────────────────────────────────
+
+TEST_CASE("CaptureEngine places sample data on a page boundary", "[audio][capture]")
+{
+    TempDir tmp;
+    auto filepath = tmp.file("layout.wav");
+
+    dc::CaptureEngine engine;
+    REQUIRE(engine.start({ { filepath, 3, dc::CaptureEngine::SampleFormat::int24 } }, 44100.0));
+
+    Block block(3, 1001);
+    engine.write(0, block.block(), 1001);
+    engine.stop();
+
+    auto bytes = readBytes(filepath);
+    size_t dataBytes = 1001 * 3 * 3;
+
+    REQUIRE(bytes.size() == 4096 + dataBytes + 1);      // odd size is padded
+    REQUIRE(std::memcmp(bytes.data(), "RIFF", 4) == 0);
+    REQUIRE(le32(bytes, 4) == bytes.size() - 8);
+    REQUIRE(std::memcmp(bytes.data() + 4088, "data", 4) == 0);
+    REQUIRE(le32(bytes, 4092) == dataBytes);
+}
+
+TEST_CASE("CaptureEngine file is readable while recording", "[audio][capture]")
+{
+    TempDir tmp;
+    auto filepath = tmp.file("live.wav");
+    const double sampleRate = 8000.0;
+
+    dc::CaptureEngine engine(1.0);
+    REQUIRE(engine.start({ { filepath, 1, dc::CaptureEngine::SampleFormat::int16 } }, sampleRate));
+
+    // Several chunks' worth, then wait for the periodic header update
+    Block block(1, 400);
+    for (int i = 0; i < 40; ++i)
+    {
+        engine.write(0, block.block(), 400);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    auto deadline = std::chrono::steady_clock::now()
+                  + std::chrono::duration<double>(dc::CaptureEngine::headerUpdateSeconds + 2.0);
+    uint32_t headerBytes = 0;
+    while (headerBytes == 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        headerBytes = le32(readBytes(filepath), 4092);
+    }
+
+    // What the header claims is on disk, in whole frames
+    REQUIRE(headerBytes > 0);
+    REQUIRE(headerBytes % 2 == 0);
+    REQUIRE(static_cast<int64_t>(headerBytes / 2) <= engine.getRecordedFrames(0));
+
+    engine.stop();
+    REQUIRE(le32(readBytes(filepath), 4092) == 40 * 400 * 2);
+}
+
+// ─── Restart ────────────────────────────────────────────────────
+
+TEST_CASE("CaptureEngine restarts while the audio thread keeps writing", "[audio][capture]")
+{
+    TempDir tmp;
+    dc::CaptureEngine engine(0.1);
+    std::atomic<bool> running{true};
+
+    // Writes to inputs that come and go as the takes change
+    std::thread audio([&]
+    {
+        Block block(2, 64);
+        while (running.load())
+            for (int input = 0; input < 3; ++input)
+                engine.write(input, block.block(), 64);
+    });
+
+    for (int take = 0; take < 20; ++take)
+    {
+        std::vector<dc::CaptureEngine::InputSpec> specs;
+        for (int i = 0; i <= take % 3; ++i)
+            specs.push_back({ tmp.file("t" + std::to_string(take) + "_" + std::to_string(i) + ".wav"), 2,
+                              dc::CaptureEngine::SampleFormat::int16 });
+
+        REQUIRE(engine.start(specs, 8000.0));
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        engine.stop();
+
+        auto reader = dc::AudioFileReader::open(specs.front().file);
+        REQUIRE(reader != nullptr);
+        CHECK(reader->getLengthInSamples() == engine.getRecordedFrames(0));
+    }
+
+    running.store(false);
+    audio.join();
+}
+
+// ─── Overflow ───────────────────────────────────────────────────
+
+TEST_CASE("CaptureEngine counts frames dropped on ring overflow", "[audio][capture]")
+{
+    TempDir tmp;
+    const double sampleRate = 1000.0;
+
+    // 0.1 s ring rounds up to 128 frames
+    dc::CaptureEngine engine(0.1);
+    REQUIRE(engine.start({ { tmp.file("over.wav"), 1, dc::CaptureEngine::SampleFormat::float32 } },
+                         sampleRate));
+
+    // Faster than the writer can possibly drain it
+    Block block(1, 1000);
+    engine.write(0, block.block(), 1000);
+
+    auto metrics = engine.getMetrics();
+    REQUIRE(metrics.droppedFrames == 1000 - 128);
+    REQUIRE(metrics.minHeadroom == 0.0);
+    REQUIRE(metrics.minHeadroomSeconds == 0.0);
+
+    engine.stop();
+    REQUIRE(engine.getRecordedFrames(0) == 128);
+}
+
+// ─── Metrics ────────────────────────────────────────────────────
+
+TEST_CASE("CaptureEngine reports throughput and headroom", "[audio][capture]")
+{
+    TempDir tmp;
+    const double sampleRate = 96000.0;
+    const int numInputs = 8;
+
+    std::vector<dc::CaptureEngine::InputSpec> specs;
+    for (int i = 0; i < numInputs; ++i)
+        specs.push_back({ tmp.file("m" + std::to_string(i) + ".wav"), 1,
+                          dc::CaptureEngine::SampleFormat::int24 });
+
+    dc::CaptureEngine engine;
+    REQUIRE(engine.start(specs, sampleRate));
+
+    // Half a second of audio, written in real-time-sized blocks
+    Block block(1, 480);
+    for (int b = 0; b < 100; ++b)
+        for (int i = 0; i < numInputs; ++i)
+            engine.write(i, block.block(), 480);
+
+    engine.stop();
+
+    auto metrics = engine.getMetrics();
+    REQUIRE(metrics.droppedFrames == 0);
+    REQUIRE(metrics.bytesWritten == numInputs * 48000 * 3);
+    REQUIRE(metrics.writes >= numInputs);
+    REQUIRE_THAT(metrics.requiredBytesPerSecond, WithinAbs(numInputs * 96000.0 * 3, 0.5));
+    REQUIRE(metrics.diskBytesPerSecond > 0.0);
+    REQUIRE(metrics.getDiskLoad() > 0.0);
+    REQUIRE(metrics.minHeadroom > 0.0);
+    REQUIRE(metrics.minHeadroom < 1.0);
+    REQUIRE(metrics.minHeadroomSeconds > 0.0);
+}
+
+// ─── Formats ────────────────────────────────────────────────────
+
+TEST_CASE("CaptureEngine 16- and 24-bit output round trips within quantisation", "[audio][capture]")
+{
+    TempDir tmp;
+    const int numFrames = 5000;
+
+    dc::CaptureEngine engine;
+    REQUIRE(engine.start({ { tmp.file("a16.wav"), 1, dc::CaptureEngine::SampleFormat::int16 },
+                           { tmp.file("a24.wav"), 1, dc::CaptureEngine::SampleFormat::int24 } },
+                         44100.0));
+
+    Block block(1, numFrames);
+    for (int i = 0; i < numFrames; ++i)
+        block.data[0][static_cast<size_t>(i)] = testValue(0, 0, i);
+    engine.write(0, block.block(), numFrames);
+    engine.write(1, block.block(), numFrames);
+    engine.stop();
+
+    const float tolerance[] = { 1.0f / 32767.0f, 1.0f / 8388607.0f };
+    const char* names[] = { "a16.wav", "a24.wav" };
+    for (int f = 0; f < 2; ++f)
+    {
+        auto reader = dc::AudioFileReader::open(tmp.file(names[f]));
+        REQUIRE(reader != nullptr);
+        REQUIRE(reader->getLengthInSamples() == numFrames);
+
+        std::vector<float> readBack(static_cast<size_t>(numFrames));
+        REQUIRE(reader->read(readBack.data(), 0, numFrames) == numFrames);
+
+        for (int i = 0; i < numFrames; ++i)
+            REQUIRE_THAT(readBack[static_cast<size_t>(i)], WithinAbs(testValue(0, 0, i), tolerance[f]));
+    }
+}
+
+// ─── Lifecycle ──────────────────────────────────────────────────
+
+TEST_CASE("CaptureEngine stop without start and write after stop are harmless", "[audio][capture]")
+{
+    TempDir tmp;
+    dc::CaptureEngine engine;
+    engine.stop();
+
+    REQUIRE_FALSE(engine.start({}, 44100.0));
+
+    REQUIRE(engine.start({ { tmp.file("x.wav"), 1, dc::CaptureEngine::SampleFormat::float32 } }, 44100.0));
+    engine.stop();
+
+    Block block(1, 64);
+    engine.write(0, block.block(), 64);
+    engine.write(5, block.block(), 64);
+    REQUIRE(engine.getRecordedFrames(0) == 0);
+}
+
+// ─── Live peaks ─────────────────────────────────────────────────
+
+TEST_CASE("CaptureEngine stores a peak file for every take", "[audio][capture]")
+{
+    TempDir tmp;
+    const int blockSize = 256;
+    const int numBlocks = 100;
+
+    std::vector<dc::CaptureEngine::InputSpec> specs {
+        { tmp.file("a.wav"), 2, dc::CaptureEngine::SampleFormat::float32 },
+        { tmp.file("b.wav"), 1, dc::CaptureEngine::SampleFormat::int24 },
+    };
+
+    dc::CaptureEngine engine;
+    REQUIRE(engine.start(specs, 48000.0));
+
+    Block block(2, blockSize);
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        for (int input = 0; input < 2; ++input)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int f = 0; f < blockSize; ++f)
+                    block.data[static_cast<size_t>(ch)][static_cast<size_t>(f)]
+                        = testValue(input, ch, b * blockSize + f);
+            engine.write(input, block.block(), blockSize);
+        }
+    }
+
+    engine.stop();
+
+    for (int input = 0; input < 2; ++input)
+    {
+        auto peaks = engine.getPeaks(input);
+        REQUIRE(peaks != nullptr);
+        REQUIRE(peaks->isComplete());
+        REQUIRE(peaks->getFramesDone() == engine.getRecordedFrames(input));
+
+        auto file = dc::PeakStore::getInstance().find(specs[static_cast<size_t>(input)].file);
+        REQUIRE(file != nullptr);
+        REQUIRE(file->getNumChannels() == specs[static_cast<size_t>(input)].numChannels);
+        REQUIRE(file->getLengthInFrames() == engine.getRecordedFrames(input));
+    }
+
+    REQUIRE(engine.getPeaks(2) == nullptr);
+}
@@ -0,0 +1,202 @@
+// Unit tests for dc::DecodeCache
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <dc/audio/DecodeCache.h>
+#include <dc/audio/DiskStreamer.h>
+#include <dc/audio/AudioFileWriter.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct TempDir
+{
+    fs::path path;
+
+    TempDir()
+    {
+        auto base = fs::temp_directory_path() / "dc_decode_cache_test_XXXXXX";
+        auto tmpl = base.string();
+        REQUIRE(mkdtemp(tmpl.data()) != nullptr);
+        path = tmpl;
+    }
+
+    ~TempDir()
+    {
+        std::error_code ec;
+        fs::remove_all(path, ec);
+    }
+};
+
+/// Stereo file where frame i holds (i, -i) / 2^20
+fs::path writeRamp(const TempDir& tmp, const std::string& name, int64_t numFrames)
+{
+    auto file = tmp.path / name;
+    std::vector<float> data(static_cast<size_t>(numFrames * 2));
+    for (int64_t i = 0; i < numFrames; ++i)
+    {
+        data[static_cast<size_t>(i * 2)] = static_cast<float>(i) / 1048576.0f;
+        data[static_cast<size_t>(i * 2 + 1)] = -static_cast<float>(i) / 1048576.0f;
+    }
+
+    auto writer = dc::AudioFileWriter::create(file, dc::AudioFileWriter::Format::WAV_32F, 2, 44100.0);
+    REQUIRE(writer != nullptr);
+    writer->write(data.data(), numFrames);
+    writer->close();
+    return file;
+}
+
+void checkRamp(const std::vector<float>& buffer, int64_t startFrame, int64_t frames)
+{
+    for (int64_t f = 0; f < frames; f += 97)
+    {
+        float expected = static_cast<float>(startFrame + f) / 1048576.0f;
+        REQUIRE_THAT(buffer[static_cast<size_t>(f * 2)], WithinAbs(expected, 1e-9));
+        REQUIRE_THAT(buffer[static_cast<size_t>(f * 2 + 1)], WithinAbs(-expected, 1e-9));
+    }
+}
+
+bool waitFor(const std::function<bool()>& condition)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (! condition())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+TEST_CASE("DecodeCache reads across block boundaries", "[audio][decode_cache]")
+{
+    TempDir tmp;
+    const int64_t length = dc::DecodeCache::blockFrames * 3 + 1000;
+    auto reader = dc::AudioFileReader::openShared(writeRamp(tmp, "a.wav", length));
+    REQUIRE(reader != nullptr);
+
+    dc::DecodeCache cache(64u * 1024u * 1024u, 1);
+    cache.setReadAheadBlocks(0);
+
+    // Straddles blocks 0 and 1
+    const int64_t start = dc::DecodeCache::blockFrames - 500;
+    std::vector<float> buffer(2000 * 2);
+    REQUIRE(cache.read(reader, buffer.data(), start, 2000) == 2000);
+    checkRamp(buffer, start, 2000);
+
+    auto stats = cache.getStats();
+    CHECK(stats.misses == 2);
+    CHECK(stats.numBlocks == 2);
+    CHECK(stats.residentBytes == static_cast<size_t>(2 * dc::DecodeCache::blockFrames * 2) * sizeof(float));
+
+    // Rereading, or seeking anywhere inside decoded blocks, decodes nothing
+    REQUIRE(cache.read(reader, buffer.data(), 10, 1000) == 1000);
+    checkRamp(buffer, 10, 1000);
+    CHECK(cache.getStats().misses == 2);
+    CHECK(cache.getStats().hits == 1);
+
+    // The tail is short
+    REQUIRE(cache.read(reader, buffer.data(), length - 300, 2000) == 300);
+    checkRamp(buffer, length - 300, 300);
+    CHECK(cache.read(reader, buffer.data(), length, 100) == 0);
+}
+
+TEST_CASE("DecodeCache decodes ahead on its workers", "[audio][decode_cache]")
+{
+    TempDir tmp;
+    auto reader = dc::AudioFileReader::openShared(writeRamp(tmp, "b.wav", dc::DecodeCache::blockFrames * 4));
+    REQUIRE(reader != nullptr);
+
+    dc::DecodeCache cache(64u * 1024u * 1024u, 2);
+    REQUIRE(cache.getNumThreads() == 2);
+    cache.setReadAheadBlocks(2);
+
+    std::vector<float> buffer(1024 * 2);
+    REQUIRE(cache.read(reader, buffer.data(), 0, 1024) == 1024);
+
+    // Blocks 1 and 2 follow without the reader decoding them
+    REQUIRE(waitFor([&] { return cache.getStats().decodedAhead == 2; }));
+    REQUIRE(cache.read(reader, buffer.data(), dc::DecodeCache::blockFrames * 2 + 7, 1024) == 1024);
+    checkRamp(buffer, dc::DecodeCache::blockFrames * 2 + 7, 1024);
+
+    auto stats = cache.getStats();
+    CHECK(stats.misses == 1);
+    CHECK(stats.hits == 1);
+
+    // Prefetch brings in the rest before it is asked for
+    cache.prefetch(reader, dc::DecodeCache::blockFrames * 3, 10);
+    REQUIRE(waitFor([&] { return cache.getStats().numBlocks == 4; }));
+}
+
+TEST_CASE("DecodeCache evicts least recently used blocks over budget", "[audio][decode_cache]")
+{
+    TempDir tmp;
+    auto reader = dc::AudioFileReader::openShared(writeRamp(tmp, "c.wav", dc::DecodeCache::blockFrames * 4));
+    REQUIRE(reader != nullptr);
+
+    const size_t blockBytes = static_cast<size_t>(dc::DecodeCache::blockFrames * 2) * sizeof(float);
+    dc::DecodeCache cache(blockBytes * 2, 1);
+    cache.setReadAheadBlocks(0);
+
+    std::vector<float> buffer(16 * 2);
+    for (int64_t b : { 0, 1, 0, 2 })
+        REQUIRE(cache.read(reader, buffer.data(), b * dc::DecodeCache::blockFrames, 16) == 16);
+
+    auto stats = cache.getStats();
+    CHECK(stats.numBlocks == 2);
+    CHECK(stats.evictions == 1);
+    CHECK(stats.residentBytes <= blockBytes * 2);
+
+    // Block 1 was the least recently used
+    cache.read(reader, buffer.data(), 0, 16);
+    CHECK(cache.getStats().hits == 2);
+    cache.read(reader, buffer.data(), dc::DecodeCache::blockFrames, 16);
+    CHECK(cache.getStats().misses == 4);
+
+    cache.clear();
+    CHECK(cache.getStats().numBlocks == 0);
+    CHECK(cache.getStats().residentBytes == 0);
+}
+
+TEST_CASE("DiskStreamer plays through a DecodeCache", "[audio][decode_cache]")
+{
+    TempDir tmp;
+    const int64_t length = dc::DecodeCache::blockFrames * 2;
+    auto file = writeRamp(tmp, "d.wav", length);
+
+    dc::DecodeCache cache(64u * 1024u * 1024u, 1);
+    dc::DiskStreamer streamer(16384);
+    streamer.setDecodeCache(&cache, true);
+    REQUIRE(streamer.open(file));
+    REQUIRE(streamer.isDecodingAhead());
+
+    streamer.seek(dc::DecodeCache::blockFrames - 100);
+    streamer.start();
+
+    std::vector<float> left(512), right(512);
+    float* channels[] = { left.data(), right.data() };
+    dc::AudioBlock block(channels, 2, 512);
+
+    int got = 0;
+    REQUIRE(waitFor([&] { got = streamer.read(block, 512); return got == 512; }));
+    REQUIRE_THAT(left[0], WithinAbs(static_cast<float>(dc::DecodeCache::blockFrames - 100) / 1048576.0f, 1e-9));
+    REQUIRE_THAT(right[511], WithinAbs(-static_cast<float>(dc::DecodeCache::blockFrames + 411) / 1048576.0f, 1e-9));
+
+    streamer.stop();
+    CHECK(cache.getStats().numBlocks >= 2);
+
+    // PCM files read directly unless asked otherwise
+    dc::DiskStreamer plain(16384);
+    REQUIRE(plain.open(file));
+    CHECK_FALSE(plain.isDecodingAhead());
+}
@@ -191,6 +191,46 @@ TEST_CASE("DiskStreamer seek to middle reads from correct position", "[audio][st
     streamer.stop();
 }
 
+TEST_CASE("DiskStreamer never plays old ring audio after a seek", "[audio][streamer]")
+{
+    TempDir tmp;
+    const int numFrames = 65536;
+    auto filepath = writeTestFile(tmp, "streamer_reseek.wav", numFrames, 44100.0);
+
+    dc::DiskStreamer streamer(4096);
+    REQUIRE(streamer.open(filepath));
+    streamer.start();
+
+    const int chunkSize = 128;
+    std::vector<float> ch0(static_cast<size_t>(chunkSize), 0.0f);
+    float* channels[] = { ch0.data() };
+    dc::AudioBlock block(channels, 1, chunkSize);
+
+    // Seek while the ring is full of audio from elsewhere, then read at
+    // once: whatever arrives must continue from the target
+    for (int i = 0; i < 50; ++i)
+    {
+        int64_t target = (static_cast<int64_t>(i) * 7919) % (numFrames - 8192);
+        streamer.seek(target);
+
+        int64_t expected = target;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+        while (expected < target + 1024 && std::chrono::steady_clock::now() < deadline)
+        {
+            int got = streamer.read(block, chunkSize);
+            for (int f = 0; f < got; ++f, ++expected)
+                REQUIRE_THAT(ch0[static_cast<size_t>(f)],
+                             WithinAbs(static_cast<float>(expected) / static_cast<float>(numFrames), 1e-6));
+
+            if (got == 0)
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        REQUIRE(expected >= target + 1024);
+    }
+
+    streamer.stop();
+}
+
 // ─── seek past EOF ──────────────────────────────────────────────
 
 TEST_CASE("DiskStreamer seek past EOF results in no data", "[audio][streamer]")
@@ -332,3 +372,100 @@ TEST_CASE("DiskStreamer destructor stops background thread cleanly", "[audio][st
     // If we get here without hanging, the test passes
     REQUIRE(true);
 }
+
+// ─── Pre-roll ───────────────────────────────────────────────────
+
+TEST_CASE("DiskStreamer seek into a pre-roll point plays at once", "[audio][streamer]")
+{
+    TempDir tmp;
+    const int numFrames = 200000;
+    auto filepath = writeTestFile(tmp, "preroll.wav", numFrames, 44100.0);
+
+    dc::DiskStreamer streamer(16384);
+    REQUIRE(streamer.open(filepath));
+    streamer.setPrerollPoints({ 0, 100000, 150000 });
+    streamer.start();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (streamer.getNumPrerollPointsReady() < 3 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    REQUIRE(streamer.getNumPrerollPointsReady() == 3);
+
+    const int chunkSize = 512;
+    std::vector<float> ch0(static_cast<size_t>(chunkSize));
+    float* channels[] = { ch0.data() };
+    dc::AudioBlock block(channels, 1, chunkSize);
+
+    // No wait between the seek and the read: the data comes from memory
+    streamer.seek(100100);
+    REQUIRE(streamer.read(block, chunkSize) == chunkSize);
+    CHECK(streamer.getPrerollHitCount() == 1);
+    for (int i = 0; i < chunkSize; ++i)
+        REQUIRE_THAT(ch0[static_cast<size_t>(i)],
+                     WithinAbs(static_cast<float>(100100 + i) / numFrames, 1e-6));
+
+    // Read through the end of the pre-roll into the ring, which caught up
+    // behind it
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    int64_t pos = 100100 + chunkSize;
+    const int prerollEnd = 100000 + static_cast<int>(std::ceil(dc::DiskStreamer::prerollSeconds * 44100.0));
+    while (pos < prerollEnd + 4 * chunkSize)
+    {
+        REQUIRE(streamer.read(block, chunkSize) == chunkSize);
+        for (int i = 0; i < chunkSize; i += 17)
+            REQUIRE_THAT(ch0[static_cast<size_t>(i)],
+                         WithinAbs(static_cast<float>(pos + i) / numFrames, 1e-6));
+        pos += chunkSize;
+    }
+
+    // A seek elsewhere is a plain ring seek
+    streamer.seek(50000);
+    CHECK(streamer.getPrerollHitCount() == 1);
+
+    streamer.stop();
+}
+
+TEST_CASE("DiskStreamer pre-roll follows moved points and resampling", "[audio][streamer]")
+{
+    TempDir tmp;
+    const int numFrames = 44100;
+    auto filepath = writeTestFile(tmp, "preroll_sr.wav", numFrames, 44100.0);
+
+    dc::DiskStreamer streamer(16384);
+    streamer.setOutputSampleRate(48000.0);
+    REQUIRE(streamer.open(filepath));
+    streamer.setPrerollPoints({ 1000 });
+    streamer.start();
+
+    auto waitReady = [&]
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (streamer.getNumPrerollPointsReady() < 1 && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    };
+    waitReady();
+
+    // Move the point; the old position stops hitting once it's redecoded
+    streamer.setPrerollPoints({ 24000 });
+    waitReady();
+
+    const int chunkSize = 256;
+    std::vector<float> ch0(static_cast<size_t>(chunkSize));
+    float* channels[] = { ch0.data() };
+    dc::AudioBlock block(channels, 1, chunkSize);
+
+    streamer.seek(24000);
+    REQUIRE(streamer.read(block, chunkSize) == chunkSize);
+    CHECK(streamer.getPrerollHitCount() == 1);
+
+    // Output frame n is file time n * 44100 / 48000
+    for (int i = 0; i < chunkSize; i += 7)
+        REQUIRE_THAT(ch0[static_cast<size_t>(i)],
+                     WithinAbs((24000 + i) * (44100.0 / 48000.0) / numFrames, 1e-4));
+
+    streamer.seek(1000);
+    CHECK(streamer.getPrerollHitCount() == 1);
+
+    streamer.stop();
+}
@@ -0,0 +1,272 @@
+// Unit tests for dc::PeakFile, dc::PeakAccumulator, dc::LivePeaks and dc::PeakStore
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <dc/audio/LivePeaks.h>
+#include <dc/audio/PeakFile.h>
+#include <dc/audio/PeakStore.h>
+#include <dc/audio/AudioFileWriter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct TempDir
+{
+    fs::path path;
+
+    TempDir()
+    {
+        auto base = fs::temp_directory_path() / "dc_peak_file_test_XXXXXX";
+        auto tmpl = base.string();
+        REQUIRE(mkdtemp(tmpl.data()) != nullptr);
+        path = tmpl;
+    }
+
+    ~TempDir()
+    {
+        std::error_code ec;
+        fs::remove_all(path, ec);
+    }
+};
+
+/// Stereo test signal: a sine on the left, its negated square on the right
+std::vector<float> makeSignal(int64_t numFrames)
+{
+    std::vector<float> data(static_cast<size_t>(numFrames * 2));
+    for (int64_t i = 0; i < numFrames; ++i)
+    {
+        auto v = static_cast<float>(std::sin(static_cast<double>(i) * 0.0123) * (0.25 + 0.5 * (i % 7) / 7.0));
+        data[static_cast<size_t>(i * 2)] = v;
+        data[static_cast<size_t>(i * 2 + 1)] = -v * v;
+    }
+    return data;
+}
+
+struct Expected
+{
+    float min, max, rms;
+};
+
+/// Bucket of one channel computed straight from the samples
+Expected direct(const std::vector<float>& data, int channel, int64_t start, int64_t end)
+{
+    Expected e { data[static_cast<size_t>(start * 2 + channel)], data[static_cast<size_t>(start * 2 + channel)], 0.0f };
+    double sumSquares = 0.0;
+    for (int64_t i = start; i < end; ++i)
+    {
+        float v = data[static_cast<size_t>(i * 2 + channel)];
+        e.min = std::min(e.min, v);
+        e.max = std::max(e.max, v);
+        sumSquares += static_cast<double>(v) * v;
+    }
+    e.rms = static_cast<float>(std::sqrt(sumSquares / static_cast<double>(end - start)));
+    return e;
+}
+
+void checkAgainstSignal(const dc::PeakFile& peaks, const std::vector<float>& data, int64_t numFrames)
+{
+    for (int level = 0; level < dc::PeakFile::numLevels; ++level)
+    {
+        auto spb = dc::PeakFile::samplesPerBucket(level);
+        REQUIRE(peaks.getNumBuckets(level) == (numFrames + spb - 1) / spb);
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            const auto* minMax = peaks.getMinMax(level, ch);
+            const auto* rms = peaks.getRms(level, ch);
+            REQUIRE(minMax != nullptr);
+            REQUIRE(rms != nullptr);
+
+            for (int64_t b = 0; b < peaks.getNumBuckets(level); ++b)
+            {
+                auto e = direct(data, ch, b * spb, std::min((b + 1) * spb, numFrames));
+                REQUIRE(minMax[b].min == e.min);
+                REQUIRE(minMax[b].max == e.max);
+                REQUIRE_THAT(rms[b], WithinAbs(e.rms, 1e-5));
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+TEST_CASE("PeakAccumulator pyramid matches peaks computed from samples", "[audio][peaks]")
+{
+    // Not a multiple of any bucket size, so every level ends on a partial bucket
+    const int64_t numFrames = 300000;
+    auto data = makeSignal(numFrames);
+
+    TempDir tmp;
+    auto peaks = dc::PeakFile::create(tmp.path / "signal.peaks", {}, 2, 48000.0, numFrames);
+    REQUIRE(peaks != nullptr);
+
+    dc::PeakAccumulator accumulator(2, [&](int level, int channel, int64_t bucket, dc::PeakFile::MinMax mm, float rms)
+    {
+        peaks->store(level, channel, bucket, mm, rms);
+    });
+
+    // Uneven chunks, as a recorder would deliver them
+    for (int64_t pos = 0; pos < numFrames;)
+    {
+        auto n = std::min<int64_t>(1000 + pos % 777, numFrames - pos);
+        accumulator.add(data.data() + pos * 2, n);
+        pos += n;
+    }
+    accumulator.finish();
+
+    REQUIRE(accumulator.getFramesAdded() == numFrames);
+    checkAgainstSignal(*peaks, data, numFrames);
+}
+
+TEST_CASE("PeakFile round-trips through disk and rejects a stale source", "[audio][peaks]")
+{
+    const int64_t numFrames = 70000;
+    auto data = makeSignal(numFrames);
+
+    TempDir tmp;
+    auto path = tmp.path / "roundtrip.peaks";
+    dc::PeakFile::SourceStamp stamp { 1234, 5678 };
+
+    {
+        auto peaks = dc::PeakFile::create(path, stamp, 2, 44100.0, numFrames);
+        REQUIRE(peaks != nullptr);
+
+        dc::PeakAccumulator accumulator(2, [&](int level, int channel, int64_t bucket, dc::PeakFile::MinMax mm, float rms)
+        {
+            peaks->store(level, channel, bucket, mm, rms);
+        });
+        accumulator.add(data.data(), numFrames);
+        accumulator.finish();
+
+        // Not visible under its real name until finished
+        REQUIRE(dc::PeakFile::open(path, stamp) == nullptr);
+        REQUIRE(peaks->finish());
+        REQUIRE(peaks->isComplete());
+    }
+
+    auto mapped = dc::PeakFile::open(path, stamp);
+    REQUIRE(mapped != nullptr);
+    REQUIRE(mapped->isComplete());
+    REQUIRE(mapped->getNumChannels() == 2);
+    REQUIRE(mapped->getLengthInFrames() == numFrames);
+    REQUIRE(mapped->getSampleRate() == 44100.0);
+    checkAgainstSignal(*mapped, data, numFrames);
+
+    REQUIRE(dc::PeakFile::open(path, { 1234, 5679 }) == nullptr);
+    REQUIRE(dc::PeakFile::open(path, { 1235, 5678 }) == nullptr);
+}
+
+TEST_CASE("PeakFile exposes only the buckets built so far", "[audio][peaks]")
+{
+    const int64_t numFrames = 100000;
+    auto data = makeSignal(numFrames);
+
+    TempDir tmp;
+    auto peaks = dc::PeakFile::create(tmp.path / "partial.peaks", {}, 2, 44100.0, numFrames);
+    REQUIRE(peaks != nullptr);
+
+    dc::PeakAccumulator accumulator(2, [&](int level, int channel, int64_t bucket, dc::PeakFile::MinMax mm, float rms)
+    {
+        peaks->store(level, channel, bucket, mm, rms);
+    });
+
+    accumulator.add(data.data(), 5000);
+    peaks->setFramesDone(accumulator.getFramesAdded());
+
+    REQUIRE_FALSE(peaks->isComplete());
+    REQUIRE(peaks->getNumBucketsReady(0) == 5000 / 256);
+    REQUIRE(peaks->getNumBucketsReady(1) == 5000 / 1024);
+    REQUIRE(peaks->getNumBucketsReady(3) == 0);
+
+    auto e = direct(data, 0, 256 * 18, 256 * 19);
+    REQUIRE(peaks->getMinMax(0, 0)[18].max == e.max);
+
+    accumulator.add(data.data() + 5000 * 2, numFrames - 5000);
+    accumulator.finish();
+    REQUIRE(peaks->finish());
+    REQUIRE(peaks->getNumBucketsReady(3) == peaks->getNumBuckets(3));
+}
+
+TEST_CASE("PeakStore builds a peak file once and maps it afterwards", "[audio][peaks]")
+{
+    const int64_t numFrames = 200000;
+    auto data = makeSignal(numFrames);
+
+    TempDir tmp;
+    auto audio = tmp.path / "take.wav";
+    {
+        auto writer = dc::AudioFileWriter::create(audio, dc::AudioFileWriter::Format::WAV_32F, 2, 48000.0);
+        REQUIRE(writer != nullptr);
+        writer->write(data.data(), numFrames);
+        writer->close();
+    }
+
+    dc::PeakStore store;
+    store.setDirectory(tmp.path / "peaks");
+    REQUIRE(store.find(audio) == nullptr);
+
+    auto peaks = store.acquire(audio);
+    REQUIRE(peaks != nullptr);
+    REQUIRE(peaks->isComplete());
+    REQUIRE(fs::exists(store.getPeakPath(audio)));
+    checkAgainstSignal(*peaks, data, numFrames);
+
+    // Same mapping while anyone holds it; a fresh one from disk afterwards
+    REQUIRE(store.find(audio) == peaks);
+    peaks.reset();
+    auto reopened = store.request(audio);
+    REQUIRE(reopened != nullptr);
+    REQUIRE(reopened->isComplete());
+
+    // A pool entry's peak file is named by its content hash
+    std::string hash(64, 'a');
+    REQUIRE(store.getPeakPath(tmp.path / "media" / "aa" / (hash + ".wav"))
+            == tmp.path / "peaks" / (hash + ".peaks"));
+}
+
+TEST_CASE("LivePeaks grows while appending and writes a complete peak file", "[audio][peaks]")
+{
+    const int64_t numFrames = 123457;
+    auto data = makeSignal(numFrames);
+
+    dc::LivePeaks live(2, 48000.0);
+
+    const dc::PeakFile::MinMax* early = nullptr;
+    for (int64_t pos = 0; pos < numFrames;)
+    {
+        auto n = std::min<int64_t>(4096, numFrames - pos);
+        live.add(data.data() + pos * 2, n);
+        pos += n;
+
+        REQUIRE(live.getFramesDone() == pos);
+        REQUIRE(live.getNumBucketsReady(0, 0) == pos / 256);
+        if (early == nullptr && live.getNumBucketsReady(0, 0) > 0)
+            early = live.getMinMax(0, 0);
+    }
+
+    // Arrays handed out before the bucket arrays grew are still readable
+    REQUIRE(early != nullptr);
+    REQUIRE(early[0].max == direct(data, 0, 0, 256).max);
+    REQUIRE_FALSE(live.isComplete());
+
+    live.finish();
+    REQUIRE(live.isComplete());
+    REQUIRE(live.getNumBucketsReady(0, 1) == (numFrames + 255) / 256);
+
+    TempDir tmp;
+    dc::PeakFile::SourceStamp stamp { 1, 2 };
+    auto written = live.writePeakFile(tmp.path / "take.peaks", stamp);
+    REQUIRE(written != nullptr);
+
+    auto mapped = dc::PeakFile::open(tmp.path / "take.peaks", stamp);
+    REQUIRE(mapped != nullptr);
+    checkAgainstSignal(*mapped, data, numFrames);
+}
@@ -0,0 +1,286 @@
+// Unit tests for dc::Resampler and DiskStreamer sample-rate conversion
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <dc/audio/Resampler.h>
+#include <dc/audio/DiskStreamer.h>
+#include <dc/audio/AudioFileReader.h>
+#include <dc/audio/AudioFileWriter.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+namespace fs = std::filesystem;
+
+// ─── Helpers ────────────────────────────────────────────────────
+
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586;
+
+struct TempDir
+{
+    fs::path path;
+
+    TempDir()
+    {
+        auto tmpl = (fs::temp_directory_path() / "dc_resampler_test_XXXXXX").string();
+        REQUIRE(mkdtemp(tmpl.data()) != nullptr);
+        path = tmpl;
+    }
+
+    ~TempDir()
+    {
+        std::error_code ec;
+        fs::remove_all(path, ec);
+    }
+};
+
+std::vector<float> sine(double freq, double rate, int numFrames)
+{
+    std::vector<float> v(static_cast<size_t>(numFrames));
+    for (int i = 0; i < numFrames; ++i)
+        v[static_cast<size_t>(i)] = static_cast<float>(std::sin(kTwoPi * freq * i / rate));
+    return v;
+}
+
+/// Mono conversion of a whole buffer in one go
+std::vector<float> convert(const std::vector<float>& in, double inRate, double outRate,
+                           dc::Resampler::Quality q)
+{
+    dc::Resampler r(1, inRate, outRate, q);
+    std::vector<float> out(static_cast<size_t>(r.getOutputLength(static_cast<int64_t>(in.size()))) + 16);
+
+    const float* inPtr = in.data();
+    float* outPtr = out.data();
+    int n = r.process(&inPtr, static_cast<int>(in.size()), &outPtr, static_cast<int>(out.size()));
+    out.resize(static_cast<size_t>(n));
+    return out;
+}
+
+/// Amplitude of a sinusoid at freq over [start, end), Hann-windowed so
+/// that stronger tones elsewhere do not leak into the estimate
+double toneAmplitude(const std::vector<float>& x, double freq, double rate, size_t start, size_t end)
+{
+    double s = 0.0, c = 0.0, wsum = 0.0;
+    double n = static_cast<double>(end - start);
+    for (size_t i = start; i < end; ++i)
+    {
+        double w = 0.5 - 0.5 * std::cos(kTwoPi * static_cast<double>(i - start) / n);
+        s += w * x[i] * std::sin(kTwoPi * freq * static_cast<double>(i) / rate);
+        c += w * x[i] * std::cos(kTwoPi * freq * static_cast<double>(i) / rate);
+        wsum += w;
+    }
+    return 2.0 * std::sqrt(s * s + c * c) / wsum;
+}
+
+double rms(const std::vector<float>& x, size_t start, size_t end)
+{
+    double sum = 0.0;
+    for (size_t i = start; i < end; ++i)
+        sum += static_cast<double>(x[i]) * x[i];
+    return std::sqrt(sum / static_cast<double>(end - start));
+}
+
+double toDb(double gain) { return 20.0 * std::log10(std::max(gain, 1e-12)); }
+
+} // anonymous namespace
+
+// ─── Frequency response ─────────────────────────────────────────
+
+TEST_CASE("Resampler passband is flat", "[audio][resampler]")
+{
+    constexpr double inRate = 44100.0;
+    constexpr double outRate = 48000.0;
+
+    for (double freq : {100.0, 1000.0, 5000.0, 10000.0, 15000.0, 17500.0})
+    {
+        auto out = convert(sine(freq, inRate, 44100), inRate, outRate, dc::Resampler::Quality::standard);
+        REQUIRE(out.size() > 40000);
+
+        double gainDb = toDb(toneAmplitude(out, freq, outRate, 1000, 40000));
+        INFO("freq " << freq << " Hz, gain " << gainDb << " dB");
+        CHECK(std::abs(gainDb) < 0.05);
+    }
+}
+
+TEST_CASE("Resampler rejects content above the output Nyquist", "[audio][resampler]")
+{
+    // 23 kHz at 48 kHz would fold to 21.1 kHz at 44.1 kHz
+    constexpr double inRate = 48000.0;
+    constexpr double outRate = 44100.0;
+    auto in = sine(23000.0, inRate, 48000);
+
+    auto standard = convert(in, inRate, outRate, dc::Resampler::Quality::standard);
+    auto high = convert(in, inRate, outRate, dc::Resampler::Quality::high);
+
+    double standardDb = toDb(rms(standard, 1000, 40000) * std::sqrt(2.0));
+    double highDb = toDb(rms(high, 1000, 40000) * std::sqrt(2.0));
+    INFO("standard " << standardDb << " dB, high " << highDb << " dB");
+
+    CHECK(standardDb < -80.0);
+    CHECK(highDb < -100.0);
+}
+
+TEST_CASE("Resampler upsampling images are suppressed", "[audio][resampler]")
+{
+    // A 20 kHz tone at 44.1 kHz upsampled to 96 kHz must not produce the
+    // 24.1 kHz image
+    constexpr double inRate = 44100.0;
+    constexpr double outRate = 96000.0;
+    auto out = convert(sine(20000.0, inRate, 44100), inRate, outRate, dc::Resampler::Quality::high);
+
+    double image = toneAmplitude(out, inRate - 20000.0, outRate, 2000, 90000);
+    CHECK(toDb(image) < -90.0);
+}
+
+TEST_CASE("Resampler keeps DC at unity and sizes output by ratio", "[audio][resampler]")
+{
+    std::vector<float> ones(10000, 1.0f);
+    for (auto q : {dc::Resampler::Quality::draft, dc::Resampler::Quality::standard,
+                   dc::Resampler::Quality::high})
+    {
+        auto out = convert(ones, 48000.0, 44100.0, q);
+        for (size_t i = 500; i < out.size() - 500; i += 37)
+            REQUIRE_THAT(out[i], WithinAbs(1.0, 1e-4));
+    }
+
+    dc::Resampler r(2, 44100.0, 48000.0);
+    CHECK(r.getOutputLength(44100) == 48000);
+    CHECK(r.getNumTaps() % 8 == 0);
+}
+
+// ─── Streaming ──────────────────────────────────────────────────
+
+TEST_CASE("Resampler output does not depend on chunking", "[audio][resampler]")
+{
+    auto in = sine(1234.5, 44100.0, 20000);
+    auto oneShot = convert(in, 44100.0, 48000.0, dc::Resampler::Quality::standard);
+
+    dc::Resampler r(1, 44100.0, 48000.0);
+    std::vector<float> chunked;
+    std::vector<float> buf(4096);
+    float* outPtr = buf.data();
+
+    size_t pos = 0;
+    int chunk = 1;
+    while (pos < in.size())
+    {
+        int n = static_cast<int>(std::min<size_t>(static_cast<size_t>(chunk), in.size() - pos));
+        const float* inPtr = in.data() + pos;
+        int produced = r.process(&inPtr, n, &outPtr, 4096);
+        chunked.insert(chunked.end(), buf.begin(), buf.begin() + produced);
+        pos += static_cast<size_t>(n);
+        chunk = chunk * 3 % 997 + 1;
+    }
+
+    REQUIRE(chunked.size() == oneShot.size());
+    for (size_t i = 0; i < chunked.size(); ++i)
+        REQUIRE(chunked[i] == oneShot[i]);
+}
+
+TEST_CASE("Resampler getInputFramesNeeded is exact", "[audio][resampler]")
+{
+    dc::Resampler r(1, 44100.0, 48000.0);
+    std::vector<float> in(8192, 0.5f), out(8192);
+    float* outPtr = out.data();
+
+    for (int request : {1, 7, 512, 1000, 3333})
+    {
+        int need = r.getInputFramesNeeded(request);
+        const float* inPtr = in.data();
+        int produced = 0;
+
+        // One frame short falls short of the request; the last frame completes it
+        if (need > 0)
+        {
+            produced = r.process(&inPtr, need - 1, &outPtr, request);
+            CHECK(produced < request);
+            inPtr = in.data() + need - 1;
+        }
+        produced += r.process(&inPtr, need > 0 ? 1 : 0, &outPtr, request - produced);
+        CHECK(produced == request);
+    }
+}
+
+// ─── DiskStreamer integration ───────────────────────────────────
+
+TEST_CASE("DiskStreamer converts file rate to the output rate", "[audio][resampler]")
+{
+    TempDir tmp;
+    auto path = tmp.path / "tone_44k1.wav";
+    constexpr double fileRate = 44100.0;
+    constexpr double freq = 441.0;
+    {
+        auto data = sine(freq, fileRate, 44100);
+        auto writer = dc::AudioFileWriter::create(path, dc::AudioFileWriter::Format::WAV_32F, 1, fileRate);
+        writer->write(data.data(), 44100);
+        writer->close();
+    }
+
+    dc::DiskStreamer streamer(65536);
+    streamer.setOutputSampleRate(48000.0);
+    REQUIRE(streamer.open(path));
+    CHECK(streamer.isResampling());
+    CHECK(streamer.getSampleRate() == 48000.0);
+    CHECK(streamer.getLengthInSamples() == 48000);
+
+    // Seek mid-file: output frame n must be the tone at n / 48000 s
+    constexpr int seekPos = 24000;
+    streamer.seek(seekPos);
+    streamer.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::vector<float> out(2048);
+    float* ch[1] = {out.data()};
+    dc::AudioBlock block(ch, 1, 2048);
+    REQUIRE(streamer.read(block, 2048) == 2048);
+
+    for (int i = 0; i < 2048; i += 11)
+    {
+        double expected = std::sin(kTwoPi * freq * (seekPos + i) / 48000.0);
+        REQUIRE_THAT(out[static_cast<size_t>(i)], WithinAbs(expected, 1e-3));
+    }
+
+    streamer.stop();
+}
+
+TEST_CASE("Resampler::convertFile writes a session-rate copy", "[audio][resampler]")
+{
+    TempDir tmp;
+    auto src = tmp.path / "src.wav";
+    auto dst = tmp.path / "dst.wav";
+    {
+        auto data = sine(1000.0, 96000.0, 96000);
+        auto writer = dc::AudioFileWriter::create(src, dc::AudioFileWriter::Format::WAV_32F, 1, 96000.0);
+        writer->write(data.data(), 96000);
+        writer->close();
+    }
+
+    std::atomic<float> progress{0.0f};
+    REQUIRE(dc::Resampler::convertFile(src, dst, 48000.0, dc::Resampler::Quality::high, &progress));
+    CHECK(progress.load() == 1.0f);
+
+    auto reader = dc::AudioFileReader::open(dst);
+    REQUIRE(reader != nullptr);
+    CHECK(reader->getSampleRate() == 48000.0);
+    CHECK(reader->getLengthInSamples() == 48000);
+
+    std::vector<float> data(48000);
+    reader->read(data.data(), 0, 48000);
+    // Away from the abrupt start and end of the tone, which ring
+    for (int i = 200; i < 47800; i += 101)
+        REQUIRE_THAT(data[static_cast<size_t>(i)],
+                     WithinAbs(std::sin(kTwoPi * 1000.0 * i / 48000.0), 1e-3));
+
+    // Cancelled conversions leave nothing behind
+    std::atomic<bool> cancel{true};
+    CHECK_FALSE(dc::Resampler::convertFile(src, tmp.path / "cancelled.wav", 48000.0,
+                                           dc::Resampler::Quality::high, nullptr, &cancel));
+    CHECK_FALSE(fs::exists(tmp.path / "cancelled.wav"));
+}
@@ -0,0 +1,262 @@
+// Unit tests for dc::SampleCache
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <dc/audio/SampleCache.h>
+#include <dc/audio/AudioFileWriter.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+namespace fs = std::filesystem;
+
+// ─── Helpers ────────────────────────────────────────────────────
+
+namespace {
+
+struct TempDir
+{
+    fs::path path;
+
+    TempDir()
+    {
+        auto tmpl = (fs::temp_directory_path() / "dc_sample_cache_test_XXXXXX").string();
+        REQUIRE(mkdtemp(tmpl.data()) != nullptr);
+        path = tmpl;
+    }
+
+    ~TempDir()
+    {
+        std::error_code ec;
+        fs::remove_all(path, ec);
+    }
+};
+
+/// Interleaved file where channel c of frame i holds (i + c * 0.5) / scale
+fs::path writeRamp(const TempDir& tmp, const std::string& name, int numChannels, int numFrames,
+                   dc::AudioFileWriter::Format format = dc::AudioFileWriter::Format::WAV_32F,
+                   double sampleRate = 44100.0)
+{
+    auto path = tmp.path / name;
+    std::vector<float> data(static_cast<size_t>(numFrames * numChannels));
+    for (int i = 0; i < numFrames; ++i)
+        for (int c = 0; c < numChannels; ++c)
+            data[static_cast<size_t>(i * numChannels + c)] = (static_cast<float>(i) + 0.5f * c) / 65536.0f;
+
+    auto writer = dc::AudioFileWriter::create(path, format, numChannels, sampleRate);
+    REQUIRE(writer != nullptr);
+    writer->write(data.data(), numFrames);
+    writer->close();
+    return path;
+}
+
+} // anonymous namespace
+
+// ─── Loading ────────────────────────────────────────────────────
+
+TEST_CASE("SampleCache maps float WAV and decodes other formats", "[audio][sample_cache]")
+{
+    TempDir tmp;
+    auto floatFile = writeRamp(tmp, "f.wav", 2, 1000);
+    auto intFile = writeRamp(tmp, "i.wav", 2, 1000, dc::AudioFileWriter::Format::WAV_16);
+
+    dc::SampleCache cache;
+    auto mapped = cache.acquire(floatFile);
+    auto decoded = cache.acquire(intFile);
+    REQUIRE(mapped != nullptr);
+    REQUIRE(decoded != nullptr);
+
+    CHECK(mapped->isMapped());
+    CHECK_FALSE(decoded->isMapped());
+    CHECK(mapped->getNumFrames() == 1000);
+    CHECK(decoded->getNumFrames() == 1000);
+    CHECK(mapped->getNumChannels() == 2);
+    CHECK(mapped->getSampleRate() == 44100.0);
+
+    REQUIRE_THAT(mapped->getData()[2 * 500 + 1], WithinAbs(500.5 / 65536.0, 1e-9));
+    REQUIRE_THAT(decoded->getData()[2 * 500], WithinAbs(500.0 / 65536.0, 1e-4));
+
+    auto stats = cache.getStats();
+    CHECK(stats.numEntries == 2);
+    CHECK(stats.mappedBytes >= 8000);
+    CHECK(stats.residentBytes >= stats.mappedBytes + 8000);
+}
+
+TEST_CASE("SampleCache shares one copy and counts hits", "[audio][sample_cache]")
+{
+    TempDir tmp;
+    auto file = writeRamp(tmp, "a.wav", 1, 500);
+
+    dc::SampleCache cache;
+    auto a = cache.acquire(file);
+    auto b = cache.acquire(file);
+    auto c = cache.acquire(tmp.path / "." / "a.wav");
+
+    CHECK(a == b);
+    CHECK(a == c);
+
+    auto stats = cache.getStats();
+    CHECK(stats.misses == 1);
+    CHECK(stats.hits == 2);
+    CHECK_THAT(stats.getHitRate(), WithinAbs(2.0 / 3.0, 1e-9));
+}
+
+TEST_CASE("SampleCache rejects files over the size threshold", "[audio][sample_cache]")
+{
+    TempDir tmp;
+    auto file = writeRamp(tmp, "long.wav", 2, 10000);
+
+    dc::SampleCache cache(1 << 20, 10000 * 2 * sizeof(float) - 1);
+    CHECK(cache.acquire(file) == nullptr);
+    CHECK(cache.acquire(file) == nullptr);
+    CHECK(cache.acquire(tmp.path / "missing.wav") == nullptr);
+
+    auto stats = cache.getStats();
+    CHECK(stats.uncacheable == 3);
+    CHECK(stats.misses == 0);
+    CHECK(stats.residentBytes == 0);
+
+    cache.setMaxSampleBytes(10000 * 2 * sizeof(float));
+    CHECK(cache.acquire(file) != nullptr);
+}
+
+TEST_CASE("SampleCache reloads a file modified on disk", "[audio][sample_cache]")
+{
+    TempDir tmp;
+    auto file = writeRamp(tmp, "a.wav", 1, 500);
+
+    dc::SampleCache cache;
+    auto before = cache.acquire(file);
+    REQUIRE(before != nullptr);
+
+    writeRamp(tmp, "a.wav", 1, 800);
+    fs::last_write_time(file, fs::last_write_time(file) + std::chrono::seconds(2));
+
+    auto after = cache.acquire(file);
+    REQUIRE(after != nullptr);
+    CHECK(after != before);
+    CHECK(after->getNumFrames() == 800);
+    CHECK(before->getNumFrames() == 500);   // still valid for its holder
+    CHECK(cache.getStats().numEntries == 1);
+}
+
+TEST_CASE("SampleCache stops handing out a mapping whose file was truncated", "[audio][sample_cache]")
+{
+    TempDir tmp;
+    auto file = writeRamp(tmp, "a.wav", 1, 4096);
+
+    dc::SampleCache cache;
+    auto before = cache.acquire(file);
+    REQUIRE(before != nullptr);
+    REQUIRE(before->isMapped());
+    CHECK_FALSE(before->isTruncated());
+
+    // Shrinking the same inode would fault on the lost pages
+    fs::resize_file(file, 1024);
+    CHECK(before->isTruncated());
+
+    auto after = cache.acquire(file);
+    REQUIRE(after != nullptr);
+    CHECK(after != before);
+    CHECK(after->getNumFrames() < 1024 / static_cast<int64_t>(sizeof(float)));
+    CHECK_FALSE(after->isTruncated());
+
+    // Replacing the file by rename leaves the mapped inode whole
+    auto replacement = writeRamp(tmp, "b.wav", 1, 100);
+    fs::rename(replacement, file);
+    CHECK_FALSE(after->isTruncated());
+}
+
+TEST_CASE("SampleCache converts to the requested rate", "[audio][sample_cache]")
+{
+    TempDir tmp;
+    auto file = writeRamp(tmp, "a.wav", 2, 44100);
+
+    dc::SampleCache cache;
+    auto native = cache.acquire(file);
+    auto converted = cache.acquire(file, 48000.0);
+    REQUIRE(native != nullptr);
+    REQUIRE(converted != nullptr);
+
+    CHECK(native != converted);
+    CHECK_FALSE(converted->isMapped());
+    CHECK(converted->getSampleRate() == 48000.0);
+    CHECK(converted->getNumFrames() == 48000);
+
+    // A ramp stays a ramp: output frame n lands at input n * 44100 / 48000
+    REQUIRE_THAT(converted->getData()[2 * 24000], WithinAbs(22050.0 / 65536.0, 1e-4));
+}
+
+// ─── Budget ─────────────────────────────────────────────────────
+
+TEST_CASE("SampleCache evicts least recently used entries over budget", "[audio][sample_cache]")
+{
+    TempDir tmp;
+    std::vector<fs::path> files;
+    for (int i = 0; i < 4; ++i)
+        files.push_back(writeRamp(tmp, "f" + std::to_string(i) + ".wav", 1, 10000,
+                                  dc::AudioFileWriter::Format::WAV_16));
+
+    // Room for three 40 kB samples
+    dc::SampleCache cache(3 * 40000 + 1000);
+
+    auto held = cache.acquire(files[0]);
+    cache.acquire(files[1]);
+    cache.acquire(files[2]);
+    cache.acquire(files[1]);          // refresh
+    cache.acquire(files[3]);          // over budget: evict files[2] (files[0] is held)
+
+    auto stats = cache.getStats();
+    CHECK(stats.evictions == 1);
+    CHECK(stats.numEntries == 3);
+    CHECK(stats.residentBytes <= cache.getMemoryBudget());
+
+    auto missesBefore = stats.misses;
+    CHECK(cache.acquire(files[0]) == held);
+    cache.acquire(files[1]);
+    CHECK(cache.getStats().misses == missesBefore);
+
+    cache.acquire(files[2]);
+    CHECK(cache.getStats().misses == missesBefore + 1);
+
+    // Shrinking the budget evicts at once, but never a held sample
+    cache.setMemoryBudget(0);
+    CHECK(cache.getStats().numEntries == 1);
+    CHECK(held->getNumFrames() == 10000);
+}
+
+// ─── Reading ────────────────────────────────────────────────────
+
+TEST_CASE("CachedSample::read de-interleaves and pads with silence", "[audio][sample_cache]")
+{
+    TempDir tmp;
+    auto stereo = writeRamp(tmp, "s.wav", 2, 100);
+    auto mono = writeRamp(tmp, "m.wav", 1, 100);
+
+    dc::SampleCache cache;
+    auto s = cache.acquire(stereo);
+    auto m = cache.acquire(mono);
+    REQUIRE(s != nullptr);
+    REQUIRE(m != nullptr);
+
+    float l[16], r[16];
+    float* ch[2] = {l, r};
+    dc::AudioBlock block(ch, 2, 16);
+
+    // Straddles the end of the file
+    CHECK(s->read(block, 90, 16) == 10);
+    REQUIRE_THAT(l[0], WithinAbs(90.0 / 65536.0, 1e-9));
+    REQUIRE_THAT(r[0], WithinAbs(90.5 / 65536.0, 1e-9));
+    CHECK(l[10] == 0.0f);
+    CHECK(r[15] == 0.0f);
+
+    // Straddles the start; mono fills both channels
+    CHECK(m->read(block, -4, 16) == 12);
+    CHECK(l[3] == 0.0f);
+    REQUIRE_THAT(l[4], WithinAbs(0.0, 1e-9));
+    REQUIRE_THAT(l[5], WithinAbs(1.0 / 65536.0, 1e-9));
+    CHECK(r[5] == l[5]);
+}
@@ -4,6 +4,7 @@
 #include <dc/audio/ThreadedRecorder.h>
 #include <dc/audio/AudioFileReader.h>
 #include <dc/audio/AudioBlock.h>
+#include <dc/audio/PeakStore.h>
 
 #include <chrono>
 #include <cmath>
@@ -30,10 +31,14 @@ struct TempDir
         auto tmpl = base.string();
         REQUIRE(mkdtemp(tmpl.data()) != nullptr);
         path = tmpl;
+
+        // Takes store their peak files; keep them out of the user's data
+        dc::PeakStore::getInstance().setDirectory(path / dc::PeakStore::directoryName);
     }
 
     ~TempDir()
     {
+        dc::PeakStore::getInstance().setDirectory({});
         std::error_code ec;
         fs::remove_all(path, ec);
     }
@@ -333,3 +338,48 @@ TEST_CASE("ThreadedRecorder can be re-used after stop", "[audio][recorder]")
     REQUIRE(reader2->getLengthInSamples() == 512);
     REQUIRE_THAT(reader2->getSampleRate(), WithinAbs(48000.0, 0.1));
 }
+
+// ─── Live peaks ─────────────────────────────────────────────────
+
+TEST_CASE("ThreadedRecorder builds the take's peaks while recording", "[audio][recorder]")
+{
+    TempDir tmp;
+    auto filepath = tmp.file("take.wav");
+    const int blockSize = 512;
+    const int numBlocks = 40;
+
+    dc::ThreadedRecorder recorder(16384);
+    REQUIRE(recorder.start(filepath, dc::AudioFileWriter::Format::WAV_32F, 1, 44100.0));
+
+    auto peaks = recorder.getPeaks();
+    REQUIRE(peaks != nullptr);
+
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        MonoBlock block(blockSize, b % 2 == 0 ? 0.5f : -0.25f);
+        recorder.write(block.block(), blockSize);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Peaks grow with what has been written, before the take ends
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (peaks->getNumBucketsReady(0) == 0 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    REQUIRE(peaks->getNumBucketsReady(0) > 0);
+    REQUIRE_FALSE(peaks->isComplete());
+
+    recorder.stop();
+
+    REQUIRE(peaks->isComplete());
+    REQUIRE(peaks->getFramesDone() == blockSize * numBlocks);
+    REQUIRE(peaks->getNumBucketsReady(0) == blockSize * numBlocks / 256);
+
+    // The finished take already has a complete peak file
+    auto& store = dc::PeakStore::getInstance();
+    auto file = store.find(filepath);
+    REQUIRE(file != nullptr);
+    REQUIRE(file->isComplete());
+    REQUIRE(fs::exists(store.getPeakPath(filepath)));
+    REQUIRE(file->getMinMax(0, 0)[0].max == 0.5f);
+    REQUIRE(file->getMinMax(0, 0)[2].min == -0.25f);
+}
@@ -119,3 +119,18 @@ TEST_CASE("MessageQueue multiple processAll cycles", "[foundation][message_queue
     mq.processAll();
     REQUIRE(counter == 111);
 }
+
+TEST_CASE("MessageQueue wakes only when the queue becomes non-empty", "[foundation][message_queue]")
+{
+    dc::MessageQueue mq;
+    int wakes = 0;
+    mq.setWakeCallback([&] { ++wakes; });
+
+    mq.post([] {});
+    mq.post([] {});
+    REQUIRE(wakes == 1);
+
+    mq.processAll();
+    mq.post([] {});
+    REQUIRE(wakes == 2);
+}
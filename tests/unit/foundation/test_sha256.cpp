@@ -0,0 +1,53 @@
+#include <catch2/catch_test_macros.hpp>
+#include <dc/foundation/sha256.h>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+TEST_CASE("sha256 matches FIPS 180-4 test vectors", "[foundation][sha256]")
+{
+    REQUIRE(dc::sha256Hex("")
+            == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    REQUIRE(dc::sha256Hex("abc")
+            == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    REQUIRE(dc::sha256Hex("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")
+            == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    REQUIRE(dc::sha256Hex(std::string(1000000, 'a'))
+            == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+TEST_CASE("sha256 incremental updates match a single update", "[foundation][sha256]")
+{
+    std::string data;
+    for (int i = 0; i < 1000; ++i)
+        data += static_cast<char>(i * 31);
+
+    // Split at every offset around the 64-byte block boundaries
+    for (size_t split : { size_t(0), size_t(1), size_t(55), size_t(56), size_t(63),
+                          size_t(64), size_t(65), size_t(127), size_t(999) })
+    {
+        dc::Sha256 hasher;
+        hasher.update(data.data(), split);
+        hasher.update(data.data() + split, data.size() - split);
+        REQUIRE(dc::Sha256::toHex(hasher.finish()) == dc::sha256Hex(data));
+    }
+}
+
+TEST_CASE("sha256 of a file matches the hash of its contents", "[foundation][sha256]")
+{
+    auto path = std::filesystem::temp_directory_path() / "dc_sha256_test.bin";
+    std::string content(3 * 1024 * 1024 + 17, '\0');
+    for (size_t i = 0; i < content.size(); ++i)
+        content[i] = static_cast<char>((i * 2654435761u) >> 24);
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(content.data(), static_cast<std::streamsize>(content.size()));
+    }
+
+    REQUIRE(dc::sha256HexOfFile(path) == dc::sha256Hex(content));
+    std::filesystem::remove(path);
+
+    REQUIRE(dc::sha256HexOfFile(path).empty());
+}
@@ -0,0 +1,313 @@
+// Unit tests for dc::MidiFile
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <dc/midi/MidiFile.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+void appendBE32(std::vector<uint8_t>& v, uint32_t x)
+{
+    v.push_back(static_cast<uint8_t>(x >> 24));
+    v.push_back(static_cast<uint8_t>(x >> 16));
+    v.push_back(static_cast<uint8_t>(x >> 8));
+    v.push_back(static_cast<uint8_t>(x));
+}
+
+/// Build a minimal SMF image from raw track bodies
+std::vector<uint8_t> makeSmf(uint16_t format, uint16_t division,
+                             const std::vector<std::vector<uint8_t>>& tracks)
+{
+    std::vector<uint8_t> v = {'M', 'T', 'h', 'd', 0, 0, 0, 6};
+    v.push_back(0);
+    v.push_back(static_cast<uint8_t>(format));
+    v.push_back(0);
+    v.push_back(static_cast<uint8_t>(tracks.size()));
+    v.push_back(static_cast<uint8_t>(division >> 8));
+    v.push_back(static_cast<uint8_t>(division));
+
+    for (auto& t : tracks)
+    {
+        v.insert(v.end(), {'M', 'T', 'r', 'k'});
+        appendBE32(v, static_cast<uint32_t>(t.size()));
+        v.insert(v.end(), t.begin(), t.end());
+    }
+    return v;
+}
+
+} // anonymous namespace
+
+// ─── Parsing ────────────────────────────────────────────────────
+
+TEST_CASE("MidiFile parses running status and meta events", "[midi][file]")
+{
+    // Type 0, 480 ticks/beat
+    std::vector<uint8_t> track = {
+        0x00, 0xFF, 0x03, 0x04, 'L', 'e', 'a', 'd',         // track name
+        0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20,           // 500000 us = 120 bpm
+        0x00, 0xFF, 0x58, 0x04, 0x03, 0x02, 0x18, 0x08,     // 3/4
+        0x00, 0x90, 60, 100,                                 // note on
+        0x00, 64, 90,                                        // running status
+        0x83, 0x60, 60, 0,                                   // 480 ticks later, vel 0 = off
+        0x00, 64, 0,
+        0x81, 0x70, 0xFF, 0x51, 0x03, 0x0F, 0x42, 0x40,     // 240 ticks later: 60 bpm
+        0x00, 0xFF, 0x2F, 0x00
+    };
+
+    auto bytes = makeSmf(0, 480, {track});
+    auto file = dc::MidiFile::readFromMemory(bytes.data(), bytes.size());
+    REQUIRE(file != nullptr);
+    REQUIRE(file->getNumTracks() == 1);
+    CHECK(file->getTicksPerQuarterNote() == 480);
+
+    const auto& t = file->getTrack(0);
+    CHECK(t.name == "Lead");
+    REQUIRE(t.sequence.getNumEvents() == 4);
+    CHECK(t.sequence.getEvent(1).message.getNoteNumber() == 64);
+    REQUIRE_THAT(t.sequence.getEvent(2).timeInBeats, WithinAbs(1.0, 1e-9));
+    CHECK(t.sequence.getEvent(0).matchedPairIndex == 2);
+    CHECK(t.sequence.getEvent(1).matchedPairIndex == 3);
+
+    REQUIRE(file->getTempoChanges().size() == 2);
+    REQUIRE_THAT(file->getTempoChanges()[0].bpm, WithinAbs(120.0, 1e-6));
+    REQUIRE_THAT(file->getTempoChanges()[1].bpm, WithinAbs(60.0, 1e-6));
+    REQUIRE_THAT(file->getTempoChanges()[1].timeInBeats, WithinAbs(1.5, 1e-9));
+
+    REQUIRE(file->getTimeSignatureChanges().size() == 1);
+    CHECK(file->getTimeSignatureChanges()[0].numerator == 3);
+    CHECK(file->getTimeSignatureChanges()[0].denominator == 4);
+}
+
+TEST_CASE("MidiFile rejects malformed headers", "[midi][file]")
+{
+    std::vector<uint8_t> junk = {'R', 'I', 'F', 'F', 0, 0, 0, 6, 0, 0, 0, 1, 1, 0xE0};
+    CHECK(dc::MidiFile::readFromMemory(junk.data(), junk.size()) == nullptr);
+    CHECK(dc::MidiFile::readFromMemory(nullptr, 0) == nullptr);
+}
+
+TEST_CASE("MidiFile keeps events before a truncated chunk", "[midi][file]")
+{
+    std::vector<uint8_t> track = {0x00, 0x90, 60, 100, 0x60, 0x80, 60};  // last event cut short
+    auto bytes = makeSmf(0, 96, {track});
+    auto file = dc::MidiFile::readFromMemory(bytes.data(), bytes.size());
+
+    REQUIRE(file != nullptr);
+    REQUIRE(file->getNumTracks() == 1);
+    CHECK(file->getTrack(0).sequence.getNumEvents() == 1);
+}
+
+TEST_CASE("MidiFile cancels running status after meta and sysex events", "[midi][file]")
+{
+    std::vector<uint8_t> afterMeta = {
+        0x00, 0x90, 60, 100,
+        0x00, 0xFF, 0x01, 0x01, 'x',                         // text
+        0x00, 64, 90,                                        // no status to run on
+    };
+    std::vector<uint8_t> afterSysex = {
+        0x00, 0x90, 60, 100,
+        0x00, 0xF0, 0x02, 0x7E, 0xF7,
+        0x00, 64, 90,
+    };
+
+    auto bytes = makeSmf(1, 96, {afterMeta, afterSysex});
+    auto file = dc::MidiFile::readFromMemory(bytes.data(), bytes.size());
+    REQUIRE(file != nullptr);
+    REQUIRE(file->getNumTracks() == 2);
+    CHECK(file->getTrack(0).sequence.getNumEvents() == 1);
+    CHECK(file->getTrack(1).sequence.getNumEvents() == 2);   // note on + sysex
+}
+
+TEST_CASE("MidiFile skips system common and real-time bytes", "[midi][file]")
+{
+    std::vector<uint8_t> track = {
+        0x00, 0x90, 60, 100,
+        0x00, 0xF8,                                          // clock: running status survives
+        0x00, 64, 90,
+        0x00, 0xF2, 0x10, 0x20,                              // song position
+        0x60, 0x80, 60, 0,
+        0x00, 0xF6,                                          // tune request cancels running status
+        0x00, 64, 0,
+    };
+
+    auto bytes = makeSmf(0, 96, {track});
+    auto file = dc::MidiFile::readFromMemory(bytes.data(), bytes.size());
+    REQUIRE(file != nullptr);
+
+    const auto& seq = file->getTrack(0).sequence;
+    REQUIRE(seq.getNumEvents() == 3);
+    CHECK(seq.getEvent(1).message.getNoteNumber() == 64);
+    CHECK(seq.getEvent(2).message.isNoteOff());
+    REQUIRE_THAT(seq.getEvent(2).timeInBeats, WithinAbs(1.0, 1e-9));
+}
+
+TEST_CASE("MidiFile maps SMPTE time through the file's tempo events", "[midi][file]")
+{
+    // 25 fps x 40 ticks = 1000 ticks per second
+    std::vector<uint8_t> track = {
+        0x00, 0xFF, 0x51, 0x03, 0x0F, 0x42, 0x40,           // 60 bpm
+        0x00, 0x90, 60, 100,
+        0x87, 0x68, 0x80, 60, 0,                             // 1 s
+        0x87, 0x68, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20,     // 2 s: 120 bpm
+        0x87, 0x68, 0x90, 62, 100,                           // 3 s
+        0x00, 0xFF, 0x2F, 0x00
+    };
+
+    auto bytes = makeSmf(0, 0xE728, {track});
+    auto file = dc::MidiFile::readFromMemory(bytes.data(), bytes.size());
+    REQUIRE(file != nullptr);
+
+    // No implied 120 bpm next to the file's own tempo
+    const auto& tempos = file->getTempoChanges();
+    REQUIRE(tempos.size() == 2);
+    REQUIRE_THAT(tempos[0].bpm, WithinAbs(60.0, 1e-6));
+    REQUIRE_THAT(tempos[1].timeInBeats, WithinAbs(2.0, 1e-9));
+
+    const auto& seq = file->getTrack(0).sequence;
+    REQUIRE(seq.getNumEvents() == 3);
+    REQUIRE_THAT(seq.getEvent(1).timeInBeats, WithinAbs(1.0, 1e-9));
+    REQUIRE_THAT(seq.getEvent(2).timeInBeats, WithinAbs(4.0, 1e-9));
+
+    // Without tempo events the grid stays at 120 bpm, implied
+    std::vector<uint8_t> plain = {0x00, 0x90, 60, 100, 0x87, 0x68, 0x80, 60, 0};
+    bytes = makeSmf(0, 0xE728, {plain});
+    file = dc::MidiFile::readFromMemory(bytes.data(), bytes.size());
+    REQUIRE(file != nullptr);
+    CHECK(file->getTempoChanges().empty());
+    REQUIRE_THAT(file->getTrack(0).sequence.getEvent(1).timeInBeats, WithinAbs(2.0, 1e-9));
+}
+
+// ─── Round trip ─────────────────────────────────────────────────
+
+TEST_CASE("MidiFile write/read round-trips tracks, tempo and sysex", "[midi][file]")
+{
+    dc::MidiFile out;
+    out.setTicksPerQuarterNote(960);
+    out.addTempoChange(0.0, 140.0);
+    out.addTempoChange(8.0, 90.0);
+    out.addTimeSignatureChange(0.0, 7, 8);
+
+    for (int t = 0; t < 3; ++t)
+    {
+        dc::MidiFile::Track track;
+        track.name = "Track " + std::to_string(t + 1);
+
+        std::vector<dc::TimedMidiEvent> events;
+        for (int i = 0; i < 32; ++i)
+        {
+            events.push_back({i * 0.25, dc::MidiMessage::noteOn(t + 1, 48 + i, 0.8f), -1});
+            events.push_back({i * 0.25 + 0.125, dc::MidiMessage::noteOff(t + 1, 48 + i), -1});
+        }
+        events.push_back({2.0, dc::MidiMessage::controllerEvent(t + 1, 7, 100), -1});
+        track.sequence.addEvents(std::move(events));
+        out.addTrack(std::move(track));
+    }
+
+    const uint8_t sysex[] = {0xF0, 0x7E, 0x7F, 0x09, 0x01, 0xF7};
+    out.getTrack(0).sequence.addEvent(dc::MidiMessage(sysex, 6), 0.5);
+
+    auto bytes = out.writeToMemory();
+    auto in = dc::MidiFile::readFromMemory(bytes.data(), bytes.size(), 2);
+    REQUIRE(in != nullptr);
+
+    // Conductor track comes back as an empty first track
+    REQUIRE(in->getNumTracks() == 4);
+    CHECK(in->getTrack(0).sequence.getNumEvents() == 0);
+    CHECK(in->getTotalNumEvents() == out.getTotalNumEvents());
+
+    for (int t = 0; t < 3; ++t)
+    {
+        const auto& a = out.getTrack(t);
+        const auto& b = in->getTrack(t + 1);
+        CHECK(b.name == a.name);
+        REQUIRE(b.sequence.getNumEvents() == a.sequence.getNumEvents());
+
+        for (int i = 0; i < a.sequence.getNumEvents(); ++i)
+        {
+            const auto& ea = a.sequence.getEvent(i);
+            const auto& eb = b.sequence.getEvent(i);
+            REQUIRE_THAT(eb.timeInBeats, WithinAbs(ea.timeInBeats, 1e-9));
+            REQUIRE(eb.message.getRawDataSize() >= 2);
+            REQUIRE(eb.message.getRawData()[0] == ea.message.getRawData()[0]);
+            REQUIRE(eb.message.getRawData()[1] == ea.message.getRawData()[1]);
+        }
+    }
+
+    const auto& sx = in->getTrack(1).sequence.getEvent(in->getTrack(1).sequence.getEventsInRange(0.5, 0.5001).first);
+    REQUIRE(sx.message.getRawDataSize() == 6);
+    CHECK(sx.message.getRawData()[5] == 0xF7);
+
+    REQUIRE(in->getTempoChanges().size() == 2);
+    REQUIRE_THAT(in->getTempoChanges()[0].bpm, WithinAbs(140.0, 0.01));
+    REQUIRE_THAT(in->getTempoChanges()[1].bpm, WithinAbs(90.0, 0.01));
+    REQUIRE_THAT(in->getTempoChanges()[1].timeInBeats, WithinAbs(8.0, 1e-9));
+    REQUIRE(in->getTimeSignatureChanges().size() == 1);
+    CHECK(in->getTimeSignatureChanges()[0].numerator == 7);
+    CHECK(in->getTimeSignatureChanges()[0].denominator == 8);
+}
+
+TEST_CASE("MidiFile write/read via disk", "[midi][file]")
+{
+    auto path = std::filesystem::temp_directory_path() / "dc_test_midi_file.mid";
+
+    dc::MidiFile out;
+    dc::MidiFile::Track track;
+    track.sequence.addEvent(dc::MidiMessage::noteOn(10, 36, 1.0f), 0.0);
+    track.sequence.addEvent(dc::MidiMessage::noteOff(10, 36), 0.5);
+    out.addTrack(std::move(track));
+
+    REQUIRE(out.write(path));
+    auto in = dc::MidiFile::read(path);
+    std::filesystem::remove(path);
+
+    REQUIRE(in != nullptr);
+    REQUIRE(in->getNumTracks() == 2);
+    CHECK(in->getTrack(1).sequence.getEvent(0).message.getChannel() == 10);
+    CHECK(in->getTrack(1).sequence.getEvent(0).matchedPairIndex == 1);
+    CHECK(dc::MidiFile::read(path) == nullptr);
+}
+
+// ─── Bulk import ────────────────────────────────────────────────
+
+TEST_CASE("MidiFile parses large multi-track files in parallel", "[midi][file]")
+{
+    constexpr int kTracks = 16;
+    constexpr int kNotesPerTrack = 20000;
+
+    dc::MidiFile out;
+    out.setTicksPerQuarterNote(480);
+    for (int t = 0; t < kTracks; ++t)
+    {
+        dc::MidiFile::Track track;
+        std::vector<dc::TimedMidiEvent> events;
+        events.reserve(kNotesPerTrack * 2);
+        for (int i = 0; i < kNotesPerTrack; ++i)
+        {
+            events.push_back({i * 0.5, dc::MidiMessage::noteOn(1, 40 + i % 40, 0.5f), -1});
+            events.push_back({i * 0.5 + 0.25, dc::MidiMessage::noteOff(1, 40 + i % 40), -1});
+        }
+        track.sequence.addEvents(std::move(events));
+        out.addTrack(std::move(track));
+    }
+
+    auto bytes = out.writeToMemory();
+
+    auto serial = dc::MidiFile::readFromMemory(bytes.data(), bytes.size(), 1);
+    auto parallel = dc::MidiFile::readFromMemory(bytes.data(), bytes.size(), 4);
+    REQUIRE(serial != nullptr);
+    REQUIRE(parallel != nullptr);
+
+    CHECK(serial->getTotalNumEvents() == kTracks * kNotesPerTrack * 2);
+    CHECK(parallel->getTotalNumEvents() == serial->getTotalNumEvents());
+    REQUIRE_THAT(parallel->getLengthInBeats(), WithinAbs((kNotesPerTrack - 1) * 0.5 + 0.25, 1e-9));
+
+    // Every note pairs with its own off
+    const auto& seq = parallel->getTrack(kTracks).sequence;
+    for (int i = 0; i < seq.getNumEvents(); i += 2)
+        REQUIRE(seq.getEvent(i).matchedPairIndex == i + 1);
+}
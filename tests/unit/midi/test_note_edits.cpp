@@ -0,0 +1,172 @@
+// Unit tests for dc::NoteEdits bulk kernels
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <dc/midi/NoteEdits.h>
+
+#include <cmath>
+
+using Catch::Matchers::WithinAbs;
+
+// ─── quantize ───────────────────────────────────────────────────
+
+TEST_CASE("quantizeNotes snaps starts to the grid", "[midi][note_edits]")
+{
+    dc::NoteArray notes;
+    notes.add(60, 0.1, 0.5, 100);
+    notes.add(62, 0.9, 0.5, 100);
+    notes.add(64, 1.3, 0.5, 100);
+
+    dc::quantizeNotes(notes, {});
+
+    REQUIRE_THAT(notes.startBeats[0], WithinAbs(0.0, 1e-12));
+    REQUIRE_THAT(notes.startBeats[1], WithinAbs(1.0, 1e-12));
+    REQUIRE_THAT(notes.startBeats[2], WithinAbs(1.25, 1e-12));
+    REQUIRE_THAT(notes.lengthBeats[0], WithinAbs(0.5, 1e-12));
+}
+
+TEST_CASE("quantizeNotes applies strength", "[midi][note_edits]")
+{
+    dc::NoteArray notes;
+    notes.add(60, 1.2, 0.5, 100);
+
+    dc::QuantizeSettings settings;
+    settings.gridBeats = 1.0;
+    settings.strength = 0.5;
+    dc::quantizeNotes(notes, settings);
+
+    REQUIRE_THAT(notes.startBeats[0], WithinAbs(1.1, 1e-12));
+}
+
+TEST_CASE("quantizeNotes swings off-beat grid lines", "[midi][note_edits]")
+{
+    dc::NoteArray notes;
+    notes.add(60, 0.02, 0.25, 100);   // on-beat: 0.0
+    notes.add(60, 0.51, 0.25, 100);   // off-beat: 0.5 + swing
+    notes.add(60, 1.49, 0.25, 100);   // off-beat: 1.5 + swing
+
+    dc::QuantizeSettings settings;
+    settings.gridBeats = 0.5;
+    settings.swing = 1.0 / 3.0;
+    dc::quantizeNotes(notes, settings);
+
+    REQUIRE_THAT(notes.startBeats[0], WithinAbs(0.0, 1e-12));
+    REQUIRE_THAT(notes.startBeats[1], WithinAbs(0.5 + 0.5 / 3.0, 1e-12));
+    REQUIRE_THAT(notes.startBeats[2], WithinAbs(1.5 + 0.5 / 3.0, 1e-12));
+}
+
+TEST_CASE("quantizeNotes can snap note ends", "[midi][note_edits]")
+{
+    dc::NoteArray notes;
+    notes.add(60, 0.1, 0.8, 100);   // end 0.9 -> 1.0
+
+    dc::QuantizeSettings settings;
+    settings.quantizeEnds = true;
+    dc::quantizeNotes(notes, settings);
+
+    REQUIRE_THAT(notes.startBeats[0], WithinAbs(0.0, 1e-12));
+    REQUIRE_THAT(notes.lengthBeats[0], WithinAbs(1.0, 1e-12));
+}
+
+// ─── humanize ───────────────────────────────────────────────────
+
+TEST_CASE("humanizeNotes is reproducible and bounded", "[midi][note_edits]")
+{
+    dc::NoteArray a;
+    for (int i = 0; i < 1000; ++i)
+        a.add(60, 4.0 + i, 0.5, 64);
+    dc::NoteArray b = a;
+    dc::NoteArray c = a;
+
+    dc::humanizeNotes(a, 0.1, 10.0, 1234);
+    dc::humanizeNotes(b, 0.1, 10.0, 1234);
+    dc::humanizeNotes(c, 0.1, 10.0, 9999);
+
+    bool anyDifferent = false;
+    bool anyMoved = false;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        REQUIRE(a.startBeats[i] == b.startBeats[i]);
+        REQUIRE(a.velocities[i] == b.velocities[i]);
+        REQUIRE(std::abs(a.startBeats[i] - (4.0 + static_cast<double>(i))) <= 0.1);
+        REQUIRE(std::abs(a.velocities[i] - 64) <= 10);
+        anyDifferent |= a.startBeats[i] != c.startBeats[i];
+        anyMoved |= a.startBeats[i] != 4.0 + static_cast<double>(i);
+    }
+    CHECK(anyDifferent);
+    CHECK(anyMoved);
+}
+
+TEST_CASE("humanizeNotes clamps to valid range", "[midi][note_edits]")
+{
+    dc::NoteArray notes;
+    for (int i = 0; i < 100; ++i)
+        notes.add(60, 0.0, 0.5, i % 2 == 0 ? 1 : 127);
+
+    dc::humanizeNotes(notes, 1.0, 50.0, 7);
+
+    for (size_t i = 0; i < notes.size(); ++i)
+    {
+        REQUIRE(notes.startBeats[i] >= 0.0);
+        REQUIRE(notes.velocities[i] >= 1);
+        REQUIRE(notes.velocities[i] <= 127);
+    }
+}
+
+// ─── transpose / velocity ───────────────────────────────────────
+
+TEST_CASE("transposeNotes clamps to MIDI range", "[midi][note_edits]")
+{
+    dc::NoteArray notes;
+    notes.add(60, 0.0, 1.0, 100);
+    notes.add(125, 0.0, 1.0, 100);
+    notes.add(2, 0.0, 1.0, 100);
+
+    dc::transposeNotes(notes, 5);
+    CHECK(notes.noteNumbers[0] == 65);
+    CHECK(notes.noteNumbers[1] == 127);
+
+    dc::transposeNotes(notes, -10);
+    CHECK(notes.noteNumbers[2] == 0);
+}
+
+TEST_CASE("scaleNoteVelocities scales and clamps", "[midi][note_edits]")
+{
+    dc::NoteArray notes;
+    notes.add(60, 0.0, 1.0, 100);
+    notes.add(60, 0.0, 1.0, 10);
+
+    dc::scaleNoteVelocities(notes, 1.5);
+    CHECK(notes.velocities[0] == 127);
+    CHECK(notes.velocities[1] == 15);
+
+    dc::scaleNoteVelocities(notes, 0.0, -5.0);
+    CHECK(notes.velocities[1] == 1);
+}
+
+// ─── legato ─────────────────────────────────────────────────────
+
+TEST_CASE("legatoNotes extends notes to the next onset", "[midi][note_edits]")
+{
+    dc::NoteArray notes;
+    notes.add(67, 2.0, 0.1, 100);   // unsorted on purpose
+    notes.add(60, 0.0, 0.1, 100);
+    notes.add(64, 0.0, 0.2, 100);   // chord with the previous note
+    notes.add(72, 3.5, 0.1, 100);
+
+    dc::legatoNotes(notes, 0.0);
+
+    REQUIRE_THAT(notes.lengthBeats[1], WithinAbs(2.0, 1e-12));
+    REQUIRE_THAT(notes.lengthBeats[2], WithinAbs(2.0, 1e-12));
+    REQUIRE_THAT(notes.lengthBeats[0], WithinAbs(1.5, 1e-12));
+    REQUIRE_THAT(notes.lengthBeats[3], WithinAbs(0.1, 1e-12));   // last keeps length
+}
+
+TEST_CASE("legatoNotes leaves a gap when asked", "[midi][note_edits]")
+{
+    dc::NoteArray notes;
+    notes.add(60, 0.0, 0.1, 100);
+    notes.add(62, 1.0, 0.1, 100);
+
+    dc::legatoNotes(notes, 0.125);
+    REQUIRE_THAT(notes.lengthBeats[0], WithinAbs(0.875, 1e-12));
+}
@@ -0,0 +1,178 @@
+// Unit tests for dc::NoteIndex
+#include <catch2/catch_test_macros.hpp>
+#include <dc/midi/NoteIndex.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<int> idsOf(const std::vector<const dc::NoteIndex::Note*>& notes)
+{
+    std::vector<int> ids;
+    for (const auto* n : notes)
+        ids.push_back(n->id);
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+/// Brute-force reference for query()
+std::vector<int> overlapping(const std::vector<dc::NoteIndex::Note>& notes, double start, double end,
+                             int low, int high)
+{
+    std::vector<int> ids;
+    for (const auto& n : notes)
+    {
+        if (n.id >= 0 && n.noteNumber >= low && n.noteNumber <= high
+            && n.startBeat < end && (n.endBeat() > start || n.startBeat >= start))
+            ids.push_back(n.id);
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+} // anonymous namespace
+
+TEST_CASE("NoteIndex finds notes overlapping a region", "[midi][note_index]")
+{
+    dc::NoteIndex index;
+    index.insert({ 0, 60, 0.0, 1.0, 100 });
+    index.insert({ 1, 60, 4.0, 8.0, 100 });     // long note starting before the range
+    index.insert({ 2, 62, 5.0, 0.5, 100 });
+    index.insert({ 3, 70, 5.0, 0.5, 100 });     // above the pitch range
+
+    std::vector<const dc::NoteIndex::Note*> found;
+    index.query(6.0, 7.0, 55, 65, found);
+    REQUIRE(idsOf(found) == std::vector<int> { 1 });
+
+    found.clear();
+    index.query(0.0, 5.5, 0, 127, found);
+    REQUIRE(idsOf(found) == std::vector<int> { 0, 1, 2, 3 });
+
+    // Ends are exclusive
+    found.clear();
+    index.query(1.0, 4.0, 0, 127, found);
+    REQUIRE(found.empty());
+}
+
+TEST_CASE("NoteIndex hit-tests the note sounding at a beat", "[midi][note_index]")
+{
+    dc::NoteIndex index;
+    index.insert({ 0, 60, 0.0, 4.0, 100 });
+    index.insert({ 1, 60, 1.0, 0.5, 100 });
+
+    REQUIRE(index.noteAt(60, 1.25)->id == 1);  // the later start wins
+    REQUIRE(index.noteAt(60, 2.0)->id == 0);
+    REQUIRE(index.noteAt(60, 4.0) == nullptr);
+    REQUIRE(index.noteAt(61, 1.0) == nullptr);
+    REQUIRE(index.noteAt(-1, 1.0) == nullptr);
+}
+
+TEST_CASE("NoteIndex moves and removes notes in place", "[midi][note_index]")
+{
+    dc::NoteIndex index;
+    index.insert({ 7, 60, 0.0, 1.0, 100 });
+    index.insert({ 7, 64, 2.0, 1.0, 90 });     // same id: moved
+
+    REQUIRE(index.size() == 1);
+    REQUIRE(index.noteAt(60, 0.5) == nullptr);
+    REQUIRE(index.noteAt(64, 2.5)->velocity == 90);
+
+    REQUIRE(index.remove(7));
+    REQUIRE_FALSE(index.remove(7));
+    REQUIRE(index.empty());
+}
+
+TEST_CASE("NoteIndex forgets long notes once they are shortened or removed", "[midi][note_index]")
+{
+    dc::NoteIndex index;
+    index.insert({ 0, 60, 0.0, 64.0, 100 });
+    index.insert({ 1, 60, 8.0, 1.0, 100 });
+    REQUIRE(index.noteAt(60, 32.0)->id == 0);
+
+    index.insert({ 0, 60, 0.0, 2.0, 100 });    // shortened
+    REQUIRE(index.noteAt(60, 32.0) == nullptr);
+    REQUIRE(index.noteAt(60, 1.0)->id == 0);
+    REQUIRE(index.noteAt(60, 8.5)->id == 1);
+
+    std::vector<const dc::NoteIndex::Note*> found;
+    index.query(16.0, 48.0, 60, 60, found);
+    REQUIRE(found.empty());
+
+    REQUIRE(index.remove(0));
+    found.clear();
+    index.query(0.0, 10.0, 60, 60, found);
+    REQUIRE(idsOf(found) == std::vector<int> { 1 });
+}
+
+TEST_CASE("NoteIndex queries match a brute-force scan through random edits", "[midi][note_index]")
+{
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> beat(0.0, 512.0);
+    std::uniform_real_distribution<double> length(0.05, 6.0);
+    std::uniform_int_distribution<int> pitch(0, 127);
+
+    const int numNotes = 20000;
+    std::vector<dc::NoteIndex::Note> notes;
+    dc::NoteIndex index;
+
+    for (int i = 0; i < numNotes; ++i)
+    {
+        notes.push_back({ i, pitch(rng), beat(rng), length(rng), 100 });
+        index.insert(notes.back());
+    }
+
+    std::uniform_int_distribution<int> pick(0, numNotes - 1);
+    for (int i = 0; i < 2000; ++i)
+    {
+        auto& n = notes[static_cast<size_t>(pick(rng))];
+        if (n.id < 0)
+            continue;
+
+        if (i % 3 == 0)
+        {
+            index.remove(n.id);
+            n.id = -1;
+        }
+        else
+        {
+            n.noteNumber = pitch(rng);
+            n.startBeat = beat(rng);
+            n.lengthBeats = i % 3 == 1 ? length(rng) * 20.0 : length(rng);
+            index.insert(n);
+        }
+    }
+
+    for (int q = 0; q < 200; ++q)
+    {
+        double start = beat(rng);
+        double end = start + length(rng) * 4.0;
+        int low = pitch(rng);
+        int high = std::min(127, low + pitch(rng) / 4);
+
+        std::vector<const dc::NoteIndex::Note*> found;
+        index.query(start, end, low, high, found);
+        REQUIRE(idsOf(found) == overlapping(notes, start, end, low, high));
+    }
+
+    // Hit-tests match the latest-starting sounding note
+    for (int q = 0; q < 500; ++q)
+    {
+        int p = pitch(rng);
+        double at = beat(rng);
+
+        const dc::NoteIndex::Note* expected = nullptr;
+        for (const auto& n : notes)
+        {
+            if (n.id < 0 || n.noteNumber != p || n.startBeat > at || at >= n.endBeat())
+                continue;
+            if (expected == nullptr || n.startBeat > expected->startBeat
+                || (n.startBeat == expected->startBeat && n.id > expected->id))
+                expected = &n;
+        }
+
+        auto* hit = index.noteAt(p, at);
+        REQUIRE((hit != nullptr ? hit->id : -1) == (expected != nullptr ? expected->id : -1));
+    }
+}
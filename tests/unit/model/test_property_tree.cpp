@@ -161,6 +161,29 @@ TEST_CASE ("PropertyTree: setting same value again does not notify", "[model][pr
     REQUIRE (callCount == 0);
 }
 
+TEST_CASE ("PropertyTree: setPropertySilently does not notify", "[model][property_tree]")
+{
+    PropertyTree parent (PropertyId ("Parent"));
+    PropertyTree child (PropertyId ("Child"));
+    parent.addChild (child, -1);
+
+    int callCount = 0;
+    struct Counter : PropertyTree::Listener
+    {
+        int& count;
+        Counter (int& c) : count (c) {}
+        void propertyChanged (PropertyTree&, PropertyId) override { ++count; }
+    } listener (callCount);
+
+    parent.addListener (&listener);
+    child.setPropertySilently (PropertyId ("x"), Variant (1));
+    child.setPropertySilently (PropertyId ("x"), Variant (2));
+    parent.removeListener (&listener);
+
+    REQUIRE (callCount == 0);
+    REQUIRE (child.getProperty (PropertyId ("x")).toInt() == 2);
+}
+
 TEST_CASE ("PropertyTree: overwriting property updates value", "[model][property_tree]")
 {
     PropertyTree tree (PropertyId ("Node"));
@@ -0,0 +1,113 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "graphics/core/Node.h"
+
+using dc::gfx::Node;
+using dc::gfx::Rect;
+
+TEST_CASE ("Node damage collects at the root in root coordinates", "[graphics][damage]")
+{
+    Node root, panel, child;
+    root.setBounds (Rect (0, 0, 800, 600));
+    panel.setBounds (Rect (100, 50, 300, 200));
+    child.setBounds (Rect (10, 20, 40, 30));
+    root.addChild (&panel);
+    panel.addChild (&child);
+    root.clearDamage();
+
+    child.invalidate();
+
+    REQUIRE (root.hasDamage());
+    REQUIRE (root.getDamage().size() == 1);
+    REQUIRE (root.getDamage()[0] == Rect (110, 70, 40, 30));
+    REQUIRE (panel.isDirty());
+    REQUIRE_FALSE (panel.hasDamage());
+}
+
+TEST_CASE ("Node damage is clipped by every ancestor", "[graphics][damage]")
+{
+    Node root, panel, child;
+    root.setBounds (Rect (0, 0, 800, 600));
+    panel.setBounds (Rect (100, 50, 300, 200));
+    child.setBounds (Rect (280, 180, 100, 100));    // hangs off the panel
+    root.addChild (&panel);
+    panel.addChild (&child);
+    root.clearDamage();
+
+    child.invalidate();
+    REQUIRE (root.getDamage().size() == 1);
+    REQUIRE (root.getDamage()[0] == Rect (380, 230, 20, 20));
+
+    // Entirely outside: marks it dirty, damages nothing
+    root.clearDamage();
+    child.invalidateRect (Rect (50, 50, 10, 10));
+    REQUIRE (child.isDirty());
+    REQUIRE_FALSE (root.hasDamage());
+}
+
+TEST_CASE ("Node damage merges overlapping rectangles and keeps separate ones", "[graphics][damage]")
+{
+    Node root;
+    root.setBounds (Rect (0, 0, 1000, 1000));
+    root.clearDamage();
+
+    root.invalidateRect (Rect (0, 0, 10, 10));
+    root.invalidateRect (Rect (5, 5, 10, 10));
+    root.invalidateRect (Rect (500, 500, 10, 10));
+
+    REQUIRE (root.getDamage().size() == 2);
+    REQUIRE (root.getDamage()[0] == Rect (0, 0, 15, 15));
+    REQUIRE (root.getDamage()[1] == Rect (500, 500, 10, 10));
+
+    SECTION ("too many rectangles collapse into one")
+    {
+        for (size_t i = 0; i < Node::maxDamageRects; ++i)
+            root.invalidateRect (Rect (20.0f + 30.0f * static_cast<float> (i), 900, 10, 10));
+
+        REQUIRE (root.getDamage().size() == 1);
+        REQUIRE (root.getDamage()[0] == Rect (0, 0, 510, 910));
+    }
+}
+
+TEST_CASE ("Moving a node damages where it was and where it is", "[graphics][damage]")
+{
+    Node root, child;
+    root.setBounds (Rect (0, 0, 800, 600));
+    child.setBounds (Rect (10, 10, 20, 20));
+    root.addChild (&child);
+    root.clearDamage();
+
+    child.setBounds (Rect (400, 300, 20, 20));
+
+    REQUIRE (root.getDamage().size() == 2);
+    REQUIRE (root.getDamage()[0] == Rect (10, 10, 20, 20));
+    REQUIRE (root.getDamage()[1] == Rect (400, 300, 20, 20));
+
+    root.clearDamage();
+    root.removeChild (&child);
+    REQUIRE (root.getDamage().size() == 1);
+    REQUIRE (root.getDamage()[0] == Rect (400, 300, 20, 20));
+}
+
+TEST_CASE ("A destroyed node is released by its resource owner", "[graphics][cache]")
+{
+    struct Owner : dc::gfx::NodeResourceOwner
+    {
+        std::vector<const Node*> released;
+        void releaseNode (Node& node) override { released.push_back (&node); }
+    };
+
+    Owner owner;
+    Node root;
+    const Node* address = nullptr;
+    {
+        Node child;
+        root.addChild (&child);
+        child.setResourceOwner (&owner);
+        address = &child;
+    }
+
+    REQUIRE (owner.released.size() == 1);
+    REQUIRE (owner.released[0] == address);
+    REQUIRE (root.getNumChildren() == 0);
+}